@@ -0,0 +1,175 @@
+#include "bench/utils/BenchUtils.h"
+#include "pljit/analysis/SemanticAnalysis.h"
+#include "pljit/analysis/SymbolTable.h"
+#include "pljit/ast/AST.h"
+#include "pljit/common/SourceCodeManager.h"
+#include "pljit/lexer/Lexer.h"
+#include "pljit/optim/ConstantPropagation.h"
+#include "pljit/optim/DeadCodeElimination.h"
+#include "pljit/parse_tree/ParseTree.h"
+#include "pljit/parser/Parser.h"
+#include "scripts/WorkloadGenerator.h"
+#include <benchmark/benchmark.h>
+
+namespace pljit {
+
+namespace {
+
+/// The compile phases which are benchmarked separately.
+enum class Phase {
+    Lexing,
+    Parsing,
+    SemanticAnalysis,
+    DeadCodeElimination,
+    ConstantPropagation,
+    Compilation
+};
+
+/// Parses the source code. The parse tree references the source code manager.
+std::unique_ptr<parse_tree::FunctionDefinition> parse(const common::SourceCodeManager& sourceCodeManager)
+{
+    // Parallel parsing is disabled, such that only the parser is measured.
+    parser::Parser parser(sourceCodeManager, parser::ParserOptions{.parallelParsingThreshold = 0});
+    return parser.parseFunctionDefinition();
+}
+
+/// Analyzes the parse tree into an AST.
+std::unique_ptr<ast::Function> analyze(const common::SourceCodeManager& sourceCodeManager,
+                                       analysis::SymbolTable& symbolTable,
+                                       const parse_tree::FunctionDefinition& parseTree)
+{
+    analysis::SemanticAnalysis semanticAnalysis(sourceCodeManager, symbolTable);
+    return semanticAnalysis.analyzeFunction(parseTree);
+}
+
+/// Benchmarks a single compile phase. The input of the phase is prepared
+/// outside of the measured time. The optimization passes transform the AST
+/// in-place, hence, a fresh AST is analyzed for every iteration.
+void benchmarkPhase(benchmark::State& state, Phase phase, const std::string& code)
+{
+    auto numberOfParameters = bench_utils::getNumberOfParameters(code);
+    if (!numberOfParameters) {
+        state.SkipWithError("compile error");
+        return;
+    }
+    common::SourceCodeManager sourceCodeManager(code);
+    auto parseTree = parse(sourceCodeManager);
+
+    for (auto _ : state) {
+        switch (phase) {
+            case Phase::Lexing: {
+                lexer::Lexer lexer(sourceCodeManager);
+                while (lexer.hasNext()) {
+                    benchmark::DoNotOptimize(lexer.next());
+                }
+                break;
+            }
+
+            case Phase::Parsing:
+                benchmark::DoNotOptimize(parse(sourceCodeManager));
+                break;
+
+            case Phase::SemanticAnalysis: {
+                analysis::SymbolTable symbolTable;
+                benchmark::DoNotOptimize(analyze(sourceCodeManager, symbolTable, *parseTree));
+                break;
+            }
+
+            case Phase::DeadCodeElimination:
+            case Phase::ConstantPropagation: {
+                state.PauseTiming();
+                analysis::SymbolTable symbolTable;
+                auto ast = analyze(sourceCodeManager, symbolTable, *parseTree);
+                state.ResumeTiming();
+                if (phase == Phase::DeadCodeElimination) {
+                    optim::DeadCodeElimination deadCodeElimination;
+                    ast->accept(deadCodeElimination);
+                } else {
+                    optim::ConstantPropagation constantPropagation(symbolTable);
+                    ast->accept(constantPropagation);
+                }
+                benchmark::DoNotOptimize(ast.get());
+                // The AST is freed outside of the measured time.
+                state.PauseTiming();
+                ast.reset();
+                state.ResumeTiming();
+                break;
+            }
+
+            case Phase::Compilation: {
+                // All phases including the code generation of the Pljit.
+                Pljit pljit;
+                auto function = pljit.registerFunction(code);
+                benchmark::DoNotOptimize(bench_utils::call(function, *numberOfParameters));
+                break;
+            }
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * code.size()));
+}
+
+/// Benchmarks a compile phase on a synthetic function.
+void benchmarkSyntheticPhase(benchmark::State& state, Phase phase)
+{
+    benchmarkPhase(state, phase, bench_utils::generateFunction(static_cast<size_t>(state.range(0))));
+}
+
+void BM_Lexing(benchmark::State& state) { benchmarkSyntheticPhase(state, Phase::Lexing); }
+void BM_Parsing(benchmark::State& state) { benchmarkSyntheticPhase(state, Phase::Parsing); }
+void BM_SemanticAnalysis(benchmark::State& state) { benchmarkSyntheticPhase(state, Phase::SemanticAnalysis); }
+void BM_DeadCodeElimination(benchmark::State& state) { benchmarkSyntheticPhase(state, Phase::DeadCodeElimination); }
+void BM_ConstantPropagation(benchmark::State& state) { benchmarkSyntheticPhase(state, Phase::ConstantPropagation); }
+void BM_Compilation(benchmark::State& state) { benchmarkSyntheticPhase(state, Phase::Compilation); }
+
+/// Benchmarks the compilation of a generated workload function with the given
+/// expression depth and fan-out.
+void BM_CompilationByShape(benchmark::State& state)
+{
+    workload::WorkloadOptions options{.numberOfParameters = 4,
+                                      .numberOfVariables = 16,
+                                      .numberOfConstants = 8,
+                                      .numberOfStatements = 256,
+                                      .maxExpressionDepth = static_cast<size_t>(state.range(0)),
+                                      .fanOut = static_cast<size_t>(state.range(1))};
+    benchmarkPhase(state, Phase::Compilation, workload::WorkloadGenerator(options).generateFunction());
+}
+
+/// Registers the benchmarks of every phase for every example program, they
+/// are named after the file, e.g. BM_Parsing/Test.pl.
+bool registerExampleBenchmarks()
+{
+    constexpr std::pair<Phase, const char*> phases[] = {
+        {Phase::Lexing, "BM_Lexing"},
+        {Phase::Parsing, "BM_Parsing"},
+        {Phase::SemanticAnalysis, "BM_SemanticAnalysis"},
+        {Phase::DeadCodeElimination, "BM_DeadCodeElimination"},
+        {Phase::ConstantPropagation, "BM_ConstantPropagation"},
+        {Phase::Compilation, "BM_Compilation"}};
+    for (const auto& [phase, name] : phases) {
+        for (const auto& example : bench_utils::getExamples()) {
+            benchmark::RegisterBenchmark((std::string{name} + "/" + example.name).c_str(),
+                                         [phase = phase, &code = example.code](benchmark::State& state) {
+                                             benchmarkPhase(state, phase, code);
+                                         });
+        }
+    }
+    return true;
+}
+
+[[maybe_unused]] const bool exampleBenchmarksRegistered = registerExampleBenchmarks();
+
+} // namespace
+
+// The argument is the number of statements of the synthetic function.
+BENCHMARK(BM_Lexing)->Apply(bench_utils::applySyntheticSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Parsing)->Apply(bench_utils::applySyntheticSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SemanticAnalysis)->Apply(bench_utils::applySyntheticSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DeadCodeElimination)->Apply(bench_utils::applySyntheticSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ConstantPropagation)->Apply(bench_utils::applySyntheticSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Compilation)->Apply(bench_utils::applySyntheticSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CompilationByShape)
+    ->ArgNames({"depth", "fanout"})
+    ->ArgsProduct({{1, 4, 16}, {2, 8}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace pljit
@@ -0,0 +1,200 @@
+#include "bench/utils/BenchUtils.h"
+#include "pljit/Pljit.h"
+#include <algorithm>
+#include <barrier>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pljit {
+
+namespace {
+
+/// Returns the current time in nanoseconds.
+uint64_t now()
+{
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+/// Collects the call latencies of one benchmark thread.
+class LatencyRecorder {
+    public:
+    /// Calls the function and records its latency. Returns the latency.
+    uint64_t call(const FunctionHandle& function)
+    {
+        auto start = now();
+        benchmark::DoNotOptimize(bench_utils::call(function, 2));
+        auto latency = now() - start;
+        latencies.push_back(latency);
+        return latency;
+    }
+
+    /// Reports the latency percentiles of the thread in nanoseconds. The
+    /// counters are averaged over the threads, i.e. they are the percentiles
+    /// of a mean thread.
+    void report(benchmark::State& state)
+    {
+        if (latencies.empty()) {
+            return;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        uint64_t sum = 0;
+        for (auto latency : latencies) {
+            sum += latency;
+        }
+        auto getPercentile = [&](double percentile) {
+            auto index = static_cast<size_t>(percentile * static_cast<double>(latencies.size()));
+            return static_cast<double>(latencies[std::min(index, latencies.size() - 1)]);
+        };
+        state.counters["mean_ns"] = benchmark::Counter(static_cast<double>(sum) / static_cast<double>(latencies.size()),
+                                                       benchmark::Counter::kAvgThreads);
+        state.counters["p50_ns"] = benchmark::Counter(getPercentile(0.5), benchmark::Counter::kAvgThreads);
+        state.counters["p99_ns"] = benchmark::Counter(getPercentile(0.99), benchmark::Counter::kAvgThreads);
+        state.counters["p999_ns"] = benchmark::Counter(getPercentile(0.999), benchmark::Counter::kAvgThreads);
+        state.counters["max_ns"] = benchmark::Counter(static_cast<double>(latencies.back()),
+                                                      benchmark::Counter::kAvgThreads);
+    }
+
+    private:
+    std::vector<uint64_t> latencies;
+};
+
+/// The Pljit and the compiled functions which are shared by the threads of
+/// BM_SharedHandleContention and BM_HandleSetContention. The first thread sets
+/// them up before the threads start measuring and tears them down after all
+/// of them finished.
+std::unique_ptr<Pljit> sharedPljit;
+std::vector<FunctionHandle> sharedFunctions;
+
+void setUpSharedFunctions(size_t numberOfFunctions, size_t numberOfStatements)
+{
+    sharedPljit = std::make_unique<Pljit>();
+    for (size_t i = 0; i < numberOfFunctions; ++i) {
+        // The functions differ, such that they do not share their images.
+        sharedFunctions.push_back(sharedPljit->registerFunction(bench_utils::generateFunction(numberOfStatements + i)));
+        benchmark::DoNotOptimize(bench_utils::call(sharedFunctions.back(), 2));
+    }
+}
+
+void tearDownSharedFunctions()
+{
+    sharedFunctions.clear();
+    sharedPljit.reset();
+}
+
+void BM_SharedHandleContention(benchmark::State& state)
+{
+    // All threads call the same compiled function.
+    if (state.thread_index() == 0) {
+        setUpSharedFunctions(1, static_cast<size_t>(state.range(0)));
+    }
+    LatencyRecorder latencies;
+    for (auto _ : state) {
+        latencies.call(sharedFunctions.front());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    latencies.report(state);
+    if (state.thread_index() == 0) {
+        tearDownSharedFunctions();
+    }
+}
+
+void BM_HandleSetContention(benchmark::State& state)
+{
+    // Every thread calls the functions round-robin, starting at its own
+    // offset, such that the threads mostly call different functions.
+    if (state.thread_index() == 0) {
+        setUpSharedFunctions(static_cast<size_t>(state.range(0)), 10);
+    }
+    LatencyRecorder latencies;
+    // The shared functions may only be accessed once the loop started, i.e.
+    // once the first thread set them up, hence, the offset is computed from
+    // the argument.
+    auto numberOfFunctions = static_cast<size_t>(state.range(0));
+    auto next = static_cast<size_t>(state.thread_index()) * numberOfFunctions / static_cast<size_t>(state.threads());
+    for (auto _ : state) {
+        latencies.call(sharedFunctions[next]);
+        next = next + 1 == numberOfFunctions ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    latencies.report(state);
+    if (state.thread_index() == 0) {
+        tearDownSharedFunctions();
+    }
+}
+
+/// The function of BM_FirstCallStorm, which is registered anew for every
+/// storm and is called by all threads at once.
+struct StormFunction {
+    std::string code;
+    std::unique_ptr<Pljit> pljit;
+    std::optional<FunctionHandle> function;
+};
+std::unique_ptr<StormFunction> stormFunction;
+
+/// Registers the function in a fresh Pljit, i.e. uncompiled. It is called by
+/// the barrier once all threads finished the previous storm.
+struct StartStorm {
+    void operator()() noexcept
+    {
+        stormFunction->function.reset();
+        stormFunction->pljit = std::make_unique<Pljit>();
+        stormFunction->function.emplace(stormFunction->pljit->registerFunction(stormFunction->code));
+    }
+};
+std::unique_ptr<std::barrier<StartStorm>> stormBarrier;
+
+void BM_FirstCallStorm(benchmark::State& state)
+{
+    // Every iteration releases all threads at the same moment on a function
+    // which is not compiled yet. One thread compiles it, the others wait for
+    // the compilation in FunctionFrame::compileOnce(). The iteration time is
+    // the latency of the first call of the thread, such that the setup of the
+    // storms is not measured. Since Google Benchmark divides the manual time
+    // by the number of threads, the latency counters are the figures to
+    // compare between thread counts.
+    if (state.thread_index() == 0) {
+        stormFunction = std::make_unique<StormFunction>();
+        stormFunction->code = bench_utils::generateFunction(static_cast<size_t>(state.range(0)));
+        stormBarrier = std::make_unique<std::barrier<StartStorm>>(state.threads());
+    }
+    LatencyRecorder latencies;
+    for (auto _ : state) {
+        stormBarrier->arrive_and_wait();
+        auto latency = latencies.call(*stormFunction->function);
+        state.SetIterationTime(static_cast<double>(latency) / 1e9);
+    }
+    latencies.report(state);
+    if (state.thread_index() == 0) {
+        stormBarrier.reset();
+        stormFunction.reset();
+    }
+}
+
+} // namespace
+
+// The argument is the number of statements of the shared function.
+BENCHMARK(BM_SharedHandleContention)
+    ->ArgName("statements")
+    ->Arg(10)
+    ->Arg(1000)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+// The argument is the number of functions in the set.
+BENCHMARK(BM_HandleSetContention)->ArgName("handles")->Arg(16)->Arg(1024)->ThreadRange(1, 16)->UseRealTime();
+// The argument is the number of statements of the function, i.e. it controls
+// how long the threads wait for the compilation.
+BENCHMARK(BM_FirstCallStorm)
+    ->ArgName("statements")
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->ThreadRange(1, 16)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace pljit
@@ -0,0 +1,105 @@
+#include "bench/utils/BenchUtils.h"
+#include "pljit/Pljit.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <optional>
+
+namespace pljit {
+
+namespace {
+
+/// Benchmarks the latency of a single call of a compiled function.
+void benchmarkCallLatency(benchmark::State& state, const std::string& code)
+{
+    auto numberOfParameters = bench_utils::getNumberOfParameters(code);
+    if (!numberOfParameters) {
+        state.SkipWithError("compile error");
+        return;
+    }
+    Pljit pljit;
+    auto function = pljit.registerFunction(code);
+    // The function is compiled by the first call.
+    benchmark::DoNotOptimize(bench_utils::call(function, *numberOfParameters));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench_utils::call(function, *numberOfParameters));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_CallLatency(benchmark::State& state)
+{
+    benchmarkCallLatency(state, bench_utils::generateFunction(static_cast<size_t>(state.range(0))));
+}
+
+/// The Pljit which is shared by the threads of BM_CallThroughput.
+std::unique_ptr<Pljit> sharedPljit;
+std::optional<FunctionHandle> sharedFunction;
+
+void BM_CallThroughput(benchmark::State& state)
+{
+    // The first thread sets up the function before the threads start
+    // measuring and tears it down after all of them finished.
+    if (state.thread_index() == 0) {
+        sharedPljit = std::make_unique<Pljit>();
+        sharedFunction.emplace(sharedPljit->registerFunction(bench_utils::generateFunction(static_cast<size_t>(state.range(0)))));
+        benchmark::DoNotOptimize(bench_utils::call(*sharedFunction, 2));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench_utils::call(*sharedFunction, 2));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    if (state.thread_index() == 0) {
+        sharedFunction.reset();
+        sharedPljit.reset();
+    }
+}
+
+void BM_BatchThroughput(benchmark::State& state)
+{
+    // Every iteration calls a batch of distinct functions once, such that the
+    // compiled code does not stay in the caches between the calls.
+    auto batchSize = static_cast<size_t>(state.range(0));
+    Pljit pljit;
+    std::vector<FunctionHandle> functions;
+    functions.reserve(batchSize);
+    for (size_t i = 0; i < batchSize; ++i) {
+        functions.push_back(pljit.registerFunction(bench_utils::generateFunction(10 + i % 16)));
+        benchmark::DoNotOptimize(bench_utils::call(functions.back(), 2));
+    }
+    for (auto _ : state) {
+        for (const auto& function : functions) {
+            benchmark::DoNotOptimize(bench_utils::call(function, 2));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batchSize));
+}
+
+/// Registers the call latency benchmark for every example program, e.g.
+/// BM_CallLatency/Test.pl.
+bool registerExampleBenchmarks()
+{
+    for (const auto& example : bench_utils::getExamples()) {
+        benchmark::RegisterBenchmark(("BM_CallLatency/" + example.name).c_str(),
+                                     [&code = example.code](benchmark::State& state) {
+                                         benchmarkCallLatency(state, code);
+                                     });
+    }
+    return true;
+}
+
+[[maybe_unused]] const bool exampleBenchmarksRegistered = registerExampleBenchmarks();
+
+} // namespace
+
+// The argument is the number of statements of the synthetic function.
+BENCHMARK(BM_CallLatency)->Apply(bench_utils::applySyntheticSizes);
+BENCHMARK(BM_CallThroughput)
+    ->ArgName("statements")
+    ->Arg(10)
+    ->Arg(1000)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+// The argument is the number of functions in the batch.
+BENCHMARK(BM_BatchThroughput)->ArgName("functions")->RangeMultiplier(16)->Range(16, 4096);
+
+} // namespace pljit
@@ -0,0 +1,63 @@
+#include "pljit/common/SourceCodeManager.h"
+#include "pljit/lexer/Lexer.h"
+#include "pljit/parse_tree/ParseTree.h"
+#include "pljit/parser/Parser.h"
+#include <benchmark/benchmark.h>
+
+namespace pljit {
+
+namespace {
+
+/// Generates a function whose source code has roughly the given size in bytes.
+std::string generateFunction(size_t size)
+{
+    std::string code{"PARAM a, b;\nVAR c;\nBEGIN\n"};
+    for (size_t i = 0; code.size() < size; ++i) {
+        code.append("c := (a + " + std::to_string(i) + ") * -b / (c - 7);\n");
+    }
+    code.append("RETURN c\nEND.");
+    return code;
+}
+
+void lex(benchmark::State& state, bool pipelined)
+{
+    common::SourceCodeManager sourceCodeManager(generateFunction(state.range(0) << 20));
+    for (auto _ : state) {
+        lexer::Lexer lexer(sourceCodeManager, pipelined);
+        while (lexer.hasNext()) {
+            benchmark::DoNotOptimize(lexer.next());
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0) << 20);
+}
+
+void parse(benchmark::State& state, bool pipelined)
+{
+    common::SourceCodeManager sourceCodeManager(generateFunction(state.range(0) << 20));
+    // Parallel parsing is disabled to compare only the lexer modes.
+    parser::ParserOptions options{.parallelParsingThreshold = 0, .pipelinedLexing = pipelined};
+    for (auto _ : state) {
+        parser::Parser parser(sourceCodeManager, options);
+        auto parseTree = parser.parseFunctionDefinition();
+        if (parseTree == nullptr) {
+            state.SkipWithError("parse error");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0) << 20);
+}
+
+void BM_LexSynchronous(benchmark::State& state) { lex(state, false); }
+void BM_LexPipelined(benchmark::State& state) { lex(state, true); }
+void BM_ParseSynchronous(benchmark::State& state) { parse(state, false); }
+void BM_ParsePipelined(benchmark::State& state) { parse(state, true); }
+
+} // namespace
+
+// The argument is the size of the source code in MiB.
+BENCHMARK(BM_LexSynchronous)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LexPipelined)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseSynchronous)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParsePipelined)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+
+} // namespace pljit
@@ -0,0 +1,38 @@
+#include "pljit/Pljit.h"
+#include <benchmark/benchmark.h>
+
+namespace pljit {
+
+namespace {
+
+/// Generates a module with the given number of functions.
+std::string generateModule(size_t numberOfFunctions)
+{
+    std::string module;
+    for (size_t i = 0; i < numberOfFunctions; ++i) {
+        module.append("PARAM a, b;\nVAR c;\nCONST k = " + std::to_string(i) + ";\nBEGIN\n");
+        for (size_t j = 0; j < 16; ++j) {
+            module.append("c := (a + k) * -b / (c - " + std::to_string(j + 1) + ");\n");
+        }
+        module.append("RETURN c\nEND.\n");
+    }
+    return module;
+}
+
+void BM_RegisterModule(benchmark::State& state)
+{
+    auto module = generateModule(4096);
+    for (auto _ : state) {
+        Pljit pljit(PljitOptions{.numberOfCompileThreads = static_cast<size_t>(state.range(0))});
+        auto functions = pljit.registerModule(module);
+        benchmark::DoNotOptimize(functions.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 4096);
+}
+
+} // namespace
+
+// The argument is the number of background compile threads.
+BENCHMARK(BM_RegisterModule)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace pljit
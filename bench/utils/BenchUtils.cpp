@@ -0,0 +1,88 @@
+#include "BenchUtils.h"
+#include "pljit/analysis/SemanticAnalysis.h"
+#include "pljit/analysis/SymbolTable.h"
+#include "pljit/common/SourceCodeManager.h"
+#include "pljit/parse_tree/ParseTree.h"
+#include "pljit/parser/Parser.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace pljit::bench_utils {
+
+const std::vector<Example>& getExamples()
+// Returns the programs of the examples directory ordered by their name.
+{
+    static const std::vector<Example> examples = [] {
+        std::vector<Example> examples;
+        std::error_code errorCode;
+        for (const auto& entry : std::filesystem::directory_iterator(PLJIT_EXAMPLES_DIRECTORY, errorCode)) {
+            if (entry.path().extension() != ".pl") {
+                continue;
+            }
+            std::ifstream file(entry.path());
+            std::ostringstream code;
+            code << file.rdbuf();
+            examples.push_back({entry.path().filename().string(), code.str()});
+        }
+        std::sort(examples.begin(), examples.end(), [](const Example& lhs, const Example& rhs) {
+            return lhs.name < rhs.name;
+        });
+        return examples;
+    }();
+    return examples;
+}
+
+std::string generateFunction(size_t numberOfStatements)
+// Generates a valid function with the given number of statements.
+{
+    std::string code{"PARAM a, b;\nVAR c;\nCONST k = 3;\nBEGIN\nc := a;\n"};
+    for (size_t i = 2; i < numberOfStatements; ++i) {
+        code.append("c := (c + a * " + std::to_string(i % 100) + ") / (k * 2 - 5) - b;\n");
+    }
+    code.append("RETURN c\nEND.");
+    return code;
+}
+
+std::optional<size_t> getNumberOfParameters(std::string_view code)
+// Returns the number of parameters of a function.
+{
+    common::SourceCodeManager sourceCodeManager(std::string{code});
+    parser::Parser parser(sourceCodeManager);
+    auto parseTree = parser.parseFunctionDefinition();
+    if (parseTree == nullptr) {
+        return std::nullopt;
+    }
+    analysis::SymbolTable symbolTable;
+    analysis::SemanticAnalysis semanticAnalysis(sourceCodeManager, symbolTable);
+    if (semanticAnalysis.analyzeFunction(*parseTree) == nullptr) {
+        return std::nullopt;
+    }
+    return symbolTable.getNumberOfParameters();
+}
+
+Result call(const FunctionHandle& function, size_t numberOfParameters)
+// Calls a function with the given number of parameters.
+{
+    switch (numberOfParameters) {
+        case 0:
+            return function();
+        case 1:
+            return function(3);
+        case 2:
+            return function(3, 2);
+        case 3:
+            return function(3, 2, 1);
+        default:
+            return function(3, 2, 1, 4);
+    }
+}
+
+void applySyntheticSizes(benchmark::internal::Benchmark* benchmark)
+// Applies the synthetic sizes to a benchmark.
+{
+    benchmark->ArgName("statements")->RangeMultiplier(10)->Range(10, 1000000);
+}
+
+} // namespace pljit::bench_utils
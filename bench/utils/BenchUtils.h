@@ -0,0 +1,42 @@
+#ifndef H_bench_BenchUtils
+#define H_bench_BenchUtils
+
+#include "pljit/Pljit.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pljit::bench_utils {
+
+/// A PL/0 program from the examples directory.
+struct Example {
+    /// File name of the program
+    std::string name;
+    /// Source code of the program
+    std::string code;
+};
+
+/// Returns the programs of the examples directory ordered by their name.
+const std::vector<Example>& getExamples();
+
+/// Generates a valid function with the given number of statements. The
+/// function takes the parameters a and b, and its values stay small enough
+/// such that it can be executed without overflows. Constant propagation folds
+/// a part of every statement.
+std::string generateFunction(size_t numberOfStatements);
+
+/// Returns the number of parameters of a function. Returns an empty optional
+/// if the function does not compile.
+std::optional<size_t> getNumberOfParameters(std::string_view code);
+
+/// Calls a function with the given number of parameters (up to four).
+Result call(const FunctionHandle& function, size_t numberOfParameters);
+
+/// Applies the synthetic sizes (10 to 1M statements) to a benchmark.
+void applySyntheticSizes(benchmark::internal::Benchmark* benchmark);
+
+} // namespace pljit::bench_utils
+
+#endif
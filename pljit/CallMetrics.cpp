@@ -0,0 +1,133 @@
+#include "CallMetrics.h"
+#include <bit>
+
+namespace pljit {
+
+namespace {
+
+/// Index of the shard of the current thread. The threads are assigned to the
+/// shards in a round-robin fashion.
+size_t getThreadShardIndex()
+{
+    static std::atomic<size_t> nextShardIndex{0};
+    thread_local size_t shardIndex = nextShardIndex.fetch_add(1, std::memory_order_relaxed);
+    return shardIndex;
+}
+
+} // namespace
+
+double CallMetrics::getMeanLatency() const
+// Returns the mean latency of the sampled calls.
+{
+    if (numberOfSampledCalls == 0) {
+        return 0;
+    }
+    return static_cast<double>(sampledTicks) / static_cast<double>(numberOfSampledCalls);
+}
+
+uint64_t CallMetrics::getLatencyPercentile(double percentile) const
+// Returns an upper bound of the latency percentile.
+{
+    if (numberOfSampledCalls == 0) {
+        return 0;
+    }
+    auto rank = static_cast<uint64_t>(percentile * static_cast<double>(numberOfSampledCalls));
+    uint64_t numberOfCallsBelow = 0;
+    for (size_t bucket = 0; bucket < numberOfLatencyBuckets; ++bucket) {
+        numberOfCallsBelow += latencyHistogram[bucket];
+        if (numberOfCallsBelow > rank || numberOfCallsBelow == numberOfSampledCalls) {
+            return (uint64_t{2} << bucket) - 1;
+        }
+    }
+    return UINT64_MAX;
+}
+
+double CallMetrics::getEstimatedTotalTicks() const
+// Returns the estimated number of ticks spent in all calls.
+{
+    return getMeanLatency() * static_cast<double>(numberOfCalls);
+}
+
+CallMetrics& CallMetrics::operator+=(const CallMetrics& other)
+// Accumulates the metrics of other calls.
+{
+    numberOfCalls += other.numberOfCalls;
+    numberOfRuntimeErrors += other.numberOfRuntimeErrors;
+    numberOfSampledCalls += other.numberOfSampledCalls;
+    sampledTicks += other.sampledTicks;
+    for (size_t bucket = 0; bucket < numberOfLatencyBuckets; ++bucket) {
+        latencyHistogram[bucket] += other.latencyHistogram[bucket];
+    }
+    return *this;
+}
+
+size_t CallMetrics::getLatencyBucket(uint64_t ticks)
+// Returns the histogram bucket of a latency.
+{
+    if (ticks == 0) {
+        return 0;
+    }
+    auto bucket = static_cast<size_t>(std::bit_width(ticks) - 1);
+    return bucket < numberOfLatencyBuckets ? bucket : numberOfLatencyBuckets - 1;
+}
+
+void CallCounters::recordCall(bool runtimeError)
+// Records an executed call.
+{
+    auto& shard = getShard();
+    shard.numberOfCalls.fetch_add(1, std::memory_order_relaxed);
+    if (runtimeError) {
+        shard.numberOfRuntimeErrors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CallCounters::recordSampledCall(bool runtimeError, uint64_t ticks)
+// Records an executed call and its latency.
+{
+    recordCall(runtimeError);
+    auto& shard = getShard();
+    shard.numberOfSampledCalls.fetch_add(1, std::memory_order_relaxed);
+    shard.sampledTicks.fetch_add(ticks, std::memory_order_relaxed);
+    shard.latencyHistogram[CallMetrics::getLatencyBucket(ticks)].fetch_add(1, std::memory_order_relaxed);
+}
+
+CallMetrics CallCounters::getMetrics() const
+// Returns the sum of the counters of all shards.
+{
+    CallMetrics metrics;
+    for (const auto& shard : shards) {
+        metrics.numberOfCalls += shard.numberOfCalls.load(std::memory_order_relaxed);
+        metrics.numberOfRuntimeErrors += shard.numberOfRuntimeErrors.load(std::memory_order_relaxed);
+        metrics.numberOfSampledCalls += shard.numberOfSampledCalls.load(std::memory_order_relaxed);
+        metrics.sampledTicks += shard.sampledTicks.load(std::memory_order_relaxed);
+        for (size_t bucket = 0; bucket < CallMetrics::numberOfLatencyBuckets; ++bucket) {
+            metrics.latencyHistogram[bucket] += shard.latencyHistogram[bucket].load(std::memory_order_relaxed);
+        }
+    }
+    return metrics;
+}
+
+CallCounters::Shard& CallCounters::getShard()
+// Returns the shard of the current thread.
+{
+    return shards[getThreadShardIndex() % numberOfShards];
+}
+
+bool CallSampler::sampleCall()
+// Counts a call and returns whether it is sampled.
+{
+    auto& shard = shards[getThreadShardIndex() % numberOfShards];
+    return (shard.numberOfCalls.fetch_add(1, std::memory_order_relaxed) + 1) % sampleInterval == 0;
+}
+
+uint64_t CallSampler::getNumberOfCalls() const
+// Returns the number of counted calls.
+{
+    uint64_t numberOfCalls = 0;
+    for (const auto& shard : shards) {
+        numberOfCalls += shard.numberOfCalls.load(std::memory_order_relaxed);
+    }
+    return numberOfCalls;
+}
+
+} // namespace pljit
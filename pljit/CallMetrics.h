@@ -0,0 +1,125 @@
+#ifndef H_jit_CallMetrics
+#define H_jit_CallMetrics
+
+#include "pljit/common/Timestamp.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pljit {
+
+/// Metrics of the calls of a function.
+struct CallMetrics {
+    /// Bucket i of the latency histogram counts the latencies in [2^i, 2^(i+1))
+    /// ticks, bucket 0 also counts zero ticks.
+    static constexpr size_t numberOfLatencyBuckets = 40;
+
+    /// Number of executed calls, i.e. without calls which failed to compile or
+    /// which provided an invalid number of parameters
+    uint64_t numberOfCalls{0};
+    /// Number of calls which failed with a runtime error
+    uint64_t numberOfRuntimeErrors{0};
+    /// Number of calls whose latency was measured
+    uint64_t numberOfSampledCalls{0};
+    /// Sum of the latencies of the sampled calls in ticks of the time stamp
+    /// counter (see readTimestampCounter())
+    uint64_t sampledTicks{0};
+    /// Latency histogram of the sampled calls
+    std::array<uint64_t, numberOfLatencyBuckets> latencyHistogram{};
+
+    /// Returns the mean latency of the sampled calls in ticks.
+    double getMeanLatency() const;
+
+    /// Returns an upper bound of the latency percentile (between 0 and 1) in
+    /// ticks, i.e. the upper end of the histogram bucket which contains it.
+    uint64_t getLatencyPercentile(double percentile) const;
+
+    /// Returns the estimated number of ticks spent in all calls, which is
+    /// extrapolated from the sampled calls.
+    double getEstimatedTotalTicks() const;
+
+    /// Accumulates the metrics of other calls.
+    CallMetrics& operator+=(const CallMetrics& other);
+
+    /// Returns the current value of the time stamp counter (see
+    /// common::readTimestampCounter()).
+    static uint64_t readTimestampCounter() { return common::readTimestampCounter(); }
+
+    /// Returns the histogram bucket of a latency.
+    static size_t getLatencyBucket(uint64_t ticks);
+};
+
+/// Counters for the calls of a function. The counters are sharded by thread
+/// and every shard occupies its own cache lines. Hence, concurrent calls of a
+/// function do not contend on the counters, unless there are more threads
+/// than shards.
+class CallCounters {
+    public:
+    /// Records an executed call.
+    /// Note: This function is thread-safe and lock-free.
+    void recordCall(bool runtimeError);
+
+    /// Records an executed call and its latency in ticks.
+    /// Note: This function is thread-safe and lock-free.
+    void recordSampledCall(bool runtimeError, uint64_t ticks);
+
+    /// Returns the sum of the counters of all shards. Calls which are recorded
+    /// concurrently might be missing.
+    /// Note: This function is thread-safe.
+    CallMetrics getMetrics() const;
+
+    private:
+    /// Avoids false sharing between the shards.
+    static constexpr size_t cacheLineSize = 64;
+    /// Number of shards of the counters.
+    static constexpr size_t numberOfShards = 8;
+
+    struct alignas(cacheLineSize) Shard {
+        std::atomic<uint64_t> numberOfCalls{0};
+        std::atomic<uint64_t> numberOfRuntimeErrors{0};
+        std::atomic<uint64_t> numberOfSampledCalls{0};
+        std::atomic<uint64_t> sampledTicks{0};
+        std::array<std::atomic<uint64_t>, CallMetrics::numberOfLatencyBuckets> latencyHistogram{};
+    };
+
+    /// Returns the shard of the current thread.
+    Shard& getShard();
+
+    std::array<Shard, numberOfShards> shards{};
+};
+
+/// Decides which calls of a function are sampled, i.e. every n-th call of the
+/// function. The calls are counted per shard of threads like the
+/// CallCounters, hence, the calls of other functions do not influence which
+/// calls of the function are sampled.
+class CallSampler {
+    public:
+    /// Every n-th call of a shard is sampled.
+    static constexpr uint64_t sampleInterval = 64;
+
+    /// Counts a call and returns whether it is sampled.
+    /// Note: This function is thread-safe and lock-free.
+    bool sampleCall();
+
+    /// Returns the number of counted calls. Calls which are counted
+    /// concurrently might be missing.
+    /// Note: This function is thread-safe.
+    uint64_t getNumberOfCalls() const;
+
+    private:
+    /// Avoids false sharing between the shards.
+    static constexpr size_t cacheLineSize = 64;
+    /// Number of shards of the counters.
+    static constexpr size_t numberOfShards = 8;
+
+    struct alignas(cacheLineSize) Shard {
+        std::atomic<uint64_t> numberOfCalls{0};
+    };
+
+    std::array<Shard, numberOfShards> shards{};
+};
+
+} // namespace pljit
+
+#endif
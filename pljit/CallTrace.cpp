@@ -0,0 +1,296 @@
+#include "CallTrace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+namespace pljit {
+
+namespace {
+
+/// "PLJITCT" followed by a zero byte.
+constexpr uint64_t magic = 0x00544354494a4c50;
+
+/// The types of the records.
+enum class RecordType : uint8_t {
+    Function = 1,
+    Call = 2
+};
+
+/// The buffer of the recorder which was used last by the current thread (see
+/// Tracer).
+struct CachedThreadBuffer {
+    uint64_t recorderId{0};
+    void* buffer{nullptr};
+};
+thread_local CachedThreadBuffer cachedThreadBuffer;
+
+/// Returns a unique id for a recorder (ids are never reused).
+uint64_t getNextRecorderId()
+{
+    static std::atomic<uint64_t> nextRecorderId{1};
+    return nextRecorderId.fetch_add(1, std::memory_order_relaxed);
+}
+
+void appendWord(std::string& bytes, uint64_t word)
+{
+    char buffer[sizeof(word)];
+    std::memcpy(buffer, &word, sizeof(word));
+    bytes.append(buffer, sizeof(word));
+}
+
+/// Appends an unsigned LEB128 varint.
+void appendVarint(std::string& bytes, uint64_t value)
+{
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<char>(value));
+}
+
+/// Appends a zig-zag encoded varint, such that small negative values are small.
+void appendSignedVarint(std::string& bytes, int64_t value)
+{
+    appendVarint(bytes, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+/// Reads the records of a call trace.
+class RecordReader {
+    public:
+    /// Constructor
+    explicit RecordReader(std::string_view bytes) : bytes(bytes) {}
+
+    bool atEnd() const { return pos == bytes.size(); }
+
+    std::optional<uint8_t> readByte()
+    {
+        if (pos == bytes.size()) {
+            return std::nullopt;
+        }
+        return static_cast<uint8_t>(bytes[pos++]);
+    }
+
+    std::optional<uint64_t> readWord()
+    {
+        if (bytes.size() - pos < sizeof(uint64_t)) {
+            return std::nullopt;
+        }
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + pos, sizeof(word));
+        pos += sizeof(word);
+        return word;
+    }
+
+    std::optional<uint64_t> readVarint()
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            auto byte = readByte();
+            if (!byte) {
+                return std::nullopt;
+            }
+            value |= static_cast<uint64_t>(*byte & 0x7f) << shift;
+            if ((*byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<int64_t> readSignedVarint()
+    {
+        auto value = readVarint();
+        if (!value) {
+            return std::nullopt;
+        }
+        return static_cast<int64_t>((*value >> 1) ^ (~(*value & 1) + 1));
+    }
+
+    std::optional<std::string_view> readString(size_t size)
+    {
+        if (bytes.size() - pos < size) {
+            return std::nullopt;
+        }
+        auto string = bytes.substr(pos, size);
+        pos += size;
+        return string;
+    }
+
+    private:
+    std::string_view bytes;
+    size_t pos{0};
+};
+
+} // namespace
+
+std::unique_ptr<CallRecorder> CallRecorder::create(const std::string& path, size_t bufferSizePerThread)
+// Creates a recorder which writes to the file.
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return nullptr;
+    }
+    return std::unique_ptr<CallRecorder>(new CallRecorder(std::move(file), bufferSizePerThread));
+}
+
+CallRecorder::CallRecorder(std::ofstream file, size_t bufferSizePerThread)
+    : id(getNextRecorderId()),
+      bufferSizePerThread(bufferSizePerThread),
+      file(std::move(file))
+// Constructor
+{
+    std::string header;
+    appendWord(header, magic);
+    appendWord(header, formatVersion);
+    write(header);
+}
+
+CallRecorder::~CallRecorder()
+// Destructor
+{
+    flush();
+}
+
+void CallRecorder::recordFunction(uint64_t sourceHash, std::string_view sourceCode)
+// Records a function unless it was already recorded.
+{
+    std::unique_lock lck(fileMutex);
+    if (!recordedFunctions.insert(sourceHash).second) {
+        return;
+    }
+    // The function is written right away, such that it precedes its calls.
+    std::string record;
+    record.push_back(static_cast<char>(RecordType::Function));
+    appendWord(record, sourceHash);
+    appendVarint(record, sourceCode.size());
+    record.append(sourceCode);
+    write(record);
+}
+
+void CallRecorder::recordCall(uint64_t sourceHash, std::span<const int64_t> arguments, Result result)
+// Records a call in the buffer of the current thread.
+{
+    auto& buffer = getThreadBuffer();
+    std::unique_lock lck(buffer.mutex);
+    auto& bytes = buffer.bytes;
+    bytes.push_back(static_cast<char>(RecordType::Call));
+    appendWord(bytes, sourceHash);
+    appendVarint(bytes, arguments.size());
+    for (auto argument : arguments) {
+        appendSignedVarint(bytes, argument);
+    }
+    bytes.push_back(static_cast<char>(result.resultCode));
+    appendSignedVarint(bytes, result.value);
+
+    if (bytes.size() >= bufferSizePerThread) {
+        std::unique_lock fileLck(fileMutex);
+        write(bytes);
+        bytes.clear();
+    }
+}
+
+bool CallRecorder::flush()
+// Writes the buffers of all threads to the file.
+{
+    std::unique_lock lck(buffersMutex);
+    for (auto& [threadId, buffer] : buffers) {
+        std::unique_lock bufferLck(buffer->mutex);
+        std::unique_lock fileLck(fileMutex);
+        write(buffer->bytes);
+        buffer->bytes.clear();
+    }
+    std::unique_lock fileLck(fileMutex);
+    // The error state of the stream is sticky, i.e. it also reflects the
+    // failures of earlier writes.
+    return static_cast<bool>(file.flush());
+}
+
+CallRecorder::ThreadBuffer& CallRecorder::getThreadBuffer()
+// Returns the buffer of the current thread.
+{
+    if (cachedThreadBuffer.recorderId == id) {
+        return *static_cast<ThreadBuffer*>(cachedThreadBuffer.buffer);
+    }
+
+    std::unique_lock lck(buffersMutex);
+    auto threadId = std::this_thread::get_id();
+    auto it = std::find_if(buffers.begin(), buffers.end(), [&](const auto& entry) { return entry.first == threadId; });
+    if (it == buffers.end()) {
+        buffers.emplace_back(threadId, std::make_unique<ThreadBuffer>());
+        it = std::prev(buffers.end());
+    }
+    cachedThreadBuffer = {id, it->second.get()};
+    return *it->second;
+}
+
+void CallRecorder::write(std::string_view bytes)
+// Appends bytes to the file.
+{
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::optional<CallTrace> CallTrace::read(const std::string& path)
+// Reads a call trace.
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    auto bytes = buffer.str();
+
+    RecordReader reader(bytes);
+    if (reader.readWord() != magic || reader.readWord() != CallRecorder::formatVersion) {
+        return std::nullopt;
+    }
+
+    // Every record is only added once it was read completely.
+    CallTrace trace;
+    while (!reader.atEnd()) {
+        auto recordType = static_cast<RecordType>(*reader.readByte());
+        if (recordType != RecordType::Function && recordType != RecordType::Call) {
+            return std::nullopt;
+        }
+        auto sourceHash = reader.readWord();
+        if (!sourceHash) {
+            break;
+        }
+        if (recordType == RecordType::Function) {
+            auto size = reader.readVarint();
+            auto sourceCode = size ? reader.readString(*size) : std::nullopt;
+            if (!sourceCode) {
+                break;
+            }
+            trace.functions.push_back({*sourceHash, std::string(*sourceCode)});
+        } else {
+            RecordedCall call{*sourceHash, {}, {}};
+            auto numberOfArguments = reader.readVarint();
+            if (!numberOfArguments) {
+                break;
+            }
+            for (uint64_t i = 0; i < *numberOfArguments; ++i) {
+                auto argument = reader.readSignedVarint();
+                if (!argument) {
+                    break;
+                }
+                call.arguments.push_back(*argument);
+            }
+            auto resultCode = reader.readByte();
+            auto value = reader.readSignedVarint();
+            if (call.arguments.size() != *numberOfArguments || !resultCode || !value) {
+                break;
+            }
+            if (*resultCode > static_cast<uint8_t>(ResultCode::InvalidFunctionCall)) {
+                return std::nullopt;
+            }
+            call.result = {*value, static_cast<ResultCode>(*resultCode)};
+            trace.calls.push_back(std::move(call));
+        }
+    }
+    return trace;
+}
+
+} // namespace pljit
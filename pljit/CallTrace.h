@@ -0,0 +1,140 @@
+#ifndef H_jit_CallTrace
+#define H_jit_CallTrace
+
+#include "pljit/CallTraceFwd.h"
+#include "pljit/Pljit.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace pljit {
+
+/// A function of a call trace.
+struct RecordedFunction {
+    /// Hash of the source code
+    uint64_t sourceHash;
+    std::string sourceCode;
+};
+
+/// A call of a call trace.
+struct RecordedCall {
+    /// Hash of the source code of the called function
+    uint64_t sourceHash;
+    std::vector<int64_t> arguments;
+    Result result;
+};
+
+/// Records the calls of a Pljit into a compact binary log (see
+/// PljitOptions::callRecorder), which can be replayed offline with
+/// pljitReplay. The log starts with a magic number and the version of the
+/// format, followed by records which start with their type:
+///
+///     function: type | source hash | source size | source code
+///     call:     type | source hash | number of arguments | arguments | result code | value
+///
+/// The source hashes are stored as 64-bit words, the sizes as LEB128 varints
+/// and the signed values as zig-zag encoded varints. Every function is
+/// recorded once before its first call. The calls of a thread are collected
+/// in a buffer of the thread, which is appended to the file when it is full.
+/// Hence, the calls of a thread are in order, but the calls of different
+/// threads are only ordered by their buffers.
+class CallRecorder {
+    public:
+    /// Version of the file format
+    static constexpr uint64_t formatVersion = 1;
+
+    /// Creates a recorder which writes to the file. Returns nullptr if the
+    /// file cannot be written.
+    static std::unique_ptr<CallRecorder> create(const std::string& path, size_t bufferSizePerThread = 65536);
+
+    /// Destructor
+    /// Note: The buffers are written to the file. Call flush() before to check
+    ///       whether the trace was written completely.
+    ~CallRecorder();
+
+    /// Copy constructor/assignment
+    CallRecorder(const CallRecorder& other) = delete;
+    CallRecorder& operator=(const CallRecorder& other) = delete;
+
+    /// Records a function unless a function with the same source hash was
+    /// already recorded.
+    /// Note: This function is thread-safe.
+    void recordFunction(uint64_t sourceHash, std::string_view sourceCode);
+
+    /// Records a call in the buffer of the current thread.
+    /// Note: This function is thread-safe. It only contends with other threads
+    ///       when the buffer is full.
+    void recordCall(uint64_t sourceHash, std::span<const int64_t> arguments, Result result);
+
+    /// Writes the buffers of all threads to the file. Calls which are recorded
+    /// concurrently might be missing. Returns false if a write to the file
+    /// failed since the recorder was created, e.g. because the disk is full.
+    /// The records after a failed write are lost.
+    /// Note: This function is thread-safe.
+    bool flush();
+
+    private:
+    /// The calls of one thread, which were not yet written.
+    struct ThreadBuffer {
+        /// Only contended while the buffers are flushed.
+        std::mutex mutex;
+        std::string bytes;
+    };
+
+    /// Constructor
+    CallRecorder(std::ofstream file, size_t bufferSizePerThread);
+
+    /// Returns the buffer of the current thread and creates it if necessary.
+    ThreadBuffer& getThreadBuffer();
+
+    /// Appends bytes to the file. A failed write sets the error state of the
+    /// file, which is reported by flush().
+    /// Note: This function is not thread-safe and should only
+    ///       be called after acquiring a unique lock on fileMutex.
+    void write(std::string_view bytes);
+
+    /// Distinguishes the recorders in the thread-local buffer cache.
+    const uint64_t id;
+    const size_t bufferSizePerThread;
+
+    std::mutex fileMutex;
+    std::ofstream file;
+    /// Source hashes of the recorded functions
+    std::unordered_set<uint64_t> recordedFunctions;
+
+    std::mutex buffersMutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<ThreadBuffer>>> buffers;
+};
+
+/// A call trace which was recorded by a CallRecorder.
+class CallTrace {
+    public:
+    /// Reads a call trace. Returns an empty optional if the file cannot be
+    /// read or is invalid. A truncated last record, e.g. of a process which
+    /// crashed while writing, is ignored.
+    static std::optional<CallTrace> read(const std::string& path);
+
+    /// Returns the recorded functions in the order of their registration.
+    const std::vector<RecordedFunction>& getFunctions() const { return functions; }
+
+    /// Returns the recorded calls.
+    const std::vector<RecordedCall>& getCalls() const { return calls; }
+
+    private:
+    std::vector<RecordedFunction> functions;
+    std::vector<RecordedCall> calls;
+};
+
+} // namespace pljit
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef H_jit_CallTraceFwd
+#define H_jit_CallTraceFwd
+
+namespace pljit {
+
+struct RecordedFunction;
+struct RecordedCall;
+class CallRecorder;
+class CallTrace;
+
+} // namespace pljit
+
+#endif
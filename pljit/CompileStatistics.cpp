@@ -0,0 +1,114 @@
+#include "CompileStatistics.h"
+#include "pljit/common/MemoryResource.h"
+#include "pljit/common/Probes.h"
+#include "pljit/common/Tracer.h"
+#include <mutex>
+
+namespace pljit {
+
+namespace {
+
+/// The statistics of all compilations in the process
+std::mutex processStatisticsMutex;
+CompileStatistics processStatistics;
+
+} // namespace
+
+std::chrono::nanoseconds CompileStatistics::getTotalTime() const
+// Returns the total time of all phases.
+{
+    std::chrono::nanoseconds totalTime{0};
+    for (const auto& phase : phases) {
+        totalTime += phase.time;
+    }
+    return totalTime;
+}
+
+CompileStatistics& CompileStatistics::operator+=(const CompileStatistics& other)
+// Accumulates the statistics of other compilations.
+{
+    for (size_t i = 0; i < numberOfPhases; ++i) {
+        phases[i].time += other.phases[i].time;
+        phases[i].allocatedBytes += other.phases[i].allocatedBytes;
+    }
+    numberOfTokens += other.numberOfTokens;
+    numberOfParseTreeNodes += other.numberOfParseTreeNodes;
+    numberOfASTNodes += other.numberOfASTNodes;
+    numberOfCompilations += other.numberOfCompilations;
+    numberOfCacheHits += other.numberOfCacheHits;
+    numberOfDeduplications += other.numberOfDeduplications;
+    return *this;
+}
+
+std::string_view CompileStatistics::getPhaseName(CompilePhase phase)
+// Returns the name of a phase.
+{
+    switch (phase) {
+        case CompilePhase::Lexing:
+            return "lexing";
+        case CompilePhase::Parsing:
+            return "parsing";
+        case CompilePhase::SemanticAnalysis:
+            return "semantic analysis";
+        case CompilePhase::DeadCodeElimination:
+            return "dead code elimination";
+        case CompilePhase::ConstantPropagation:
+            return "constant propagation";
+        case CompilePhase::CodeGeneration:
+            return "code generation";
+    }
+    __builtin_unreachable();
+}
+
+CompileStatistics CompileStatistics::getProcessSnapshot()
+// Returns the accumulated statistics of all compilations in the process.
+{
+    std::unique_lock lck(processStatisticsMutex);
+    return processStatistics;
+}
+
+void CompileStatistics::addToProcessSnapshot(const CompileStatistics& statistics)
+// Adds the statistics of a compilation to the process-wide statistics.
+{
+    std::unique_lock lck(processStatisticsMutex);
+    processStatistics += statistics;
+}
+
+CompilePhaseScope::CompilePhaseScope(const CompileInstrumentation& instrumentation, CompilePhase phase)
+    : instrumentation(instrumentation),
+      phase(phase)
+// Constructor
+{
+    PLJIT_PROBE3(compile__phase__start, instrumentation.functionId, instrumentation.functionHash, phase);
+    if (instrumentation.statistics != nullptr) {
+        startNodes = common::getNumberOfAllocatedNodes();
+        startBytes = common::getNumberOfAllocatedNodeBytes();
+        start = std::chrono::steady_clock::now();
+    }
+    if (instrumentation.tracer != nullptr) {
+        startTime = common::Tracer::now();
+    }
+}
+
+CompilePhaseScope::~CompilePhaseScope()
+// Destructor
+{
+    if (instrumentation.statistics != nullptr) {
+        auto& phaseStatistics = (*instrumentation.statistics)[phase];
+        phaseStatistics.time += std::chrono::steady_clock::now() - start;
+        phaseStatistics.allocatedBytes += common::getNumberOfAllocatedNodeBytes() - startBytes;
+    }
+    if (instrumentation.tracer != nullptr) {
+        instrumentation.tracer->recordComplete(CompileStatistics::getPhaseName(phase), "compile", startTime,
+                                               common::Tracer::now(), instrumentation.functionHash);
+    }
+    PLJIT_PROBE3(compile__phase__end, instrumentation.functionId, instrumentation.functionHash, phase);
+}
+
+size_t CompilePhaseScope::getNumberOfAllocatedNodes() const
+// Returns the number of nodes which were allocated since the start of the scope.
+{
+    return common::getNumberOfAllocatedNodes() - startNodes;
+}
+
+} // namespace pljit
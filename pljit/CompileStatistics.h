@@ -0,0 +1,117 @@
+#ifndef H_jit_CompileStatistics
+#define H_jit_CompileStatistics
+
+#include "pljit/common/TracerFwd.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace pljit {
+
+/// The phases of a compilation.
+enum class CompilePhase {
+    /// Tokenizing on the compiling thread, which is interleaved with parsing
+    /// but not part of the parsing time
+    Lexing,
+    Parsing,
+    SemanticAnalysis,
+    DeadCodeElimination,
+    ConstantPropagation,
+    /// Building the execution image, including the lookup of equal functions
+    /// and loading from or storing to the compile cache
+    CodeGeneration
+};
+
+/// Statistics of one or more compilations.
+struct CompileStatistics {
+    static constexpr size_t numberOfPhases = static_cast<size_t>(CompilePhase::CodeGeneration) + 1;
+
+    struct PhaseStatistics {
+        /// Wall-clock time spent in the phase
+        std::chrono::nanoseconds time{0};
+        /// Bytes allocated for parse tree and AST nodes by the compiling thread,
+        /// including the nodes which the compile threads parsed in parallel
+        size_t allocatedBytes{0};
+    };
+
+    /// Statistics per phase (the index represents the phase)
+    std::array<PhaseStatistics, numberOfPhases> phases{};
+
+    /// Number of tokens, parse tree nodes and AST nodes (before the
+    /// optimization passes)
+    size_t numberOfTokens{0};
+    size_t numberOfParseTreeNodes{0};
+    size_t numberOfASTNodes{0};
+
+    /// Number of compilations, of functions which were loaded from the compile
+    /// cache and of functions which share the image of an equal function
+    uint64_t numberOfCompilations{0};
+    uint64_t numberOfCacheHits{0};
+    uint64_t numberOfDeduplications{0};
+
+    /// Returns the statistics of a phase.
+    PhaseStatistics& operator[](CompilePhase phase) { return phases[static_cast<size_t>(phase)]; }
+    const PhaseStatistics& operator[](CompilePhase phase) const { return phases[static_cast<size_t>(phase)]; }
+
+    /// Returns the total time of all phases.
+    std::chrono::nanoseconds getTotalTime() const;
+
+    /// Accumulates the statistics of other compilations.
+    CompileStatistics& operator+=(const CompileStatistics& other);
+
+    /// Returns the name of a phase.
+    static std::string_view getPhaseName(CompilePhase phase);
+
+    /// Returns the accumulated statistics of all compilations in the process.
+    /// Note: This function is thread-safe.
+    static CompileStatistics getProcessSnapshot();
+
+    /// Adds the statistics of a compilation to the process-wide statistics.
+    /// Note: This function is thread-safe.
+    static void addToProcessSnapshot(const CompileStatistics& statistics);
+};
+
+/// The instrumentation of the compilation of a function.
+struct CompileInstrumentation {
+    /// Statistics of the compilation (nullptr if they are not collected)
+    CompileStatistics* statistics{nullptr};
+    /// Tracer of the compilation (nullptr if disabled)
+    common::Tracer* tracer{nullptr};
+    /// Id and source hash of the compiled function (see common/Probes.h)
+    uint64_t functionId{0};
+    uint64_t functionHash{0};
+};
+
+/// Instruments a compile phase on the current thread: It measures the time and
+/// the node allocations of the phase and adds them to the statistics at the
+/// end of the scope, records the phase as a trace event, and fires the
+/// compile__phase__start and compile__phase__end probes.
+class CompilePhaseScope {
+    public:
+    /// Constructor
+    CompilePhaseScope(const CompileInstrumentation& instrumentation, CompilePhase phase);
+
+    /// Destructor
+    ~CompilePhaseScope();
+
+    /// Copy constructor/assignment
+    CompilePhaseScope(const CompilePhaseScope& other) = delete;
+    CompilePhaseScope& operator=(const CompilePhaseScope& other) = delete;
+
+    /// Returns the number of nodes which were allocated since the start of the scope.
+    size_t getNumberOfAllocatedNodes() const;
+
+    private:
+    const CompileInstrumentation& instrumentation;
+    CompilePhase phase;
+    uint64_t startTime{0};
+    std::chrono::steady_clock::time_point start{};
+    size_t startNodes{0};
+    size_t startBytes{0};
+};
+
+} // namespace pljit
+
+#endif
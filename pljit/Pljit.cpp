@@ -1,20 +1,85 @@
 #include "Pljit.h"
+#include "pljit/CallTrace.h"
 #include "pljit/analysis/SemanticAnalysis.h"
 #include "pljit/analysis/SymbolTable.h"
 #include "pljit/ast/AST.h"
+#include "pljit/ast/ASTDotVisitor.h"
+#include "pljit/ast/NodeSourceMap.h"
+#include "pljit/common/Diagnostics.h"
+#include "pljit/common/Hash.h"
+#include "pljit/common/MappedFile.h"
+#include "pljit/common/MemoryResource.h"
+#include "pljit/common/Probes.h"
 #include "pljit/common/SourceCodeManager.h"
+#include "pljit/common/ThreadPool.h"
+#include "pljit/common/Tracer.h"
+#include "pljit/exec/CompileCache.h"
 #include "pljit/exec/ExecutionContext.h"
+#include "pljit/exec/ExecutionImage.h"
+#include "pljit/exec/ExecutionProfile.h"
+#include "pljit/exec/FunctionFingerprint.h"
+#include "pljit/lexer/Lexer.h"
 #include "pljit/optim/ConstantPropagation.h"
 #include "pljit/optim/DeadCodeElimination.h"
 #include "pljit/parse_tree/ParseTree.h"
 #include "pljit/parser/Parser.h"
+#include <algorithm>
 #include <cassert>
-#include <iostream>
+#include <cctype>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+#include <utility>
 
 namespace pljit {
 
 namespace {
 
+bool isIdentifierCharacter(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) != 0;
+}
+
+std::string_view trimLeadingWhitespace(std::string_view code)
+{
+    size_t start = 0;
+    while (start < code.size() && std::isspace(static_cast<unsigned char>(code[start])) != 0) {
+        ++start;
+    }
+    return code.substr(start);
+}
+
+/// Splits a module into its function definitions, i.e. after each "END.".
+std::vector<std::string_view> splitModule(std::string_view module)
+{
+    std::vector<std::string_view> definitions;
+    size_t definitionStart = 0;
+    for (size_t pos = module.find("END"); pos != std::string_view::npos; pos = module.find("END", pos + 1)) {
+        // END must be a keyword and not part of an identifier.
+        size_t end = pos + 3;
+        if ((pos > 0 && isIdentifierCharacter(module[pos - 1])) ||
+            (end < module.size() && isIdentifierCharacter(module[end]))) {
+            continue;
+        }
+        while (end < module.size() && std::isspace(static_cast<unsigned char>(module[end])) != 0) {
+            ++end;
+        }
+        if (end == module.size() || module[end] != '.') {
+            continue;
+        }
+        definitions.push_back(trimLeadingWhitespace(module.substr(definitionStart, end + 1 - definitionStart)));
+        definitionStart = end + 1;
+    }
+
+    // Trailing code without a terminator is reported as an erroneous function.
+    auto rest = trimLeadingWhitespace(module.substr(definitionStart));
+    if (!rest.empty()) {
+        definitions.push_back(rest);
+    }
+    return definitions;
+}
+
 bool isSourceCodeEmpty(const common::SourceCodeManager& sourceCodeManager)
 {
     return sourceCodeManager.getCodeBegin() == sourceCodeManager.getCodeEnd();
@@ -50,107 +115,885 @@ Result success(int64_t result)
     return Result{result, ResultCode::Success};
 }
 
-void optimize(ast::Function& ast, const analysis::SymbolTable& symbolTable)
+void optimize(ast::Function& ast, const analysis::SymbolTable& symbolTable,
+              std::pmr::memory_resource* memoryResource, const CompileInstrumentation& instrumentation)
 {
-    optim::DeadCodeElimination deadCodeElimination;
-    ast.accept(deadCodeElimination);
-
-    optim::ConstantPropagation constantPropagation(symbolTable);
-    ast.accept(constantPropagation);
+    {
+        CompilePhaseScope scope(instrumentation, CompilePhase::DeadCodeElimination);
+        optim::DeadCodeElimination deadCodeElimination;
+        ast.accept(deadCodeElimination);
+    }
+    {
+        CompilePhaseScope scope(instrumentation, CompilePhase::ConstantPropagation);
+        optim::ConstantPropagation constantPropagation(symbolTable, memoryResource);
+        ast.accept(constantPropagation);
+    }
 }
 
 } // namespace
 
+Pljit::Pljit(PljitOptions options)
+    : options(std::move(options))
+// Constructor
+{
+    if (!this->options.compileCacheDirectory.empty()) {
+        compileCache = std::make_unique<exec::CompileCache>(this->options.compileCacheDirectory);
+    }
+    if (!this->options.profilePath.empty()) {
+        previousProfile = exec::WarmUpProfile::read(this->options.profilePath);
+    }
+}
+
+Pljit::~Pljit()
+// Destructor
+{
+    if (!options.profilePath.empty()) {
+        writeProfile(options.profilePath);
+    }
+}
+
 FunctionHandle Pljit::registerFunction(const std::string& code)
 // Registers a PL/0 function.
 {
-    functions.emplace_front(code);
-    return FunctionHandle(functions.begin());
+    return registerFunction(code, nullptr);
+}
+
+FunctionHandle Pljit::registerFunction(std::string_view code, std::shared_ptr<const void> owner)
+// Registers a PL/0 function without copying its source code.
+{
+    // Without an owner, the source code is copied.
+    auto sourceCodeManager = owner != nullptr ?
+        std::make_unique<common::SourceCodeManager>(code, std::move(owner)) :
+        std::make_unique<common::SourceCodeManager>(std::string(code));
+    FunctionHandle handle(functions.emplace(*this, std::move(sourceCodeManager)));
+    // Memory which was still in use when functions were unregistered is
+    // reclaimed opportunistically.
+    epochManager.reclaim();
+    if (options.eagerCompilation) {
+        submitCompileTask(handle.functionRef, [functionRef = handle.functionRef]() {
+            functionRef->compileOnce();
+        });
+    }
+    return handle;
+}
+
+std::vector<ModuleFunction> Pljit::registerModule(std::string_view module)
+// Registers all functions of a module.
+{
+    // The module is copied once and shared by its functions.
+    auto ownedModule = std::make_shared<const std::string>(module);
+    return registerModule(*ownedModule, ownedModule);
+}
+
+std::vector<ModuleFunction> Pljit::registerModule(std::string_view module, std::shared_ptr<const void> owner)
+// Registers all functions of a module without copying their source code.
+{
+    std::vector<std::unique_ptr<common::SourceCodeManager>> definitions;
+    for (auto definition : splitModule(module)) {
+        definitions.push_back(std::make_unique<common::SourceCodeManager>(definition, owner));
+    }
+    return registerModule(std::move(definitions));
 }
 
-void Pljit::FunctionFrame::compile()
+std::vector<ModuleFunction> Pljit::registerModule(std::vector<std::unique_ptr<common::SourceCodeManager>> definitions)
+// Registers and compiles the function definitions of a module.
+{
+    std::vector<FunctionRef> functionRefs;
+    for (auto& definition : definitions) {
+        functionRefs.push_back(functions.emplace(*this, std::move(definition)));
+    }
+
+    // The background tasks might outlive this call, hence, they share the diagnostics.
+    auto diagnostics = std::make_shared<std::vector<std::ostringstream>>(functionRefs.size());
+    auto compileModuleFunction = [diagnostics](FunctionRef functionRef, size_t index) {
+        common::StreamDiagnosticsSink sink((*diagnostics)[index]);
+        common::DiagnosticsSinkScope scope(&sink);
+        return functionRef->compileOnce();
+    };
+
+    for (size_t i = 0; i < functionRefs.size(); ++i) {
+        submitCompileTask(functionRefs[i], [compileModuleFunction, functionRef = functionRefs[i], i]() {
+            compileModuleFunction(functionRef, i);
+        });
+    }
+
+    // The calling thread compiles the functions which were not yet started by
+    // the background threads and waits for the others.
+    std::vector<ModuleFunction> moduleFunctions;
+    moduleFunctions.reserve(functionRefs.size());
+    for (size_t i = 0; i < functionRefs.size(); ++i) {
+        auto state = compileModuleFunction(functionRefs[i], i);
+        moduleFunctions.push_back({FunctionHandle(functionRefs[i]),
+                                   state == FunctionState::Compiled,
+                                   (*diagnostics)[i].str()});
+    }
+    return moduleFunctions;
+}
+
+std::vector<ModuleFunction> Pljit::registerModuleFile(const std::string& path)
+// Maps a module file into memory and registers all of its functions.
+{
+    auto file = common::MappedFile::open(path);
+    if (file == nullptr) {
+        common::DiagnosticsSinkScope scope(options.diagnosticsSink.get());
+        common::getDiagnosticsSink().report({common::Diagnostic::Kind::CompileError,
+                                             "cannot read module file '" + path + "'"});
+        return {};
+    }
+    std::vector<std::unique_ptr<common::SourceCodeManager>> definitions;
+    for (auto definition : splitModule(file->getContents())) {
+        definitions.push_back(std::make_unique<common::SourceCodeManager>(definition, file));
+    }
+    return registerModule(std::move(definitions));
+}
+
+std::future<bool> Pljit::compileAsync(FunctionHandle handle)
+// Enqueues the compilation of a function on the background compile threads.
+{
+    // The thread pool only accepts copyable tasks, hence, the packaged task is shared.
+    auto task = std::make_shared<std::packaged_task<bool()>>([functionRef = handle.functionRef]() {
+        return functionRef->compileOnce() == FunctionState::Compiled;
+    });
+    auto future = task->get_future();
+    submitCompileTask(handle.functionRef, [task = std::move(task)]() { (*task)(); });
+    return future;
+}
+
+size_t Pljit::warmUp()
+// Compiles the functions which were compiled in the previous run.
+{
+    if (!previousProfile) {
+        return 0;
+    }
+
+    std::vector<std::pair<FunctionRef, uint64_t>> hotFunctions;
+    functions.forEach([&](FunctionFrame& function) {
+        if (function.getState() != FunctionState::NotCompiled) {
+            return;
+        }
+        if (auto entry = previousProfile->lookup(function.getSourceHash())) {
+            hotFunctions.emplace_back(&function, entry->numberOfCalls);
+        }
+    });
+    std::stable_sort(hotFunctions.begin(), hotFunctions.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second > rhs.second;
+    });
+
+    for (auto [functionRef, numberOfCalls] : hotFunctions) {
+        submitCompileTask(functionRef, [functionRef = functionRef]() { functionRef->compileOnce(); });
+    }
+
+    // The calling thread helps with the compilation, again the hottest first.
+    size_t numberOfCompiledFunctions = 0;
+    for (auto [functionRef, numberOfCalls] : hotFunctions) {
+        if (functionRef->compileOnce() == FunctionState::Compiled) {
+            ++numberOfCompiledFunctions;
+        }
+    }
+    return numberOfCompiledFunctions;
+}
+
+bool Pljit::writeProfile(const std::string& path)
+// Writes the profile of the compiled functions.
+{
+    // Functions which were evicted since are still hot, i.e. they are written
+    // if they were called.
+    exec::WarmUpProfile profile;
+    functions.forEach([&](FunctionFrame& function) {
+        auto state = function.getState();
+        if (state == FunctionState::Unregistered) {
+            return;
+        }
+        auto numberOfCalls = function.getNumberOfCalls();
+        if (state == FunctionState::Compiled || numberOfCalls > 0) {
+            profile.add(function.getSourceHash(), {numberOfCalls, exec::WarmUpProfile::Tier::Compiled});
+        }
+    });
+    return profile.write(path);
+}
+
+bool Pljit::waitUntilCompiled(FunctionHandle handle)
+// Blocks until the function is compiled.
+{
+    return handle.functionRef->compileOnce() == FunctionState::Compiled;
+}
+
+common::ThreadPool& Pljit::getCompileThreads()
+// Returns the background compile threads.
+{
+    std::call_once(compileThreadsStarted, [this]() {
+        compileThreads = std::make_unique<common::ThreadPool>(options.numberOfCompileThreads);
+    });
+    return *compileThreads;
+}
+
+void Pljit::submitCompileTask(FunctionRef functionRef, std::function<void()> task)
+// Enqueues a task which compiles the function on the background compile threads.
+{
+    auto& compileThreads = getCompileThreads();
+    if (options.tracer == nullptr) {
+        compileThreads.submit(std::move(task));
+        return;
+    }
+    // The time in the queue is recorded by the worker which runs the task.
+    compileThreads.submit([tracer = options.tracer.get(), functionRef, task = std::move(task),
+                           submitTime = common::Tracer::now()]() {
+        tracer->recordComplete("compile queue", "compile", submitTime, common::Tracer::now(),
+                               functionRef->getSourceHash());
+        task();
+    });
+}
+
+void Pljit::unregisterFunction(FunctionHandle handle)
+// Unregisters a PL/0 function.
+{
+    handle.functionRef->unregister();
+    epochManager.reclaim();
+}
+
+std::optional<CompileStatistics> Pljit::getCompileStatistics(FunctionHandle handle)
+// Returns the statistics of the last compilation of a function.
+{
+    return handle.functionRef->getCompileStatistics();
+}
+
+CompileStatistics Pljit::getCompileStatistics() const
+// Returns the accumulated statistics of all compilations of this Pljit.
+{
+    std::unique_lock lck(compileStatisticsMutex);
+    return compileStatistics;
+}
+
+void Pljit::addCompileStatistics(const CompileStatistics& statistics)
+// Adds the statistics of a compilation.
+{
+    {
+        std::unique_lock lck(compileStatisticsMutex);
+        compileStatistics += statistics;
+    }
+    CompileStatistics::addToProcessSnapshot(statistics);
+}
+
+std::optional<CallMetrics> Pljit::getCallMetrics(FunctionHandle handle)
+// Returns the call metrics of a function.
+{
+    return handle.functionRef->getCallMetrics();
+}
+
+std::vector<FunctionMetrics> Pljit::getFunctionMetrics()
+// Returns the call metrics of all registered functions.
+{
+    std::vector<FunctionMetrics> functionMetrics;
+    if (!options.collectCallMetrics) {
+        return functionMetrics;
+    }
+    functions.forEach([&](FunctionFrame& function) {
+        // The function might be unregistered concurrently.
+        auto metrics = function.getCallMetrics();
+        if (function.getState() == FunctionState::Unregistered || !metrics) {
+            return;
+        }
+        functionMetrics.push_back({FunctionHandle(&function), function.getSourceHash(), function.getSourceCode(),
+                                   *metrics});
+    });
+    return functionMetrics;
+}
+
+std::shared_ptr<const exec::ExecutionProfile> Pljit::getExecutionProfile(FunctionHandle handle)
+// Returns the execution profile of a function.
+{
+    return handle.functionRef->getExecutionProfile();
+}
+
+std::string Pljit::getAnnotatedSource(FunctionHandle handle)
+// Returns the source code of a function annotated with its execution profile.
+{
+    return handle.functionRef->getAnnotatedSource();
+}
+
+std::string Pljit::getProfileDotGraph(FunctionHandle handle)
+// Returns the AST of a function in the DOT format annotated with its execution profile.
+{
+    return handle.functionRef->getProfileDotGraph();
+}
+
+bool Pljit::replaceFunction(FunctionHandle handle, const std::string& code)
+// Replaces the source code of a registered function.
+{
+    // The new version is compiled off to the side, such that the old version
+    // can be called in the meantime.
+    FunctionFrame replacement(*this, std::make_unique<common::SourceCodeManager>(code));
+    if (replacement.compileOnce() != FunctionState::Compiled) {
+        return false;
+    }
+    bool replaced = handle.functionRef->replace(replacement);
+    if (!replaced) {
+        replacement.unregister();
+    }
+    epochManager.reclaim();
+    return replaced;
+}
+
+void Pljit::enforceCompiledCodeBudget(FunctionRef compiledFunction)
+// Evicts the least recently executed functions until the compiled code fits below the low-water mark.
+{
+    if (compiledCodeSize.load() <= options.compiledCodeBudget) {
+        return;
+    }
+    std::unique_lock lck(evictionMutex, std::try_to_lock);
+    if (!lck.owns_lock()) {
+        // Another thread is already evicting.
+        return;
+    }
+
+    // Calls after this point are considered more recent than all calls before.
+    evictionTick.fetch_add(1, std::memory_order_relaxed);
+
+    // Evicting some headroom below the budget avoids an eviction on every
+    // further compilation once the budget is reached.
+    auto lowWaterMark = options.compiledCodeBudget - options.compiledCodeBudget / 10;
+
+    // Usually only a few functions are evicted, hence, they are popped from a
+    // heap instead of sorting all functions. Functions which were executed in
+    // the same tick are evicted in the order of their registration.
+    using Candidate = std::tuple<uint64_t, size_t, FunctionRef>;
+    std::vector<Candidate> candidates;
+    functions.forEach([&](FunctionFrame& function) {
+        if (&function != compiledFunction && function.getState() == FunctionState::Compiled) {
+            candidates.emplace_back(function.getLastUsedTick(), candidates.size(), &function);
+        }
+    });
+    std::make_heap(candidates.begin(), candidates.end(), std::greater<>());
+
+    for (auto end = candidates.end(); end != candidates.begin() && compiledCodeSize.load() > lowWaterMark; --end) {
+        std::pop_heap(candidates.begin(), end, std::greater<>());
+        if (std::get<FunctionRef>(*(end - 1))->evict()) {
+            numberOfEvictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    epochManager.reclaim();
+}
+
+void Pljit::FunctionFrame::compile(CompileStatistics* statistics)
 // Compiles the function.
 {
+    CompileInstrumentation instrumentation{statistics, options.tracer.get(), getId(), getSourceHash()};
+    auto* tracer = instrumentation.tracer;
+    auto functionHash = instrumentation.functionHash;
+
     if (isSourceCodeEmpty(*sourceCodeManager)) {
         // The source code is empty!
-        std::cout << "error: received code string of length 0" << std::endl;
+        common::getDiagnosticsSink().report({common::Diagnostic::Kind::CompileError,
+                                             "received code string of length 0"});
         state = FunctionState::CompileError;
         return;
     }
 
+    // A function is recompiled from its mapped file after it was evicted. If
+    // the file was modified in place, the function is not compiled, as its
+    // source code does not match its hash anymore.
+    if (const auto* mappedFile = sourceCodeManager->getMappedFile()) {
+        if (mappedFile->isModified() || common::hashBytes(sourceCodeManager->getSourceCode()) != getSourceHash()) {
+            common::getDiagnosticsSink().report({common::Diagnostic::Kind::CompileError,
+                                                 "source file was modified after the function was registered"});
+            state = FunctionState::CompileError;
+            return;
+        }
+    }
+
+    // Functions which were compiled before are loaded from the persistent cache.
+    if (compileCache != nullptr && !options.profileExecution) {
+        CompilePhaseScope phaseScope(instrumentation, CompilePhase::CodeGeneration);
+        common::MemoryResourceScope scope(options.memoryResource);
+        if (auto image = compileCache->load(sourceCodeManager->getSourceCode())) {
+            if (statistics != nullptr) {
+                statistics->numberOfCacheHits = 1;
+            }
+            if (tracer != nullptr) {
+                tracer->recordInstant("compile cache hit", "compile", functionHash);
+            }
+            publish(std::move(image));
+            return;
+        }
+    }
+
+    // The temporary objects of the compilation (e.g. the parse tree) are allocated
+    // from an arena which is released in one shot at the end of the compilation.
+    std::pmr::monotonic_buffer_resource compileArena(options.memoryResource);
+    common::SynchronizedMemoryResource synchronizedCompileArena(&compileArena);
+
     // Parsing and lexing
-    parser::Parser parser(*sourceCodeManager);
-    auto parseTree = parser.parseFunctionDefinition();
+    std::unique_ptr<parse_tree::FunctionDefinition> parseTree;
+    lexer::Lexer::Statistics lexerStatistics;
+    {
+        CompilePhaseScope phaseScope(instrumentation, CompilePhase::Parsing);
+        // Large functions are parsed in parallel on the compile threads, which
+        // are only started for them and share the arena.
+        auto sourceCode = sourceCodeManager->getSourceCode();
+        bool parseInParallel = options.parallelParsingThreshold > 0 &&
+            static_cast<size_t>(std::count(sourceCode.begin(), sourceCode.end(), ';')) >=
+                options.parallelParsingThreshold;
+        common::MemoryResourceScope scope(parseInParallel ? static_cast<std::pmr::memory_resource*>(&synchronizedCompileArena)
+                                                          : &compileArena);
+        parser::Parser parser(*sourceCodeManager,
+                              parser::ParserOptions{.parallelParsingThreshold = options.parallelParsingThreshold,
+                                                    .threadPool = parseInParallel ? &pljit.getCompileThreads() : nullptr,
+                                                    .pipelinedLexing = options.pipelinedLexing,
+                                                    .lexerStatistics = statistics != nullptr ? &lexerStatistics : nullptr});
+        parseTree = parser.parseFunctionDefinition();
+        if (statistics != nullptr) {
+            statistics->numberOfParseTreeNodes = phaseScope.getNumberOfAllocatedNodes();
+        }
+    }
+    if (statistics != nullptr) {
+        // The parser pulls its tokens lazily, hence, the time of the lexer is
+        // moved from the parsing phase to the lexing phase.
+        statistics->numberOfTokens = lexerStatistics.numberOfTokens;
+        (*statistics)[CompilePhase::Lexing].time += lexerStatistics.time;
+        (*statistics)[CompilePhase::Parsing].time -= lexerStatistics.time;
+    }
     if (parserError(parseTree)) {
         // An error occurred during the compilation!
         state = FunctionState::CompileError;
         return;
     }
 
+    // The symbol table and the AST outlive the compilation.
+    common::MemoryResourceScope scope(options.memoryResource);
+
     // Semantic analysis
-    auto symbolTablePtr = std::make_unique<analysis::SymbolTable>();
-    analysis::SemanticAnalysis semanticAnalysis(*sourceCodeManager,
-                                                *symbolTablePtr);
-    auto ast = semanticAnalysis.analyzeFunction(*parseTree);
+    auto symbolTablePtr = std::make_unique<analysis::SymbolTable>(options.memoryResource);
+    std::optional<ast::NodeSourceMap> nodeSourceMap;
+    if (options.profileExecution) {
+        nodeSourceMap.emplace(sourceCodeManager->getSourceCode());
+    }
+    std::unique_ptr<ast::Function> ast;
+    {
+        CompilePhaseScope phaseScope(instrumentation, CompilePhase::SemanticAnalysis);
+        analysis::SemanticAnalysis semanticAnalysis(*sourceCodeManager,
+                                                    *symbolTablePtr,
+                                                    &compileArena,
+                                                    nodeSourceMap ? &*nodeSourceMap : nullptr);
+        ast = semanticAnalysis.analyzeFunction(*parseTree);
+        if (statistics != nullptr) {
+            statistics->numberOfASTNodes = phaseScope.getNumberOfAllocatedNodes();
+        }
+    }
     if (analysisError(ast)) {
         // An error occurred during the compilation!
         state = FunctionState::CompileError;
         return;
     }
 
-    // Optimization passes
-    optimize(*ast, *symbolTablePtr);
+    std::shared_ptr<const exec::ExecutionImage> image;
+    if (options.deduplicateFunctions && !options.profileExecution) {
+        // Equal functions share the image of the function which was compiled
+        // first. The fingerprint is computed from the optimized function, such
+        // that the cache can compare it with the cached images.
+        optimize(*ast, *symbolTablePtr, &compileArena, instrumentation);
+        CompilePhaseScope phaseScope(instrumentation, CompilePhase::CodeGeneration);
+        exec::FunctionFingerprint fingerprint(*ast, *symbolTablePtr);
+        image = imageCache.lookup(fingerprint);
+        if (image == nullptr) {
+            image = imageCache.insert(fingerprint,
+                                      std::make_shared<exec::ExecutionImage>(std::move(ast), *symbolTablePtr));
+        } else {
+            if (statistics != nullptr) {
+                statistics->numberOfDeduplications = 1;
+            }
+            if (tracer != nullptr) {
+                tracer->recordInstant("deduplication", "compile", functionHash);
+            }
+        }
+    } else {
+        // Optimization passes
+        optimize(*ast, *symbolTablePtr, &compileArena, instrumentation);
+        CompilePhaseScope phaseScope(instrumentation, CompilePhase::CodeGeneration);
+        auto newImage = std::make_shared<exec::ExecutionImage>(std::move(ast), *symbolTablePtr);
+        if (nodeSourceMap) {
+            // A recompiled function continues its profile.
+            if (executionProfile == nullptr || executionProfile->getSourceMap().size() != nodeSourceMap->size()) {
+                executionProfile = std::make_shared<exec::ExecutionProfile>(std::move(*nodeSourceMap));
+            }
+            newImage->setExecutionProfile(executionProfile);
+        }
+        image = std::move(newImage);
+    }
+
+    if (compileCache != nullptr) {
+        CompilePhaseScope phaseScope(instrumentation, CompilePhase::CodeGeneration);
+        compileCache->store(sourceCodeManager->getSourceCode(), *image);
+    }
 
-    // We successfully compiled the function! Update the function frame!
-    assert(function == nullptr);
-    function = std::move(ast);
+    // We successfully compiled the function! Publish the execution image!
     symbolTable = std::move(symbolTablePtr);
+    publish(std::move(image));
+}
+
+void Pljit::FunctionFrame::publish(std::shared_ptr<const exec::ExecutionImage> image)
+// Publishes the image of the compiled function.
+{
+    assert(executionImage.load(std::memory_order_relaxed) == nullptr);
     state = FunctionState::Compiled;
+    executionImage.store(image.get(), std::memory_order_release);
+    executionImageOwner = std::move(image);
+    if (options.tracer != nullptr) {
+        options.tracer->recordInstant("publish", "compile", getSourceHash());
+    }
 }
 
-Pljit::FunctionFrame::FunctionFrame(std::string code)
-    : sourceCodeManager(std::make_unique<common::SourceCodeManager>(std::move(code)))
+void Pljit::FunctionFrame::releaseCompileArtifacts()
+// Releases the artifacts which are only needed during compilation.
+{
+    // The symbol table references the source code, hence, both are
+    // released together.
+    symbolTable.reset();
+    sourceCodeManager.reset();
+}
+
+Pljit::FunctionFrame::FunctionFrame(Pljit& pljit, std::unique_ptr<common::SourceCodeManager> sourceCodeManager)
+    : pljit(pljit),
+      options(pljit.options),
+      epochManager(pljit.epochManager),
+      imageCache(pljit.imageCache),
+      compileCache(pljit.compileCache.get()),
+      sourceCodeManager(std::move(sourceCodeManager)),
+      sourceHash(common::hashBytes(this->sourceCodeManager->getSourceCode()))
 // Constructor
-{}
+{
+    if (options.collectCallMetrics) {
+        callCountersOwner = std::make_unique<CallCounters>();
+        callCounters.store(callCountersOwner.get());
+    }
+    if (!options.profilePath.empty() || options.collectCallMetrics || options.traceSampledExecutions) {
+        callSamplerOwner = std::make_unique<CallSampler>();
+        callSampler.store(callSamplerOwner.get());
+    }
+    if (options.callRecorder != nullptr) {
+        options.callRecorder->recordFunction(getSourceHash(), this->sourceCodeManager->getSourceCode());
+    }
+}
 
-Result Pljit::FunctionFrame::execute(std::vector<int64_t>&& parameters)
-// Execute a function. If it was not yet compiled, compile it.
+std::optional<CompileStatistics> Pljit::FunctionFrame::getCompileStatistics()
+// Returns the statistics of the last compilation.
+{
+    std::unique_lock lck(compileMutex);
+    if (compileStatistics == nullptr) {
+        return std::nullopt;
+    }
+    return *compileStatistics;
+}
+
+std::optional<CallMetrics> Pljit::FunctionFrame::getCallMetrics() const
+// Returns the call metrics.
+{
+    // The counters must not be reclaimed while we read them.
+    auto guard = epochManager.pin();
+    const auto* counters = callCounters.load(std::memory_order_acquire);
+    if (counters == nullptr) {
+        return std::nullopt;
+    }
+    return counters->getMetrics();
+}
+
+std::shared_ptr<const exec::ExecutionProfile> Pljit::FunctionFrame::getExecutionProfile()
+// Returns the execution profile.
+{
+    std::unique_lock lck(compileMutex);
+    return executionProfile;
+}
+
+std::string Pljit::FunctionFrame::getAnnotatedSource()
+// Returns the source code annotated with the execution profile.
+{
+    std::unique_lock lck(compileMutex);
+    if (executionProfile == nullptr || sourceCodeManager == nullptr) {
+        return {};
+    }
+    std::ostringstream out;
+    executionProfile->writeAnnotatedSource(out, sourceCodeManager->getSourceCode());
+    return out.str();
+}
+
+std::string Pljit::FunctionFrame::getProfileDotGraph()
+// Returns the AST in the DOT format annotated with the execution profile.
+{
+    std::unique_lock lck(compileMutex);
+    if (executionProfile == nullptr || symbolTable == nullptr || executionImageOwner == nullptr) {
+        return {};
+    }
+    std::ostringstream out;
+    ast::ASTDotVisitor visitor(out, *symbolTable, executionProfile.get());
+    executionImageOwner->getFunction().accept(visitor);
+    return out.str();
+}
+
+std::string Pljit::FunctionFrame::getSourceCode()
+// Returns the source code.
+{
+    std::unique_lock lck(compileMutex);
+    if (sourceCodeManager == nullptr) {
+        return {};
+    }
+    return std::string(sourceCodeManager->getSourceCode());
+}
+
+uint64_t Pljit::FunctionFrame::getNumberOfCalls() const
+// Returns the number of executed calls.
 {
-    // We first need to check whether the function is already compiled.
-    bool wasCompiled = false;
+    // The sampler must not be reclaimed while we read it.
+    auto guard = epochManager.pin();
+    const auto* sampler = callSampler.load(std::memory_order_acquire);
+    return sampler != nullptr ? sampler->getNumberOfCalls() : 0;
+}
+
+Pljit::FunctionFrame::~FunctionFrame() = default;
+
+Pljit::FunctionState Pljit::FunctionFrame::compileOnce()
+// Compiles the function unless it was already compiled.
+{
+    // The mutex also makes concurrent callers wait for a running compilation.
+    std::unique_lock lck(compileMutex, std::defer_lock);
+    PLJIT_PROBE2(compile__lock__wait, getId(), getSourceHash());
     {
-        std::shared_lock lck(compileMutex);
-        if (state == FunctionState::CompileError) {
-            return compileError();
-        }
-        wasCompiled = state == FunctionState::Compiled;
+        common::TraceScope traceScope(options.tracer.get(), "compile lock", "compile", getSourceHash());
+        lck.lock();
+    }
+    PLJIT_PROBE2(compile__lock__acquired, getId(), getSourceHash());
+    if (state != FunctionState::NotCompiled) {
+        return state;
+    }
+    if (evicted) {
+        pljit.numberOfRecompilations.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::unique_ptr<CompileStatistics> statistics;
+    if (options.collectCompileStatistics) {
+        statistics = std::make_unique<CompileStatistics>();
+        statistics->numberOfCompilations = 1;
     }
+    {
+        common::DiagnosticsSinkScope scope(options.diagnosticsSink.get());
+        common::TraceScope traceScope(options.tracer.get(), "compile", "compile", getSourceHash());
+        compile(statistics.get());
+    }
+    if (statistics != nullptr) {
+        pljit.addCompileStatistics(*statistics);
+        compileStatistics = std::move(statistics);
+    }
+    if (options.lowMemoryMode) {
+        releaseCompileArtifacts();
+    }
+    if (state != FunctionState::Compiled) {
+        return state;
+    }
+
+    // The compiled code is charged to the budget of the Pljit.
+    compiledCodeSize = executionImageOwner->getMemoryUsage();
+    if (symbolTable != nullptr) {
+        compiledCodeSize += symbolTable->getMemoryUsage();
+    }
+    pljit.compiledCodeSize.fetch_add(compiledCodeSize);
+    lastUsedTick.store(pljit.evictionTick.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    lck.unlock();
 
-    if (!wasCompiled) {
-        // When we previously checked, the function was not yet compiled.
-        std::unique_lock lck(compileMutex);
-        // Does this still hold? If yes, start the compilation process.
-        if (state == FunctionState::NotCompiled) {
-            compile();
+    // The eviction locks other functions, hence, our mutex must be released.
+    if (options.compiledCodeBudget != 0) {
+        pljit.enforceCompiledCodeBudget(this);
+    }
+    return FunctionState::Compiled;
+}
+
+void Pljit::FunctionFrame::unregister()
+// Frees the source code, the symbol table and the compiled code.
+{
+    std::unique_lock lck(compileMutex);
+    if (state == FunctionState::Unregistered) {
+        return;
+    }
+    state = FunctionState::Unregistered;
+
+    // Concurrent calls might still execute the image, hence, we only unlink it
+    // and let the epoch manager free it once all of them left.
+    executionImage.store(nullptr);
+    if (executionImageOwner != nullptr) {
+        epochManager.retire(std::make_unique<std::shared_ptr<const exec::ExecutionImage>>(std::move(executionImageOwner)));
+    }
+    callCounters.store(nullptr);
+    if (callCountersOwner != nullptr) {
+        epochManager.retire(std::move(callCountersOwner));
+    }
+    callSampler.store(nullptr);
+    if (callSamplerOwner != nullptr) {
+        epochManager.retire(std::move(callSamplerOwner));
+    }
+    // The compile artifacts, the statistics and the profile are only accessed
+    // while holding the mutex. The image keeps its profile alive on its own.
+    releaseCompileArtifacts();
+    compileStatistics.reset();
+    executionProfile.reset();
+    pljit.compiledCodeSize.fetch_sub(compiledCodeSize);
+    compiledCodeSize = 0;
+}
+
+bool Pljit::FunctionFrame::evict()
+// Drops the compiled code of the function.
+{
+    std::unique_lock lck(compileMutex);
+    // Without the source code, the function could not be recompiled.
+    if (state != FunctionState::Compiled || sourceCodeManager == nullptr) {
+        return false;
+    }
+    state = FunctionState::NotCompiled;
+    evicted = true;
+
+    // Concurrent calls might still execute the image (see unregister()).
+    executionImage.store(nullptr);
+    epochManager.retire(std::make_unique<std::shared_ptr<const exec::ExecutionImage>>(std::move(executionImageOwner)));
+    symbolTable.reset();
+    pljit.compiledCodeSize.fetch_sub(compiledCodeSize);
+    compiledCodeSize = 0;
+    if (options.tracer != nullptr) {
+        options.tracer->recordInstant("evict", "compile", getSourceHash());
+    }
+    return true;
+}
+
+bool Pljit::FunctionFrame::replace(FunctionFrame& replacement)
+// Takes over the compiled code and the source code of the replacement.
+{
+    assert(replacement.state == FunctionState::Compiled);
+    std::unique_lock lck(compileMutex);
+    if (state == FunctionState::Unregistered) {
+        return false;
+    }
+
+    // The compile artifacts are only accessed while holding the mutex, hence,
+    // the old ones can be freed right away.
+    symbolTable = std::move(replacement.symbolTable);
+    sourceCodeManager = std::move(replacement.sourceCodeManager);
+    executionProfile = std::move(replacement.executionProfile);
+    compileStatistics = std::move(replacement.compileStatistics);
+    sourceHash.store(replacement.getSourceHash(), std::memory_order_relaxed);
+    pljit.compiledCodeSize.fetch_sub(compiledCodeSize);
+    compiledCodeSize = std::exchange(replacement.compiledCodeSize, 0);
+
+    // Concurrent calls might still execute the old image (see unregister()).
+    auto oldImageOwner = std::move(executionImageOwner);
+    replacement.executionImage.store(nullptr);
+    replacement.state = FunctionState::Unregistered;
+    state = FunctionState::Compiled;
+    executionImage.store(replacement.executionImageOwner.get(), std::memory_order_release);
+    executionImageOwner = std::move(replacement.executionImageOwner);
+    if (oldImageOwner != nullptr) {
+        epochManager.retire(std::make_unique<std::shared_ptr<const exec::ExecutionImage>>(std::move(oldImageOwner)));
+    }
+    lastUsedTick.store(pljit.evictionTick.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return true;
+}
+
+Result Pljit::FunctionFrame::execute(std::span<const int64_t> arguments)
+// Execute a function. If it was not yet compiled, compile it.
+{
+    PLJIT_PROBE2(execute__start, getId(), getSourceHash());
+    Result result;
+    if (auto* callRecorder = options.callRecorder.get(); callRecorder != nullptr) {
+        // The function might be replaced during the call.
+        auto sourceHash = getSourceHash();
+        result = run(arguments);
+        callRecorder->recordCall(sourceHash, arguments, result);
+    } else {
+        result = run(arguments);
+    }
+    PLJIT_PROBE3(execute__end, getId(), getSourceHash(), result.resultCode);
+    return result;
+}
+
+Result Pljit::FunctionFrame::run(std::span<const int64_t> arguments)
+// Executes the function without firing the execute probes.
+{
+    while (true) {
+        {
+            // The image must not be reclaimed while we execute it.
+            auto guard = epochManager.pin();
+            const auto* image = executionImage.load(std::memory_order_acquire);
+            if (image != nullptr) {
+                return executeImage(*image, arguments);
+            }
+        }
+
+        // The function is not compiled yet. The epoch is not pinned while
+        // compiling, such that the images which the compilation evicts and the
+        // objects which other threads retire meanwhile can be freed.
+        auto currentState = state.load();
+        if (currentState != FunctionState::CompileError && currentState != FunctionState::Unregistered) {
+            // When we previously checked, the function was not yet compiled.
+            currentState = compileOnce();
         }
         // Did a compile error occur in the compiling thread?
-        if (state == FunctionState::CompileError) {
+        if (currentState == FunctionState::CompileError) {
             return compileError();
         }
+        if (currentState == FunctionState::Unregistered) {
+            common::DiagnosticsSinkScope scope(options.diagnosticsSink.get());
+            common::getDiagnosticsSink().report({common::Diagnostic::Kind::InvalidCall,
+                                                 "the function was unregistered"});
+            return errorInvalidFunctionCall();
+        }
+        // The function might also have been evicted again after its compilation.
+    }
+}
+
+Result Pljit::FunctionFrame::executeImage(const exec::ExecutionImage& image, std::span<const int64_t> arguments)
+// Executes the compiled image of the function.
+{
+    // The tick is only written once per eviction, i.e. usually not by this call.
+    auto currentTick = pljit.evictionTick.load(std::memory_order_relaxed);
+    if (lastUsedTick.load(std::memory_order_relaxed) != currentTick) {
+        lastUsedTick.store(currentTick, std::memory_order_relaxed);
     }
 
-    if (parameters.size() != symbolTable->getNumberOfParameters()) {
-        std::cout << "error: invalid number of parameters provided, expected "
-                  << symbolTable->getNumberOfParameters() << " but "
-                  << parameters.size() << " were provided" << std::endl;
+    if (arguments.size() != image.getNumberOfParameters()) {
+        common::DiagnosticsSinkScope scope(options.diagnosticsSink.get());
+        common::getDiagnosticsSink().report({common::Diagnostic::Kind::InvalidCall,
+                                             "invalid number of parameters provided, expected " +
+                                                 std::to_string(image.getNumberOfParameters()) + " but " +
+                                                 std::to_string(arguments.size()) + " were provided"});
         return errorInvalidFunctionCall();
     }
 
-    exec::ExecutionContext executionContext(std::move(parameters),
-                                            *symbolTable);
-    function->execute(executionContext);
+    // Every n-th call of the function is sampled. The calls are counted in
+    // shards, such that concurrent calls rarely write to the same memory. They
+    // are only counted if the counts or the samples are used.
+    auto* sampler = callSampler.load(std::memory_order_acquire);
+    bool sampled = sampler != nullptr && sampler->sampleCall();
+    // The latency is only measured for the sampled calls.
+    auto* counters = callCounters.load(std::memory_order_acquire);
+    uint64_t startTicks = counters != nullptr && sampled ? CallMetrics::readTimestampCounter() : 0;
+    auto* tracer = sampled && options.traceSampledExecutions ? options.tracer.get() : nullptr;
+    uint64_t startTime = tracer != nullptr ? common::Tracer::now() : 0;
+
+    // The parameters are assignable, hence, the execution works on a copy of
+    // the arguments.
+    exec::ExecutionContext executionContext(std::vector<int64_t>(arguments.begin(), arguments.end()), image);
+    {
+        // Runtime errors are reported by the AST.
+        common::DiagnosticsSinkScope scope(options.diagnosticsSink.get());
+        image.getFunction().execute(executionContext);
+    }
+
+    if (tracer != nullptr) {
+        tracer->recordComplete("execute", "execution", startTime, common::Tracer::now(), getSourceHash());
+    }
+    if (counters != nullptr) {
+        if (sampled) {
+            counters->recordSampledCall(executionContext.hasError(), CallMetrics::readTimestampCounter() - startTicks);
+        } else {
+            counters->recordCall(executionContext.hasError());
+        }
+    }
 
     if (executionContext.hasError()) {
+        PLJIT_PROBE2(runtime__error, getId(), getSourceHash());
         return runtimeError();
     }
     return success(executionContext.returnValue);
@@ -167,4 +1010,10 @@ FunctionHandle::FunctionHandle(Pljit::FunctionRef functionRef)
 // Constructor
 {}
 
+Result FunctionHandle::call(std::span<const int64_t> arguments) const
+// Invokes the JIT compiled function with the given arguments.
+{
+    return functionRef->execute(arguments);
+}
+
 } // namespace pljit
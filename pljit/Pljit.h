@@ -1,14 +1,34 @@
 #ifndef H_jit_Pljit
 #define H_jit_Pljit
 
+#include "pljit/CallMetrics.h"
+#include "pljit/CallTraceFwd.h"
+#include "pljit/CompileStatistics.h"
 #include "pljit/FunctionHandleFwd.h"
 #include "pljit/analysis/SymbolTableFwd.h"
-#include "pljit/ast/ASTFwd.h"
+#include "pljit/common/ConcurrentArena.h"
+#include "pljit/common/DiagnosticsFwd.h"
+#include "pljit/common/TracerFwd.h"
+#include "pljit/common/EpochManager.h"
 #include "pljit/common/SourceCodeManagerFwd.h"
-#include <list>
+#include "pljit/common/ThreadPoolFwd.h"
+#include "pljit/exec/CompileCacheFwd.h"
+#include "pljit/exec/ExecutionImageCache.h"
+#include "pljit/exec/ExecutionImageFwd.h"
+#include "pljit/exec/ExecutionProfileFwd.h"
+#include "pljit/exec/WarmUpProfile.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
-#include <shared_mutex>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace pljit {
@@ -25,13 +45,245 @@ struct Result {
     ResultCode resultCode;
 };
 
+/// Options for configuring the Pljit.
+struct PljitOptions {
+    /// If set, a function frame drops its source code and its symbol table
+    /// after compilation and only keeps the compact execution image. Compile
+    /// errors are still reported since they are emitted during compilation.
+    bool lowMemoryMode{false};
+    /// Minimum number of statements in a function body from which on the
+    /// statements are parsed in parallel on the background compile threads.
+    /// Zero disables parallel parsing.
+    size_t parallelParsingThreshold{16384};
+    /// If set, the lexer runs on its own thread concurrently to the parser.
+    bool pipelinedLexing{false};
+    /// Memory resource from which the compiled functions are allocated. The
+    /// temporary objects of a compilation are allocated from a monotonic arena
+    /// on top of it, which is released in one shot after the compilation.
+    /// Note: The resource must outlive the Pljit and must be thread-safe if
+    ///       functions are compiled concurrently.
+    std::pmr::memory_resource* memoryResource{std::pmr::new_delete_resource()};
+    /// If set, registerFunction() enqueues the compilation of the function on
+    /// the background compile threads instead of compiling on the first call.
+    bool eagerCompilation{false};
+    /// Number of background compile threads. Zero selects the number of
+    /// hardware threads. The threads are only started when needed.
+    size_t numberOfCompileThreads{0};
+    /// If set, functions which only differ in whitespace or in the names of
+    /// their identifiers, or which are optimized into the same code, share one
+    /// compiled execution image. Such functions are recognized after the
+    /// optimization passes by a canonical fingerprint of their AST.
+    bool deduplicateFunctions{false};
+    /// Directory of the persistent compile cache. If set, compiled functions
+    /// are stored in the directory and loaded from it instead of compiling
+    /// functions with the same source code again, e.g. after a restart.
+    std::string compileCacheDirectory{};
+    /// Path of the warm-up profile. If set, the profile of the previous run is
+    /// read on construction (see Pljit::warmUp()) and the profile of this run
+    /// is written on destruction.
+    std::string profilePath{};
+    /// Budget in bytes for the compiled code, i.e. for the execution images
+    /// and the symbol tables of the compiled functions. If it is exceeded, the
+    /// least recently executed functions are evicted down to 90% of the
+    /// budget and recompiled on their next call. Zero disables the budget.
+    /// Note: Functions can only be evicted if their source code is kept, i.e.
+    ///       not in low-memory mode. Shared images are charged to every
+    ///       function which uses them.
+    size_t compiledCodeBudget{0};
+    /// Sink for the compile errors and runtime errors of the functions. If not
+    /// set, they are reported to the sink of the calling thread, which drops
+    /// them unless a common::DiagnosticsSinkScope is active (see
+    /// common::getDiagnosticsSink()). Set a common::StreamDiagnosticsSink to
+    /// print them, or a common::AsyncDiagnosticsSink to log them off the
+    /// executing threads.
+    /// Note: If set, the compile errors of modules are reported to the sink
+    ///       instead of ModuleFunction::diagnostics.
+    std::shared_ptr<common::DiagnosticsSink> diagnosticsSink{};
+    /// If set, the time and the node allocations of every compile phase are
+    /// measured (see Pljit::getCompileStatistics()). Since the parser pulls
+    /// its tokens lazily, the lexing time is measured per token and is not
+    /// part of the parsing time. Pipelined lexing and the lexing of the
+    /// compile threads overlap with parsing and count as parsing time.
+    bool collectCompileStatistics{false};
+    /// If set, every function counts its calls and runtime errors, and the
+    /// latency of every 64th call of the function is measured with the time
+    /// stamp counter (see Pljit::getFunctionMetrics()). The counters are
+    /// sharded, such that concurrent calls do not contend on them.
+    bool collectCallMetrics{false};
+    /// Tracer which records the timeline of the compilations: the wait for
+    /// the compile lock, the time in the compile queue, every compile phase,
+    /// cache hits, deduplications, the publication of compiled functions and
+    /// evictions. Export it with common::Tracer::writeJson(). Disabled if not
+    /// set.
+    std::shared_ptr<common::Tracer> tracer{};
+    /// If set, the tracer also records every 64th call of a function.
+    bool traceSampledExecutions{false};
+    /// If set, every AST node counts its executions and the ticks spent in it
+    /// (see Pljit::getExecutionProfile()). The instrumentation slows down the
+    /// execution considerably. Profiled functions are neither deduplicated
+    /// nor loaded from the compile cache, since their nodes must be mapped to
+    /// their own source code.
+    bool profileExecution{false};
+    /// Recorder of the calls of the functions, i.e. of their source hashes,
+    /// arguments and results. The source code of every function is recorded
+    /// on its registration, such that the trace can be replayed with
+    /// pljitReplay. Disabled if not set.
+    std::shared_ptr<CallRecorder> callRecorder{};
+};
+
+struct ModuleFunction;
+struct FunctionMetrics;
+
 /// A class for JIT compilation of PL/0 functions.
 class Pljit {
     public:
+    /// Constructor
+    explicit Pljit(PljitOptions options = {});
+
+    /// Destructor
+    /// Note: Pending background compilations are discarded. If a profile path
+    ///       is set, the profile is written.
+    ~Pljit();
+
     /// Registers a PL/0 function.
-    /// Note: This function is not thread-safe.
+    /// Note: This function is thread-safe and can be called concurrently to
+    ///       the execution of already registered functions.
     FunctionHandle registerFunction(const std::string& code);
 
+    /// Registers a PL/0 function without copying its source code, e.g. from
+    /// a memory-mapped file (see common::MappedFile). The owner keeps the
+    /// source code alive as long as the function references it.
+    /// Note: This function is thread-safe.
+    FunctionHandle registerFunction(std::string_view code, std::shared_ptr<const void> owner);
+
+    /// Registers all functions of a module, i.e. of consecutive PL/0 function
+    /// definitions which are each terminated by "END.". The functions are
+    /// compiled in parallel on the background compile threads and the calling
+    /// thread. The compile errors are reported per function, their positions
+    /// are relative to the start of the function definition.
+    /// Note: This function is thread-safe.
+    std::vector<ModuleFunction> registerModule(std::string_view module);
+
+    /// Registers all functions of a module without copying their source code.
+    /// The owner keeps the module alive as long as any of its functions
+    /// references it.
+    /// Note: This function is thread-safe.
+    std::vector<ModuleFunction> registerModule(std::string_view module, std::shared_ptr<const void> owner);
+
+    /// Maps a module file into memory and registers all of its functions. The
+    /// functions reference the mapped file instead of copies of their source
+    /// code. Returns an empty vector if the file cannot be read.
+    /// Note: The file must be immutable while its functions are registered,
+    ///       i.e. only be replaced by renaming a new file over it (see
+    ///       common::MappedFile). Functions which are recompiled after an
+    ///       eviction fail to compile if the file was modified in place.
+    /// Note: This function is thread-safe.
+    std::vector<ModuleFunction> registerModuleFile(const std::string& path);
+
+    /// Enqueues the compilation of a function on the background compile
+    /// threads. The future yields whether the function compiled successfully.
+    /// Note: This function is thread-safe.
+    std::future<bool> compileAsync(FunctionHandle handle);
+
+    /// Compiles the registered functions which were compiled in the previous
+    /// run according to its profile, the hottest functions first. The
+    /// functions are compiled on the background compile threads and the
+    /// calling thread. Returns the number of successfully compiled functions.
+    /// Note: This function is thread-safe.
+    size_t warmUp();
+
+    /// Writes the profile of the compiled functions and of the functions which
+    /// were called, e.g. before they were evicted, i.e. their source hashes
+    /// and their number of calls. Returns false if the file cannot be written.
+    /// Note: The calls are only counted if PljitOptions::profilePath is set,
+    ///       the call metrics are collected or sampled calls are traced.
+    /// Note: This function is thread-safe.
+    bool writeProfile(const std::string& path);
+
+    /// Blocks until the function is compiled and returns whether it compiled
+    /// successfully. If no thread started the compilation yet, the function is
+    /// compiled on the calling thread.
+    /// Note: This function is thread-safe.
+    bool waitUntilCompiled(FunctionHandle handle);
+
+    /// Unregisters a PL/0 function and frees its source code, its AST, its
+    /// compiled code, its statistics and its profile. Calls which are executing
+    /// the function concurrently finish normally, the memory they still use is
+    /// reclaimed by a later unregistration or registration once they left the
+    /// function. Later calls of the handle fail with
+    /// ResultCode::InvalidFunctionCall, hence, the frame of the function itself
+    /// (below a kilobyte) is only freed with the Pljit.
+    /// Note: This function is thread-safe. Executing functions never waits for
+    ///       an unregistration.
+    void unregisterFunction(FunctionHandle handle);
+
+    /// Replaces the source code of a registered function. The new version is
+    /// compiled on the calling thread while the old version can still be
+    /// called. Then, it is published atomically: calls which are executing the
+    /// old version finish on it, later calls execute the new version. Returns
+    /// false if the new version does not compile or the function was
+    /// unregistered, the function then keeps its old version.
+    /// Note: This function is thread-safe. Executing functions never waits for
+    ///       a replacement.
+    bool replaceFunction(FunctionHandle handle, const std::string& code);
+
+    /// Returns the statistics of the last compilation of a function. Returns an
+    /// empty optional if the function was not compiled yet or if the
+    /// statistics are not collected.
+    /// Note: This function is thread-safe.
+    std::optional<CompileStatistics> getCompileStatistics(FunctionHandle handle);
+
+    /// Returns the accumulated statistics of all compilations of this Pljit.
+    /// The statistics of all Pljits are available through
+    /// CompileStatistics::getProcessSnapshot().
+    /// Note: This function is thread-safe.
+    CompileStatistics getCompileStatistics() const;
+
+    /// Returns the call metrics of a function. Returns an empty optional if
+    /// the call metrics are not collected.
+    /// Note: This function is thread-safe.
+    std::optional<CallMetrics> getCallMetrics(FunctionHandle handle);
+
+    /// Returns the call metrics of all registered functions in the order of
+    /// their registration. Returns an empty vector if the call metrics are not
+    /// collected.
+    /// Note: This function is thread-safe. Calls which are executed
+    ///       concurrently might be missing.
+    std::vector<FunctionMetrics> getFunctionMetrics();
+
+    /// Returns the execution profile of a function. Returns nullptr if the
+    /// function was not compiled yet or if the executions are not profiled.
+    /// The profile is kept if the function is evicted and recompiled.
+    /// Note: This function is thread-safe.
+    std::shared_ptr<const exec::ExecutionProfile> getExecutionProfile(FunctionHandle handle);
+
+    /// Returns the source code of a function annotated with its execution
+    /// profile (see exec::ExecutionProfile::writeAnnotatedSource()). Returns an
+    /// empty string if there is no profile or if the source code was released.
+    /// Note: This function is thread-safe.
+    std::string getAnnotatedSource(FunctionHandle handle);
+
+    /// Returns the AST of a function in the DOT format, where the nodes are
+    /// colored by their share of the ticks. Returns an empty string if there
+    /// is no profile or if the symbol table was released.
+    /// Note: This function is thread-safe.
+    std::string getProfileDotGraph(FunctionHandle handle);
+
+    /// Returns the estimated number of bytes which are occupied by the
+    /// compiled code.
+    size_t getCompiledCodeSize() const { return compiledCodeSize.load(std::memory_order_relaxed); }
+
+    /// Returns the number of functions which were evicted because the
+    /// compiled code budget was exceeded.
+    uint64_t getNumberOfEvictions() const { return numberOfEvictions.load(std::memory_order_relaxed); }
+
+    /// Returns the number of compilations of evicted functions.
+    uint64_t getNumberOfRecompilations() const { return numberOfRecompilations.load(std::memory_order_relaxed); }
+
+    /// Returns the number of unlinked objects, e.g. of evicted images, which
+    /// are not yet freed since concurrent calls might still access them.
+    size_t getNumberOfRetiredObjects() const { return epochManager.getNumberOfRetiredObjects(); }
+
     private:
     /// The function handle is marked as a friend, such that it can call execute()
     /// from FunctionFrame.
@@ -40,49 +292,232 @@ class Pljit {
     enum class FunctionState {
         NotCompiled,
         Compiled,
-        CompileError
+        CompileError,
+        Unregistered
     };
 
     class FunctionFrame {
         private:
-        /// Source code management
-        const std::unique_ptr<common::SourceCodeManager> sourceCodeManager;
-        /// Pointer to the symbol table
+        /// The owning Pljit, which enforces the compiled code budget
+        Pljit& pljit;
+        /// Options of the owning Pljit
+        const PljitOptions& options;
+        /// Memory reclamation of the owning Pljit
+        common::EpochManager& epochManager;
+        /// Shared execution images of the owning Pljit
+        exec::ExecutionImageCache& imageCache;
+        /// Persistent compile cache of the owning Pljit (nullptr if disabled)
+        const exec::CompileCache* compileCache;
+        /// Source code management (released after compilation in low-memory mode)
+        std::unique_ptr<common::SourceCodeManager> sourceCodeManager;
+        /// Pointer to the symbol table (not kept in low-memory mode)
         std::unique_ptr<const analysis::SymbolTable> symbolTable{};
-        /// Pointer to the executable AST function node
-        std::unique_ptr<const ast::Function> function{};
-        /// Mutex for making compilation thread-safe
-        std::shared_mutex compileMutex{};
+        /// Pointer to the compact image of the compiled function. It is
+        /// published once the function is compiled and read by the executing
+        /// threads without a lock. Hence, an unregistered image is reclaimed
+        /// through the epoch manager.
+        std::atomic<const exec::ExecutionImage*> executionImage{nullptr};
+        /// Keeps the image alive, it might be shared with other functions
+        std::shared_ptr<const exec::ExecutionImage> executionImageOwner{};
+        /// Mutex for making compilation and unregistration thread-safe
+        std::mutex compileMutex{};
         /// Current state of the function
-        FunctionState state{FunctionState::NotCompiled};
+        std::atomic<FunctionState> state{FunctionState::NotCompiled};
+        /// Hash of the source code, which identifies the function across runs
+        std::atomic<uint64_t> sourceHash;
+        /// Eviction tick of the owning Pljit during the last call. It is only
+        /// written once per tick, such that calls rarely write shared memory.
+        std::atomic<uint64_t> lastUsedTick{0};
+        /// Compiled code size which is charged to the budget
+        size_t compiledCodeSize{0};
+        /// Whether the compiled code was evicted
+        bool evicted{false};
+        /// Statistics of the last compilation (only if they are collected)
+        std::unique_ptr<const CompileStatistics> compileStatistics{};
+        /// Counters of the calls (only if they are collected). They are
+        /// written by the executing threads without a lock, hence, they are
+        /// reclaimed through the epoch manager like the image.
+        std::atomic<CallCounters*> callCounters{nullptr};
+        /// Keeps the counters alive
+        std::unique_ptr<CallCounters> callCountersOwner{};
+        /// Counts the calls and decides which of them are sampled (only if a
+        /// profile is written, the call metrics are collected or sampled calls
+        /// are traced). It is reclaimed like the counters.
+        std::atomic<CallSampler*> callSampler{nullptr};
+        /// Keeps the sampler alive
+        std::unique_ptr<CallSampler> callSamplerOwner{};
+        /// Profile of the AST nodes (only if the executions are profiled)
+        std::shared_ptr<exec::ExecutionProfile> executionProfile{};
+
+        /// Compiles the function. The statistics are only collected if they
+        /// are not nullptr.
+        /// Note: This function is not thread-safe and should only
+        ///       be called after acquiring a unique lock on compileMutex.
+        void compile(CompileStatistics* statistics);
 
-        /// Compiles the function.
+        /// Publishes the image of the compiled function.
         /// Note: This function is not thread-safe and should only
         ///       be called after acquiring a unique lock on compileMutex.
-        void compile();
+        void publish(std::shared_ptr<const exec::ExecutionImage> image);
+
+        /// Releases the artifacts which are only needed during compilation.
+        /// Note: This function is not thread-safe and should only
+        ///       be called after acquiring a unique lock on compileMutex.
+        void releaseCompileArtifacts();
+
+        /// Executes the function, see execute().
+        Result run(std::span<const int64_t> arguments);
+
+        /// Executes the compiled image of the function.
+        /// Note: The epoch must be pinned, such that the image is not freed.
+        Result executeImage(const exec::ExecutionImage& image, std::span<const int64_t> arguments);
 
         public:
         /// Constructor
-        explicit FunctionFrame(std::string code);
+        FunctionFrame(Pljit& pljit, std::unique_ptr<common::SourceCodeManager> sourceCodeManager);
+
+        /// Destructor
+        ~FunctionFrame();
+
+        /// Returns the current state of the function.
+        FunctionState getState() const { return state.load(); }
+
+        /// Returns the id of the function, which is the address of its frame.
+        uint64_t getId() const { return reinterpret_cast<uintptr_t>(this); }
+
+        /// Returns the hash of the source code.
+        uint64_t getSourceHash() const { return sourceHash.load(std::memory_order_relaxed); }
+
+        /// Returns the number of executed calls, or zero if the calls are not
+        /// counted. Calls which are executed concurrently might be missing.
+        /// Note: This function is thread-safe.
+        uint64_t getNumberOfCalls() const;
+
+        /// Returns the statistics of the last compilation.
+        /// Note: This function is thread-safe.
+        std::optional<CompileStatistics> getCompileStatistics();
+
+        /// Returns the call metrics, if they are collected.
+        /// Note: This function is thread-safe.
+        std::optional<CallMetrics> getCallMetrics() const;
+
+        /// Returns the execution profile, if the executions are profiled.
+        /// Note: This function is thread-safe.
+        std::shared_ptr<const exec::ExecutionProfile> getExecutionProfile();
+
+        /// Returns the source code annotated with the execution profile.
+        /// Note: This function is thread-safe.
+        std::string getAnnotatedSource();
+
+        /// Returns the AST in the DOT format annotated with the execution profile.
+        /// Note: This function is thread-safe.
+        std::string getProfileDotGraph();
+
+        /// Returns the source code, or an empty string if it was released.
+        /// Note: This function is thread-safe.
+        std::string getSourceCode();
+
+        /// Returns the eviction tick during the last call.
+        uint64_t getLastUsedTick() const { return lastUsedTick.load(std::memory_order_relaxed); }
+
+        /// Compiles the function unless it was already compiled and returns
+        /// the resulting state.
+        /// Note: This function is thread-safe.
+        FunctionState compileOnce();
+
+        /// Frees the source code, the symbol table, the compiled code, the
+        /// statistics and the profile of the function. The frame itself stays
+        /// valid to reject later calls.
+        /// Note: This function is thread-safe.
+        void unregister();
+
+        /// Drops the compiled code of the function, such that it is recompiled
+        /// on its next call. Returns false if the function was not compiled or
+        /// cannot be recompiled.
+        /// Note: This function is thread-safe.
+        bool evict();
+
+        /// Takes over the compiled code and the source code of the compiled
+        /// replacement and publishes its image. Returns false if the function
+        /// was unregistered.
+        /// Note: This function is thread-safe. The replacement must not be
+        ///       accessed concurrently.
+        bool replace(FunctionFrame& replacement);
 
         /// Executes a function. If the function was not yet compiled,
         /// it will be compiled. If any error during the compilation or
         /// execution phase occurs, a corresponding error code is returned.
+        /// The call fires the execute__start and execute__end probes (see
+        /// common/Probes.h).
         /// Note: This function is thread-safe.
-        Result execute(std::vector<int64_t>&& parameters);
+        Result execute(std::span<const int64_t> arguments);
     };
 
-    /// Why does it make sense to use a list here?
-    /// The main advantage is that the references (i.e. the iterators of std::list) to
-    /// our function entries are not invalidated when a new function entry is inserted.
-    /// Hence, we can use them as references. Moreover, we will never iterate over the
-    /// registered function, therefore, the locality advantage from e.g. vectors does
-    /// not matter here.
-    using Functions = std::list<FunctionFrame>;
-    using FunctionRef = Functions::iterator;
+    /// Why does it make sense to use a concurrent arena here?
+    /// The function frames have stable addresses, i.e. pointers to them are not
+    /// invalidated when a new function is registered. Hence, we can use them as
+    /// references. Moreover, functions can be registered from multiple threads
+    /// without a global lock while other threads execute functions.
+    using Functions = common::ConcurrentArena<FunctionFrame>;
+    using FunctionRef = FunctionFrame*;
+
+    /// Options
+    const PljitOptions options;
+
+    /// Reclaims the memory of unregistered functions (must outlive the functions)
+    common::EpochManager epochManager;
+
+    /// Execution images shared by equal functions (must outlive the functions)
+    exec::ExecutionImageCache imageCache;
+
+    /// Persistent compile cache (nullptr if disabled)
+    std::unique_ptr<const exec::CompileCache> compileCache;
+
+    /// Profile of the previous run (empty if it could not be read)
+    std::optional<exec::WarmUpProfile> previousProfile;
 
     /// Registered functions
     Functions functions;
+
+    /// Evicts the least recently executed functions until the compiled code
+    /// fits into the budget again. The function which was just compiled is
+    /// kept. Only one thread evicts at a time, the others skip the eviction.
+    void enforceCompiledCodeBudget(FunctionRef compiledFunction);
+
+    /// Estimated size of the compiled code of all functions
+    std::atomic<size_t> compiledCodeSize{0};
+    /// Advanced by every eviction, the functions remember the tick of their
+    /// last call. Hence, the functions which were not called since an older
+    /// tick are evicted first.
+    std::atomic<uint64_t> evictionTick{1};
+    /// Statistics of the compiled code budget
+    std::atomic<uint64_t> numberOfEvictions{0};
+    std::atomic<uint64_t> numberOfRecompilations{0};
+    /// Serializes the evictions
+    std::mutex evictionMutex;
+
+    /// Adds the statistics of a compilation to the statistics of this Pljit
+    /// and to the process-wide statistics.
+    void addCompileStatistics(const CompileStatistics& statistics);
+
+    /// Accumulated statistics of all compilations
+    mutable std::mutex compileStatisticsMutex;
+    CompileStatistics compileStatistics;
+
+    /// Returns the background compile threads and starts them if necessary.
+    common::ThreadPool& getCompileThreads();
+
+    /// Registers the function definitions of a module and compiles them in
+    /// parallel (see registerModule()).
+    std::vector<ModuleFunction> registerModule(std::vector<std::unique_ptr<common::SourceCodeManager>> definitions);
+
+    /// Enqueues a task which compiles the function on the background compile
+    /// threads. If tracing, the time in the queue is recorded.
+    void submitCompileTask(FunctionRef functionRef, std::function<void()> task);
+
+    /// Background compile threads (must be destroyed before the functions)
+    std::once_flag compileThreadsStarted;
+    std::unique_ptr<common::ThreadPool> compileThreads;
 };
 
 /// Wrapper function for safe-calls, i.e. the user is sure that neither
@@ -102,6 +537,11 @@ class FunctionHandle {
     template <typename... Tail>
     Result operator()(Tail... tail) const;
 
+    /// Invokes the JIT compiled function with the given arguments, e.g. with
+    /// the arguments of a recorded call. The arguments are not copied before
+    /// the execution.
+    Result call(std::span<const int64_t> arguments) const;
+
     private:
     /// Constructor
     explicit FunctionHandle(Pljit::FunctionRef functionRef);
@@ -111,12 +551,34 @@ class FunctionHandle {
     Pljit::FunctionRef functionRef;
 };
 
+/// The call metrics of a registered function.
+struct FunctionMetrics {
+    /// Handle of the function
+    FunctionHandle handle;
+    /// Hash of the source code of the function
+    uint64_t sourceHash;
+    /// Source code of the function (empty in low-memory mode)
+    std::string sourceCode;
+    /// Metrics of the calls of the function
+    CallMetrics callMetrics;
+};
+
+/// A function which was registered as part of a module.
+struct ModuleFunction {
+    /// Handle of the function
+    FunctionHandle handle;
+    /// Whether the function was compiled successfully
+    bool compiled;
+    /// The compile errors of the function
+    std::string diagnostics;
+};
+
 template <typename... Tail>
 Result FunctionHandle::operator()(Tail... tail) const
 // Invokes the JIT compiled function.
 {
-    std::vector<int64_t> params{tail...};
-    return functionRef->execute(std::move(params));
+    std::array<int64_t, sizeof...(Tail)> arguments{tail...};
+    return functionRef->execute(arguments);
 }
 
 } // namespace pljit
@@ -1,6 +1,7 @@
 #include "SemanticAnalysis.h"
 #include "pljit/analysis/SymbolTable.h"
 #include "pljit/ast/AST.h"
+#include "pljit/ast/NodeSourceMap.h"
 #include "pljit/common/SourceCodeManager.h"
 #include "pljit/parse_tree/ParseTree.h"
 #include <cassert>
@@ -44,9 +45,15 @@ bool haveStatementsError(const std::vector<std::unique_ptr<ast::Statement>>& stm
 } // namespace
 
 SemanticAnalysis::SemanticAnalysis(const common::SourceCodeManager& sourceCodeManager,
-                                   SymbolTable& symbolTable)
+                                   SymbolTable& symbolTable,
+                                   std::pmr::memory_resource* memoryResource,
+                                   ast::NodeSourceMap* nodeSourceMap)
     : sourceCodeManager(sourceCodeManager),
-      symbolTable(symbolTable)
+      symbolTable(symbolTable),
+      nodeSourceMap(nodeSourceMap),
+      initializedVariables(memoryResource),
+      pendingNodes(memoryResource),
+      operands(memoryResource)
 // Constructor
 {}
 
@@ -185,6 +192,7 @@ std::vector<std::unique_ptr<ast::Statement>> SemanticAnalysis::analyzeStatements
         if (hasError(astStatement)) {
             return statementsError();
         }
+        recordSourceRange(*astStatement, *child);
         statements.push_back(std::move(astStatement));
     }
 
@@ -271,118 +279,156 @@ std::unique_ptr<ast::Expression> SemanticAnalysis::analyzeExpression(
     const parse_tree::AdditiveExpression& node)
 // Semantically analyzes an additive-expression.
 {
-    // The first child is always a multiplicative expression and does always exist.
-    auto mulExpr = analyzeExpression(node.getMultiplicativeExpression());
-    if (hasError(mulExpr)) {
-        return error<ast::Expression>();
-    }
-
-    auto addExprType = node.getAdditiveExpressionType();
-
-    if (addExprType == parse_tree::AdditiveExpression::Type::None) {
-        // The expression is just a multiplicative expression!
-        return mulExpr;
-    }
-
-    // The expression must be either an addition or subtraction!
-    assert(addExprType == parse_tree::AdditiveExpression::Type::Add ||
-           addExprType == parse_tree::AdditiveExpression::Type::Sub);
-
-    // Determine the sign of the additive-expression.
-    auto binaryOpType = node.getAdditiveExpressionType() == parse_tree::AdditiveExpression::Type::Add
-                        ? ast::BinaryOp::Type::Add : ast::BinaryOp::Type::Sub;
-
-    // Analyze the last child which is an additive-expression.
-    auto addExpr = analyzeExpression(node.getAdditiveExpression());
-    if (hasError(addExpr)) {
-        return error<ast::Expression>();
-    }
-
-    return std::make_unique<ast::BinaryOp>(std::move(mulExpr), binaryOpType, std::move(addExpr));
-}
-
-std::unique_ptr<ast::Expression> SemanticAnalysis::analyzeExpression(
-    const parse_tree::MultiplicativeExpression& node)
-// Semantically analyzes a multiplicative-expression.
-{
-    // The first child is always a unary expression and does always exist.
-    auto unaryExpr = analyzeExpression(node.getUnaryExpression());
-    if (hasError(unaryExpr)) {
-        return error<ast::Expression>();
-    }
-
-    auto mulExprType = node.getMultiplicativeExpressionType();
-
-    if (mulExprType == parse_tree::MultiplicativeExpression::Type::None) {
-        // The expression is just a unary expression!
-        return unaryExpr;
-    }
-
-    // The expression must be either a multiplication or division!
-    assert(mulExprType == parse_tree::MultiplicativeExpression::Type::Mul ||
-           mulExprType == parse_tree::MultiplicativeExpression::Type::Div);
-
-    // Determine the operation type of the multiplicative-expression.
-    auto binaryOpType = node.getMultiplicativeExpressionType()
-                        == parse_tree::MultiplicativeExpression::Type::Mul
-                        ? ast::BinaryOp::Type::Mul : ast::BinaryOp::Type::Div;
-
-    // Analyze the last child which is again a multiplicative-expression.
-    auto mulExpr = analyzeExpression(node.getMultiplicativeExpression());
-    if (hasError(mulExpr)) {
-        return error<ast::Expression>();
+    // Expressions can be nested arbitrarily deep, hence, we traverse the parse tree
+    // with an explicit stack instead of recursion. A node is visited twice if it
+    // becomes an operator in the AST: once before and once after its operands were
+    // analyzed. The analyzed operands are kept on a separate stack.
+    // Note: The stacks are members, such that their memory is reused.
+    assert(pendingNodes.empty() && operands.empty());
+    pendingNodes.push_back({&node, false});
+
+    while (!pendingNodes.empty()) {
+        auto [current, operandsAnalyzed] = pendingNodes.back();
+        pendingNodes.pop_back();
+
+        switch (current->getType()) {
+            case parse_tree::ParseTreeNode::Type::AdditiveExpression: {
+                const auto& addExpr = static_cast<const parse_tree::AdditiveExpression&>(*current); // NOLINT
+                auto addExprType = addExpr.getAdditiveExpressionType();
+
+                if (addExprType == parse_tree::AdditiveExpression::Type::None) {
+                    // The expression is just a multiplicative expression!
+                    pendingNodes.push_back({&addExpr.getMultiplicativeExpression(), false});
+                    break;
+                }
+
+                // The expression must be either an addition or subtraction!
+                assert(addExprType == parse_tree::AdditiveExpression::Type::Add ||
+                       addExprType == parse_tree::AdditiveExpression::Type::Sub);
+
+                if (!operandsAnalyzed) {
+                    // Analyze the multiplicative-expression first and the
+                    // additive-expression afterwards.
+                    pendingNodes.push_back({current, true});
+                    pendingNodes.push_back({&addExpr.getAdditiveExpression(), false});
+                    pendingNodes.push_back({&addExpr.getMultiplicativeExpression(), false});
+                    break;
+                }
+
+                // Determine the sign of the additive-expression.
+                auto binaryOpType = addExprType == parse_tree::AdditiveExpression::Type::Add
+                                    ? ast::BinaryOp::Type::Add : ast::BinaryOp::Type::Sub;
+
+                auto rhs = std::move(operands.back());
+                operands.pop_back();
+                auto& lhs = operands.back();
+                lhs = std::make_unique<ast::BinaryOp>(std::move(lhs), binaryOpType, std::move(rhs));
+                recordSourceRange(*lhs, addExpr);
+                break;
+            }
+
+            case parse_tree::ParseTreeNode::Type::MultiplicativeExpression: {
+                const auto& mulExpr = static_cast<const parse_tree::MultiplicativeExpression&>(*current); // NOLINT
+                auto mulExprType = mulExpr.getMultiplicativeExpressionType();
+
+                if (mulExprType == parse_tree::MultiplicativeExpression::Type::None) {
+                    // The expression is just a unary expression!
+                    pendingNodes.push_back({&mulExpr.getUnaryExpression(), false});
+                    break;
+                }
+
+                // The expression must be either a multiplication or division!
+                assert(mulExprType == parse_tree::MultiplicativeExpression::Type::Mul ||
+                       mulExprType == parse_tree::MultiplicativeExpression::Type::Div);
+
+                if (!operandsAnalyzed) {
+                    // Analyze the unary-expression first and the multiplicative-expression
+                    // afterwards.
+                    pendingNodes.push_back({current, true});
+                    pendingNodes.push_back({&mulExpr.getMultiplicativeExpression(), false});
+                    pendingNodes.push_back({&mulExpr.getUnaryExpression(), false});
+                    break;
+                }
+
+                // Determine the operation type of the multiplicative-expression.
+                auto binaryOpType = mulExprType == parse_tree::MultiplicativeExpression::Type::Mul
+                                    ? ast::BinaryOp::Type::Mul : ast::BinaryOp::Type::Div;
+
+                auto rhs = std::move(operands.back());
+                operands.pop_back();
+                auto& lhs = operands.back();
+                lhs = std::make_unique<ast::BinaryOp>(std::move(lhs), binaryOpType, std::move(rhs));
+                recordSourceRange(*lhs, mulExpr);
+                break;
+            }
+
+            case parse_tree::ParseTreeNode::Type::UnaryExpression: {
+                const auto& unaryExpr = static_cast<const parse_tree::UnaryExpression&>(*current); // NOLINT
+                auto unaryExprType = unaryExpr.getUnaryExpressionType();
+
+                if (unaryExprType == parse_tree::UnaryExpression::Type::Unsigned) {
+                    // The unary expression does not have a sign!
+                    pendingNodes.push_back({&unaryExpr.getPrimaryExpression(), false});
+                    break;
+                }
+
+                // The unary expression must have a sign!
+                assert(unaryExprType == parse_tree::UnaryExpression::Type::PlusSign ||
+                       unaryExprType == parse_tree::UnaryExpression::Type::MinusSign);
+
+                if (!operandsAnalyzed) {
+                    pendingNodes.push_back({current, true});
+                    pendingNodes.push_back({&unaryExpr.getPrimaryExpression(), false});
+                    break;
+                }
+
+                auto unaryOpType = unaryExprType == parse_tree::UnaryExpression::Type::PlusSign ?
+                                   ast::UnaryOp::Type::PlusSign : ast::UnaryOp::Type::MinusSign;
+
+                auto& operand = operands.back();
+                operand = std::make_unique<ast::UnaryOp>(unaryOpType, std::move(operand));
+                recordSourceRange(*operand, unaryExpr);
+                break;
+            }
+
+            case parse_tree::ParseTreeNode::Type::PrimaryExpression: {
+                const auto& primaryExpr = static_cast<const parse_tree::PrimaryExpression&>(*current); // NOLINT
+
+                switch (primaryExpr.getPrimaryExpressionType()) {
+                    case parse_tree::PrimaryExpression::Type::Literal:
+                        operands.push_back(analyzeExpression(primaryExpr.getLiteral()));
+                        break;
+
+                    case parse_tree::PrimaryExpression::Type::Identifier: {
+                        auto identifier = analyzeExpression(primaryExpr.getIdentifier()); // NOLINT
+                        if (hasError(identifier)) {
+                            pendingNodes.clear();
+                            operands.clear();
+                            return error<ast::Expression>();
+                        }
+                        operands.push_back(std::move(identifier));
+                        break;
+                    }
+
+                    case parse_tree::PrimaryExpression::Type::Parenthesized:
+                        // In the case of a parenthesized primary expression, we are only interested
+                        // in the additive-expression. The parenthesis do not matter.
+                        pendingNodes.push_back({&primaryExpr.getAdditiveExpression(), false});
+                        break;
+                }
+                break;
+            }
+
+            default:
+                // Only expression nodes are pushed onto the stack.
+                __builtin_unreachable();
+        }
     }
 
-    return std::make_unique<ast::BinaryOp>(std::move(unaryExpr), binaryOpType, std::move(mulExpr));
-}
-
-std::unique_ptr<ast::Expression> SemanticAnalysis::analyzeExpression(
-    const parse_tree::UnaryExpression& node)
-// Semantically analyzes a unary-expression.
-{
-    auto primaryExpr = analyzeExpression(node.getPrimaryExpression());
-    if (hasError(primaryExpr)) {
-        return error<ast::Expression>();
-    }
-
-    auto unaryExprType = node.getUnaryExpressionType();
-
-    if (node.getUnaryExpressionType() == parse_tree::UnaryExpression::Type::Unsigned) {
-        // The unary expression does not have a sign!
-        return primaryExpr;
-    }
-
-    // The unary expression must have a sign!
-    assert(unaryExprType == parse_tree::UnaryExpression::Type::PlusSign ||
-           unaryExprType == parse_tree::UnaryExpression::Type::MinusSign);
-
-    auto unaryOpType = node.getUnaryExpressionType() == parse_tree::UnaryExpression::Type::PlusSign ?
-                       ast::UnaryOp::Type::PlusSign : ast::UnaryOp::Type::MinusSign;
-
-    return std::make_unique<ast::UnaryOp>(unaryOpType, std::move(primaryExpr));
-}
-
-std::unique_ptr<ast::Expression> SemanticAnalysis::analyzeExpression(
-    const parse_tree::PrimaryExpression& node)
-// Semantically analyzes a primary-expression.
-{
-    switch (node.getPrimaryExpressionType()) {
-        case parse_tree::PrimaryExpression::Type::Literal:
-            return analyzeExpression(node.getLiteral());
-
-        case parse_tree::PrimaryExpression::Type::Identifier:
-            return analyzeExpression(node.getIdentifier()); // NOLINT
-
-        case parse_tree::PrimaryExpression::Type::Parenthesized:
-            // In the case of a parenthesized primary expression, we are only interested
-            // in the additive-expression. The parenthesis do not matter.
-            return analyzeExpression(node.getAdditiveExpression());
-
-        default:
-            // This case should never be reached since all cases are handled,
-            // but clang-tidy still complains...
-            __builtin_unreachable();
-    }
+    assert(operands.size() == 1);
+    auto result = std::move(operands.back());
+    operands.pop_back();
+    return result;
 }
 
 std::unique_ptr<ast::Expression> SemanticAnalysis::analyzeExpression(
@@ -412,14 +458,26 @@ std::unique_ptr<ast::Expression> SemanticAnalysis::analyzeExpression(
         }
     }
 
-    return std::make_unique<ast::Identifier>(lookUpResult.symbolType, lookUpResult.symbolId);
+    auto identifier = std::make_unique<ast::Identifier>(lookUpResult.symbolType, lookUpResult.symbolId);
+    recordSourceRange(*identifier, node);
+    return identifier;
 }
 
 std::unique_ptr<ast::Expression> SemanticAnalysis::analyzeExpression( // NOLINT
     const parse_tree::Literal& node)
 // Semantically analyzes a literal.
 {
-    return std::make_unique<ast::ConstantLiteral>(node.getValue());
+    auto literal = std::make_unique<ast::ConstantLiteral>(node.getValue());
+    recordSourceRange(*literal, node);
+    return literal;
+}
+
+void SemanticAnalysis::recordSourceRange(ast::ASTNode& node, const parse_tree::ParseTreeNode& parseTreeNode)
+// Records the source range of the AST node, if a node source map is given.
+{
+    if (nodeSourceMap != nullptr) {
+        nodeSourceMap->add(node, parseTreeNode.getReference());
+    }
 }
 
 } // namespace pljit::analysis
@@ -6,6 +6,7 @@
 #include "pljit/common/SourceCodeManagerFwd.h"
 #include "pljit/parse_tree/ParseTreeFwd.h"
 #include <memory>
+#include <memory_resource>
 #include <unordered_set>
 #include <vector>
 
@@ -16,8 +17,13 @@ namespace pljit::analysis {
 class SemanticAnalysis {
     public:
     /// Constructor
+    /// Temporary data structures are allocated from the given memory resource.
+    /// If a node source map is given, the ids of the built AST nodes and their
+    /// source ranges are recorded in it.
     SemanticAnalysis(const common::SourceCodeManager& sourceCodeManager,
-                     SymbolTable& symbolTable);
+                     SymbolTable& symbolTable,
+                     std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource(),
+                     ast::NodeSourceMap* nodeSourceMap = nullptr);
 
     /// Semantically analyzes the parse tree and builds up an AST.
     /// If an error occurs, a nullptr will be returned.
@@ -54,26 +60,45 @@ class SemanticAnalysis {
     /// If an error occurs, a nullptr will be returned.
     std::unique_ptr<ast::Statement> analyzeStatement(const parse_tree::Statement& node);
 
-    /// Semantically analyzes an expression.
+    /// Semantically analyzes an additive-expression including all its nested
+    /// expressions. It does not recurse, thus, the depth of the expression is
+    /// only limited by the available memory.
     /// If an error occurs, a nullptr will be returned.
     std::unique_ptr<ast::Expression> analyzeExpression(const parse_tree::AdditiveExpression& node);
-    std::unique_ptr<ast::Expression> analyzeExpression(const parse_tree::MultiplicativeExpression& node);
-    std::unique_ptr<ast::Expression> analyzeExpression(const parse_tree::UnaryExpression& node);
-    std::unique_ptr<ast::Expression> analyzeExpression(const parse_tree::PrimaryExpression& node);
+
+    /// Semantically analyzes the leaves of an expression.
+    /// If an error occurs, a nullptr will be returned.
     std::unique_ptr<ast::Expression> analyzeExpression(const parse_tree::Identifier& node);
     std::unique_ptr<ast::Expression> analyzeExpression(const parse_tree::Literal& node);
 
+    /// Records the source range of the AST node, if a node source map is given.
+    void recordSourceRange(ast::ASTNode& node, const parse_tree::ParseTreeNode& parseTreeNode);
+
     /// Source code manager
     const common::SourceCodeManager& sourceCodeManager;
 
     /// Symbol table
     SymbolTable& symbolTable;
 
+    /// Map in which the source ranges of the AST nodes are recorded (optional)
+    ast::NodeSourceMap* nodeSourceMap;
+
     /// Flag whether a return statement was found during the analysis.
     bool containsReturnStatement{false};
 
     /// Set which contains the symbol ids of the variables which were already initialized.
-    std::unordered_set<size_t> initializedVariables{};
+    std::pmr::unordered_set<size_t> initializedVariables;
+
+    /// A node on the explicit stack of analyzeExpression().
+    struct PendingNode {
+        const parse_tree::ParseTreeNode* node;
+        /// True if the operands of the node were already analyzed.
+        bool operandsAnalyzed;
+    };
+
+    /// Stacks for analyzing expressions without recursion.
+    std::pmr::vector<PendingNode> pendingNodes;
+    std::pmr::vector<std::unique_ptr<ast::Expression>> operands;
 };
 
 } // namespace pljit::analysis
@@ -9,13 +9,22 @@ constexpr bool SYMBOL_ALREADY_EXISTS = false;
 constexpr bool SYMBOL_NEWLY_INSERTED = true;
 
 std::optional<std::string_view> lookUpString(size_t symbolId,
-                                             const std::vector<std::string_view>& vec)
+                                             const std::pmr::vector<std::string_view>& vec)
 {
     return symbolId < vec.size() ? std::optional(vec[symbolId]) : std::nullopt;
 }
 
 } // namespace
 
+SymbolTable::SymbolTable(std::pmr::memory_resource* memoryResource)
+    : symbolStrToSymbolEntryMapping(memoryResource),
+      parameterIdToStringMapping(memoryResource),
+      variableIdToStringMapping(memoryResource),
+      constantIdToStringMapping(memoryResource),
+      constantValues(memoryResource)
+// Constructor
+{}
+
 SymbolTable::RegistrationResult SymbolTable::registerSymbol(ast::Identifier::Type symbolType,
                                                             common::SourceRangeReference declarationRef,
                                                             int64_t constantValue)
@@ -81,6 +90,12 @@ int64_t SymbolTable::getConstantValue(size_t constantId) const
     return constantValues[constantId];
 }
 
+std::span<const int64_t> SymbolTable::getConstantValues() const
+// Returns the values of all registered constants.
+{
+    return constantValues;
+}
+
 size_t SymbolTable::getNumberOfParameters() const
 // Returns the number of registered parameters.
 {
@@ -93,4 +108,18 @@ size_t SymbolTable::getNumberOfVariables() const
     return variableIdToStringMapping.size();
 }
 
+size_t SymbolTable::getMemoryUsage() const
+// Returns the estimated number of bytes which are occupied by the symbol table.
+{
+    // Every entry of the hash map is stored in its own node.
+    size_t memoryUsage = sizeof(SymbolTable);
+    memoryUsage += symbolStrToSymbolEntryMapping.bucket_count() * sizeof(void*);
+    memoryUsage += symbolStrToSymbolEntryMapping.size() *
+        (sizeof(void*) + sizeof(decltype(symbolStrToSymbolEntryMapping)::value_type));
+    memoryUsage += (parameterIdToStringMapping.capacity() + variableIdToStringMapping.capacity() +
+                    constantIdToStringMapping.capacity()) * sizeof(std::string_view);
+    memoryUsage += constantValues.capacity() * sizeof(int64_t);
+    return memoryUsage;
+}
+
 } // namespace pljit::analysis
@@ -3,7 +3,9 @@
 
 #include "pljit/ast/AST.h"
 #include "pljit/common/References.h"
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
@@ -14,6 +16,9 @@ namespace pljit::analysis {
 /// analysis.
 class SymbolTable {
     public:
+    /// Constructor
+    /// The symbol table allocates its memory from the given memory resource.
+    explicit SymbolTable(std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource());
 
     struct SymbolEntry {
         size_t symbolId;
@@ -47,12 +52,20 @@ class SymbolTable {
     /// Gets the value for a registered constant.
     int64_t getConstantValue(size_t constantId) const;
 
+    /// Returns the values of all registered constants (the index represents
+    /// the symbol id).
+    std::span<const int64_t> getConstantValues() const;
+
     /// Returns the number of registered parameters.
     size_t getNumberOfParameters() const;
 
     /// Returns the number of registered variables.
     size_t getNumberOfVariables() const;
 
+    /// Returns the estimated number of bytes which are occupied by the symbol
+    /// table (without the referenced source code).
+    size_t getMemoryUsage() const;
+
     private:
     /// Indicates the next symbol id for each identifier type.
     size_t nextParameterId{};
@@ -60,16 +73,16 @@ class SymbolTable {
     size_t nextConstantId{};
 
     /// Mapping between a symbol string and the symbol entries.
-    std::unordered_map<std::string_view, SymbolEntry> symbolStrToSymbolEntryMapping{};
+    std::pmr::unordered_map<std::string_view, SymbolEntry> symbolStrToSymbolEntryMapping;
 
     /// Mapping between a symbol id and its symbol string (the index of the
     /// vector represents the symbol id).
-    std::vector<std::string_view> parameterIdToStringMapping{};
-    std::vector<std::string_view> variableIdToStringMapping{};
-    std::vector<std::string_view> constantIdToStringMapping{};
+    std::pmr::vector<std::string_view> parameterIdToStringMapping;
+    std::pmr::vector<std::string_view> variableIdToStringMapping;
+    std::pmr::vector<std::string_view> constantIdToStringMapping;
 
     /// Stores the constant values.
-    std::vector<int64_t> constantValues{};
+    std::pmr::vector<int64_t> constantValues;
 };
 
 } // namespace pljit::analysis
@@ -1,17 +1,178 @@
 #include "AST.h"
-#include "pljit/analysis/SymbolTable.h"
+#include "pljit/common/Diagnostics.h"
+#include "pljit/common/MemoryResource.h"
+#include "pljit/common/Timestamp.h"
 #include "pljit/exec/ExecutionContext.h"
+#include "pljit/exec/ExecutionProfile.h"
 #include <cassert>
-#include <iostream>
 
 namespace pljit::ast {
 
+namespace {
+
+int64_t popOperand(std::vector<int64_t>& operandStack)
+{
+    auto operand = operandStack.back();
+    operandStack.pop_back();
+    return operand;
+}
+
+/// Evaluates an expression. Expressions can be nested arbitrarily deep, hence,
+/// the expression is traversed with an explicit stack instead of recursion.
+/// An operation is visited twice: once before and once after its operands were
+/// evaluated. The values of the evaluated operands are kept on a separate stack.
+/// If profiling, every evaluated node is recorded in the execution profile
+/// together with its inclusive ticks, whose start ticks are kept on a third stack.
+template <bool profiling>
+int64_t evaluateIteratively(const Expression& expression, exec::ExecutionContext& context)
+{
+    auto& pendingExpressions = context.pendingExpressions;
+    auto& operandStack = context.operandStack;
+    auto& startTicks = context.startTicks;
+    assert(pendingExpressions.empty() && operandStack.empty() && startTicks.empty());
+
+    pendingExpressions.push_back({&expression, false});
+    while (!pendingExpressions.empty()) {
+        auto [current, operandsEvaluated] = pendingExpressions.back();
+        pendingExpressions.pop_back();
+        if constexpr (profiling) {
+            if (!operandsEvaluated) {
+                startTicks.push_back(common::readTimestampCounter());
+            }
+        }
+
+        switch (current->getType()) {
+            case ASTNode::Type::ConstantLiteral:
+                operandStack.push_back(static_cast<const ConstantLiteral&>(*current).evaluate(context)); // NOLINT
+                break;
+
+            case ASTNode::Type::Identifier:
+                operandStack.push_back(static_cast<const Identifier&>(*current).evaluate(context)); // NOLINT
+                break;
+
+            case ASTNode::Type::UnaryOp: {
+                const auto& unaryOp = static_cast<const UnaryOp&>(*current); // NOLINT
+                if (!operandsEvaluated) {
+                    pendingExpressions.push_back({current, true});
+                    pendingExpressions.push_back({&unaryOp.getExpression(), false});
+                    break;
+                }
+
+                if (unaryOp.getUnaryOpType() == UnaryOp::Type::MinusSign) {
+                    operandStack.back() = -operandStack.back();
+                } else {
+                    assert(unaryOp.getUnaryOpType() == UnaryOp::Type::PlusSign);
+                }
+                break;
+            }
+
+            case ASTNode::Type::BinaryOp: {
+                const auto& binaryOp = static_cast<const BinaryOp&>(*current); // NOLINT
+                if (!operandsEvaluated) {
+                    // The lhs is evaluated before the rhs.
+                    pendingExpressions.push_back({current, true});
+                    pendingExpressions.push_back({&binaryOp.getRhsExpression(), false});
+                    pendingExpressions.push_back({&binaryOp.getLhsExpression(), false});
+                    break;
+                }
+
+                int64_t rhs = popOperand(operandStack);
+                int64_t lhs = popOperand(operandStack);
+
+                switch (binaryOp.getBinaryOpType()) {
+                    case BinaryOp::Type::Add:
+                        operandStack.push_back(lhs + rhs);
+                        break;
+
+                    case BinaryOp::Type::Sub:
+                        operandStack.push_back(lhs - rhs);
+                        break;
+
+                    case BinaryOp::Type::Mul:
+                        operandStack.push_back(lhs * rhs);
+                        break;
+
+                    case BinaryOp::Type::Div:
+                        if (rhs == 0) {
+                            // Error! Division by zero! We stop the evaluation.
+                            context.error = exec::ExecutionContext::ErrorType::DivisionByZero;
+                            common::getDiagnosticsSink().report({common::Diagnostic::Kind::RuntimeError,
+                                                                 "division by zero"});
+                            pendingExpressions.clear();
+                            operandStack.clear();
+                            startTicks.clear();
+                            return 0;
+                        }
+                        operandStack.push_back(lhs / rhs);
+                        break;
+                }
+                break;
+            }
+
+            default:
+                // This case should never be reached since all expression types are
+                // handled, but clang-tidy still complains...
+                __builtin_unreachable();
+        }
+
+        if constexpr (profiling) {
+            // Operations are evaluated once their operands were evaluated,
+            // leaves are evaluated on their first visit.
+            bool isLeaf = current->getType() == ASTNode::Type::ConstantLiteral ||
+                current->getType() == ASTNode::Type::Identifier;
+            if (operandsEvaluated || isLeaf) {
+                context.profile->record(current->getNodeId(), common::readTimestampCounter() - startTicks.back());
+                startTicks.pop_back();
+            }
+        }
+    }
+
+    assert(operandStack.size() == 1);
+    return popOperand(operandStack);
+}
+
+/// Evaluates the expression of a statement. If profiling, also leaves are
+/// evaluated iteratively, such that they are recorded.
+int64_t evaluateStatementExpression(const Expression& expression, exec::ExecutionContext& context)
+{
+    if (context.profile != nullptr) {
+        return evaluateIteratively<true>(expression, context);
+    }
+    return expression.evaluate(context);
+}
+
+} // namespace
+
 ASTNode::Type ASTNode::getType() const
 // Returns the type of the ASTNode.
 {
     return type;
 }
 
+void* ASTNode::operator new(size_t size)
+// Allocates a node from the node memory resource of the current thread.
+{
+    return common::allocateNode(size);
+}
+
+void ASTNode::operator delete(void* ptr, size_t size)
+// Deallocates a node.
+{
+    common::deallocateNode(ptr, size);
+}
+
+uint32_t ASTNode::getNodeId() const
+// Returns the id of the node.
+{
+    return nodeId;
+}
+
+void ASTNode::setNodeId(uint32_t newNodeId)
+// Sets the id of the node.
+{
+    nodeId = newNodeId;
+}
+
 ASTNode::ASTNode(Type type)
     : type(type)
 // Constructor
@@ -24,10 +185,20 @@ ExecutableNode::ExecutableNode(ASTNode::Type type)
 
 Function::Function(std::vector<std::unique_ptr<Statement>> statements)
     : ExecutableNode(ASTNode::Type::Function),
-      statements(std::move(statements))
+      statements(std::move(statements)),
+      resource(common::getNodeMemoryResource())
 // Constructor
 {}
 
+void Function::operator delete(Function* function, std::destroying_delete_t)
+// Deletes the function and its statements while their node memory resource is active.
+{
+    auto* resource = function->resource;
+    common::MemoryResourceScope scope(resource);
+    function->~Function();
+    common::deallocateNode(function, sizeof(Function));
+}
+
 const std::vector<std::unique_ptr<Statement>>& Function::getStatements() const
 // Returns a const-reference to the statements.
 {
@@ -56,7 +227,13 @@ void Function::execute(exec::ExecutionContext& context) const
 // Execution function.
 {
     for (const auto& stmt : statements) {
-        stmt->execute(context);
+        if (context.profile != nullptr) {
+            auto startTicks = common::readTimestampCounter();
+            stmt->execute(context);
+            context.profile->record(stmt->getNodeId(), common::readTimestampCounter() - startTicks);
+        } else {
+            stmt->execute(context);
+        }
         // Did an error occur?
         if (context.hasError()) {
             // Yes! Hence, stop the execution!
@@ -129,7 +306,7 @@ void AssignmentStatement::accept(ASTVisitor& visitor)
 void AssignmentStatement::execute(exec::ExecutionContext& context) const
 // Execution function.
 {
-    int64_t result = expression->evaluate(context);
+    int64_t result = evaluateStatementExpression(*expression, context);
     if (!context.hasError()) {
         // If no error occurred, we update the value of the assignment
         // target.
@@ -162,7 +339,7 @@ void ReturnStatement::accept(ASTVisitor& visitor)
 void ReturnStatement::execute(exec::ExecutionContext& context) const
 // Execution function.
 {
-    int64_t result = expression->evaluate(context);
+    int64_t result = evaluateStatementExpression(*expression, context);
     if (!context.hasError()) {
         // If no error occurred, we update the return value.
         context.returnValue = result;
@@ -174,6 +351,24 @@ Expression::Expression(Type type)
 // Constructor
 {}
 
+void Expression::destroyIteratively(std::vector<std::unique_ptr<Expression>> pendingExpressions)
+// Destroys the given expressions without recursion.
+{
+    while (!pendingExpressions.empty()) {
+        auto expression = std::move(pendingExpressions.back());
+        pendingExpressions.pop_back();
+        if (expression != nullptr) {
+            // Detach the children, such that the expression is destroyed
+            // without any children left.
+            expression->releaseChildren(pendingExpressions);
+        }
+    }
+}
+
+void Expression::releaseChildren(std::vector<std::unique_ptr<Expression>>& /*children*/)
+// Moves the child expressions of the node into the given vector.
+{}
+
 ConstantLiteral::ConstantLiteral(int64_t value)
     : Expression(ASTNode::Type::ConstantLiteral),
       value(value)
@@ -246,7 +441,7 @@ int64_t Identifier::evaluate(exec::ExecutionContext& context) const
             return context.variableValues[id];
 
         case Type::Constant:
-            return context.symbolTable.getConstantValue(id);
+            return context.constantValues[id];
 
         default:
             // This case should never be reached since all cases are handled,
@@ -262,6 +457,16 @@ UnaryOp::UnaryOp(Type unaryOpType, std::unique_ptr<Expression> expression)
 // Constructor
 {}
 
+UnaryOp::~UnaryOp()
+// Destructor
+{
+    if (expression != nullptr) {
+        std::vector<std::unique_ptr<Expression>> children;
+        children.push_back(std::move(expression));
+        destroyIteratively(std::move(children));
+    }
+}
+
 UnaryOp::Type UnaryOp::getUnaryOpType() const
 // Returns the type of the UnaryOp.
 {
@@ -297,18 +502,16 @@ void UnaryOp::accept(ASTVisitor& visitor)
 int64_t UnaryOp::evaluate(exec::ExecutionContext& context) const
 // Function which evaluates an expression.
 {
-    auto result = expression->evaluate(context);
-    if (context.hasError()) {
-        // An error occurred, hence, we stop.
-        return 0;
-    }
-
-    if (unaryOpType == Type::MinusSign) {
-        return -result;
+    if (context.profile != nullptr) {
+        return evaluateIteratively<true>(*this, context);
     }
+    return evaluateIteratively<false>(*this, context);
+}
 
-    assert(unaryOpType == Type::PlusSign);
-    return result;
+void UnaryOp::releaseChildren(std::vector<std::unique_ptr<Expression>>& children)
+// Moves the child expression into the given vector.
+{
+    children.push_back(std::move(expression));
 }
 
 BinaryOp::BinaryOp(std::unique_ptr<Expression> lhsExpression,
@@ -321,6 +524,17 @@ BinaryOp::BinaryOp(std::unique_ptr<Expression> lhsExpression,
 // Constructor
 {}
 
+BinaryOp::~BinaryOp()
+// Destructor
+{
+    if (lhsExpression != nullptr || rhsExpression != nullptr) {
+        std::vector<std::unique_ptr<Expression>> children;
+        children.push_back(std::move(lhsExpression));
+        children.push_back(std::move(rhsExpression));
+        destroyIteratively(std::move(children));
+    }
+}
+
 BinaryOp::Type BinaryOp::getBinaryOpType() const
 // Returns the type of BinaryOp.
 {
@@ -382,42 +596,17 @@ void BinaryOp::accept(ASTVisitor& visitor)
 int64_t BinaryOp::evaluate(exec::ExecutionContext& context) const
 // Function which evaluates an expression.
 {
-    int64_t lhs = lhsExpression->evaluate(context);
-    if (context.hasError()) {
-        // An error occurred, hence, we stop.
-        return 0;
+    if (context.profile != nullptr) {
+        return evaluateIteratively<true>(*this, context);
     }
+    return evaluateIteratively<false>(*this, context);
+}
 
-    int64_t rhs = rhsExpression->evaluate(context);
-    if (context.hasError()) {
-        // An error occurred, hence, we stop.
-        return 0;
-    }
-
-    switch (binaryOpType) {
-        case Type::Add:
-            return lhs + rhs;
-
-        case Type::Sub:
-            return lhs - rhs;
-
-        case Type::Mul:
-            return lhs * rhs;
-
-        case Type::Div:
-            if (rhs == 0) {
-                // Error! Division by zero!
-                context.error = exec::ExecutionContext::ErrorType::DivisionByZero;
-                std::cout << "error: division by zero" << std::endl;
-                return 0;
-            }
-            return lhs / rhs;
-
-        default:
-            // This case should never be reached since all cases are handled,
-            // but clang-tidy still complains...
-            __builtin_unreachable();
-    }
+void BinaryOp::releaseChildren(std::vector<std::unique_ptr<Expression>>& children)
+// Moves the child expressions into the given vector.
+{
+    children.push_back(std::move(lhsExpression));
+    children.push_back(std::move(rhsExpression));
 }
 
 } // namespace pljit::ast
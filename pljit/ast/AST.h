@@ -4,7 +4,10 @@
 #include "pljit/ast/ASTFwd.h"
 #include "pljit/ast/ASTVisitor.h"
 #include "pljit/exec/ExecutionContextFwd.h"
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <vector>
 
 namespace pljit::ast {
@@ -30,9 +33,22 @@ class ASTNode {
     /// Destructor
     virtual ~ASTNode() = default;
 
+    /// Nodes are allocated from the node memory resource of the current thread
+    /// (see common::MemoryResourceScope) and must be deleted while that resource
+    /// is active. The Function at the root of the tree takes care of this.
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     /// Returns the type of the ASTNode.
     Type getType() const;
 
+    /// Returns the id of the node, which identifies the node in side tables
+    /// (see NodeSourceMap). Zero if no id was assigned.
+    uint32_t getNodeId() const;
+
+    /// Sets the id of the node.
+    void setNodeId(uint32_t newNodeId);
+
     /// Accept function for applying the visitor pattern on the AST.
     virtual void accept(ASTConstVisitor& visitor) const = 0;
     virtual void accept(ASTVisitor& visitor) = 0;
@@ -43,6 +59,8 @@ class ASTNode {
 
     private:
     Type type;
+    /// Id of the node (fits into the padding after the type)
+    uint32_t nodeId{0};
 };
 
 class ExecutableNode : public ASTNode {
@@ -58,7 +76,7 @@ class ExecutableNode : public ASTNode {
     explicit ExecutableNode(ASTNode::Type type);
 };
 
-class Function : public ExecutableNode {
+class Function final : public ExecutableNode {
     public:
     /// Constructor
     explicit Function(std::vector<std::unique_ptr<Statement>> statements);
@@ -66,6 +84,10 @@ class Function : public ExecutableNode {
     /// Destructor
     ~Function() override = default;
 
+    /// Deletes the function and its statements while the node memory resource
+    /// from which they were allocated is active.
+    static void operator delete(Function* function, std::destroying_delete_t);
+
     /// Returns a const-reference to the statements.
     const std::vector<std::unique_ptr<Statement>>& getStatements() const;
 
@@ -81,6 +103,8 @@ class Function : public ExecutableNode {
 
     private:
     std::vector<std::unique_ptr<Statement>> statements;
+    /// The node memory resource of the whole tree
+    std::pmr::memory_resource* resource;
 };
 
 class Statement : public ExecutableNode {
@@ -152,6 +176,15 @@ class Expression : public ASTNode {
     protected:
     /// Constructor
     explicit Expression(Type type);
+
+    /// Destroys the given expressions. Expressions can be nested arbitrarily
+    /// deep, hence, the subtrees are taken apart iteratively instead of being
+    /// destroyed recursively by the destructors of their nodes.
+    static void destroyIteratively(std::vector<std::unique_ptr<Expression>> pendingExpressions);
+
+    private:
+    /// Moves the child expressions of the node into the given vector.
+    virtual void releaseChildren(std::vector<std::unique_ptr<Expression>>& children);
 };
 
 class ConstantLiteral : public Expression {
@@ -221,7 +254,7 @@ class UnaryOp : public Expression {
     UnaryOp(Type unaryOpType, std::unique_ptr<Expression> expression);
 
     /// Destructor
-    ~UnaryOp() override = default;
+    ~UnaryOp() override;
 
     /// Returns the type of UnaryOp.
     Type getUnaryOpType() const;
@@ -238,6 +271,9 @@ class UnaryOp : public Expression {
     int64_t evaluate(exec::ExecutionContext& context) const final;
 
     private:
+    /// Moves the child expression into the given vector.
+    void releaseChildren(std::vector<std::unique_ptr<Expression>>& children) final;
+
     Type unaryOpType;
     std::unique_ptr<Expression> expression;
 };
@@ -258,7 +294,7 @@ class BinaryOp : public Expression {
              std::unique_ptr<Expression> rhsExpression);
 
     /// Destructor
-    ~BinaryOp() override = default;
+    ~BinaryOp() override;
 
     /// Returns the type of BinaryOp.
     Type getBinaryOpType() const;
@@ -285,6 +321,9 @@ class BinaryOp : public Expression {
     int64_t evaluate(exec::ExecutionContext& context) const final;
 
     private:
+    /// Moves the child expressions into the given vector.
+    void releaseChildren(std::vector<std::unique_ptr<Expression>>& children) final;
+
     Type binaryOpType;
     std::unique_ptr<Expression> lhsExpression;
     std::unique_ptr<Expression> rhsExpression;
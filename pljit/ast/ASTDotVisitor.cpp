@@ -1,64 +1,60 @@
 #include "ASTDotVisitor.h"
 #include "pljit/analysis/SymbolTable.h"
 #include "pljit/ast/AST.h"
+#include "pljit/exec/ExecutionProfile.h"
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdio>
 
 namespace pljit::ast {
 
-ASTDotVisitor::ASTDotVisitor(std::ostream& out, const analysis::SymbolTable& symbolTable)
+ASTDotVisitor::ASTDotVisitor(std::ostream& out,
+                             const analysis::SymbolTable& symbolTable,
+                             const exec::ExecutionProfile* executionProfile)
     : out(out),
-      symbolTable(symbolTable)
+      symbolTable(symbolTable),
+      executionProfile(executionProfile),
+      totalTicks(executionProfile != nullptr ? executionProfile->getTotalTicks() : 0)
 // Constructor
 {}
 
 void ASTDotVisitor::visit(const Function& node)
 {
     unsigned myLabelId = labels.size();
-    labels.emplace_back("Function");
-
-    ++currentDepth;
+    addLabel(node, "Function");
 
     for (const auto& stmt : node.getStatements()) {
         handleNextVisit(myLabelId, *stmt);
     }
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
 void ASTDotVisitor::visit(const AssignmentStatement& node)
 {
     unsigned myLabelId = labels.size();
-    labels.emplace_back(":=");
-
-    ++currentDepth;
+    addLabel(node, ":=");
 
     handleNextVisit(myLabelId, node.getAssignmentTarget());
     handleNextVisit(myLabelId, node.getExpression());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
 void ASTDotVisitor::visit(const ReturnStatement& node)
 {
     unsigned myLabelId = labels.size();
-    labels.emplace_back("RETURN");
-
-    ++currentDepth;
+    addLabel(node, "RETURN");
 
     handleNextVisit(myLabelId, node.getExpression());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
 void ASTDotVisitor::visit(const ConstantLiteral& node)
 {
-    labels.emplace_back(std::to_string(node.getValue()));
+    addLabel(node, std::to_string(node.getValue()));
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -70,10 +66,10 @@ void ASTDotVisitor::visit(const Identifier& node)
     auto symbolName = symbolNameOpt.value();
     if (node.getIdentifierType() == Identifier::Type::Constant) {
         int64_t constValue = symbolTable.getConstantValue(node.getId());
-        labels.emplace_back(std::string{symbolName} +
+        addLabel(node, std::string{symbolName} +
                             ": " + std::to_string(constValue));
     } else {
-        labels.emplace_back(symbolName);
+        addLabel(node, std::string{symbolName});
     }
     printDotGraphIfStartingNodeIsReachedAgain();
 }
@@ -83,20 +79,16 @@ void ASTDotVisitor::visit(const UnaryOp& node)
     unsigned myLabelId = labels.size();
     switch (node.getUnaryOpType()) {
         case UnaryOp::Type::PlusSign:
-            labels.emplace_back("+");
+            addLabel(node, "+");
             break;
 
         case UnaryOp::Type::MinusSign:
-            labels.emplace_back("-");
+            addLabel(node, "-");
             break;
     }
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getExpression());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -105,32 +97,49 @@ void ASTDotVisitor::visit(const BinaryOp& node)
     unsigned myLabelId = labels.size();
     switch (node.getBinaryOpType()) {
         case BinaryOp::Type::Add:
-            labels.emplace_back("+");
+            addLabel(node, "+");
             break;
 
         case BinaryOp::Type::Sub:
-            labels.emplace_back("-");
+            addLabel(node, "-");
             break;
 
         case BinaryOp::Type::Mul:
-            labels.emplace_back("*");
+            addLabel(node, "*");
             break;
 
         case BinaryOp::Type::Div:
-            labels.emplace_back("/");
+            addLabel(node, "/");
             break;
     }
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getLhsExpression());
     handleNextVisit(myLabelId, node.getRhsExpression());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
+void ASTDotVisitor::addLabel(const ASTNode& node, std::string label)
+// Adds the label of a node.
+{
+    if (executionProfile == nullptr || node.getNodeId() == 0) {
+        labels.push_back(std::move(label));
+        attributes.emplace_back();
+        return;
+    }
+
+    // The saturation of the fill color represents the share of the ticks.
+    auto nodeProfile = executionProfile->getNodeProfile(node.getNodeId());
+    double share = totalTicks == 0 ? 0.0 :
+        std::min(1.0, static_cast<double>(nodeProfile.ticks) / static_cast<double>(totalTicks));
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer), "\\n%llux %.2f%%", static_cast<unsigned long long>(nodeProfile.executions),
+                  100.0 * share);
+    labels.push_back(std::move(label) + buffer);
+    std::snprintf(buffer, sizeof(buffer), ", style=filled, fillcolor=\"0.000 %.3f 1.000\"", share);
+    attributes.emplace_back(buffer);
+}
+
 void ASTDotVisitor::addEdgeToNextNode(unsigned int currentLabelId)
 // Add a new edge from the current node to the next unvisited node.
 {
@@ -140,23 +149,38 @@ void ASTDotVisitor::addEdgeToNextNode(unsigned int currentLabelId)
 
 void ASTDotVisitor::handleNextVisit(unsigned int currentLabelId,
                                     const ASTNode& node)
-// Handles the next visit, i.e. adding a new edge and visiting the next node.
+// Schedules the visit of a child node.
 {
-    addEdgeToNextNode(currentLabelId);
-    node.accept(*this);
+    pendingVisits.push_back({currentLabelId, &node});
 }
 
 void ASTDotVisitor::printDotGraphIfStartingNodeIsReachedAgain()
-// Prints the DOT graph if currentDepth == 0.
+// Visits the scheduled nodes and prints the DOT graph if the starting node is reached again.
 {
-    if (currentDepth != 0) {
+    if (traversing) {
         return;
     }
 
+    // The nodes are visited with an explicit stack instead of recursively,
+    // such that deep expressions do not overflow the stack. The children of
+    // a node are scheduled in order, hence, they are reversed on the stack to
+    // keep the pre-order numbering of the labels.
+    traversing = true;
+    std::reverse(pendingVisits.begin(), pendingVisits.end());
+    while (!pendingVisits.empty()) {
+        auto [currentLabelId, node] = pendingVisits.back();
+        pendingVisits.pop_back();
+        addEdgeToNextNode(currentLabelId);
+        auto numberOfPendingVisits = pendingVisits.size();
+        node->accept(*this);
+        std::reverse(pendingVisits.begin() + static_cast<std::ptrdiff_t>(numberOfPendingVisits), pendingVisits.end());
+    }
+    traversing = false;
+
     out << "digraph {\n";
     // Print the labels.
     for (unsigned i = 0; i < labels.size(); ++i) {
-        out << "\t" << i << " [label=\"" << labels[i] << "\"];\n";
+        out << "\t" << i << " [label=\"" << labels[i] << "\"" << attributes[i] << "];\n";
     }
     // Print the edges.
     for (const auto [from, to] : edges) {
@@ -166,6 +190,7 @@ void ASTDotVisitor::printDotGraphIfStartingNodeIsReachedAgain()
 
     // We make the visitor re-usable.
     labels.clear();
+    attributes.clear();
     edges.clear();
 }
 
@@ -3,7 +3,10 @@
 
 #include "pljit/analysis/SymbolTableFwd.h"
 #include "pljit/ast/ASTVisitor.h"
+#include "pljit/exec/ExecutionProfileFwd.h"
+#include <cstdint>
 #include <ostream>
+#include <string>
 #include <vector>
 
 namespace pljit::ast {
@@ -11,7 +14,11 @@ namespace pljit::ast {
 class ASTDotVisitor : public ASTConstVisitor {
     public:
     /// Constructor
-    ASTDotVisitor(std::ostream& out, const analysis::SymbolTable& symbolTable);
+    /// If an execution profile is given, the nodes are labeled with their
+    /// executions and share of the ticks and filled with a heat color.
+    ASTDotVisitor(std::ostream& out,
+                  const analysis::SymbolTable& symbolTable,
+                  const exec::ExecutionProfile* executionProfile = nullptr);
 
     /// Destructor
     ~ASTDotVisitor() override = default;
@@ -39,26 +46,46 @@ class ASTDotVisitor : public ASTConstVisitor {
     /// id will be labels.size(). This function stores the edges.
     void addEdgeToNextNode(unsigned currentLabelId);
 
-    /// Handles the next visit, i.e. adding a new edge and visiting the next node.
+    /// Adds the label of a node, which is annotated with the profile of the
+    /// node if an execution profile is given.
+    void addLabel(const ASTNode& node, std::string label);
+
+    /// Handles the next visit, i.e. schedules the visit of a child node, which
+    /// adds a new edge and visits the node.
     void handleNextVisit(unsigned currentLabelId, const ASTNode& node);
 
-    /// This function prints the collected information about the tree
-    /// in the DOT format if currentDepth == 0. This implies that
-    /// the starting node is reached
+    /// If the starting node is reached again, this function visits the
+    /// scheduled nodes and prints the collected information about the tree
+    /// in the DOT format.
     void printDotGraphIfStartingNodeIsReachedAgain();
 
     std::ostream& out;
 
     const analysis::SymbolTable& symbolTable;
 
-    /// Indicates the current depth of the parse tree. This is needed
-    /// in order to know when we reached the starting node again. This
-    /// needs to be known for printing the DOT format.
-    unsigned currentDepth{};
+    /// Execution profile (optional)
+    const exec::ExecutionProfile* executionProfile;
+    /// Total ticks of the profile, which are summed up once for all nodes
+    uint64_t totalTicks;
+
+    /// Whether the scheduled nodes are being visited, i.e. whether the
+    /// current node is not the starting node. This ensures that also subtrees
+    /// can be printed.
+    bool traversing{false};
+
+    /// Scheduled visits of child nodes
+    struct PendingVisit {
+        unsigned parentLabelId;
+        const ASTNode* node;
+    };
+    std::vector<PendingVisit> pendingVisits;
 
     /// Vector of labels
     std::vector<std::string> labels;
 
+    /// Vector of additional attributes of the labels
+    std::vector<std::string> attributes;
+
     struct Edge {
         unsigned from{};
         unsigned to{};
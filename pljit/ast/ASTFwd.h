@@ -14,6 +14,7 @@ class ConstantLiteral;
 class Identifier;
 class UnaryOp;
 class BinaryOp;
+class NodeSourceMap;
 
 } // namespace pljit::ast
 
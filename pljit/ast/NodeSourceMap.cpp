@@ -0,0 +1,36 @@
+#include "NodeSourceMap.h"
+#include <cassert>
+
+namespace pljit::ast {
+
+NodeSourceMap::NodeSourceMap(std::string_view sourceCode)
+    : sourceCode(sourceCode)
+// Constructor
+{}
+
+uint32_t NodeSourceMap::add(ASTNode& node, std::string_view range)
+// Assigns the next id to the node and records its range of the source code.
+{
+    assert(range.data() >= sourceCode.data() &&
+           range.data() + range.size() <= sourceCode.data() + sourceCode.size());
+    auto offset = static_cast<uint32_t>(range.data() - sourceCode.data());
+    entries.push_back({node.getType(), offset, static_cast<uint32_t>(range.size())});
+    auto nodeId = static_cast<uint32_t>(entries.size());
+    node.setNodeId(nodeId);
+    return nodeId;
+}
+
+size_t NodeSourceMap::size() const
+// Returns the number of ids which were assigned.
+{
+    return entries.size();
+}
+
+const NodeSourceMap::Entry& NodeSourceMap::getEntry(uint32_t nodeId) const
+// Returns the entry of a node id.
+{
+    assert(nodeId > 0 && nodeId <= entries.size());
+    return entries[nodeId - 1];
+}
+
+} // namespace pljit::ast
@@ -0,0 +1,53 @@
+#ifndef H_ast_NodeSourceMap
+#define H_ast_NodeSourceMap
+
+#include "pljit/ast/AST.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace pljit::ast {
+
+/// A side table which maps the ids of AST nodes to the ranges of the source
+/// code from which they were built. The ids are assigned sequentially starting
+/// at one, such that they can be used as indexes into other side tables (see
+/// exec::ExecutionProfile). The AST nodes only store their id.
+class NodeSourceMap {
+    public:
+    /// The source range of an AST node.
+    struct Entry {
+        /// Type of the node
+        ASTNode::Type type;
+        /// Offset of the range in the source code
+        uint32_t offset;
+        /// Length of the range
+        uint32_t length;
+    };
+
+    /// Constructor
+    /// Note: The source code is only accessed by add(), i.e. the map can
+    ///       outlive it.
+    explicit NodeSourceMap(std::string_view sourceCode);
+
+    /// Assigns the next id to the node and records the given range of the source
+    /// code, which must be a part of the source code of the map.
+    /// Returns the assigned id.
+    uint32_t add(ASTNode& node, std::string_view range);
+
+    /// Returns the number of ids which were assigned.
+    size_t size() const;
+
+    /// Returns the entry of a node id, which must be valid.
+    const Entry& getEntry(uint32_t nodeId) const;
+
+    private:
+    /// Source code which the ranges refer to
+    std::string_view sourceCode;
+
+    /// Entries (the index plus one represents the node id)
+    std::vector<Entry> entries;
+};
+
+} // namespace pljit::ast
+
+#endif
@@ -0,0 +1,73 @@
+#include "AsyncDiagnosticsSink.h"
+#include <cassert>
+
+namespace pljit::common {
+
+AsyncDiagnosticsSink::AsyncDiagnosticsSink(std::shared_ptr<DiagnosticsSink> target, size_t capacity)
+    : target(std::move(target)),
+      capacity(capacity)
+// Constructor
+{
+    assert(this->target != nullptr);
+    thread = std::thread([this]() { run(); });
+}
+
+AsyncDiagnosticsSink::~AsyncDiagnosticsSink()
+// Destructor
+{
+    {
+        std::unique_lock lck(mutex);
+        stopped = true;
+    }
+    diagnosticsAvailable.notify_one();
+    thread.join();
+}
+
+void AsyncDiagnosticsSink::report(const Diagnostic& diagnostic)
+// Enqueues a diagnostic.
+{
+    {
+        std::unique_lock lck(mutex);
+        if (queue.size() >= capacity) {
+            numberOfDroppedDiagnostics.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        queue.push_back(diagnostic);
+    }
+    diagnosticsAvailable.notify_one();
+}
+
+void AsyncDiagnosticsSink::flush()
+// Blocks until all queued diagnostics were forwarded.
+{
+    std::unique_lock lck(mutex);
+    queueDrained.wait(lck, [this]() { return queue.empty() && !forwarding; });
+}
+
+void AsyncDiagnosticsSink::run()
+// Main loop of the background thread.
+{
+    std::unique_lock lck(mutex);
+    while (true) {
+        diagnosticsAvailable.wait(lck, [this]() { return stopped || !queue.empty(); });
+        if (queue.empty()) {
+            // Stopped and drained
+            return;
+        }
+
+        // The target is called without holding the lock, such that reporting
+        // threads do not wait for it.
+        auto diagnostic = std::move(queue.front());
+        queue.pop_front();
+        forwarding = true;
+        lck.unlock();
+        target->report(diagnostic);
+        lck.lock();
+        forwarding = false;
+        if (queue.empty()) {
+            queueDrained.notify_all();
+        }
+    }
+}
+
+} // namespace pljit::common
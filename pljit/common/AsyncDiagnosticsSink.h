@@ -0,0 +1,67 @@
+#ifndef H_common_AsyncDiagnosticsSink
+#define H_common_AsyncDiagnosticsSink
+
+#include "pljit/common/Diagnostics.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace pljit::common {
+
+/// Forwards the diagnostics to another sink on a background thread. Reporting
+/// threads only enqueue the diagnostic, i.e. they never wait for the output
+/// of a slow sink. If the queue is full, the diagnostic is dropped, such that
+/// a burst of errors cannot pile up unbounded memory.
+class AsyncDiagnosticsSink : public DiagnosticsSink {
+    public:
+    /// Constructor
+    AsyncDiagnosticsSink(std::shared_ptr<DiagnosticsSink> target, size_t capacity = 1024);
+
+    /// Destructor
+    /// Note: The queued diagnostics are forwarded before the thread stops.
+    ~AsyncDiagnosticsSink() override;
+
+    /// Copy constructor/assignment
+    AsyncDiagnosticsSink(const AsyncDiagnosticsSink& other) = delete;
+    AsyncDiagnosticsSink& operator=(const AsyncDiagnosticsSink& other) = delete;
+
+    /// Enqueues a diagnostic.
+    /// Note: This function is thread-safe.
+    void report(const Diagnostic& diagnostic) override;
+
+    /// Blocks until all queued diagnostics were forwarded.
+    /// Note: This function is thread-safe.
+    void flush();
+
+    /// Returns the number of diagnostics which were dropped.
+    uint64_t getNumberOfDroppedDiagnostics() const { return numberOfDroppedDiagnostics.load(); }
+
+    private:
+    /// Main loop of the background thread.
+    void run();
+
+    std::shared_ptr<DiagnosticsSink> target;
+    const size_t capacity;
+
+    std::mutex mutex;
+    /// Signaled when a diagnostic is enqueued or the sink is stopped
+    std::condition_variable diagnosticsAvailable;
+    /// Signaled when the queue was drained
+    std::condition_variable queueDrained;
+    std::deque<Diagnostic> queue;
+    /// Whether the background thread is forwarding a diagnostic
+    bool forwarding{false};
+    bool stopped{false};
+
+    std::atomic<uint64_t> numberOfDroppedDiagnostics{0};
+
+    std::thread thread;
+};
+
+} // namespace pljit::common
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef H_common_ConcurrentArena
+#define H_common_ConcurrentArena
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace pljit::common {
+
+/// An append-only container whose elements have stable addresses. Elements can
+/// be appended concurrently without a lock, while other threads use the
+/// previously appended elements. The storage consists of segments which double
+/// in size, hence, existing elements are never moved.
+template <typename T>
+class ConcurrentArena {
+    public:
+    /// Constructor
+    ConcurrentArena() = default;
+
+    /// Destructor
+    /// Note: Must not run concurrently to any other member function.
+    ~ConcurrentArena();
+
+    /// Copy constructor/assignment
+    ConcurrentArena(const ConcurrentArena& other) = delete;
+    ConcurrentArena& operator=(const ConcurrentArena& other) = delete;
+
+    /// Constructs a new element and returns a pointer to it, which stays valid
+    /// until the arena is destroyed.
+    /// Note: This function is thread-safe.
+    template <typename... Args>
+    T* emplace(Args&&... args);
+
+    /// Calls the function for every element which was completely constructed.
+    /// Note: This function is thread-safe. Elements appended concurrently
+    ///       might not be visited.
+    template <typename Function>
+    void forEach(Function&& function);
+
+    private:
+    struct Slot {
+        alignas(T) std::byte storage[sizeof(T)];
+        /// Set after the element was constructed.
+        std::atomic<bool> constructed{false};
+
+        T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    /// Size of the first segment, the size of each following segment doubles.
+    static constexpr size_t firstSegmentSize = 64;
+    /// Maximum number of segments (more than enough for any index).
+    static constexpr size_t maxNumberOfSegments = 48;
+
+    /// Returns the size of the segment with the given index.
+    static constexpr size_t getSegmentSize(size_t segmentIndex) { return firstSegmentSize << segmentIndex; }
+
+    /// Returns the segment index and the offset within the segment for an element index.
+    static std::pair<size_t, size_t> locate(size_t index);
+
+    /// Returns the segment with the given index and allocates it if necessary.
+    Slot* getSegment(size_t segmentIndex);
+
+    /// Index of the next element.
+    std::atomic<size_t> nextIndex{0};
+    /// Segments, allocated on first use.
+    std::array<std::atomic<Slot*>, maxNumberOfSegments> segments{};
+};
+
+template <typename T>
+ConcurrentArena<T>::~ConcurrentArena()
+// Destructor
+{
+    for (size_t segmentIndex = 0; segmentIndex < maxNumberOfSegments; ++segmentIndex) {
+        auto* segment = segments[segmentIndex].load(std::memory_order_acquire);
+        if (segment == nullptr) {
+            continue;
+        }
+        for (size_t offset = 0; offset < getSegmentSize(segmentIndex); ++offset) {
+            if (segment[offset].constructed.load(std::memory_order_acquire)) {
+                std::destroy_at(segment[offset].get());
+            }
+        }
+        delete[] segment;
+    }
+}
+
+template <typename T>
+template <typename... Args>
+T* ConcurrentArena<T>::emplace(Args&&... args)
+// Constructs a new element.
+{
+    auto [segmentIndex, offset] = locate(nextIndex.fetch_add(1, std::memory_order_relaxed));
+    auto& slot = getSegment(segmentIndex)[offset];
+    auto* element = std::construct_at(reinterpret_cast<T*>(slot.storage), std::forward<Args>(args)...);
+    slot.constructed.store(true, std::memory_order_release);
+    return element;
+}
+
+template <typename T>
+template <typename Function>
+void ConcurrentArena<T>::forEach(Function&& function)
+// Calls the function for every element which was completely constructed.
+{
+    auto [lastSegmentIndex, lastOffset] = locate(nextIndex.load(std::memory_order_acquire));
+    for (size_t segmentIndex = 0; segmentIndex <= lastSegmentIndex; ++segmentIndex) {
+        auto* segment = segments[segmentIndex].load(std::memory_order_acquire);
+        if (segment == nullptr) {
+            continue;
+        }
+        size_t segmentEnd = segmentIndex == lastSegmentIndex ? lastOffset : getSegmentSize(segmentIndex);
+        for (size_t offset = 0; offset < segmentEnd; ++offset) {
+            if (segment[offset].constructed.load(std::memory_order_acquire)) {
+                function(*segment[offset].get());
+            }
+        }
+    }
+}
+
+template <typename T>
+std::pair<size_t, size_t> ConcurrentArena<T>::locate(size_t index)
+// Returns the segment index and the offset within the segment.
+{
+    // The segment k starts at the index firstSegmentSize * (2^k - 1).
+    size_t segmentIndex = std::bit_width(index / firstSegmentSize + 1) - 1;
+    size_t segmentStart = firstSegmentSize * ((size_t{1} << segmentIndex) - 1);
+    return {segmentIndex, index - segmentStart};
+}
+
+template <typename T>
+typename ConcurrentArena<T>::Slot* ConcurrentArena<T>::getSegment(size_t segmentIndex)
+// Returns the segment with the given index.
+{
+    auto* segment = segments[segmentIndex].load(std::memory_order_acquire);
+    if (segment != nullptr) {
+        return segment;
+    }
+
+    // Allocate the segment. If another thread was faster, we use its segment.
+    auto* newSegment = new Slot[getSegmentSize(segmentIndex)];
+    if (segments[segmentIndex].compare_exchange_strong(segment, newSegment, std::memory_order_acq_rel)) {
+        return newSegment;
+    }
+    delete[] newSegment;
+    return segment;
+}
+
+} // namespace pljit::common
+
+#endif
@@ -0,0 +1,91 @@
+#include "Diagnostics.h"
+#include <iomanip>
+#include <sstream>
+
+namespace pljit::common {
+
+namespace {
+
+thread_local DiagnosticsSink* diagnosticsSink = nullptr;
+
+std::string_view getPrefix(Diagnostic::Kind kind)
+{
+    return kind == Diagnostic::Kind::Note ? "note: " : "error: ";
+}
+
+} // namespace
+
+std::string Diagnostic::format() const
+// Returns the diagnostic formatted for the console.
+{
+    std::ostringstream out;
+    if (line == 0) {
+        out << getPrefix(kind) << message << "\n";
+        return std::move(out).str();
+    }
+
+    // Print the first line containing some meta information and the message.
+    out << line << ":" << column << ": " << getPrefix(kind) << message << "\n";
+
+    // Print the actual line, i.e. the context.
+    out << sourceLine << "\n";
+
+    // Underline the referenced section.
+    out << std::setw(static_cast<int>(column))
+        << "^"
+        << std::setfill('~')
+        << std::setw(static_cast<int>(length))
+        << "\n";
+    return std::move(out).str();
+}
+
+StreamDiagnosticsSink::StreamDiagnosticsSink(std::ostream& stream)
+    : stream(stream)
+// Constructor
+{}
+
+void StreamDiagnosticsSink::report(const Diagnostic& diagnostic)
+// Prints a diagnostic to the stream.
+{
+    // The diagnostic is written at once, such that concurrent diagnostics are
+    // not interleaved.
+    stream << diagnostic.format();
+}
+
+void RecordingDiagnosticsSink::report(const Diagnostic& diagnostic)
+// Records a diagnostic.
+{
+    std::unique_lock lck(mutex);
+    diagnostics.push_back(diagnostic);
+}
+
+std::vector<Diagnostic> RecordingDiagnosticsSink::getDiagnostics() const
+// Returns the recorded diagnostics.
+{
+    std::unique_lock lck(mutex);
+    return diagnostics;
+}
+
+DiagnosticsSink& getDiagnosticsSink()
+// Returns the sink for the diagnostics on the current thread.
+{
+    static NullDiagnosticsSink nullSink;
+    return diagnosticsSink != nullptr ? *diagnosticsSink : nullSink;
+}
+
+DiagnosticsSinkScope::DiagnosticsSinkScope(DiagnosticsSink* sink)
+    : previousSink(diagnosticsSink)
+// Constructor
+{
+    if (sink != nullptr) {
+        diagnosticsSink = sink;
+    }
+}
+
+DiagnosticsSinkScope::~DiagnosticsSinkScope()
+// Destructor
+{
+    diagnosticsSink = previousSink;
+}
+
+} // namespace pljit::common
@@ -0,0 +1,119 @@
+#ifndef H_common_Diagnostics
+#define H_common_Diagnostics
+
+#include "pljit/common/DiagnosticsFwd.h"
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace pljit::common {
+
+/// A compile error or runtime error.
+struct Diagnostic {
+    enum class Kind {
+        /// The function does not compile
+        CompileError,
+        /// Additional information about the preceding compile error
+        Note,
+        /// The execution of the function failed
+        RuntimeError,
+        /// The function was called incorrectly
+        InvalidCall
+    };
+
+    Kind kind;
+    /// The message without the "error: " or "note: " prefix
+    std::string message;
+    /// Line and column (starting at 1) and length of the referenced source
+    /// code. They are zero if the diagnostic does not reference source code.
+    size_t line{0};
+    size_t column{0};
+    size_t length{0};
+    /// The referenced line of source code
+    std::string sourceLine{};
+
+    /// Returns the diagnostic formatted for the console, i.e. the position,
+    /// the message and the referenced source code which is underlined.
+    std::string format() const;
+};
+
+/// Receives the diagnostics of the compilation and the execution.
+class DiagnosticsSink {
+    public:
+    /// Destructor
+    virtual ~DiagnosticsSink() = default;
+
+    /// Reports a diagnostic.
+    /// Note: This function can be called concurrently, unless the sink is
+    ///       only used by a single thread.
+    virtual void report(const Diagnostic& diagnostic) = 0;
+};
+
+/// Prints the formatted diagnostics to a stream.
+class StreamDiagnosticsSink : public DiagnosticsSink {
+    public:
+    /// Constructor
+    explicit StreamDiagnosticsSink(std::ostream& stream);
+
+    /// Reports a diagnostic.
+    /// Note: This function is only thread-safe if the stream is, e.g. for
+    ///       std::cout. The stream is not flushed.
+    void report(const Diagnostic& diagnostic) override;
+
+    private:
+    std::ostream& stream;
+};
+
+/// Drops all diagnostics.
+class NullDiagnosticsSink : public DiagnosticsSink {
+    public:
+    /// Reports a diagnostic.
+    void report(const Diagnostic& /*diagnostic*/) override {}
+};
+
+/// Records the diagnostics.
+class RecordingDiagnosticsSink : public DiagnosticsSink {
+    public:
+    /// Reports a diagnostic.
+    /// Note: This function is thread-safe.
+    void report(const Diagnostic& diagnostic) override;
+
+    /// Returns the recorded diagnostics.
+    /// Note: This function is thread-safe.
+    std::vector<Diagnostic> getDiagnostics() const;
+
+    private:
+    mutable std::mutex mutex;
+    std::vector<Diagnostic> diagnostics;
+};
+
+/// Returns the sink to which the diagnostics are reported on the current
+/// thread. Unless a DiagnosticsSinkScope is active, the diagnostics are
+/// dropped.
+DiagnosticsSink& getDiagnosticsSink();
+
+/// Redirects the diagnostics of the current thread to a sink for the lifetime
+/// of the scope.
+class DiagnosticsSinkScope {
+    public:
+    /// Constructor
+    /// Note: A nullptr keeps the current sink.
+    explicit DiagnosticsSinkScope(DiagnosticsSink* sink);
+
+    /// Destructor
+    ~DiagnosticsSinkScope();
+
+    /// Copy constructor/assignment
+    DiagnosticsSinkScope(const DiagnosticsSinkScope& other) = delete;
+    DiagnosticsSinkScope& operator=(const DiagnosticsSinkScope& other) = delete;
+
+    private:
+    /// The sink which was active before the scope.
+    DiagnosticsSink* previousSink;
+};
+
+} // namespace pljit::common
+
+#endif
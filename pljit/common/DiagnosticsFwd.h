@@ -0,0 +1,11 @@
+#ifndef H_common_DiagnosticsFwd
+#define H_common_DiagnosticsFwd
+
+namespace pljit::common {
+
+struct Diagnostic;
+class DiagnosticsSink;
+
+} // namespace pljit::common
+
+#endif
@@ -0,0 +1,110 @@
+#include "EpochManager.h"
+#include <algorithm>
+
+namespace pljit::common {
+
+namespace {
+
+/// Index of the shard of the current thread. The threads are assigned to the
+/// shards in a round-robin fashion.
+size_t getThreadShardIndex()
+{
+    static std::atomic<size_t> nextShardIndex{0};
+    thread_local size_t shardIndex = nextShardIndex.fetch_add(1, std::memory_order_relaxed);
+    return shardIndex;
+}
+
+} // namespace
+
+EpochManager::Guard::Guard(Shard& shard, uint64_t epoch)
+    : shard(shard), epoch(epoch)
+// Constructor
+{}
+
+EpochManager::Guard::~Guard()
+// Destructor
+{
+    shard.pinnedReaders[epoch & 1].fetch_sub(1, std::memory_order_release);
+}
+
+EpochManager::~EpochManager() = default;
+
+EpochManager::Guard EpochManager::pin()
+// Pins the current epoch.
+{
+    auto& shard = getShard();
+    while (true) {
+        auto epoch = globalEpoch.load();
+        shard.pinnedReaders[epoch & 1].fetch_add(1);
+        // If the epoch advanced in the meantime, a writer might have missed our
+        // counter. Hence, we retry with the new epoch.
+        if (globalEpoch.load() == epoch) {
+            return Guard(shard, epoch);
+        }
+        shard.pinnedReaders[epoch & 1].fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void EpochManager::reclaim()
+// Tries to advance the epoch and frees the objects which can no longer be referenced.
+{
+    std::vector<RetiredObject> reclaimableObjects;
+    {
+        std::unique_lock lck(retiredObjectsMutex);
+        if (retiredObjects.empty()) {
+            return;
+        }
+
+        // Objects need two epoch advances until they are safe to free.
+        tryAdvanceEpoch();
+        tryAdvanceEpoch();
+
+        auto epoch = globalEpoch.load();
+        auto it = std::partition(retiredObjects.begin(), retiredObjects.end(),
+                                 [epoch](const RetiredObject& retiredObject) {
+                                     return retiredObject.epoch + 2 > epoch;
+                                 });
+        std::move(it, retiredObjects.end(), std::back_inserter(reclaimableObjects));
+        retiredObjects.erase(it, retiredObjects.end());
+    }
+    // The objects are freed outside the critical section.
+}
+
+size_t EpochManager::getNumberOfRetiredObjects() const
+// Returns the number of retired objects which are not yet freed.
+{
+    std::unique_lock lck(retiredObjectsMutex);
+    return retiredObjects.size();
+}
+
+EpochManager::Shard& EpochManager::getShard()
+// Returns the shard of the current thread.
+{
+    return shards[getThreadShardIndex() % numberOfShards];
+}
+
+void EpochManager::tryAdvanceEpoch()
+// Advances the epoch if no reader is pinned in the previous epoch.
+{
+    auto epoch = globalEpoch.load();
+    // Readers of the previous epoch use the same counters as the next epoch.
+    auto previousParity = (epoch - 1) & 1;
+    for (auto& shard : shards) {
+        if (shard.pinnedReaders[previousParity].load() != 0) {
+            return;
+        }
+    }
+    globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+}
+
+void EpochManager::retire(std::unique_ptr<void, void (*)(void*)> object)
+// Adds an object to the retired objects.
+{
+    // The object must already be unlinked, i.e. readers which pin an epoch from
+    // now on cannot reach it anymore.
+    auto epoch = globalEpoch.load();
+    std::unique_lock lck(retiredObjectsMutex);
+    retiredObjects.push_back({epoch, std::move(object)});
+}
+
+} // namespace pljit::common
@@ -0,0 +1,118 @@
+#ifndef H_common_EpochManager
+#define H_common_EpochManager
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace pljit::common {
+
+/// Epoch-based memory reclamation. Readers pin the current epoch while they
+/// access shared objects, writers unlink shared objects and retire them. A
+/// retired object is freed once no reader can hold a reference to it anymore,
+/// i.e. once the global epoch advanced twice after its retirement.
+/// Pinning only modifies a counter of the reader's shard, hence, readers never
+/// block and do not contend on a single cache line.
+class EpochManager {
+    private:
+    struct Shard;
+
+    public:
+    /// Keeps the epoch pinned for the lifetime of the guard.
+    class Guard {
+        public:
+        /// Destructor
+        ~Guard();
+
+        /// Copy constructor/assignment
+        Guard(const Guard& other) = delete;
+        Guard& operator=(const Guard& other) = delete;
+
+        private:
+        friend EpochManager;
+
+        /// Constructor
+        Guard(Shard& shard, uint64_t epoch);
+
+        Shard& shard;
+        uint64_t epoch;
+    };
+
+    /// Constructor
+    EpochManager() = default;
+
+    /// Destructor
+    /// Note: Frees all retired objects, hence, no reader must be active.
+    ~EpochManager();
+
+    /// Copy constructor/assignment
+    EpochManager(const EpochManager& other) = delete;
+    EpochManager& operator=(const EpochManager& other) = delete;
+
+    /// Pins the current epoch, such that objects which are reachable at this
+    /// point are not freed until the guard is destroyed.
+    /// Note: This function is thread-safe and lock-free.
+    [[nodiscard]] Guard pin();
+
+    /// Retires an object which was unlinked from all shared data structures.
+    /// Note: This function is thread-safe.
+    template <typename T>
+    void retire(std::unique_ptr<T> object);
+
+    /// Tries to advance the epoch and frees the retired objects which can no
+    /// longer be referenced. It never waits for readers.
+    /// Note: This function is thread-safe.
+    void reclaim();
+
+    /// Returns the number of retired objects which are not yet freed.
+    size_t getNumberOfRetiredObjects() const;
+
+    private:
+    /// Avoids false sharing between the shards.
+    static constexpr size_t cacheLineSize = 64;
+    /// Number of shards of the reader counters.
+    static constexpr size_t numberOfShards = 16;
+
+    struct alignas(cacheLineSize) Shard {
+        /// Number of pinned readers for even and odd epochs.
+        std::array<std::atomic<uint64_t>, 2> pinnedReaders{};
+    };
+
+    struct RetiredObject {
+        /// Epoch in which the object was retired.
+        uint64_t epoch;
+        std::unique_ptr<void, void (*)(void*)> object;
+    };
+
+    /// Returns the shard of the current thread.
+    Shard& getShard();
+
+    /// Advances the epoch if no reader is pinned in the previous epoch.
+    void tryAdvanceEpoch();
+
+    /// Adds an object to the retired objects.
+    void retire(std::unique_ptr<void, void (*)(void*)> object);
+
+    std::atomic<uint64_t> globalEpoch{2};
+    std::array<Shard, numberOfShards> shards{};
+
+    mutable std::mutex retiredObjectsMutex;
+    std::vector<RetiredObject> retiredObjects;
+};
+
+template <typename T>
+void EpochManager::retire(std::unique_ptr<T> object)
+// Retires an object.
+{
+    auto deleter = [](void* ptr) { delete static_cast<T*>(ptr); };
+    auto* ptr = const_cast<std::remove_const_t<T>*>(object.release());
+    retire(std::unique_ptr<void, void (*)(void*)>(ptr, deleter));
+}
+
+} // namespace pljit::common
+
+#endif
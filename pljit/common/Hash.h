@@ -0,0 +1,23 @@
+#ifndef H_common_Hash
+#define H_common_Hash
+
+#include <cstdint>
+#include <string_view>
+
+namespace pljit::common {
+
+/// FNV-1a hash over the bytes of a string, e.g. of source code. The hash is
+/// stable across processes, hence, it can be persisted.
+inline uint64_t hashBytes(std::string_view bytes)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (auto c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace pljit::common
+
+#endif
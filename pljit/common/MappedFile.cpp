@@ -0,0 +1,73 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pljit::common {
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path)
+// Maps a file.
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat fileStatus {};
+    if (::fstat(fd, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    // Empty files cannot be mapped.
+    auto size = static_cast<size_t>(fileStatus.st_size);
+    void* data = nullptr;
+    if (size > 0) {
+        data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (data == MAP_FAILED) {
+        ::close(fd);
+        return nullptr;
+    }
+    return std::shared_ptr<const MappedFile>(
+        new MappedFile(fd, static_cast<const char*>(data), size, fileStatus.st_mtim));
+}
+
+MappedFile::MappedFile(int fd, const char* data, size_t size, timespec modificationTime)
+    : fd(fd),
+      data(data),
+      size(size),
+      modificationTime(modificationTime)
+// Constructor
+{}
+
+MappedFile::~MappedFile()
+// Destructor
+{
+    if (data != nullptr) {
+        ::munmap(const_cast<char*>(data), size);
+    }
+    ::close(fd);
+}
+
+std::string_view MappedFile::getContents() const
+// Returns the contents of the file.
+{
+    return std::string_view(data, size);
+}
+
+bool MappedFile::isModified() const
+// Returns true if the file was modified in place since it was mapped.
+{
+    // A file which replaced the mapped one by renaming has its own inode,
+    // hence, it does not affect the status of the mapped file.
+    struct stat fileStatus {};
+    if (::fstat(fd, &fileStatus) != 0) {
+        return true;
+    }
+    return static_cast<size_t>(fileStatus.st_size) != size ||
+        fileStatus.st_mtim.tv_sec != modificationTime.tv_sec ||
+        fileStatus.st_mtim.tv_nsec != modificationTime.tv_nsec;
+}
+
+} // namespace pljit::common
@@ -0,0 +1,52 @@
+#ifndef H_common_MappedFile
+#define H_common_MappedFile
+
+#include <cstddef>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace pljit::common {
+
+/// A file which is mapped read-only into memory. Source code can reference the
+/// mapped pages directly, i.e. without copying the file, while the file is kept
+/// mapped through a shared pointer.
+/// Note: The file must not be modified in place while it is mapped, as the
+///       mapping reflects such changes and accesses beyond a truncated end
+///       raise SIGBUS. Replace the file by renaming a new one over it instead,
+///       which keeps the mapping of the old file intact.
+class MappedFile {
+    public:
+    /// Maps a file. Returns nullptr if the file cannot be opened or mapped.
+    static std::shared_ptr<const MappedFile> open(const std::string& path);
+
+    /// Destructor
+    ~MappedFile();
+
+    /// Copy constructor/assignment
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    /// Returns the contents of the file.
+    std::string_view getContents() const;
+
+    /// Returns true if the size or the modification time of the file changed
+    /// since it was mapped, i.e. if it was modified in place.
+    bool isModified() const;
+
+    private:
+    /// Constructor
+    MappedFile(int fd, const char* data, size_t size, timespec modificationTime);
+
+    /// The file descriptor, which is kept open to detect modifications
+    int fd;
+    /// Start of the mapping (nullptr for empty files)
+    const char* data;
+    size_t size;
+    timespec modificationTime;
+};
+
+} // namespace pljit::common
+
+#endif
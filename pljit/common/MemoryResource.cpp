@@ -0,0 +1,100 @@
+#include "MemoryResource.h"
+#include <cassert>
+
+namespace pljit::common {
+
+namespace {
+
+thread_local std::pmr::memory_resource* nodeMemoryResource = nullptr;
+
+/// Statistics of the node allocations on the current thread
+thread_local size_t numberOfAllocatedNodes = 0;
+thread_local size_t numberOfAllocatedNodeBytes = 0;
+
+/// Alignment of the nodes
+constexpr size_t nodeAlignment = alignof(std::max_align_t);
+
+} // namespace
+
+std::pmr::memory_resource* getNodeMemoryResource()
+// Returns the memory resource for the nodes on the current thread.
+{
+    return nodeMemoryResource != nullptr ? nodeMemoryResource : std::pmr::new_delete_resource();
+}
+
+MemoryResourceScope::MemoryResourceScope(std::pmr::memory_resource* resource)
+    : previousResource(nodeMemoryResource)
+// Constructor
+{
+    assert(resource != nullptr);
+    nodeMemoryResource = resource;
+}
+
+MemoryResourceScope::~MemoryResourceScope()
+// Destructor
+{
+    nodeMemoryResource = previousResource;
+}
+
+void* allocateNode(size_t size)
+// Allocates memory for a node from the current node memory resource.
+{
+    ++numberOfAllocatedNodes;
+    numberOfAllocatedNodeBytes += size;
+    return getNodeMemoryResource()->allocate(size, nodeAlignment);
+}
+
+void deallocateNode(void* ptr, size_t size) noexcept
+// Deallocates memory which was allocated with allocateNode().
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    getNodeMemoryResource()->deallocate(ptr, size, nodeAlignment);
+}
+
+size_t getNumberOfAllocatedNodes()
+// Returns the number of nodes which were allocated on the current thread.
+{
+    return numberOfAllocatedNodes;
+}
+
+size_t getNumberOfAllocatedNodeBytes()
+// Returns the number of bytes which were allocated for nodes on the current thread.
+{
+    return numberOfAllocatedNodeBytes;
+}
+
+void addAllocatedNodes(size_t numberOfNodes, size_t numberOfBytes)
+// Adds nodes which another thread allocated on behalf of the current thread.
+{
+    numberOfAllocatedNodes += numberOfNodes;
+    numberOfAllocatedNodeBytes += numberOfBytes;
+}
+
+SynchronizedMemoryResource::SynchronizedMemoryResource(std::pmr::memory_resource* upstream)
+    : upstream(upstream)
+// Constructor
+{}
+
+void* SynchronizedMemoryResource::do_allocate(size_t bytes, size_t alignment)
+// Allocates memory from the upstream resource.
+{
+    std::unique_lock lck(mutex);
+    return upstream->allocate(bytes, alignment);
+}
+
+void SynchronizedMemoryResource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+// Deallocates memory to the upstream resource.
+{
+    std::unique_lock lck(mutex);
+    upstream->deallocate(ptr, bytes, alignment);
+}
+
+bool SynchronizedMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+// Returns true if both resources are the same.
+{
+    return this == &other;
+}
+
+} // namespace pljit::common
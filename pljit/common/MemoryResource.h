@@ -0,0 +1,79 @@
+#ifndef H_common_MemoryResource
+#define H_common_MemoryResource
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace pljit::common {
+
+/// Returns the memory resource from which the parse tree and AST nodes are
+/// allocated on the current thread. Unless a MemoryResourceScope is active,
+/// this is the new/delete resource.
+std::pmr::memory_resource* getNodeMemoryResource();
+
+/// Sets the memory resource from which the parse tree and AST nodes are
+/// allocated on the current thread for the lifetime of the scope.
+class MemoryResourceScope {
+    public:
+    /// Constructor
+    explicit MemoryResourceScope(std::pmr::memory_resource* resource);
+
+    /// Destructor
+    ~MemoryResourceScope();
+
+    /// Copy constructor/assignment
+    MemoryResourceScope(const MemoryResourceScope& other) = delete;
+    MemoryResourceScope& operator=(const MemoryResourceScope& other) = delete;
+
+    private:
+    /// The resource which was active before the scope.
+    std::pmr::memory_resource* previousResource;
+};
+
+/// Allocates memory for a node from the current node memory resource.
+/// Note: The resource is not remembered per node. The roots of the trees
+///       (ast::Function and parse_tree::FunctionDefinition) remember it and
+///       activate it while the tree is deleted.
+void* allocateNode(size_t size);
+
+/// Deallocates memory which was allocated with allocateNode(). The node must
+/// be deallocated while the resource from which it was allocated is active.
+void deallocateNode(void* ptr, size_t size) noexcept;
+
+/// Serializes the allocations from another resource, e.g. such that threads
+/// which parse in parallel allocate their nodes from the arena of the
+/// compilation.
+class SynchronizedMemoryResource : public std::pmr::memory_resource {
+    public:
+    /// Constructor
+    explicit SynchronizedMemoryResource(std::pmr::memory_resource* upstream);
+
+    private:
+    /// Allocates memory from the upstream resource.
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    /// Deallocates memory to the upstream resource.
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+    /// Returns true if both resources are the same.
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::pmr::memory_resource* upstream;
+    std::mutex mutex;
+};
+
+/// Returns the number of nodes which were allocated on the current thread.
+size_t getNumberOfAllocatedNodes();
+
+/// Returns the number of bytes which were allocated for nodes on the current
+/// thread.
+size_t getNumberOfAllocatedNodeBytes();
+
+/// Adds nodes which another thread allocated on behalf of the current thread,
+/// e.g. when parsing in parallel, to the statistics of the current thread.
+void addAllocatedNodes(size_t numberOfNodes, size_t numberOfBytes);
+
+} // namespace pljit::common
+
+#endif
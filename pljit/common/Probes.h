@@ -0,0 +1,81 @@
+#ifndef H_common_Probes
+#define H_common_Probes
+
+#include <cstdint>
+
+/// USDT probes (statically defined tracepoints) in the style of <sys/sdt.h>.
+/// Every probe is a single nop instruction, its location and the locations of
+/// its arguments are described in the .note.stapsdt section. Hence, the probes
+/// are free unless a tracer like bpftrace or perf attaches to them, e.g.:
+///
+///     bpftrace -e 'usdt:./app:pljit:execute__start { @start[tid] = nsecs; }'
+///
+/// All probes belong to the provider "pljit" and carry the id (the address of
+/// the function frame) and the source hash of the function:
+///
+///     compile__lock__wait(id, hash)          before locking the compile mutex
+///     compile__lock__acquired(id, hash)      after locking the compile mutex
+///     compile__phase__start(id, hash, phase) start of a phase (see CompilePhase)
+///     compile__phase__end(id, hash, phase)   end of a phase
+///     execute__start(id, hash)               start of a call
+///     execute__end(id, hash, resultCode)     end of a call (see ResultCode)
+///     runtime__error(id, hash)               a call failed with a runtime error
+///
+/// The probes are only emitted on Linux for x86-64 and AArch64 and can be
+/// disabled by defining PLJIT_DISABLE_PROBES.
+
+#if !defined(PLJIT_DISABLE_PROBES) && defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+
+/// The note of a probe, whose format is read by the tracers. The base section
+/// lets tracers detect prelinked addresses, the semaphore is not used.
+#define PLJIT_PROBE_NOTE(name, arguments)                                       \
+    "990: nop\n"                                                                \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n"                               \
+    ".balign 4\n"                                                               \
+    ".4byte 992f-991f,994f-993f,3\n"                                            \
+    "991: .asciz \"stapsdt\"\n"                                                 \
+    "992: .balign 4\n"                                                          \
+    "993: .8byte 990b\n"                                                        \
+    ".8byte _.stapsdt.base\n"                                                   \
+    ".8byte 0\n"                                                                \
+    ".asciz \"pljit\"\n"                                                        \
+    ".asciz \"" #name "\"\n"                                                    \
+    ".asciz \"" arguments "\"\n"                                                \
+    "994: .balign 4\n"                                                          \
+    ".popsection\n"                                                             \
+    ".ifndef _.stapsdt.base\n"                                                  \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"     \
+    ".weak _.stapsdt.base\n"                                                    \
+    ".hidden _.stapsdt.base\n"                                                  \
+    "_.stapsdt.base: .space 1\n"                                                \
+    ".size _.stapsdt.base, 1\n"                                                 \
+    ".popsection\n"                                                             \
+    ".endif\n"
+
+/// Arguments are passed as unsigned 64-bit values in a register, in memory or
+/// as an immediate, whatever the compiler prefers.
+#define PLJIT_PROBE2(name, arg1, arg2)                                          \
+    __asm__ __volatile__(PLJIT_PROBE_NOTE(name, "8@%[a1] 8@%[a2]")              \
+                         :                                                      \
+                         : [a1] "nor"(static_cast<uint64_t>(arg1)),             \
+                           [a2] "nor"(static_cast<uint64_t>(arg2)))
+
+#define PLJIT_PROBE3(name, arg1, arg2, arg3)                                    \
+    __asm__ __volatile__(PLJIT_PROBE_NOTE(name, "8@%[a1] 8@%[a2] 8@%[a3]")      \
+                         :                                                      \
+                         : [a1] "nor"(static_cast<uint64_t>(arg1)),             \
+                           [a2] "nor"(static_cast<uint64_t>(arg2)),             \
+                           [a3] "nor"(static_cast<uint64_t>(arg3)))
+
+#else
+
+#define PLJIT_PROBE2(name, arg1, arg2) \
+    do {                               \
+    } while (false)
+#define PLJIT_PROBE3(name, arg1, arg2, arg3) \
+    do {                                     \
+    } while (false)
+
+#endif
+
+#endif
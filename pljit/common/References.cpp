@@ -1,15 +1,11 @@
 #include "References.h"
 #include <cassert>
+#include <memory>
 
 namespace pljit::common {
 
-SourceLocationReference::SourceLocationReference(const char* ref)
-    : ref(ref)
-// Constructor
-{}
-
-SourceLocationReference::SourceLocationReference(std::string::const_iterator location)
-    : ref(location.base())
+SourceLocationReference::SourceLocationReference(std::string_view::const_iterator location)
+    : ref(std::to_address(location))
 // Constructor
 {}
 
@@ -3,7 +3,7 @@
 
 #include "pljit/common/ReferencesFwd.h"
 #include "pljit/common/SourceCodeManagerFwd.h"
-#include <string>
+#include <string_view>
 
 namespace pljit::common {
 
@@ -20,12 +20,11 @@ class SourceLocationReference {
     /// Points to the char right to the location reference.
     const char* ref;
 
-    /// Constructor
-    explicit SourceLocationReference(const char* ref);
-
     public:
     /// Constructor
-    explicit SourceLocationReference(std::string::const_iterator location);
+    /// Note: The iterator of a string_view is a plain char pointer, hence, this
+    ///       constructor is also used by the SourceRangeReference.
+    explicit SourceLocationReference(std::string_view::const_iterator location);
 };
 
 /// Represents a range of characters from the source code.
@@ -0,0 +1,158 @@
+#ifndef H_common_SPSCRingBuffer
+#define H_common_SPSCRingBuffer
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace pljit::common {
+
+/// A bounded lock-free ring buffer for exactly one producer thread and exactly
+/// one consumer thread. Besides the non-blocking tryPush() and tryPop(), the
+/// threads can wait for each other with push() and pop(), which spin for a
+/// short while and then block on the index of the other thread.
+template <typename T>
+class SPSCRingBuffer {
+    public:
+    /// Constructor
+    /// Note: The capacity must be a power of two.
+    explicit SPSCRingBuffer(size_t capacity);
+
+    /// Appends an element. Returns false if the ring buffer is full.
+    /// Note: Must only be called by the producer.
+    bool tryPush(T&& element);
+
+    /// Removes the oldest element. Returns false if the ring buffer is empty.
+    /// Note: Must only be called by the consumer.
+    bool tryPop(T& element);
+
+    /// Appends an element and waits while the ring buffer is full. Returns
+    /// false if the consumer stopped.
+    /// Note: Must only be called by the producer.
+    bool push(T&& element);
+
+    /// Removes the oldest element and waits while the ring buffer is empty.
+    /// Returns false if the ring buffer is empty and the producer finished.
+    /// Note: Must only be called by the consumer.
+    bool pop(T& element);
+
+    /// Signals that no further elements are pushed and wakes up the consumer.
+    /// Note: Must only be called by the producer.
+    void finish();
+
+    /// Signals that no further elements are popped and wakes up the producer.
+    /// Note: Must only be called by the consumer.
+    void stop();
+
+    private:
+    /// Avoids false sharing between the indexes of the producer and the consumer.
+    static constexpr size_t cacheLineSize = 64;
+    /// Number of failed attempts after which push() and pop() block.
+    static constexpr size_t spinLimit = 1024;
+    /// Set in the index of a thread by finish() and stop(). Changing the index
+    /// wakes up the other thread, which waits on it.
+    static constexpr size_t closedBit = size_t{1} << (std::numeric_limits<size_t>::digits - 1);
+
+    std::vector<T> slots;
+    const size_t mask;
+
+    /// Index of the next element to pop (written by the consumer).
+    alignas(cacheLineSize) std::atomic<size_t> head{0};
+    /// Index of the next element to push (written by the producer).
+    alignas(cacheLineSize) std::atomic<size_t> tail{0};
+};
+
+template <typename T>
+SPSCRingBuffer<T>::SPSCRingBuffer(size_t capacity)
+    : slots(capacity), mask(capacity - 1)
+// Constructor
+{
+    assert(capacity > 0 && (capacity & mask) == 0);
+}
+
+template <typename T>
+bool SPSCRingBuffer<T>::tryPush(T&& element)
+// Appends an element.
+{
+    auto currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail - (head.load(std::memory_order_acquire) & ~closedBit) == slots.size()) {
+        return false;
+    }
+    slots[currentTail & mask] = std::move(element);
+    tail.store(currentTail + 1, std::memory_order_release);
+    tail.notify_one();
+    return true;
+}
+
+template <typename T>
+bool SPSCRingBuffer<T>::tryPop(T& element)
+// Removes the oldest element.
+{
+    auto currentHead = head.load(std::memory_order_relaxed);
+    if (currentHead == (tail.load(std::memory_order_acquire) & ~closedBit)) {
+        return false;
+    }
+    element = std::move(slots[currentHead & mask]);
+    head.store(currentHead + 1, std::memory_order_release);
+    head.notify_one();
+    return true;
+}
+
+template <typename T>
+bool SPSCRingBuffer<T>::push(T&& element)
+// Appends an element and waits while the ring buffer is full.
+{
+    for (size_t attempt = 0; !tryPush(std::move(element)); ++attempt) {
+        auto currentHead = head.load(std::memory_order_acquire);
+        if ((currentHead & closedBit) != 0) {
+            return false;
+        }
+        // The consumer might have popped since the failed attempt, then the
+        // wait returns right away.
+        if (attempt >= spinLimit) {
+            head.wait(currentHead, std::memory_order_acquire);
+        }
+    }
+    return true;
+}
+
+template <typename T>
+bool SPSCRingBuffer<T>::pop(T& element)
+// Removes the oldest element and waits while the ring buffer is empty.
+{
+    for (size_t attempt = 0; !tryPop(element); ++attempt) {
+        auto currentTail = tail.load(std::memory_order_acquire);
+        if ((currentTail & closedBit) != 0) {
+            // The elements which were pushed before finishing are still popped.
+            return tryPop(element);
+        }
+        // The producer might have pushed since the failed attempt, then the
+        // wait returns right away.
+        if (attempt >= spinLimit) {
+            tail.wait(currentTail, std::memory_order_acquire);
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void SPSCRingBuffer<T>::finish()
+// Signals that no further elements are pushed.
+{
+    tail.fetch_or(closedBit, std::memory_order_release);
+    tail.notify_one();
+}
+
+template <typename T>
+void SPSCRingBuffer<T>::stop()
+// Signals that no further elements are popped.
+{
+    head.fetch_or(closedBit, std::memory_order_release);
+    head.notify_one();
+}
+
+} // namespace pljit::common
+
+#endif
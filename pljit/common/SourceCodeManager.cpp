@@ -1,14 +1,31 @@
 #include "SourceCodeManager.h"
-#include <iomanip>
-#include <iostream>
+#include "pljit/common/Diagnostics.h"
 
 namespace pljit::common {
 
 SourceCodeManager::SourceCodeManager(std::string code)
-    : sourceCode(std::move(code))
+    : SourceCodeManager(std::make_shared<const std::string>(std::move(code)))
 // Constructor
 {}
 
+SourceCodeManager::SourceCodeManager(std::string_view sourceCode, std::shared_ptr<const void> owner)
+    : owner(std::move(owner)),
+      sourceCode(sourceCode)
+// Constructor for source code which is not copied.
+{}
+
+SourceCodeManager::SourceCodeManager(std::string_view sourceCode, std::shared_ptr<const MappedFile> file)
+    : owner(file),
+      mappedFile(file.get()),
+      sourceCode(sourceCode)
+// Constructor for source code which is a region of a memory-mapped file.
+{}
+
+SourceCodeManager::SourceCodeManager(std::shared_ptr<const std::string> code)
+    : SourceCodeManager(*code, code)
+// Constructor for source code which is owned by the manager.
+{}
+
 void SourceCodeManager::printContext(SourceLocationReference location, std::string_view message) const
 // Prints the context with a message for a given reference.
 {
@@ -21,26 +38,24 @@ void SourceCodeManager::printContext(SourceRangeReference ref, std::string_view
 {
     auto locationInfo = resolveLocation(ref.first());
 
-    // Print the first line containing some meta information and the message.
-    std::cout << locationInfo.lineNumber
-              << ":"
-              << locationInfo.lineOffset
-              << ": "
-              << message
-              << std::endl;
+    // The messages are prefixed with their kind, i.e. "error: " or "note: ".
+    constexpr std::string_view notePrefix = "note: ";
+    constexpr std::string_view errorPrefix = "error: ";
+    auto kind = Diagnostic::Kind::CompileError;
+    if (message.starts_with(notePrefix)) {
+        kind = Diagnostic::Kind::Note;
+        message.remove_prefix(notePrefix.size());
+    } else if (message.starts_with(errorPrefix)) {
+        message.remove_prefix(errorPrefix.size());
+    }
 
-    // Print the actual line, i.e. the context.
     const auto* lineStart = sourceCode.data() + locationInfo.indexLineStart;
-    std::string_view line(lineStart, locationInfo.lineLength);
-    std::cout << line << std::endl;
-
-    // Underline the referenced section.
-    std::cout << std::setw(static_cast<int>(locationInfo.lineOffset))
-              << "^"
-              << std::setfill('~')
-              << std::setw(static_cast<int>(ref.length))
-              << "\n"
-              << std::setfill(' '); // Reset the fill character.
+    getDiagnosticsSink().report({kind,
+                                 std::string(message),
+                                 locationInfo.lineNumber,
+                                 locationInfo.lineOffset,
+                                 ref.length,
+                                 std::string(lineStart, locationInfo.lineLength)});
 }
 
 SourceCodeManager::SourceCodeIterator SourceCodeManager::getCodeBegin() const
@@ -55,6 +70,25 @@ SourceCodeManager::SourceCodeIterator SourceCodeManager::getCodeEnd() const
     return sourceCode.cend();
 }
 
+std::string_view SourceCodeManager::getSourceCode() const
+// Returns the whole source code.
+{
+    return sourceCode;
+}
+
+SourceCodeManager::SourceCodeIterator SourceCodeManager::getCodeIterator(
+    SourceLocationReference location) const
+// Returns an iterator referring to the character right to the location reference.
+{
+    return sourceCode.cbegin() + (location.ref - sourceCode.data());
+}
+
+const MappedFile* SourceCodeManager::getMappedFile() const
+// Returns the mapped file which contains the source code.
+{
+    return mappedFile;
+}
+
 SourceCodeManager::SourceCodeLocation SourceCodeManager::resolveLocation(
     SourceLocationReference ref) const
 // Resolves a (range) reference into its line and line offset position.
@@ -1,7 +1,9 @@
 #ifndef H_common_SourceCodeManager
 #define H_common_SourceCodeManager
 
+#include "pljit/common/MappedFile.h"
 #include "pljit/common/References.h"
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -14,13 +16,23 @@ class SourceCodeManager {
     /// Constructor
     explicit SourceCodeManager(std::string sourceCode);
 
-    /// Prints the context with a message for a given reference.
+    /// Constructor for source code which is not copied, e.g. a region of a
+    /// memory-mapped file. The owner keeps the source code alive.
+    SourceCodeManager(std::string_view sourceCode, std::shared_ptr<const void> owner);
+
+    /// Constructor for source code which is a region of a memory-mapped file.
+    SourceCodeManager(std::string_view sourceCode, std::shared_ptr<const MappedFile> file);
+
+    /// Reports the message for a given reference with its context to the
+    /// diagnostics sink of the current thread (see common::getDiagnosticsSink()).
+    /// The message is prefixed by its kind, i.e. "error: " or "note: ".
     void printContext(SourceLocationReference location, std::string_view message) const;
 
-    /// Prints the range with a message for a given range reference.
+    /// Reports the message for a given range reference with its context to the
+    /// diagnostics sink of the current thread.
     void printContext(SourceRangeReference ref, std::string_view message) const;
 
-    using SourceCodeIterator = std::string::const_iterator;
+    using SourceCodeIterator = std::string_view::const_iterator;
 
     /// Get begin iterator for iterating over the source code.
     SourceCodeIterator getCodeBegin() const;
@@ -28,7 +40,20 @@ class SourceCodeManager {
     /// Get end iterator for iterating over the source code.
     SourceCodeIterator getCodeEnd() const;
 
+    /// Returns the whole source code.
+    std::string_view getSourceCode() const;
+
+    /// Get an iterator referring to the character right to the location reference.
+    SourceCodeIterator getCodeIterator(SourceLocationReference location) const;
+
+    /// Returns the mapped file which contains the source code.
+    /// Note: Might be nullptr.
+    const MappedFile* getMappedFile() const;
+
     private:
+    /// Constructor for source code which is owned by the manager.
+    explicit SourceCodeManager(std::shared_ptr<const std::string> code);
+
     /// Useful information about a location in the source code.
     struct SourceCodeLocation {
         size_t lineNumber{};
@@ -44,8 +69,14 @@ class SourceCodeManager {
     /// required for printContext).
     SourceCodeLocation resolveLocation(SourceLocationReference location) const;
 
+    /// Keeps the source code alive
+    const std::shared_ptr<const void> owner;
+
+    /// The mapped file which contains the source code (nullptr if there is none)
+    const MappedFile* const mappedFile{nullptr};
+
     /// String view which contains the original source code.
-    const std::string sourceCode;
+    const std::string_view sourceCode;
 };
 
 } // namespace pljit::common
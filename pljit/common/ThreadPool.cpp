@@ -0,0 +1,118 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace pljit::common {
+
+namespace {
+
+/// The pool and the index of the worker which runs on the current thread.
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t numberOfThreads)
+// Constructor
+{
+    if (numberOfThreads == 0) {
+        numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    queues.reserve(numberOfThreads);
+    for (size_t i = 0; i < numberOfThreads; ++i) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+    workers.reserve(numberOfThreads);
+    for (size_t i = 0; i < numberOfThreads; ++i) {
+        workers.emplace_back([this, i]() { runWorker(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+// Destructor
+{
+    {
+        std::unique_lock lck(sleepMutex);
+        stopped = true;
+    }
+    for (auto& queue : queues) {
+        std::unique_lock lck(queue->mutex);
+        queue->tasks.clear();
+    }
+    tasksAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+// Enqueues a task.
+{
+    // Workers keep their own tasks local, the others are distributed.
+    size_t queueIndex = currentPool == this ?
+        currentWorkerIndex :
+        nextQueueIndex.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    // The task is counted before it is published, otherwise a worker could
+    // take it and decrement the counter first.
+    {
+        std::unique_lock lck(sleepMutex);
+        ++pendingTasks;
+    }
+    {
+        std::unique_lock lck(queues[queueIndex]->mutex);
+        queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    tasksAvailable.notify_one();
+}
+
+void ThreadPool::runWorker(size_t workerIndex)
+// Main loop of a worker thread.
+{
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+
+    while (!stopped) {
+        Task task;
+        if (popTask(workerIndex, task) || stealTask(workerIndex, task)) {
+            {
+                std::unique_lock lck(sleepMutex);
+                --pendingTasks;
+            }
+            task();
+            continue;
+        }
+
+        // All queues are empty, wait for new tasks.
+        std::unique_lock lck(sleepMutex);
+        tasksAvailable.wait(lck, [this]() { return stopped || pendingTasks > 0; });
+    }
+}
+
+bool ThreadPool::popTask(size_t workerIndex, Task& task)
+// Takes the oldest task of the worker's own queue.
+{
+    auto& queue = *queues[workerIndex];
+    std::unique_lock lck(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool ThreadPool::stealTask(size_t workerIndex, Task& task)
+// Takes the newest task of another worker's queue.
+{
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        auto& queue = *queues[(workerIndex + offset) % queues.size()];
+        std::unique_lock lck(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace pljit::common
@@ -0,0 +1,81 @@
+#ifndef H_common_ThreadPool
+#define H_common_ThreadPool
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pljit::common {
+
+/// A fixed number of worker threads with a work-stealing scheduler. Every
+/// worker has its own task queue, tasks submitted by a worker are appended to
+/// its own queue, other tasks are distributed round-robin. A worker whose
+/// queue runs empty steals tasks from the other queues, such that tasks of
+/// very different costs are balanced across the workers.
+class ThreadPool {
+    public:
+    using Task = std::function<void()>;
+
+    /// Constructor
+    /// Note: Zero threads select the number of hardware threads.
+    explicit ThreadPool(size_t numberOfThreads);
+
+    /// Destructor
+    /// Note: Tasks which did not start yet are discarded, running tasks
+    ///       are completed.
+    ~ThreadPool();
+
+    /// Copy constructor/assignment
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    /// Enqueues a task.
+    /// Note: This function is thread-safe.
+    void submit(Task task);
+
+    /// Returns the number of worker threads.
+    size_t getNumberOfThreads() const { return workers.size(); }
+
+    private:
+    /// Avoids false sharing between the queues.
+    static constexpr size_t cacheLineSize = 64;
+
+    struct alignas(cacheLineSize) TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /// Main loop of a worker thread.
+    void runWorker(size_t workerIndex);
+
+    /// Takes the oldest task of the worker's own queue.
+    bool popTask(size_t workerIndex, Task& task);
+
+    /// Takes the newest task of another worker's queue.
+    bool stealTask(size_t workerIndex, Task& task);
+
+    /// One queue per worker
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    /// Queue for the next task which is not submitted by a worker
+    std::atomic<size_t> nextQueueIndex{0};
+
+    /// Idle workers sleep until a task is submitted.
+    std::mutex sleepMutex;
+    std::condition_variable tasksAvailable;
+    /// Number of tasks in all queues
+    size_t pendingTasks{0};
+    /// Set when the pool is destroyed
+    std::atomic<bool> stopped{false};
+
+    std::vector<std::thread> workers;
+};
+
+} // namespace pljit::common
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef H_common_ThreadPoolFwd
+#define H_common_ThreadPoolFwd
+
+namespace pljit::common {
+
+class ThreadPool;
+
+} // namespace pljit::common
+
+#endif
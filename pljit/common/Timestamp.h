@@ -0,0 +1,25 @@
+#ifndef H_common_Timestamp
+#define H_common_Timestamp
+
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace pljit::common {
+
+/// Returns the current value of the time stamp counter. On other
+/// architectures than x86, it falls back to a steady clock in nanoseconds.
+inline uint64_t readTimestampCounter()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+} // namespace pljit::common
+
+#endif
@@ -0,0 +1,210 @@
+#include "Tracer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace pljit::common {
+
+namespace {
+
+/// The buffer of the tracer which was used last by the current thread. Hence,
+/// the buffers of the tracer are only searched when the thread switches
+/// between tracers.
+struct CachedThreadBuffer {
+    uint64_t tracerId{0};
+    void* buffer{nullptr};
+};
+thread_local CachedThreadBuffer cachedThreadBuffer;
+
+/// Returns a unique id for a tracer (ids are never reused).
+uint64_t getNextTracerId()
+{
+    static std::atomic<uint64_t> nextTracerId{1};
+    return nextTracerId.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Writes a string literal as a JSON string.
+void writeJsonString(std::ostream& stream, std::string_view string)
+{
+    stream << '"';
+    for (char c : string) {
+        if (c == '"' || c == '\\') {
+            stream << '\\';
+        }
+        stream << c;
+    }
+    stream << '"';
+}
+
+/// Writes nanoseconds as microseconds, which is the unit of the trace event format.
+void writeMicroseconds(std::ostream& stream, uint64_t nanoseconds)
+{
+    stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000;
+}
+
+} // namespace
+
+Tracer::ThreadBuffer::ThreadBuffer(size_t capacity, uint32_t threadIndex)
+    : events(capacity),
+      threadIndex(threadIndex)
+// Constructor
+{}
+
+Tracer::Tracer(size_t capacityPerThread)
+    : id(getNextTracerId()),
+      capacityPerThread(std::max<size_t>(capacityPerThread, 1)),
+      startTime(now())
+// Constructor
+{}
+
+Tracer::~Tracer() = default;
+
+void Tracer::recordComplete(std::string_view name, std::string_view category, uint64_t start, uint64_t end,
+                            uint64_t functionHash)
+// Records an event with a duration.
+{
+    record({TraceEvent::Type::Complete, name, category, start, end, functionHash, 0});
+}
+
+void Tracer::recordInstant(std::string_view name, std::string_view category, uint64_t functionHash)
+// Records an event without a duration.
+{
+    auto time = now();
+    record({TraceEvent::Type::Instant, name, category, time, time, functionHash, 0});
+}
+
+std::vector<TraceEvent> Tracer::getEvents() const
+// Returns the recorded events of all threads.
+{
+    std::vector<TraceEvent> events;
+    {
+        std::unique_lock lck(buffersMutex);
+        for (const auto& [threadId, buffer] : buffers) {
+            std::unique_lock bufferLck(buffer->mutex);
+            auto numberOfStoredEvents = std::min<uint64_t>(buffer->numberOfEvents, capacityPerThread);
+            // The oldest stored event follows the newest one in the ring.
+            for (uint64_t i = buffer->numberOfEvents - numberOfStoredEvents; i < buffer->numberOfEvents; ++i) {
+                events.push_back(buffer->events[i % capacityPerThread]);
+            }
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent& lhs, const TraceEvent& rhs) {
+        return lhs.start < rhs.start;
+    });
+    return events;
+}
+
+uint64_t Tracer::getNumberOfOverwrittenEvents() const
+// Returns the number of events which were overwritten.
+{
+    uint64_t numberOfOverwrittenEvents = 0;
+    std::unique_lock lck(buffersMutex);
+    for (const auto& [threadId, buffer] : buffers) {
+        std::unique_lock bufferLck(buffer->mutex);
+        if (buffer->numberOfEvents > capacityPerThread) {
+            numberOfOverwrittenEvents += buffer->numberOfEvents - capacityPerThread;
+        }
+    }
+    return numberOfOverwrittenEvents;
+}
+
+void Tracer::writeJson(std::ostream& stream) const
+// Writes the recorded events as a Chrome trace event JSON document.
+{
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& event : getEvents()) {
+        stream << (first ? "\n" : ",\n");
+        first = false;
+
+        stream << "{\"name\":";
+        writeJsonString(stream, event.name);
+        stream << ",\"cat\":";
+        writeJsonString(stream, event.category);
+        auto start = event.start >= startTime ? event.start - startTime : 0;
+        if (event.type == TraceEvent::Type::Complete) {
+            stream << ",\"ph\":\"X\",\"ts\":";
+            writeMicroseconds(stream, start);
+            stream << ",\"dur\":";
+            writeMicroseconds(stream, event.end >= event.start ? event.end - event.start : 0);
+        } else {
+            // Instant events are drawn on the track of their thread.
+            stream << ",\"ph\":\"i\",\"s\":\"t\",\"ts\":";
+            writeMicroseconds(stream, start);
+        }
+        stream << ",\"pid\":1,\"tid\":" << std::dec << event.threadIndex << ",\"args\":{\"function\":\"0x"
+               << std::hex << std::setw(16) << std::setfill('0') << event.functionHash << std::dec << "\"}}";
+    }
+    stream << "\n]}\n";
+}
+
+bool Tracer::writeJson(const std::string& path) const
+// Writes the recorded events to a JSON file.
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    writeJson(file);
+    return static_cast<bool>(file);
+}
+
+uint64_t Tracer::now()
+// Returns the current time in nanoseconds.
+{
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+Tracer::ThreadBuffer& Tracer::getThreadBuffer()
+// Returns the buffer of the current thread.
+{
+    if (cachedThreadBuffer.tracerId == id) {
+        return *static_cast<ThreadBuffer*>(cachedThreadBuffer.buffer);
+    }
+
+    std::unique_lock lck(buffersMutex);
+    auto threadId = std::this_thread::get_id();
+    auto it = std::find_if(buffers.begin(), buffers.end(), [&](const auto& entry) { return entry.first == threadId; });
+    if (it == buffers.end()) {
+        auto threadIndex = static_cast<uint32_t>(buffers.size() + 1);
+        buffers.emplace_back(threadId, std::make_unique<ThreadBuffer>(capacityPerThread, threadIndex));
+        it = std::prev(buffers.end());
+    }
+    cachedThreadBuffer = {id, it->second.get()};
+    return *it->second;
+}
+
+void Tracer::record(TraceEvent event)
+// Appends an event to the buffer of the current thread.
+{
+    auto& buffer = getThreadBuffer();
+    event.threadIndex = buffer.threadIndex;
+    std::unique_lock lck(buffer.mutex);
+    buffer.events[buffer.numberOfEvents % capacityPerThread] = event;
+    ++buffer.numberOfEvents;
+}
+
+TraceScope::TraceScope(Tracer* tracer, std::string_view name, std::string_view category, uint64_t functionHash)
+    : tracer(tracer),
+      name(name),
+      category(category),
+      functionHash(functionHash)
+// Constructor
+{
+    if (tracer != nullptr) {
+        start = Tracer::now();
+    }
+}
+
+TraceScope::~TraceScope()
+// Destructor
+{
+    if (tracer != nullptr) {
+        tracer->recordComplete(name, category, start, Tracer::now(), functionHash);
+    }
+}
+
+} // namespace pljit::common
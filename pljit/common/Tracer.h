@@ -0,0 +1,140 @@
+#ifndef H_common_Tracer
+#define H_common_Tracer
+
+#include "pljit/common/TracerFwd.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pljit::common {
+
+/// An event of the compile and execution timeline.
+struct TraceEvent {
+    enum class Type {
+        /// An event with a duration
+        Complete,
+        /// An event without a duration
+        Instant
+    };
+
+    Type type;
+    /// Name and category of the event (must be string literals)
+    std::string_view name;
+    std::string_view category;
+    /// Start and end of the event in nanoseconds (see Tracer::now())
+    uint64_t start;
+    uint64_t end;
+    /// Hash of the source code of the function the event belongs to
+    uint64_t functionHash;
+    /// Index of the thread which recorded the event (starting at 1)
+    uint32_t threadIndex;
+};
+
+/// Records trace events in per-thread ring buffers and exports them in the
+/// Chrome trace event format, which can be opened in chrome://tracing or in
+/// Perfetto. Every thread only writes to its own buffer, hence, recording
+/// never contends with other threads. If a buffer is full, the oldest events
+/// of the thread are overwritten.
+class Tracer {
+    public:
+    /// Constructor
+    explicit Tracer(size_t capacityPerThread = 65536);
+
+    /// Destructor
+    ~Tracer();
+
+    /// Copy constructor/assignment
+    Tracer(const Tracer& other) = delete;
+    Tracer& operator=(const Tracer& other) = delete;
+
+    /// Records an event with a duration.
+    /// Note: This function is thread-safe.
+    void recordComplete(std::string_view name, std::string_view category, uint64_t start, uint64_t end,
+                        uint64_t functionHash);
+
+    /// Records an event without a duration at the current time.
+    /// Note: This function is thread-safe.
+    void recordInstant(std::string_view name, std::string_view category, uint64_t functionHash);
+
+    /// Returns the recorded events of all threads ordered by their start.
+    /// Note: This function is thread-safe.
+    std::vector<TraceEvent> getEvents() const;
+
+    /// Returns the number of events which were overwritten since the buffers
+    /// were full.
+    /// Note: This function is thread-safe.
+    uint64_t getNumberOfOverwrittenEvents() const;
+
+    /// Writes the recorded events as a Chrome trace event JSON document.
+    /// Note: This function is thread-safe.
+    void writeJson(std::ostream& stream) const;
+
+    /// Writes the recorded events to a JSON file. Returns false if the file
+    /// cannot be written.
+    /// Note: This function is thread-safe.
+    bool writeJson(const std::string& path) const;
+
+    /// Returns the current time in nanoseconds of a steady clock.
+    static uint64_t now();
+
+    private:
+    /// The events of one thread.
+    struct ThreadBuffer {
+        /// Constructor
+        ThreadBuffer(size_t capacity, uint32_t threadIndex);
+
+        /// Only contended while the events are exported.
+        mutable std::mutex mutex;
+        std::vector<TraceEvent> events;
+        /// Number of recorded events, including the overwritten ones
+        uint64_t numberOfEvents{0};
+        uint32_t threadIndex;
+    };
+
+    /// Returns the buffer of the current thread and creates it if necessary.
+    ThreadBuffer& getThreadBuffer();
+
+    /// Appends an event to the buffer of the current thread.
+    void record(TraceEvent event);
+
+    /// Distinguishes the tracers in the thread-local buffer cache.
+    const uint64_t id;
+    const size_t capacityPerThread;
+    /// Time at which the tracer was created, the exported timestamps are relative to it.
+    const uint64_t startTime;
+
+    mutable std::mutex buffersMutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<ThreadBuffer>>> buffers;
+};
+
+/// Records an event for the lifetime of the scope. A nullptr disables it.
+class TraceScope {
+    public:
+    /// Constructor
+    TraceScope(Tracer* tracer, std::string_view name, std::string_view category, uint64_t functionHash);
+
+    /// Destructor
+    ~TraceScope();
+
+    /// Copy constructor/assignment
+    TraceScope(const TraceScope& other) = delete;
+    TraceScope& operator=(const TraceScope& other) = delete;
+
+    private:
+    Tracer* tracer;
+    std::string_view name;
+    std::string_view category;
+    uint64_t functionHash;
+    uint64_t start{0};
+};
+
+} // namespace pljit::common
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef H_common_TracerFwd
+#define H_common_TracerFwd
+
+namespace pljit::common {
+
+struct TraceEvent;
+class Tracer;
+class TraceScope;
+
+} // namespace pljit::common
+
+#endif
@@ -0,0 +1,291 @@
+#include "CompileCache.h"
+#include "pljit/ast/AST.h"
+#include "pljit/common/Hash.h"
+#include "pljit/exec/ExecutionImage.h"
+#include "pljit/exec/FunctionFingerprint.h"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+
+#ifndef PLJIT_BUILD_ID
+#define PLJIT_BUILD_ID "unknown"
+#endif
+
+namespace pljit::exec {
+
+namespace {
+
+/// "PLJITCC" followed by a zero byte.
+constexpr uint64_t magic = 0x00434354494a4c50;
+/// Number of words before the encoding
+constexpr size_t headerSize = 5;
+
+using Opcode = FunctionFingerprint::Opcode;
+
+/// Returns the number of words which are needed for the given number of bytes.
+size_t getNumberOfWords(size_t numberOfBytes)
+{
+    return (numberOfBytes + sizeof(int64_t) - 1) / sizeof(int64_t);
+}
+
+/// Returns the identifier type of an identifier opcode.
+std::optional<ast::Identifier::Type> getIdentifierType(int64_t opcode)
+{
+    switch (static_cast<Opcode>(opcode)) {
+        case Opcode::Parameter:
+            return ast::Identifier::Type::Parameter;
+        case Opcode::Variable:
+            return ast::Identifier::Type::Variable;
+        case Opcode::Constant:
+            return ast::Identifier::Type::Constant;
+        default:
+            return std::nullopt;
+    }
+}
+
+/// Returns the binary operation type of a binary operation opcode.
+ast::BinaryOp::Type getBinaryOpType(Opcode opcode)
+{
+    switch (opcode) {
+        case Opcode::Add:
+            return ast::BinaryOp::Type::Add;
+        case Opcode::Sub:
+            return ast::BinaryOp::Type::Sub;
+        case Opcode::Mul:
+            return ast::BinaryOp::Type::Mul;
+        case Opcode::Div:
+            return ast::BinaryOp::Type::Div;
+        default:
+            __builtin_unreachable();
+    }
+}
+
+} // namespace
+
+CompileCache::CompileCache(std::filesystem::path directory, std::string_view buildId)
+    : directory(std::move(directory)), buildHash(common::hashBytes(buildId))
+// Constructor
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(this->directory, errorCode);
+}
+
+std::string_view CompileCache::getBuildId()
+// Returns the id of this build.
+{
+    return PLJIT_BUILD_ID;
+}
+
+std::unique_ptr<ExecutionImage> CompileCache::load(std::string_view sourceCode) const
+// Loads the compiled function for the source code.
+{
+    std::ifstream file(getPath(sourceCode), std::ios::binary | std::ios::ate);
+    if (!file) {
+        return nullptr;
+    }
+    auto fileSize = static_cast<size_t>(file.tellg());
+    if (fileSize < headerSize * sizeof(int64_t)) {
+        return nullptr;
+    }
+    std::vector<int64_t> words(getNumberOfWords(fileSize));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(fileSize))) {
+        return nullptr;
+    }
+
+    auto sourceSize = static_cast<size_t>(words[3]);
+    auto encodingSize = static_cast<size_t>(words[4]);
+    if (static_cast<uint64_t>(words[0]) != magic || static_cast<uint64_t>(words[1]) != formatVersion ||
+        static_cast<uint64_t>(words[2]) != buildHash || sourceSize != sourceCode.size() || encodingSize > words.size() - headerSize ||
+        words.size() != headerSize + encodingSize + getNumberOfWords(sourceSize)) {
+        return nullptr;
+    }
+
+    // The hash of the source code might collide.
+    const auto* storedSourceCode = reinterpret_cast<const char*>(words.data() + headerSize + encodingSize);
+    if (std::memcmp(storedSourceCode, sourceCode.data(), sourceSize) != 0) {
+        return nullptr;
+    }
+    return decode(std::span<const int64_t>(words).subspan(headerSize, encodingSize));
+}
+
+void CompileCache::store(std::string_view sourceCode, const ExecutionImage& image) const
+// Stores the compiled function for the source code.
+{
+    FunctionFingerprint fingerprint(image);
+    const auto& encoding = fingerprint.getEncoding();
+
+    std::vector<int64_t> words{static_cast<int64_t>(magic), static_cast<int64_t>(formatVersion),
+                               static_cast<int64_t>(buildHash), static_cast<int64_t>(sourceCode.size()),
+                               static_cast<int64_t>(encoding.size())};
+    words.insert(words.end(), encoding.begin(), encoding.end());
+    auto sourceOffset = words.size();
+    words.resize(sourceOffset + getNumberOfWords(sourceCode.size()), 0);
+    std::memcpy(words.data() + sourceOffset, sourceCode.data(), sourceCode.size());
+
+    // The file is written to a unique temporary file first and then renamed,
+    // which atomically replaces an existing file.
+    static std::atomic<uint64_t> nextTemporaryId{0};
+    auto path = getPath(sourceCode);
+    auto temporaryPath = path;
+    temporaryPath += ".tmp." + std::to_string(::getpid()) + "." + std::to_string(nextTemporaryId++);
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(words.data()),
+                   static_cast<std::streamsize>(words.size() * sizeof(int64_t)));
+        if (!file) {
+            std::error_code errorCode;
+            std::filesystem::remove(temporaryPath, errorCode);
+            return;
+        }
+    }
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryPath, path, errorCode);
+    if (errorCode) {
+        std::filesystem::remove(temporaryPath, errorCode);
+    }
+}
+
+std::filesystem::path CompileCache::getPath(std::string_view sourceCode) const
+// Returns the path of the file for the source code.
+{
+    std::ostringstream fileName;
+    fileName << std::hex << std::setfill('0') << std::setw(16) << common::hashBytes(sourceCode) << "."
+             << std::setw(16) << buildHash << ".v" << std::dec << formatVersion << ".plc";
+    return directory / fileName.str();
+}
+
+std::unique_ptr<ExecutionImage> CompileCache::decode(std::span<const int64_t> encoding)
+// Decodes the post-order encoding of a function.
+{
+    // The header contains the number of parameters, variables and constants,
+    // followed by the constant values.
+    if (encoding.size() < 3 || encoding[0] < 0 || encoding[1] < 0 || encoding[2] < 0 ||
+        static_cast<size_t>(encoding[2]) > encoding.size() - 3) {
+        return nullptr;
+    }
+    auto numberOfParameters = static_cast<size_t>(encoding[0]);
+    auto numberOfVariables = static_cast<size_t>(encoding[1]);
+    auto numberOfConstants = static_cast<size_t>(encoding[2]);
+    std::vector<int64_t> constantValues(encoding.begin() + 3, encoding.begin() + 3 + numberOfConstants);
+
+    // Reads an identifier (opcode and symbol id) and checks its symbol id.
+    size_t pos = 3 + numberOfConstants;
+    auto readIdentifier = [&](int64_t opcode) -> std::unique_ptr<ast::Identifier> {
+        auto identifierType = getIdentifierType(opcode);
+        if (!identifierType || pos == encoding.size() || encoding[pos] < 0) {
+            return nullptr;
+        }
+        auto id = static_cast<size_t>(encoding[pos++]);
+        switch (*identifierType) {
+            case ast::Identifier::Type::Parameter:
+                if (id >= numberOfParameters) {
+                    return nullptr;
+                }
+                break;
+            case ast::Identifier::Type::Variable:
+                if (id >= numberOfVariables) {
+                    return nullptr;
+                }
+                break;
+            case ast::Identifier::Type::Constant:
+                if (id >= numberOfConstants) {
+                    return nullptr;
+                }
+                break;
+        }
+        return std::make_unique<ast::Identifier>(*identifierType, id);
+    };
+
+    // The expressions are rebuilt on a stack, i.e. without recursion.
+    std::vector<std::unique_ptr<ast::Statement>> statements;
+    std::vector<std::unique_ptr<ast::Expression>> operands;
+    while (pos < encoding.size()) {
+        auto opcode = encoding[pos++];
+        switch (static_cast<Opcode>(opcode)) {
+            case Opcode::ConstantLiteral:
+                if (pos == encoding.size()) {
+                    return nullptr;
+                }
+                operands.push_back(std::make_unique<ast::ConstantLiteral>(encoding[pos++]));
+                break;
+
+            case Opcode::Parameter:
+            case Opcode::Variable:
+            case Opcode::Constant: {
+                auto identifier = readIdentifier(opcode);
+                if (identifier == nullptr) {
+                    return nullptr;
+                }
+                operands.push_back(std::move(identifier));
+                break;
+            }
+
+            case Opcode::PlusSign:
+            case Opcode::MinusSign: {
+                if (operands.empty()) {
+                    return nullptr;
+                }
+                auto unaryOpType = static_cast<Opcode>(opcode) == Opcode::PlusSign ?
+                    ast::UnaryOp::Type::PlusSign :
+                    ast::UnaryOp::Type::MinusSign;
+                operands.back() = std::make_unique<ast::UnaryOp>(unaryOpType, std::move(operands.back()));
+                break;
+            }
+
+            case Opcode::Add:
+            case Opcode::Sub:
+            case Opcode::Mul:
+            case Opcode::Div: {
+                if (operands.size() < 2) {
+                    return nullptr;
+                }
+                auto binaryOpType = getBinaryOpType(static_cast<Opcode>(opcode));
+                auto rhs = std::move(operands.back());
+                operands.pop_back();
+                operands.back() = std::make_unique<ast::BinaryOp>(std::move(operands.back()), binaryOpType,
+                                                                  std::move(rhs));
+                break;
+            }
+
+            case Opcode::Assignment: {
+                if (operands.size() != 1 || pos == encoding.size()) {
+                    return nullptr;
+                }
+                auto targetOpcode = encoding[pos++];
+                auto target = readIdentifier(targetOpcode);
+                if (target == nullptr || target->getIdentifierType() == ast::Identifier::Type::Constant) {
+                    return nullptr;
+                }
+                statements.push_back(std::make_unique<ast::AssignmentStatement>(std::move(target),
+                                                                                std::move(operands.back())));
+                operands.pop_back();
+                break;
+            }
+
+            case Opcode::Return:
+                if (operands.size() != 1) {
+                    return nullptr;
+                }
+                statements.push_back(std::make_unique<ast::ReturnStatement>(std::move(operands.back())));
+                operands.pop_back();
+                break;
+
+            default:
+                return nullptr;
+        }
+    }
+    if (!operands.empty() || statements.empty()) {
+        return nullptr;
+    }
+
+    return std::make_unique<ExecutionImage>(std::make_unique<ast::Function>(std::move(statements)),
+                                            std::move(constantValues), numberOfParameters, numberOfVariables);
+}
+
+} // namespace pljit::exec
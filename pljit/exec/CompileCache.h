@@ -0,0 +1,66 @@
+#ifndef H_exec_CompileCache
+#define H_exec_CompileCache
+
+#include "pljit/exec/CompileCacheFwd.h"
+#include "pljit/exec/ExecutionImageFwd.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace pljit::exec {
+
+/// A persistent cache of compiled functions in a directory. Every function is
+/// stored in its own file, which is named after the hash of its source code,
+/// the hash of the build id and the version of the cache format. A file
+/// consists of 64-bit words:
+///
+///     magic | version | build | source size | encoding size | encoding | source
+///
+/// The encoding is the post-order encoding of the optimized AST (see
+/// FunctionFingerprint), i.e. the file does not contain any pointers and can
+/// be mapped into memory as is. The source code is stored to rule out hash
+/// collisions. The build id identifies the compiler and the revision of the
+/// sources (PLJIT_BUILD_ID, set by CMake), such that a build never loads the
+/// functions which another build compiled, e.g. with other optimizations.
+class CompileCache {
+    public:
+    /// Version of the file format, files of other versions are ignored.
+    static constexpr uint64_t formatVersion = 2;
+
+    /// Constructor
+    /// Note: Files of other build ids are ignored.
+    explicit CompileCache(std::filesystem::path directory, std::string_view buildId = getBuildId());
+
+    /// Returns the id of this build.
+    static std::string_view getBuildId();
+
+    /// Loads the compiled function for the source code. Returns nullptr if the
+    /// function is not cached or the file is invalid.
+    /// Note: This function is thread-safe. The AST nodes are allocated from
+    ///       the node memory resource of the calling thread.
+    std::unique_ptr<ExecutionImage> load(std::string_view sourceCode) const;
+
+    /// Stores the compiled function for the source code. Failures are ignored,
+    /// since the function is simply compiled again the next time.
+    /// Note: This function is thread-safe. Files are replaced atomically, such
+    ///       that concurrent processes never read partially written files.
+    void store(std::string_view sourceCode, const ExecutionImage& image) const;
+
+    /// Returns the path of the file for the source code.
+    std::filesystem::path getPath(std::string_view sourceCode) const;
+
+    /// Decodes the post-order encoding of a function. Returns nullptr if the
+    /// encoding is invalid.
+    static std::unique_ptr<ExecutionImage> decode(std::span<const int64_t> encoding);
+
+    private:
+    std::filesystem::path directory;
+    /// Hash of the build id
+    uint64_t buildHash;
+};
+
+} // namespace pljit::exec
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef H_exec_CompileCacheFwd
+#define H_exec_CompileCacheFwd
+
+namespace pljit::exec {
+
+class CompileCache;
+
+} // namespace pljit::exec
+
+#endif
@@ -1,5 +1,6 @@
 #include "ExecutionContext.h"
 #include "pljit/analysis/SymbolTable.h"
+#include "pljit/exec/ExecutionImage.h"
 
 namespace pljit::exec {
 
@@ -7,7 +8,16 @@ ExecutionContext::ExecutionContext(std::vector<int64_t>&& parameterValues,
                                    const analysis::SymbolTable& symbolTable)
     : parameterValues(std::move(parameterValues)),
       variableValues(symbolTable.getNumberOfVariables()),
-      symbolTable(symbolTable)
+      constantValues(symbolTable.getConstantValues())
+// Constructor
+{}
+
+ExecutionContext::ExecutionContext(std::vector<int64_t>&& parameterValues,
+                                   const ExecutionImage& executionImage)
+    : parameterValues(std::move(parameterValues)),
+      variableValues(executionImage.getNumberOfVariables()),
+      constantValues(executionImage.getConstantValues()),
+      profile(executionImage.getExecutionProfile())
 // Constructor
 {}
 
@@ -2,6 +2,11 @@
 #define H_exec_ExecutionContext
 
 #include "pljit/analysis/SymbolTableFwd.h"
+#include "pljit/ast/ASTFwd.h"
+#include "pljit/exec/ExecutionImageFwd.h"
+#include "pljit/exec/ExecutionProfileFwd.h"
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace pljit::exec {
@@ -12,14 +17,18 @@ struct ExecutionContext {
     ExecutionContext(std::vector<int64_t>&& parameterValues,
                      const analysis::SymbolTable& symbolTable);
 
+    /// Constructor
+    ExecutionContext(std::vector<int64_t>&& parameterValues,
+                     const ExecutionImage& executionImage);
+
     /// Vector which maps the parameter id to the current value.
     std::vector<int64_t> parameterValues;
 
     /// Map for tracking the variable assignments.
     std::vector<int64_t> variableValues;
 
-    /// Symbol table, used for obtaining the constant values.
-    const analysis::SymbolTable& symbolTable;
+    /// Values of the constants (the index represents the symbol id).
+    std::span<const int64_t> constantValues;
 
     /// Return value
     int64_t returnValue{};
@@ -33,6 +42,23 @@ struct ExecutionContext {
     /// Error type which might have occurred during the execution.
     ErrorType error{ErrorType::NoError};
 
+    /// An expression whose evaluation is pending.
+    struct PendingExpression {
+        const ast::Expression* expression;
+        /// True if the operands of the expression were already evaluated.
+        bool operandsEvaluated;
+    };
+
+    /// Stacks for evaluating expressions without recursion. They are part of
+    /// the context, such that their memory is reused by all statements of a call.
+    std::vector<PendingExpression> pendingExpressions{};
+    std::vector<int64_t> operandStack{};
+
+    /// Profile in which the executed nodes are recorded (nullptr if the
+    /// execution is not profiled) and the start ticks of the pending nodes.
+    const ExecutionProfile* profile{nullptr};
+    std::vector<uint64_t> startTicks{};
+
     /// Returns true if an error is set, otherwise it returns false.
     bool hasError() const;
 };
@@ -0,0 +1,133 @@
+#include "ExecutionImage.h"
+#include "pljit/analysis/SymbolTable.h"
+#include "pljit/ast/AST.h"
+#include "pljit/exec/ExecutionProfile.h"
+#include <cassert>
+
+namespace pljit::exec {
+
+namespace {
+
+/// Returns the size of an expression node.
+size_t getNodeSize(const ast::Expression& expression)
+{
+    switch (expression.getType()) {
+        case ast::ASTNode::Type::ConstantLiteral:
+            return sizeof(ast::ConstantLiteral);
+        case ast::ASTNode::Type::Identifier:
+            return sizeof(ast::Identifier);
+        case ast::ASTNode::Type::UnaryOp:
+            return sizeof(ast::UnaryOp);
+        case ast::ASTNode::Type::BinaryOp:
+            return sizeof(ast::BinaryOp);
+        default:
+            __builtin_unreachable();
+    }
+}
+
+/// Estimates the number of bytes which are occupied by the AST of a function.
+size_t estimateMemoryUsage(const ast::Function& function)
+{
+    size_t memoryUsage = sizeof(ast::Function) + function.getStatements().capacity() * sizeof(void*);
+
+    // The expressions can be nested arbitrarily deep, hence, they are visited
+    // iteratively.
+    std::vector<const ast::Expression*> pendingExpressions;
+    for (const auto& statement : function.getStatements()) {
+        if (statement->getType() == ast::ASTNode::Type::AssignmentStatement) {
+            memoryUsage += sizeof(ast::AssignmentStatement) + sizeof(ast::Identifier);
+        } else {
+            memoryUsage += sizeof(ast::ReturnStatement);
+        }
+        pendingExpressions.push_back(&statement->getExpression());
+        while (!pendingExpressions.empty()) {
+            const auto* current = pendingExpressions.back();
+            pendingExpressions.pop_back();
+            memoryUsage += getNodeSize(*current);
+            if (current->getType() == ast::ASTNode::Type::UnaryOp) {
+                pendingExpressions.push_back(&static_cast<const ast::UnaryOp*>(current)->getExpression()); // NOLINT
+            } else if (current->getType() == ast::ASTNode::Type::BinaryOp) {
+                const auto* binaryOp = static_cast<const ast::BinaryOp*>(current); // NOLINT
+                pendingExpressions.push_back(&binaryOp->getLhsExpression());
+                pendingExpressions.push_back(&binaryOp->getRhsExpression());
+            }
+        }
+    }
+    return memoryUsage;
+}
+
+} // namespace
+
+ExecutionImage::ExecutionImage(std::unique_ptr<const ast::Function> function,
+                               const analysis::SymbolTable& symbolTable)
+    : function(std::move(function)),
+      constantValues(symbolTable.getConstantValues().begin(), symbolTable.getConstantValues().end()),
+      numberOfParameters(symbolTable.getNumberOfParameters()),
+      numberOfVariables(symbolTable.getNumberOfVariables())
+// Constructor
+{
+    assert(this->function != nullptr);
+    memoryUsage = sizeof(ExecutionImage) + constantValues.capacity() * sizeof(int64_t) +
+        estimateMemoryUsage(*this->function);
+}
+
+ExecutionImage::ExecutionImage(std::unique_ptr<const ast::Function> function,
+                               std::vector<int64_t> constantValues,
+                               size_t numberOfParameters,
+                               size_t numberOfVariables)
+    : function(std::move(function)),
+      constantValues(std::move(constantValues)),
+      numberOfParameters(numberOfParameters),
+      numberOfVariables(numberOfVariables)
+// Constructor for images which are not compiled from source code.
+{
+    assert(this->function != nullptr);
+    memoryUsage = sizeof(ExecutionImage) + this->constantValues.capacity() * sizeof(int64_t) +
+        estimateMemoryUsage(*this->function);
+}
+
+ExecutionImage::~ExecutionImage() = default;
+
+const ast::Function& ExecutionImage::getFunction() const
+// Returns a const-reference to the executable AST function node.
+{
+    return *function;
+}
+
+const std::vector<int64_t>& ExecutionImage::getConstantValues() const
+// Returns the values of the constants.
+{
+    return constantValues;
+}
+
+size_t ExecutionImage::getNumberOfParameters() const
+// Returns the number of parameters.
+{
+    return numberOfParameters;
+}
+
+size_t ExecutionImage::getNumberOfVariables() const
+// Returns the number of variables.
+{
+    return numberOfVariables;
+}
+
+size_t ExecutionImage::getMemoryUsage() const
+// Returns the estimated number of bytes which are occupied by the image.
+{
+    return memoryUsage;
+}
+
+void ExecutionImage::setExecutionProfile(std::shared_ptr<const ExecutionProfile> newExecutionProfile)
+// Sets the profile in which the executions of the image are recorded.
+{
+    executionProfile = std::move(newExecutionProfile);
+}
+
+const ExecutionProfile* ExecutionImage::getExecutionProfile() const
+// Returns the profile in which the executions of the image are recorded.
+{
+    return executionProfile.get();
+}
+
+} // namespace pljit::exec
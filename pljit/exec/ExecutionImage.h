@@ -0,0 +1,78 @@
+#ifndef H_exec_ExecutionImage
+#define H_exec_ExecutionImage
+
+#include "pljit/analysis/SymbolTableFwd.h"
+#include "pljit/ast/ASTFwd.h"
+#include "pljit/exec/ExecutionImageFwd.h"
+#include "pljit/exec/ExecutionProfileFwd.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pljit::exec {
+
+/// The compact representation of a compiled function. It only contains what
+/// is needed for executing the function, i.e. it does neither reference the
+/// source code nor the names of the symbols.
+class ExecutionImage {
+    public:
+    /// Constructor
+    ExecutionImage(std::unique_ptr<const ast::Function> function,
+                   const analysis::SymbolTable& symbolTable);
+
+    /// Constructor for images which are not compiled from source code.
+    ExecutionImage(std::unique_ptr<const ast::Function> function,
+                   std::vector<int64_t> constantValues,
+                   size_t numberOfParameters,
+                   size_t numberOfVariables);
+
+    /// Destructor
+    ~ExecutionImage();
+
+    /// Copy constructor/assignment
+    ExecutionImage(const ExecutionImage& other) = delete;
+    ExecutionImage& operator=(const ExecutionImage& other) = delete;
+
+    /// Returns a const-reference to the executable AST function node.
+    const ast::Function& getFunction() const;
+
+    /// Returns the values of the constants (the index represents the symbol id).
+    const std::vector<int64_t>& getConstantValues() const;
+
+    /// Returns the number of parameters.
+    size_t getNumberOfParameters() const;
+
+    /// Returns the number of variables.
+    size_t getNumberOfVariables() const;
+
+    /// Returns the estimated number of bytes which are occupied by the image.
+    size_t getMemoryUsage() const;
+
+    /// Sets the profile in which the executions of the image are recorded.
+    /// Must be set before the image is published.
+    void setExecutionProfile(std::shared_ptr<const ExecutionProfile> newExecutionProfile);
+
+    /// Returns the profile in which the executions of the image are recorded
+    /// (nullptr if the image is not profiled).
+    const ExecutionProfile* getExecutionProfile() const;
+
+    private:
+    /// Executable AST function node
+    std::unique_ptr<const ast::Function> function;
+
+    /// Values of the constants
+    std::vector<int64_t> constantValues;
+
+    size_t numberOfParameters;
+    size_t numberOfVariables;
+
+    /// Estimated memory usage (computed once on construction)
+    size_t memoryUsage;
+
+    /// Execution profile (optional)
+    std::shared_ptr<const ExecutionProfile> executionProfile;
+};
+
+} // namespace pljit::exec
+
+#endif
@@ -0,0 +1,74 @@
+#include "ExecutionImageCache.h"
+#include "pljit/exec/ExecutionImage.h"
+#include <algorithm>
+
+namespace pljit::exec {
+
+std::shared_ptr<const ExecutionImage> ExecutionImageCache::lookup(const FunctionFingerprint& fingerprint)
+// Returns the cached image for the fingerprint.
+{
+    std::unique_lock lck(mutex);
+    return find(fingerprint);
+}
+
+std::shared_ptr<const ExecutionImage> ExecutionImageCache::insert(const FunctionFingerprint& fingerprint,
+                                                                  std::shared_ptr<const ExecutionImage> image)
+// Inserts an image for the fingerprint.
+{
+    std::unique_lock lck(mutex);
+    if (auto existingImage = find(fingerprint)) {
+        return existingImage;
+    }
+
+    entries[fingerprint.getHash()].push_back({fingerprint.getEncoding(), image});
+    ++numberOfEntries;
+    if (numberOfEntries >= nextCleanup) {
+        removeExpiredEntries();
+        nextCleanup = std::max<size_t>(64, 2 * numberOfEntries);
+    }
+    return image;
+}
+
+size_t ExecutionImageCache::size()
+// Returns the number of cached images which are still alive.
+{
+    std::unique_lock lck(mutex);
+    size_t aliveImages = 0;
+    for (const auto& [hash, bucket] : entries) {
+        aliveImages += std::count_if(bucket.begin(), bucket.end(), [](const Entry& entry) {
+            return !entry.image.expired();
+        });
+    }
+    return aliveImages;
+}
+
+std::shared_ptr<const ExecutionImage> ExecutionImageCache::find(const FunctionFingerprint& fingerprint)
+// Returns the alive image of the entry with an equal fingerprint.
+{
+    auto it = entries.find(fingerprint.getHash());
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    // Different functions only share a bucket if their hashes collide.
+    for (const auto& entry : it->second) {
+        if (entry.encoding == fingerprint.getEncoding()) {
+            // An expired entry might be followed by the entry of a newer image.
+            if (auto image = entry.image.lock()) {
+                return image;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void ExecutionImageCache::removeExpiredEntries()
+// Removes the entries whose images were freed.
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto& bucket = it->second;
+        numberOfEntries -= std::erase_if(bucket, [](const Entry& entry) { return entry.image.expired(); });
+        it = bucket.empty() ? entries.erase(it) : std::next(it);
+    }
+}
+
+} // namespace pljit::exec
@@ -0,0 +1,65 @@
+#ifndef H_exec_ExecutionImageCache
+#define H_exec_ExecutionImageCache
+
+#include "pljit/exec/ExecutionImageFwd.h"
+#include "pljit/exec/FunctionFingerprint.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace pljit::exec {
+
+/// A content-addressed cache of the execution images. Functions with equal
+/// fingerprints share one immutable execution image. The images are grouped by
+/// the hashes of their fingerprints and a lookup compares the fingerprint with
+/// the encodings which are stored next to the images. The fingerprints must be
+/// computed from the function as it is compiled into the image, i.e. after the
+/// optimization passes. The cache does not keep the images alive, i.e. an
+/// image is freed once no function uses it anymore.
+class ExecutionImageCache {
+    public:
+    /// Returns the cached image for the fingerprint, or nullptr if no function
+    /// with an equal fingerprint is alive.
+    /// Note: This function is thread-safe.
+    std::shared_ptr<const ExecutionImage> lookup(const FunctionFingerprint& fingerprint);
+
+    /// Inserts an image for the fingerprint. If another thread inserted an
+    /// image for an equal fingerprint in the meantime, that image is returned.
+    /// Note: This function is thread-safe.
+    std::shared_ptr<const ExecutionImage> insert(const FunctionFingerprint& fingerprint,
+                                                 std::shared_ptr<const ExecutionImage> image);
+
+    /// Returns the number of cached images which are still alive.
+    /// Note: This function is thread-safe.
+    size_t size();
+
+    private:
+    /// A cached image together with the encoding of its fingerprint
+    struct Entry {
+        std::vector<int64_t> encoding;
+        std::weak_ptr<const ExecutionImage> image;
+    };
+
+    /// Returns the alive image in the bucket of the fingerprint whose encoding
+    /// equals the fingerprint, or nullptr.
+    /// Note: Must be called while holding the mutex.
+    std::shared_ptr<const ExecutionImage> find(const FunctionFingerprint& fingerprint);
+
+    /// Removes the entries whose images were freed.
+    /// Note: Must be called while holding the mutex.
+    void removeExpiredEntries();
+
+    std::mutex mutex;
+    /// The entries grouped by the hash of their fingerprints
+    std::unordered_map<uint64_t, std::vector<Entry>> entries;
+    /// Number of entries in all buckets
+    size_t numberOfEntries{0};
+    /// Expired entries are removed once the number of entries doubled.
+    size_t nextCleanup{64};
+};
+
+} // namespace pljit::exec
+
+#endif
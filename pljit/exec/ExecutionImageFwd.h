@@ -0,0 +1,10 @@
+#ifndef H_exec_ExecutionImageFwd
+#define H_exec_ExecutionImageFwd
+
+namespace pljit::exec {
+
+class ExecutionImage;
+
+} // namespace pljit::exec
+
+#endif
@@ -0,0 +1,169 @@
+#include "ExecutionProfile.h"
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+
+namespace pljit::exec {
+
+namespace {
+
+/// Width of the prefix of an annotated line
+constexpr size_t prefixWidth = 23;
+
+/// Returns the share of the ticks in percent.
+double getShare(uint64_t ticks, uint64_t totalTicks)
+{
+    return totalTicks == 0 ? 0.0 : 100.0 * static_cast<double>(ticks) / static_cast<double>(totalTicks);
+}
+
+/// Returns whether the node is an operation, i.e. underlined in the annotated source.
+bool isOperation(ast::ASTNode::Type type)
+{
+    return type == ast::ASTNode::Type::UnaryOp || type == ast::ASTNode::Type::BinaryOp;
+}
+
+/// Returns whether the node is a statement.
+bool isStatement(ast::ASTNode::Type type)
+{
+    return type == ast::ASTNode::Type::AssignmentStatement || type == ast::ASTNode::Type::ReturnStatement;
+}
+
+} // namespace
+
+ExecutionProfile::ExecutionProfile(ast::NodeSourceMap sourceMap)
+    : sourceMap(std::move(sourceMap)),
+      counters(this->sourceMap.size())
+// Constructor
+{}
+
+void ExecutionProfile::record(uint32_t nodeId, uint64_t ticks) const
+// Records an execution of the node with the given id.
+{
+    if (nodeId == 0) {
+        return;
+    }
+    assert(nodeId <= counters.size());
+    const auto& nodeCounters = counters[nodeId - 1];
+    nodeCounters.executions.fetch_add(1, std::memory_order_relaxed);
+    nodeCounters.ticks.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+const ast::NodeSourceMap& ExecutionProfile::getSourceMap() const
+// Returns the source map of the profiled function.
+{
+    return sourceMap;
+}
+
+std::vector<ExecutionProfile::NodeProfile> ExecutionProfile::getNodeProfiles() const
+// Returns the profiles of all nodes ordered by their id.
+{
+    std::vector<NodeProfile> nodeProfiles;
+    nodeProfiles.reserve(counters.size());
+    for (uint32_t nodeId = 1; nodeId <= counters.size(); ++nodeId) {
+        nodeProfiles.push_back(getNodeProfile(nodeId));
+    }
+    return nodeProfiles;
+}
+
+ExecutionProfile::NodeProfile ExecutionProfile::getNodeProfile(uint32_t nodeId) const
+// Returns the profile of the node with the given id.
+{
+    const auto& entry = sourceMap.getEntry(nodeId);
+    const auto& nodeCounters = counters[nodeId - 1];
+    return {nodeId, entry.type, entry.offset, entry.length,
+            nodeCounters.executions.load(std::memory_order_relaxed),
+            nodeCounters.ticks.load(std::memory_order_relaxed)};
+}
+
+uint64_t ExecutionProfile::getTotalTicks() const
+// Returns the ticks which were spent in the statements of the function.
+{
+    uint64_t totalTicks = 0;
+    for (uint32_t nodeId = 1; nodeId <= counters.size(); ++nodeId) {
+        if (isStatement(sourceMap.getEntry(nodeId).type)) {
+            totalTicks += counters[nodeId - 1].ticks.load(std::memory_order_relaxed);
+        }
+    }
+    return totalTicks;
+}
+
+void ExecutionProfile::reset()
+// Resets all counters.
+{
+    for (auto& nodeCounters : counters) {
+        nodeCounters.executions.store(0, std::memory_order_relaxed);
+        nodeCounters.ticks.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ExecutionProfile::writeAnnotatedSource(std::ostream& out, std::string_view sourceCode) const
+// Writes the source code annotated with the profile.
+{
+    auto totalTicks = getTotalTicks();
+
+    // The executed nodes ordered by their position, outer nodes first.
+    std::vector<NodeProfile> nodeProfiles;
+    for (const auto& nodeProfile : getNodeProfiles()) {
+        if (nodeProfile.executions > 0 && nodeProfile.offset < sourceCode.size()) {
+            nodeProfiles.push_back(nodeProfile);
+        }
+    }
+    std::stable_sort(nodeProfiles.begin(), nodeProfiles.end(), [](const NodeProfile& lhs, const NodeProfile& rhs) {
+        return lhs.offset != rhs.offset ? lhs.offset < rhs.offset : lhs.length > rhs.length;
+    });
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%12s %7s |", "executions", "ticks");
+    out << buffer << "\n";
+
+    auto nextNode = nodeProfiles.begin();
+    size_t lineBegin = 0;
+    while (lineBegin < sourceCode.size()) {
+        auto lineEnd = std::min(sourceCode.find('\n', lineBegin), sourceCode.size());
+        auto line = sourceCode.substr(lineBegin, lineEnd - lineBegin);
+
+        // The nodes which start on the current line.
+        auto lineNodesEnd = nextNode;
+        while (lineNodesEnd != nodeProfiles.end() && lineNodesEnd->offset < lineEnd + 1) {
+            ++lineNodesEnd;
+        }
+
+        uint64_t statementExecutions = 0;
+        uint64_t statementTicks = 0;
+        bool hasStatement = false;
+        for (auto it = nextNode; it != lineNodesEnd; ++it) {
+            if (isStatement(it->type)) {
+                hasStatement = true;
+                statementExecutions += it->executions;
+                statementTicks += it->ticks;
+            }
+        }
+        if (hasStatement) {
+            std::snprintf(buffer, sizeof(buffer), "%12" PRIu64 " %6.2f%% | ", statementExecutions,
+                          getShare(statementTicks, totalTicks));
+            out << buffer;
+        } else {
+            out << std::string(prefixWidth - 2, ' ') << "| ";
+        }
+        out << line << "\n";
+
+        // Underline the operations.
+        for (auto it = nextNode; it != lineNodesEnd; ++it) {
+            if (!isOperation(it->type)) {
+                continue;
+            }
+            auto column = it->offset - lineBegin;
+            auto length = std::max<size_t>(1, std::min<size_t>(it->length, line.size() - column));
+            std::snprintf(buffer, sizeof(buffer), " %.2f%% (%" PRIu64 "x)", getShare(it->ticks, totalTicks),
+                          it->executions);
+            out << std::string(prefixWidth - 2, ' ') << "| " << std::string(column, ' ') << '^'
+                << std::string(length - 1, '~') << buffer << "\n";
+        }
+
+        nextNode = lineNodesEnd;
+        lineBegin = lineEnd + 1;
+    }
+}
+
+} // namespace pljit::exec
@@ -0,0 +1,80 @@
+#ifndef H_exec_ExecutionProfile
+#define H_exec_ExecutionProfile
+
+#include "pljit/ast/NodeSourceMap.h"
+#include "pljit/exec/ExecutionProfileFwd.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace pljit::exec {
+
+/// Per-node execution counts and inclusive ticks of a profiled function. The
+/// counters are indexed by the node ids of a NodeSourceMap, such that every
+/// counter can be attributed to its range of the source code.
+/// Note: The ticks of a node include the ticks of its operands as well as the
+///       overhead of the instrumentation, hence, they are meant to compare nodes
+///       of the same function rather than to measure absolute costs.
+class ExecutionProfile {
+    public:
+    /// The profile of a single AST node.
+    struct NodeProfile {
+        uint32_t nodeId;
+        ast::ASTNode::Type type;
+        /// Source range of the node
+        uint32_t offset;
+        uint32_t length;
+        /// Number of times the node was executed
+        uint64_t executions;
+        /// Inclusive ticks spent in the node
+        uint64_t ticks;
+    };
+
+    /// Constructor
+    explicit ExecutionProfile(ast::NodeSourceMap sourceMap);
+
+    /// Records an execution of the node with the given id. Nodes without an
+    /// id (zero) are ignored.
+    /// Note: This function is thread-safe.
+    void record(uint32_t nodeId, uint64_t ticks) const;
+
+    /// Returns the source map of the profiled function.
+    const ast::NodeSourceMap& getSourceMap() const;
+
+    /// Returns the profiles of all nodes ordered by their id.
+    std::vector<NodeProfile> getNodeProfiles() const;
+
+    /// Returns the profile of the node with the given id.
+    NodeProfile getNodeProfile(uint32_t nodeId) const;
+
+    /// Returns the ticks which were spent in the statements of the function.
+    uint64_t getTotalTicks() const;
+
+    /// Resets all counters.
+    void reset();
+
+    /// Writes the source code annotated with the profile. Every line is
+    /// prefixed with the executions and the share of the ticks of the
+    /// statements which start on it. The unary and binary operations which
+    /// start on a line are underlined below it together with their share.
+    void writeAnnotatedSource(std::ostream& out, std::string_view sourceCode) const;
+
+    private:
+    /// Counters of a node
+    struct Counters {
+        mutable std::atomic<uint64_t> executions{0};
+        mutable std::atomic<uint64_t> ticks{0};
+    };
+
+    /// Source ranges of the nodes
+    ast::NodeSourceMap sourceMap;
+
+    /// Counters (the index plus one represents the node id)
+    std::vector<Counters> counters;
+};
+
+} // namespace pljit::exec
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef H_exec_ExecutionProfileFwd
+#define H_exec_ExecutionProfileFwd
+
+namespace pljit::exec {
+
+class ExecutionProfile;
+
+} // namespace pljit::exec
+
+#endif
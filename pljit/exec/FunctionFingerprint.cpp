@@ -0,0 +1,160 @@
+#include "FunctionFingerprint.h"
+#include "pljit/analysis/SymbolTable.h"
+#include "pljit/ast/AST.h"
+#include "pljit/exec/ExecutionImage.h"
+#include <utility>
+
+namespace pljit::exec {
+
+namespace {
+
+void appendOpcode(std::vector<int64_t>& encoding, FunctionFingerprint::Opcode opcode)
+{
+    encoding.push_back(static_cast<int64_t>(opcode));
+}
+
+/// Returns the opcode of an identifier.
+FunctionFingerprint::Opcode getIdentifierOpcode(const ast::Identifier& identifier)
+{
+    switch (identifier.getIdentifierType()) {
+        case ast::Identifier::Type::Parameter:
+            return FunctionFingerprint::Opcode::Parameter;
+        case ast::Identifier::Type::Variable:
+            return FunctionFingerprint::Opcode::Variable;
+        case ast::Identifier::Type::Constant:
+            return FunctionFingerprint::Opcode::Constant;
+    }
+    __builtin_unreachable();
+}
+
+/// FNV-1a hash over the words of the encoding.
+uint64_t hashEncoding(const std::vector<int64_t>& encoding)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (auto word : encoding) {
+        hash ^= static_cast<uint64_t>(word);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+FunctionFingerprint::FunctionFingerprint(const ast::Function& function,
+                                         const analysis::SymbolTable& symbolTable)
+// Constructor
+{
+    encodeFunction(function, symbolTable.getNumberOfParameters(), symbolTable.getNumberOfVariables(),
+                   symbolTable.getConstantValues());
+    hash = hashEncoding(encoding);
+}
+
+FunctionFingerprint::FunctionFingerprint(const ExecutionImage& image)
+// Constructor for the function of a compiled image.
+{
+    encodeFunction(image.getFunction(), image.getNumberOfParameters(), image.getNumberOfVariables(),
+                   image.getConstantValues());
+    hash = hashEncoding(encoding);
+}
+
+bool FunctionFingerprint::operator==(const FunctionFingerprint& other) const
+// Comparison operator
+{
+    return hash == other.hash && encoding == other.encoding;
+}
+
+void FunctionFingerprint::encodeFunction(const ast::Function& function, size_t numberOfParameters,
+                                         size_t numberOfVariables, std::span<const int64_t> constantValues)
+// Appends the encoding of a function.
+{
+    encoding.push_back(static_cast<int64_t>(numberOfParameters));
+    encoding.push_back(static_cast<int64_t>(numberOfVariables));
+    encoding.push_back(static_cast<int64_t>(constantValues.size()));
+    encoding.insert(encoding.end(), constantValues.begin(), constantValues.end());
+
+    for (const auto& statement : function.getStatements()) {
+        encodeExpression(statement->getExpression());
+        if (statement->getType() == ast::ASTNode::Type::AssignmentStatement) {
+            const auto& target = static_cast<const ast::AssignmentStatement&>(*statement).getAssignmentTarget(); // NOLINT
+            appendOpcode(encoding, Opcode::Assignment);
+            appendOpcode(encoding, getIdentifierOpcode(target));
+            encoding.push_back(static_cast<int64_t>(target.getId()));
+        } else {
+            appendOpcode(encoding, Opcode::Return);
+        }
+    }
+}
+
+void FunctionFingerprint::encodeExpression(const ast::Expression& expression)
+// Appends an expression in post-order.
+{
+    // The expressions can be nested arbitrarily deep, hence, the operations are
+    // visited iteratively: once before and once after their children.
+    std::vector<std::pair<const ast::Expression*, bool>> pendingExpressions;
+    pendingExpressions.emplace_back(&expression, false);
+    while (!pendingExpressions.empty()) {
+        auto [current, childrenVisited] = pendingExpressions.back();
+        pendingExpressions.pop_back();
+
+        switch (current->getType()) {
+            case ast::ASTNode::Type::ConstantLiteral: {
+                const auto& literal = static_cast<const ast::ConstantLiteral&>(*current); // NOLINT
+                appendOpcode(encoding, Opcode::ConstantLiteral);
+                encoding.push_back(literal.getValue());
+                break;
+            }
+
+            case ast::ASTNode::Type::Identifier: {
+                const auto& identifier = static_cast<const ast::Identifier&>(*current); // NOLINT
+                appendOpcode(encoding, getIdentifierOpcode(identifier));
+                encoding.push_back(static_cast<int64_t>(identifier.getId()));
+                break;
+            }
+
+            case ast::ASTNode::Type::UnaryOp: {
+                const auto& unaryOp = static_cast<const ast::UnaryOp&>(*current); // NOLINT
+                if (!childrenVisited) {
+                    pendingExpressions.emplace_back(current, true);
+                    pendingExpressions.emplace_back(&unaryOp.getExpression(), false);
+                    break;
+                }
+                appendOpcode(encoding, unaryOp.getUnaryOpType() == ast::UnaryOp::Type::PlusSign ?
+                                           Opcode::PlusSign :
+                                           Opcode::MinusSign);
+                break;
+            }
+
+            case ast::ASTNode::Type::BinaryOp: {
+                const auto& binaryOp = static_cast<const ast::BinaryOp&>(*current); // NOLINT
+                if (!childrenVisited) {
+                    // The lhs is encoded before the rhs.
+                    pendingExpressions.emplace_back(current, true);
+                    pendingExpressions.emplace_back(&binaryOp.getRhsExpression(), false);
+                    pendingExpressions.emplace_back(&binaryOp.getLhsExpression(), false);
+                    break;
+                }
+                switch (binaryOp.getBinaryOpType()) {
+                    case ast::BinaryOp::Type::Add:
+                        appendOpcode(encoding, Opcode::Add);
+                        break;
+                    case ast::BinaryOp::Type::Sub:
+                        appendOpcode(encoding, Opcode::Sub);
+                        break;
+                    case ast::BinaryOp::Type::Mul:
+                        appendOpcode(encoding, Opcode::Mul);
+                        break;
+                    case ast::BinaryOp::Type::Div:
+                        appendOpcode(encoding, Opcode::Div);
+                        break;
+                }
+                break;
+            }
+
+            default:
+                // Functions and statements are no expressions.
+                __builtin_unreachable();
+        }
+    }
+}
+
+} // namespace pljit::exec
@@ -0,0 +1,67 @@
+#ifndef H_exec_FunctionFingerprint
+#define H_exec_FunctionFingerprint
+
+#include "pljit/analysis/SymbolTableFwd.h"
+#include "pljit/ast/ASTFwd.h"
+#include "pljit/exec/ExecutionImageFwd.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pljit::exec {
+
+/// A canonical encoding of an analyzed function. The identifiers are encoded
+/// by their symbol ids instead of their names and the source locations are
+/// not part of the encoding. Hence, functions which only differ in whitespace
+/// or in the names of their identifiers have equal fingerprints.
+class FunctionFingerprint {
+    public:
+    /// Operations of the encoding. The expressions of a statement are encoded
+    /// in post-order and followed by the statement.
+    enum class Opcode : int64_t {
+        ConstantLiteral, // followed by the value
+        Parameter, // followed by the symbol id
+        Variable, // followed by the symbol id
+        Constant, // followed by the symbol id
+        PlusSign,
+        MinusSign,
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Assignment, // followed by the identifier opcode and the symbol id of the target
+        Return
+    };
+
+    /// Constructor
+    FunctionFingerprint(const ast::Function& function, const analysis::SymbolTable& symbolTable);
+
+    /// Constructor for the function of a compiled image.
+    explicit FunctionFingerprint(const ExecutionImage& image);
+
+    /// Returns the hash of the encoding.
+    uint64_t getHash() const { return hash; }
+
+    /// Returns the encoding. It starts with the number of parameters, the
+    /// number of variables, the number of constants and the constant values,
+    /// which is followed by the encoded statements.
+    const std::vector<int64_t>& getEncoding() const { return encoding; }
+
+    /// Comparison operator
+    bool operator==(const FunctionFingerprint& other) const;
+
+    private:
+    /// Appends the encoding of a function.
+    void encodeFunction(const ast::Function& function, size_t numberOfParameters, size_t numberOfVariables,
+                        std::span<const int64_t> constantValues);
+
+    /// Appends an expression in post-order.
+    void encodeExpression(const ast::Expression& expression);
+
+    std::vector<int64_t> encoding;
+    uint64_t hash;
+};
+
+} // namespace pljit::exec
+
+#endif
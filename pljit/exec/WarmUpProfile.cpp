@@ -0,0 +1,119 @@
+#include "WarmUpProfile.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+
+namespace pljit::exec {
+
+namespace {
+
+/// The first line of a profile
+constexpr std::string_view profileHeader = "pljit-profile 1";
+
+std::string_view getTierName(WarmUpProfile::Tier tier)
+{
+    switch (tier) {
+        case WarmUpProfile::Tier::Compiled:
+            return "compiled";
+    }
+    __builtin_unreachable();
+}
+
+std::optional<WarmUpProfile::Tier> parseTierName(std::string_view name)
+{
+    if (name == getTierName(WarmUpProfile::Tier::Compiled)) {
+        return WarmUpProfile::Tier::Compiled;
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+std::optional<WarmUpProfile> WarmUpProfile::read(const std::string& path)
+// Reads a profile.
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line) || line != profileHeader) {
+        return std::nullopt;
+    }
+
+    WarmUpProfile profile;
+    while (std::getline(file, line)) {
+        std::istringstream lineStream(line);
+        uint64_t sourceHash = 0;
+        uint64_t numberOfCalls = 0;
+        std::string tierName;
+        if (!(lineStream >> std::hex >> sourceHash >> std::dec >> numberOfCalls >> tierName)) {
+            return std::nullopt;
+        }
+        auto tier = parseTierName(tierName);
+        if (!tier) {
+            return std::nullopt;
+        }
+        profile.add(sourceHash, {numberOfCalls, *tier});
+    }
+    return profile;
+}
+
+bool WarmUpProfile::write(const std::string& path) const
+// Writes the profile.
+{
+    // The hottest functions come first, which makes the file easy to inspect.
+    std::vector<std::pair<uint64_t, Entry>> sortedEntries(entries.begin(), entries.end());
+    std::sort(sortedEntries.begin(), sortedEntries.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second.numberOfCalls > rhs.second.numberOfCalls;
+    });
+
+    // The profile is written to a unique temporary file first and then
+    // renamed, which atomically replaces the previous profile. Hence, a
+    // concurrent or crashing process never leaves a partial profile behind.
+    static std::atomic<uint64_t> nextTemporaryId{0};
+    auto temporaryPath = path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(nextTemporaryId++);
+    {
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        file << profileHeader << "\n";
+        for (const auto& [sourceHash, entry] : sortedEntries) {
+            file << std::hex << sourceHash << std::dec << " " << entry.numberOfCalls << " "
+                 << getTierName(entry.tier) << "\n";
+        }
+        file.close();
+        if (!file) {
+            std::error_code errorCode;
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+    }
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryPath, path, errorCode);
+    if (errorCode) {
+        std::filesystem::remove(temporaryPath, errorCode);
+        return false;
+    }
+    return true;
+}
+
+void WarmUpProfile::add(uint64_t sourceHash, Entry entry)
+// Adds a function to the profile.
+{
+    auto [it, inserted] = entries.emplace(sourceHash, entry);
+    if (!inserted) {
+        it->second.numberOfCalls += entry.numberOfCalls;
+    }
+}
+
+std::optional<WarmUpProfile::Entry> WarmUpProfile::lookup(uint64_t sourceHash) const
+// Looks up a function.
+{
+    auto it = entries.find(sourceHash);
+    if (it == entries.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+} // namespace pljit::exec
@@ -0,0 +1,55 @@
+#ifndef H_exec_WarmUpProfile
+#define H_exec_WarmUpProfile
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace pljit::exec {
+
+/// A profile of the functions which were compiled during a run, identified by
+/// the hash of their source code. The profile is written at shutdown and
+/// read on the next start, such that the hot functions can be compiled before
+/// they are called. It is stored as a small text file with one line per
+/// function:
+///
+///     <source hash (hex)> <estimated number of calls> <tier>
+class WarmUpProfile {
+    public:
+    /// The tiers a function can reach. There is only one tier so far, i.e.
+    /// the compiled AST.
+    enum class Tier {
+        Compiled
+    };
+
+    struct Entry {
+        /// Estimated number of calls
+        uint64_t numberOfCalls;
+        Tier tier;
+    };
+
+    /// Reads a profile. Returns an empty optional if the file cannot be read
+    /// or is invalid.
+    static std::optional<WarmUpProfile> read(const std::string& path);
+
+    /// Writes the profile. Returns false if the file cannot be written.
+    bool write(const std::string& path) const;
+
+    /// Adds a function to the profile. If the function is already part of the
+    /// profile, the calls are accumulated.
+    void add(uint64_t sourceHash, Entry entry);
+
+    /// Looks up a function.
+    std::optional<Entry> lookup(uint64_t sourceHash) const;
+
+    /// Returns the number of functions in the profile.
+    size_t size() const { return entries.size(); }
+
+    private:
+    std::unordered_map<uint64_t, Entry> entries;
+};
+
+} // namespace pljit::exec
+
+#endif
@@ -1,5 +1,7 @@
 #include "Lexer.h"
+#include "pljit/common/SPSCRingBuffer.h"
 #include <cassert>
+#include <thread>
 
 namespace pljit::lexer {
 
@@ -27,22 +29,92 @@ bool isLegalChar(char c)
         isWhitespace(c); // covers whitespaces
 }
 
+/// Number of tokens which can be buffered between the producer and the consumer.
+constexpr size_t pipelineCapacity = 4096;
+
 } // namespace
 
-Lexer::Lexer(const common::SourceCodeManager& manager)
+struct Lexer::Pipeline {
+    /// Constructor
+    Pipeline() : tokens(pipelineCapacity) {}
+
+    /// Returns true if there are still tokens left. Waits for the producer
+    /// if no token is buffered yet.
+    bool hasNext();
+
+    /// Returns the next token.
+    TokenizedToken pop();
+
+    /// Tokens which were produced but not yet consumed. The producer finishes
+    /// the ring buffer after the last token and the consumer stops it to
+    /// abort the producer.
+    common::SPSCRingBuffer<std::optional<TokenizedToken>> tokens;
+    /// The token which was taken from the ring buffer by hasNext().
+    std::optional<TokenizedToken> prefetched{};
+    /// Thread which produces the tokens.
+    std::thread producer{};
+};
+
+bool Lexer::Pipeline::hasNext()
+// Returns true if there are still tokens left.
+{
+    return prefetched.has_value() || tokens.pop(prefetched);
+}
+
+Lexer::TokenizedToken Lexer::Pipeline::pop()
+// Returns the next token.
+{
+    [[maybe_unused]] bool hasNextToken = hasNext();
+    assert(hasNextToken);
+    auto token = std::move(prefetched.value());
+    prefetched = std::nullopt;
+    return token;
+}
+
+Lexer::Lexer(const common::SourceCodeManager& manager, bool pipelined, Statistics* statistics)
     : sourceCodeManager(manager),
       current(sourceCodeManager.getCodeBegin()),
-      end(sourceCodeManager.getCodeEnd())
+      end(sourceCodeManager.getCodeEnd()),
+      statistics(statistics)
+// Constructor
+{
+    // We always ensure that current points to a non-whitespace character.
+    trimLeadingWhitespace();
+
+    if (pipelined) {
+        startPipeline();
+    }
+}
+
+Lexer::Lexer(const common::SourceCodeManager& manager,
+             common::SourceCodeManager::SourceCodeIterator begin,
+             common::SourceCodeManager::SourceCodeIterator end,
+             bool reportErrors,
+             Statistics* statistics)
+    : sourceCodeManager(manager),
+      current(begin),
+      end(end),
+      reportErrors(reportErrors),
+      statistics(statistics)
 // Constructor
 {
     // We always ensure that current points to a non-whitespace character.
     trimLeadingWhitespace();
 }
 
-bool Lexer::hasNext() const
+Lexer::~Lexer()
+// Destructor
+{
+    stopPipeline();
+}
+
+bool Lexer::hasNext()
 // Returns true if there are still tokens left and false otherwise.
 {
-    return current != end || tokenCache.has_value();
+    if (tokenCache.has_value()) {
+        return true;
+    }
+    return pipeline != nullptr ? pipeline->hasNext() : current != end;
 }
 
 Token Lexer::next()
@@ -61,7 +133,26 @@ Token Lexer::next()
         return token;
     }
 
-    assert(hasNext());
+    auto [token, errorMessage] = pipeline != nullptr ? pipeline->pop() : tokenizeMeasured();
+    if (statistics != nullptr) {
+        ++statistics->numberOfTokens;
+    }
+    if (token.hasError()) {
+        // The error is reported when the error token is consumed, such that
+        // the order of the error messages is the same in pipelined mode.
+        if (reportErrors) {
+            sourceCodeManager.printContext(token.getReference(), errorMessage);
+        }
+        // Store the error in the token cache to not let the caller continue.
+        tokenCache = token;
+    }
+    return token;
+}
+
+Lexer::TokenizedToken Lexer::tokenize()
+// Tokenizes the next token.
+{
+    assert(current != end);
     // Current should always point to the first non-whitespace character if the
     // end was not yet reached.
     assert(!isWhitespace(*current));
@@ -72,10 +163,8 @@ Token Lexer::next()
 
     if (!isLegalChar(firstChar)) {
         // The next char is an invalid character. Hence, we stop the compilation.
-        sourceCodeManager.printContext(startRef, "error: illegal character");
-        // Store the error in the token cache to not let the caller continue.
-        tokenCache = Token(Token::Type::LexerError, common::SourceRangeReference(startRef));
-        return tokenCache.value();
+        return {Token(Token::Type::LexerError, common::SourceRangeReference(startRef)),
+                "error: illegal character"};
     }
 
     // Move to the next char.
@@ -90,7 +179,7 @@ Token Lexer::next()
         // found or the end is reached.
         trimLeadingWhitespace();
 
-        return Token(tokenType, common::SourceRangeReference(startRef));
+        return {Token(tokenType, common::SourceRangeReference(startRef))};
     }
 
     // The token must be a multi-character token (if valid of course)!
@@ -107,10 +196,8 @@ Token Lexer::next()
         if (!isLegalChar(currentChar)) {
             // The current char is an illegal character. Hence, we stop the compilation.
             common::SourceLocationReference ref(current);
-            sourceCodeManager.printContext(ref, "error: illegal character");
-            // Store the error in the token cache to not let the caller continue.
-            tokenCache = Token(Token::Type::LexerError, common::SourceRangeReference(ref));
-            return tokenCache.value();
+            return {Token(Token::Type::LexerError, common::SourceRangeReference(ref)),
+                    "error: illegal character"};
         }
 
         // Edge case: assignment operator
@@ -119,10 +206,8 @@ Token Lexer::next()
                 // We have an illegal token type. We stop the compilation.
                 common::SourceLocationReference currentRef(current);
                 common::SourceRangeReference rangeRef(startRef, currentRef);
-                sourceCodeManager.printContext(rangeRef, "error: unknown multi-character token");
-                // Store the error in the token cache to not let the caller continue.
-                tokenCache = Token(Token::Type::LexerError, rangeRef);
-                return tokenCache.value();
+                return {Token(Token::Type::LexerError, rangeRef),
+                        "error: unknown multi-character token"};
             }
             // We found an assignment token!
             tokenType = Token::Type::Assignment;
@@ -156,7 +241,19 @@ Token Lexer::next()
     trimLeadingWhitespace();
 
     assert(tokenType != Token::Type::Unknown);
-    return Token(tokenType, ref);
+    return {Token(tokenType, ref)};
+}
+
+Lexer::TokenizedToken Lexer::tokenizeMeasured()
+// Tokenizes the next token on the consuming thread and measures the time.
+{
+    if (statistics == nullptr) {
+        return tokenize();
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto token = tokenize();
+    statistics->time += std::chrono::steady_clock::now() - start;
+    return token;
 }
 
 Token Lexer::peek()
@@ -171,6 +268,66 @@ Token Lexer::peek()
     return tokenCache.value();
 }
 
+void Lexer::skipTo(common::SourceCodeManager::SourceCodeIterator position)
+// Continues tokenizing at the given position.
+{
+    // The producer owns the current position, hence, it is restarted.
+    bool pipelined = pipeline != nullptr;
+    stopPipeline();
+
+    assert(position <= end);
+    current = position;
+    if (statistics != nullptr && tokenCache.has_value()) {
+        // The peeked token is skipped.
+        --statistics->numberOfTokens;
+    }
+    tokenCache = std::nullopt;
+    trimLeadingWhitespace();
+
+    if (pipelined) {
+        startPipeline();
+    }
+}
+
+void Lexer::startPipeline()
+// Starts the thread which produces the tokens.
+{
+    assert(pipeline == nullptr);
+    pipeline = std::make_unique<Pipeline>();
+    pipeline->producer = std::thread([this]() { produceTokens(); });
+}
+
+void Lexer::stopPipeline()
+// Stops the thread which produces the tokens.
+{
+    if (pipeline == nullptr) {
+        return;
+    }
+    pipeline->tokens.stop();
+    pipeline->producer.join();
+    pipeline.reset();
+}
+
+void Lexer::produceTokens()
+// Produces the tokens until the end or an error is reached.
+{
+    while (current != end) {
+        std::optional<TokenizedToken> token = tokenize();
+        bool hasError = token->token.hasError();
+
+        if (!pipeline->tokens.push(std::move(token))) {
+            // The consumer stopped.
+            return;
+        }
+
+        if (hasError) {
+            // The consumer stops at the first error.
+            break;
+        }
+    }
+    pipeline->tokens.finish();
+}
+
 void Lexer::trimLeadingWhitespace()
 // Trims leading whitespace.
 {
@@ -4,20 +4,55 @@
 #include "pljit/common/SourceCodeManager.h"
 #include "pljit/common/References.h"
 #include "pljit/lexer/Token.h"
+#include <chrono>
+#include <memory>
 #include <optional>
+#include <string_view>
 
 namespace pljit::lexer {
 
 /// A class which performs lexical analysis on source code in a stream-like
 /// fashion.
+/// In pipelined mode, the tokens are produced on a separate thread and passed
+/// to the caller through a bounded single-producer/single-consumer ring buffer,
+/// such that lexing overlaps with the processing of the tokens.
 class Lexer {
     public:
+    /// Statistics of the tokens which the lexer returned.
+    struct Statistics {
+        /// Number of returned tokens
+        size_t numberOfTokens{0};
+        /// Time spent tokenizing on the consuming thread, i.e. zero in
+        /// pipelined mode
+        std::chrono::nanoseconds time{0};
+    };
+
     /// Constructor
-    explicit Lexer(const common::SourceCodeManager& manager);
+    /// If statistics are given, the statistics of the tokens are accumulated.
+    explicit Lexer(const common::SourceCodeManager& manager,
+                   bool pipelined = false,
+                   Statistics* statistics = nullptr);
+
+    /// Constructor for a lexer which only tokenizes the characters within
+    /// [begin, end). If reportErrors is false, errors are not printed.
+    Lexer(const common::SourceCodeManager& manager,
+          common::SourceCodeManager::SourceCodeIterator begin,
+          common::SourceCodeManager::SourceCodeIterator end,
+          bool reportErrors,
+          Statistics* statistics = nullptr);
+
+    /// Destructor
+    ~Lexer();
+
+    /// Copy constructor/assignment
+    Lexer(const Lexer& other) = delete;
+    Lexer& operator=(const Lexer& other) = delete;
 
     /// Returns true if there are still tokens left.
     /// Note: Returns true even if the next token might be an illegal token.
-    bool hasNext() const;
+    ///       In pipelined mode, it waits for the producer and takes the next
+    ///       token from the ring buffer.
+    bool hasNext();
 
     /// Returns the next token. If an illegal token was encountered, the
     /// token type is set to "LexerError".
@@ -27,7 +62,35 @@ class Lexer {
     /// If the next token is illegal, the token type is set to "LexerError".
     Token peek();
 
+    /// Continues tokenizing at the given position, which must be the start
+    /// of a token or whitespace and must not be behind the end of the lexer.
+    void skipTo(common::SourceCodeManager::SourceCodeIterator position);
+
     private:
+    /// A token together with the error message for error tokens.
+    struct TokenizedToken {
+        Token token;
+        std::string_view errorMessage{};
+    };
+
+    /// State of the pipelined mode.
+    struct Pipeline;
+
+    /// Tokenizes the next token. Errors are not printed but returned with the token.
+    TokenizedToken tokenize();
+
+    /// Tokenizes the next token on the consuming thread and measures the time.
+    TokenizedToken tokenizeMeasured();
+
+    /// Starts the thread which produces the tokens in pipelined mode.
+    void startPipeline();
+
+    /// Stops the thread which produces the tokens in pipelined mode.
+    void stopPipeline();
+
+    /// Produces the tokens in pipelined mode until the end or an error is reached.
+    void produceTokens();
+
     /// Advances current extendUntil either a non-whitespace character or the end
     /// is reached.
     void trimLeadingWhitespace();
@@ -51,6 +114,15 @@ class Lexer {
 
     /// Cache, needed for the peek functionality.
     std::optional<Token> tokenCache;
+
+    /// True if errors should be printed.
+    bool reportErrors{true};
+
+    /// Only set in pipelined mode.
+    std::unique_ptr<Pipeline> pipeline{};
+
+    /// Only set if the statistics are collected.
+    Statistics* statistics{nullptr};
 };
 
 } // namespace pljit::lexer
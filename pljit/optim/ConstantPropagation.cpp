@@ -12,10 +12,23 @@ std::pair<size_t, ast::Identifier::Type> constructKey(const ast::Identifier& nod
     return {node.getId(), node.getIdentifierType()};
 }
 
+/// Creates a constant literal which replaces the given expression. The literal
+/// takes over the node id of the expression, such that it keeps its source range.
+std::unique_ptr<ast::ConstantLiteral> materializeConstant(int64_t value, const ast::Expression& replacedExpression)
+{
+    auto literal = std::make_unique<ast::ConstantLiteral>(value);
+    literal->setNodeId(replacedExpression.getNodeId());
+    return literal;
+}
+
 } // namespace
 
-ConstantPropagation::ConstantPropagation(const analysis::SymbolTable& symbolTable)
-    : symbolTable(symbolTable)
+ConstantPropagation::ConstantPropagation(const analysis::SymbolTable& symbolTable,
+                                         std::pmr::memory_resource* memoryResource)
+    : variableTable(memoryResource),
+      pendingExpressions(memoryResource),
+      constantResults(memoryResource),
+      symbolTable(symbolTable)
 // Constructor
 {}
 
@@ -43,7 +56,7 @@ void ConstantPropagation::visit(ast::AssignmentStatement& node)
 
         // Since we now can't further propagate the constant result up,
         // we materialize the constant here.
-        node.setExpression(std::make_unique<ast::ConstantLiteral>(result));
+        node.setExpression(materializeConstant(result, node.getExpression()));
 
         // Remember that the variable with the key assignmentTargetKey is a
         // constant as well as its value!
@@ -75,7 +88,7 @@ void ConstantPropagation::visit(ast::ReturnStatement& node)
 
         // Since we now can't further propagate the constant result up,
         // we materialize the constant here.
-        node.setExpression(std::make_unique<ast::ConstantLiteral>(result));
+        node.setExpression(materializeConstant(result, node.getExpression()));
 
         // Reset the optional because we cannot propagate the constant
         // value further up.
@@ -108,30 +121,90 @@ void ConstantPropagation::visit(ast::Identifier& node)
 
 void ConstantPropagation::visit(ast::UnaryOp& node)
 {
-    // Visit the child expression.
-    node.getExpression().accept(*this);
+    constantResultFromLastCall = propagate(node);
+}
+
+void ConstantPropagation::visit(ast::BinaryOp& node)
+{
+    constantResultFromLastCall = propagate(node);
+}
+
+std::optional<int64_t> ConstantPropagation::propagate(ast::Expression& expression)
+// Propagates the constants through the given expression.
+{
+    // The operations are visited twice: once before and once after their
+    // children were visited. The constant results of the visited children
+    // are kept on a separate stack.
+    // Note: The stacks are members, such that their memory is reused.
+    assert(pendingExpressions.empty() && constantResults.empty());
+    pendingExpressions.push_back({&expression, false});
+    while (!pendingExpressions.empty()) {
+        auto [current, childrenVisited] = pendingExpressions.back();
+        pendingExpressions.pop_back();
+
+        switch (current->getType()) {
+            case ast::ASTNode::Type::UnaryOp: {
+                auto& unaryOp = static_cast<ast::UnaryOp&>(*current); // NOLINT
+                if (!childrenVisited) {
+                    pendingExpressions.push_back({current, true});
+                    pendingExpressions.push_back({&unaryOp.getExpression(), false});
+                    break;
+                }
+                constantResults.back() = foldUnaryOp(unaryOp, constantResults.back());
+                break;
+            }
+
+            case ast::ASTNode::Type::BinaryOp: {
+                auto& binaryOp = static_cast<ast::BinaryOp&>(*current); // NOLINT
+                if (!childrenVisited) {
+                    // The lhs is visited before the rhs.
+                    pendingExpressions.push_back({current, true});
+                    pendingExpressions.push_back({&binaryOp.getRhsExpression(), false});
+                    pendingExpressions.push_back({&binaryOp.getLhsExpression(), false});
+                    break;
+                }
+                auto rightConstantResultOpt = constantResults.back();
+                constantResults.pop_back();
+                auto leftConstantResultOpt = constantResults.back();
+                constantResults.back() = foldBinaryOp(binaryOp, leftConstantResultOpt, rightConstantResultOpt);
+                break;
+            }
+
+            default:
+                // Identifiers and literals are leaves, hence, visiting them
+                // does not recurse.
+                constantResultFromLastCall = std::nullopt;
+                current->accept(*this);
+                constantResults.push_back(constantResultFromLastCall);
+                constantResultFromLastCall = std::nullopt;
+                break;
+        }
+    }
+
+    assert(constantResults.size() == 1);
+    auto result = constantResults.back();
+    constantResults.pop_back();
+    return result;
+}
 
+std::optional<int64_t> ConstantPropagation::foldUnaryOp(const ast::UnaryOp& node, std::optional<int64_t> constantResult)
+// Folds a unary operation.
+{
     // In case the child expression evaluated to a constant and the unary expression
     // has a minus sign, then we need to update the constant value.
-    if (constantResultFromLastCall && node.getUnaryOpType() == ast::UnaryOp::Type::MinusSign) {
+    if (constantResult && node.getUnaryOpType() == ast::UnaryOp::Type::MinusSign) {
         // If we have a negative sign, the new constant is:
-        constantResultFromLastCall = -constantResultFromLastCall.value();
+        return -constantResult.value();
     }
     // otherwise we can just propagate the result of the child expression up.
+    return constantResult;
 }
 
-void ConstantPropagation::visit(ast::BinaryOp& node)
+std::optional<int64_t> ConstantPropagation::foldBinaryOp(ast::BinaryOp& node,
+                                                         std::optional<int64_t> leftConstantResultOpt,
+                                                         std::optional<int64_t> rightConstantResultOpt)
+// Folds a binary operation.
 {
-    // Visit the left child expression.
-    node.getLhsExpression().accept(*this);
-    auto leftConstantResultOpt = constantResultFromLastCall;
-    constantResultFromLastCall = std::nullopt;
-
-    // Visit the right child expression.
-    node.getRhsExpression().accept(*this);
-    auto rightConstantResultOpt = constantResultFromLastCall;
-    constantResultFromLastCall = std::nullopt;
-
     if (leftConstantResultOpt && rightConstantResultOpt) {
         // We can transform the whole binary operation into a constant!
 
@@ -143,28 +216,22 @@ void ConstantPropagation::visit(ast::BinaryOp& node)
 
         switch (node.getBinaryOpType()) {
             case ast::BinaryOp::Type::Add:
-                constantResultFromLastCall = lhsValue + rhsValue;
-                break;
+                return lhsValue + rhsValue;
 
             case ast::BinaryOp::Type::Sub:
-                constantResultFromLastCall = lhsValue - rhsValue;
-                break;
+                return lhsValue - rhsValue;
 
             case ast::BinaryOp::Type::Mul:
-                constantResultFromLastCall = lhsValue * rhsValue;
-                break;
+                return lhsValue * rhsValue;
 
             case ast::BinaryOp::Type::Div:
                 if (rhsValue == 0) {
                     // If we have a division by 0 error, we leave it as is
                     // during optimization.
-                    constantResultFromLastCall = std::nullopt;
-                } else {
-                    constantResultFromLastCall = lhsValue / rhsValue;
+                    return std::nullopt;
                 }
-                break;
+                return lhsValue / rhsValue;
         }
-        return;
     }
 
     // The whole binary operation cannot be evaluated to a constant.
@@ -174,16 +241,17 @@ void ConstantPropagation::visit(ast::BinaryOp& node)
 
     if (leftConstantResultOpt) {
         auto result = leftConstantResultOpt.value();
-        // Update the expression of the unary op node!
-        node.setLhsExpression(std::make_unique<ast::ConstantLiteral>(result));
-        return;
+        // Update the expression of the binary op node!
+        node.setLhsExpression(materializeConstant(result, node.getLhsExpression()));
+        return std::nullopt;
     }
 
     if (rightConstantResultOpt) {
         auto result = rightConstantResultOpt.value();
-        // Update the expression of the unary op node!
-        node.setRhsExpression(std::make_unique<ast::ConstantLiteral>(result));
+        // Update the expression of the binary op node!
+        node.setRhsExpression(materializeConstant(result, node.getRhsExpression()));
     }
+    return std::nullopt;
 }
 
 } // namespace pljit::optim
@@ -4,15 +4,19 @@
 #include "pljit/analysis/SymbolTableFwd.h"
 #include "pljit/ast/AST.h"
 #include "pljit/optim/OptimizationPass.h"
+#include <memory_resource>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace pljit::optim {
 
 class ConstantPropagation : public OptimizationPass {
     public:
     /// Constructor
-    explicit ConstantPropagation(const analysis::SymbolTable& symbolTable);
+    /// Temporary data structures are allocated from the given memory resource.
+    explicit ConstantPropagation(const analysis::SymbolTable& symbolTable,
+                                 std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource());
 
     /// Destructor
     ~ConstantPropagation() override = default;
@@ -34,6 +38,20 @@ class ConstantPropagation : public OptimizationPass {
     void visit(ast::BinaryOp& node) final;
 
     private:
+    /// Propagates the constants through the given expression and returns its
+    /// constant value if it has one. Expressions can be nested arbitrarily deep,
+    /// hence, the expression is traversed with an explicit stack.
+    std::optional<int64_t> propagate(ast::Expression& expression);
+
+    /// Folds a unary operation whose child expression has the given constant result.
+    static std::optional<int64_t> foldUnaryOp(const ast::UnaryOp& node, std::optional<int64_t> constantResult);
+
+    /// Folds a binary operation whose child expressions have the given constant
+    /// results. Materializes a constant child if the operation cannot be folded.
+    static std::optional<int64_t> foldBinaryOp(ast::BinaryOp& node,
+                                               std::optional<int64_t> leftConstantResultOpt,
+                                               std::optional<int64_t> rightConstantResultOpt);
+
     /// Optional for storing the result of evaluating a constant expression.
     /// This variable is used to propagate the evaluated constant expression
     /// results up the tree.
@@ -60,7 +78,18 @@ class ConstantPropagation : public OptimizationPass {
 
     /// Map in which we track whether a variable has a constant value
     /// assigned and its value.
-    std::unordered_map<IdentifierKey, VariableAssignment, IdentifierKeyHash> variableTable;
+    std::pmr::unordered_map<IdentifierKey, VariableAssignment, IdentifierKeyHash> variableTable;
+
+    /// An expression on the explicit stack of propagate().
+    struct PendingExpression {
+        ast::Expression* expression;
+        /// True if the child expressions were already visited.
+        bool childrenVisited;
+    };
+
+    /// Stacks for propagating the constants without recursion.
+    std::pmr::vector<PendingExpression> pendingExpressions;
+    std::pmr::vector<std::optional<int64_t>> constantResults;
 
     /// Symbol table for obtaining the constant values of Const variables.
     const analysis::SymbolTable& symbolTable;
@@ -25,6 +25,18 @@ common::SourceRangeReference ParseTreeNode::getReference() const
     return ref;
 }
 
+void* ParseTreeNode::operator new(size_t size)
+// Allocates a node from the node memory resource of the current thread.
+{
+    return common::allocateNode(size);
+}
+
+void ParseTreeNode::operator delete(void* ptr, size_t size)
+// Deallocates a node.
+{
+    common::deallocateNode(ptr, size);
+}
+
 ParseTreeNode::ParseTreeNode(Type type, common::SourceRangeReference ref)
     : type(type),
       ref(ref)
@@ -45,6 +57,26 @@ FlexibleChildrenBase::FlexibleChildrenBase(ParseTreeNode::Type type,
 // Constructor
 {}
 
+FlexibleChildrenBase::~FlexibleChildrenBase()
+// Destructor
+{
+    // Destroying the children recursively could overflow the call stack for deeply
+    // nested expressions. Hence, we first detach the children of every descendant,
+    // such that each node is destroyed without any children left.
+    ChildrenType pendingNodes = std::move(children);
+    while (!pendingNodes.empty()) {
+        auto node = std::move(pendingNodes.back());
+        pendingNodes.pop_back();
+
+        if (auto* flexibleNode = dynamic_cast<FlexibleChildrenBase*>(node.get())) {
+            for (auto& child : flexibleNode->children) {
+                pendingNodes.push_back(std::move(child));
+            }
+            flexibleNode->children.clear();
+        }
+    }
+}
+
 Identifier::Identifier(common::SourceRangeReference ref)
     : ParseTreeNode(ParseTreeNode::Type::Identifier, ref)
 // Constructor
@@ -96,10 +128,20 @@ FunctionDefinition::FunctionDefinition(std::unique_ptr<ParameterDeclarations> pa
       variableDeclarations(std::move(varDeclarations)),
       constantDeclarations(std::move(constDeclarations)),
       compoundStatement(std::move(compoundStatement)),
-      programTerminator(std::move(programTerminator))
+      programTerminator(std::move(programTerminator)),
+      resource(common::getNodeMemoryResource())
 // Constructor
 {}
 
+void FunctionDefinition::operator delete(FunctionDefinition* definition, std::destroying_delete_t)
+// Deletes the function definition and its children while their node memory resource is active.
+{
+    auto* resource = definition->resource;
+    common::MemoryResourceScope scope(resource);
+    definition->~FunctionDefinition();
+    common::deallocateNode(definition, sizeof(FunctionDefinition));
+}
+
 const ParameterDeclarations* FunctionDefinition::getParameterDeclarations() const
 // Returns a pointer to the optional parameter-declarations.
 {
@@ -262,7 +304,7 @@ void DeclaratorList::accept(ParseTreeVisitor& visitor) const
     visitor.visit(*this);
 }
 
-InitDeclaratorList::InitDeclaratorList(std::vector<std::unique_ptr<ParseTreeNode>> children,
+InitDeclaratorList::InitDeclaratorList(ChildrenType children,
                                        common::SourceRangeReference ref)
     : FlexibleChildrenBase(ParseTreeNode::Type::InitDeclaratorList,
                            std::move(children),
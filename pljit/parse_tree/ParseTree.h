@@ -1,10 +1,13 @@
 #ifndef H_parse_tree_ParseTree
 #define H_parse_tree_ParseTree
 
+#include "pljit/common/MemoryResource.h"
 #include "pljit/common/References.h"
 #include "pljit/parse_tree/ParseTreeFwd.h"
 #include "pljit/parse_tree/ParseTreeVisitorFwd.h"
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <vector>
 
 namespace pljit::parse_tree {
@@ -39,6 +42,12 @@ class ParseTreeNode {
     /// Destructor
     virtual ~ParseTreeNode() = default;
 
+    /// Nodes are allocated from the node memory resource of the current thread
+    /// (see common::MemoryResourceScope) and must be deleted while that resource
+    /// is active. The FunctionDefinition at the root of the tree takes care of this.
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     /// Returns the type of the node.
     Type getType() const;
 
@@ -59,10 +68,12 @@ class ParseTreeNode {
 
 class FlexibleChildrenBase : public ParseTreeNode {
     public:
-    using ChildrenType = std::vector<std::unique_ptr<ParseTreeNode>>;
+    using ChildrenType = std::pmr::vector<std::unique_ptr<ParseTreeNode>>;
 
     /// Destructor
-    ~FlexibleChildrenBase() override = default;
+    /// Note: Destroys the subtree without recursion since expressions can be
+    ///       nested arbitrarily deep.
+    ~FlexibleChildrenBase() override;
 
     protected:
     /// Constructor
@@ -73,7 +84,7 @@ class FlexibleChildrenBase : public ParseTreeNode {
     /// Constructor
     FlexibleChildrenBase(ParseTreeNode::Type type, common::SourceRangeReference ref);
 
-    ChildrenType children{};
+    ChildrenType children{common::getNodeMemoryResource()};
 };
 
 class Identifier : public ParseTreeNode {
@@ -124,7 +135,7 @@ class GenericToken : public ParseTreeNode {
 ///                       [ constant-declarations ]
 ///                       compound-statement
 ///                       "."
-class FunctionDefinition : public ParseTreeNode {
+class FunctionDefinition final : public ParseTreeNode {
     public:
     /// Constructor
     FunctionDefinition(std::unique_ptr<ParameterDeclarations> paramDeclarations,
@@ -137,6 +148,10 @@ class FunctionDefinition : public ParseTreeNode {
     /// Destructor
     ~FunctionDefinition() override = default;
 
+    /// Deletes the function definition and its children while the node memory
+    /// resource from which they were allocated is active.
+    static void operator delete(FunctionDefinition* definition, std::destroying_delete_t);
+
     /// Returns a pointer to the optional parameter-declarations.
     /// Note: Might be nullptr.
     const ParameterDeclarations* getParameterDeclarations() const;
@@ -164,6 +179,8 @@ class FunctionDefinition : public ParseTreeNode {
     std::unique_ptr<ConstantDeclarations> constantDeclarations{};
     std::unique_ptr<CompoundStatement> compoundStatement{};
     std::unique_ptr<GenericToken> programTerminator{};
+    /// The node memory resource of the whole tree
+    std::pmr::memory_resource* resource;
 };
 
 /// Base class for productions of the form: <...> declarator-list ";"
@@ -271,7 +288,7 @@ class ConstantDeclarations : public ParseTreeNode {
 class DeclaratorList : public FlexibleChildrenBase {
     public:
     /// Constructor
-    DeclaratorList(std::vector<std::unique_ptr<ParseTreeNode>> children,
+    DeclaratorList(ChildrenType children,
                    common::SourceRangeReference ref);
 
     /// Destructor
@@ -289,7 +306,7 @@ class DeclaratorList : public FlexibleChildrenBase {
 class InitDeclaratorList : public FlexibleChildrenBase {
     public:
     /// Constructor
-    InitDeclaratorList(std::vector<std::unique_ptr<ParseTreeNode>> children,
+    InitDeclaratorList(ChildrenType children,
                        common::SourceRangeReference ref);
 
     /// Destructor
@@ -369,7 +386,7 @@ class CompoundStatement : public ParseTreeNode {
 class StatementList : public FlexibleChildrenBase {
     public:
     /// Constructor
-    StatementList(std::vector<std::unique_ptr<ParseTreeNode>> children,
+    StatementList(ChildrenType children,
                   common::SourceRangeReference ref);
 
     /// Destructor
@@ -1,5 +1,7 @@
 #include "ParseTreeDotVisitor.h"
 #include "pljit/parse_tree/ParseTree.h"
+#include <algorithm>
+#include <cstddef>
 
 namespace pljit::parse_tree {
 
@@ -31,8 +33,6 @@ void ParseTreeDotVisitor::visit(const FunctionDefinition& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("function-definition");
 
-    ++currentDepth;
-
     const auto* paramDeclarations = node.getParameterDeclarations();
     if (paramDeclarations != nullptr) {
         handleNextVisit(myLabelId, *paramDeclarations);
@@ -51,8 +51,6 @@ void ParseTreeDotVisitor::visit(const FunctionDefinition& node)
     handleNextVisit(myLabelId, node.getCompoundStatement());
     handleNextVisit(myLabelId, node.getProgramTerminator());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -61,13 +59,9 @@ void ParseTreeDotVisitor::visit(const ParameterDeclarations& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("parameter-declarations");
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getParamKeyword());
     visitDeclaratorListWrapper(myLabelId, node);
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -76,13 +70,9 @@ void ParseTreeDotVisitor::visit(const VariableDeclarations& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("variable-declarations");
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getVarKeyword());
     visitDeclaratorListWrapper(myLabelId, node);
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -91,14 +81,10 @@ void ParseTreeDotVisitor::visit(const ConstantDeclarations& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("constant-declarations");
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getConstKeyword());
     handleNextVisit(myLabelId, node.getInitDeclaratorList());
     handleNextVisit(myLabelId, node.getSemiColon());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -117,14 +103,10 @@ void ParseTreeDotVisitor::visit(const InitDeclarator& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("init-declarator");
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getInitTarget());
     handleNextVisit(myLabelId, node.getInitToken());
     handleNextVisit(myLabelId, node.getLiteral());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -133,14 +115,10 @@ void ParseTreeDotVisitor::visit(const CompoundStatement& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("compound-statement");
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getBeginKeyword());
     handleNextVisit(myLabelId, node.getStatementList());
     handleNextVisit(myLabelId, node.getEndKeyword());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -154,8 +132,6 @@ void ParseTreeDotVisitor::visit(const Statement& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("statement");
 
-    ++currentDepth;
-
     if (node.getStatementType() == Statement::Type::AssignmentStatement) {
         handleNextVisit(myLabelId, node.getAssignmentExpression());
     } else {
@@ -163,8 +139,6 @@ void ParseTreeDotVisitor::visit(const Statement& node)
         handleNextVisit(myLabelId, node.getAdditiveExpression());
     }
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -173,14 +147,10 @@ void ParseTreeDotVisitor::visit(const AssignmentExpression& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("assignment-expression");
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getAssignmentTarget());
     handleNextVisit(myLabelId, node.getAssignmentToken());
     handleNextVisit(myLabelId, node.getAdditiveExpression());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -189,16 +159,12 @@ void ParseTreeDotVisitor::visit(const AdditiveExpression& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("additive-expression");
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getMultiplicativeExpression());
     if (node.getAdditiveExpressionType() != AdditiveExpression::Type::None) {
         handleNextVisit(myLabelId, node.getAdditiveOpToken());
         handleNextVisit(myLabelId, node.getAdditiveExpression());
     }
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -207,16 +173,12 @@ void ParseTreeDotVisitor::visit(const MultiplicativeExpression& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("multiplicative-expression");
 
-    ++currentDepth;
-
     handleNextVisit(myLabelId, node.getUnaryExpression());
     if (node.getMultiplicativeExpressionType() != MultiplicativeExpression::Type::None) {
         handleNextVisit(myLabelId, node.getMultiplicativeOpToken());
         handleNextVisit(myLabelId, node.getMultiplicativeExpression());
     }
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -225,15 +187,11 @@ void ParseTreeDotVisitor::visit(const UnaryExpression& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("unary-expression");
 
-    ++currentDepth;
-
     if (node.getUnaryExpressionType() != UnaryExpression::Type::Unsigned) {
         handleNextVisit(myLabelId, node.getSignToken());
     }
     handleNextVisit(myLabelId, node.getPrimaryExpression());
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -242,8 +200,6 @@ void ParseTreeDotVisitor::visit(const PrimaryExpression& node)
     unsigned myLabelId = labels.size();
     labels.emplace_back("primary-expression");
 
-    ++currentDepth;
-
     switch (node.getPrimaryExpressionType()) {
         case PrimaryExpression::Type::Identifier:
             handleNextVisit(myLabelId, node.getIdentifier());
@@ -260,8 +216,6 @@ void ParseTreeDotVisitor::visit(const PrimaryExpression& node)
             break;
     }
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
@@ -280,38 +234,49 @@ void ParseTreeDotVisitor::visitDeclaratorListWrapper(unsigned int currentLabelId
     handleNextVisit(currentLabelId, node.getSemiColon());
 }
 
-void ParseTreeDotVisitor::visitVariableLengthChildren(const std::vector<std::unique_ptr<ParseTreeNode>>& children,
+void ParseTreeDotVisitor::visitVariableLengthChildren(const std::pmr::vector<std::unique_ptr<ParseTreeNode>>& children,
                                                       std::string_view label)
 // General visit function for nodes which have variable length children.
 {
     unsigned myLabelId = labels.size();
     labels.emplace_back(label);
 
-    ++currentDepth;
-
     for (const auto& child : children) {
         handleNextVisit(myLabelId, *child);
     }
 
-    --currentDepth;
-
     printDotGraphIfStartingNodeIsReachedAgain();
 }
 
 void ParseTreeDotVisitor::handleNextVisit(unsigned int current, const ParseTreeNode& node)
-// Handles the next visit, i.e. adding a new edge and visiting the next node.
+// Schedules the visit of a child node.
 {
-    addEdgeToNextNode(current);
-    node.accept(*this);
+    pendingVisits.push_back({current, &node});
 }
 
 void ParseTreeDotVisitor::printDotGraphIfStartingNodeIsReachedAgain()
-// Prints the DOT graph if currentDepth == 0.
+// Visits the scheduled nodes and prints the DOT graph if the starting node is reached again.
 {
-    if (currentDepth != 0) {
+    if (traversing) {
         return;
     }
 
+    // The nodes are visited with an explicit stack instead of recursively,
+    // such that deep expressions do not overflow the stack. The children of
+    // a node are scheduled in order, hence, they are reversed on the stack to
+    // keep the pre-order numbering of the labels.
+    traversing = true;
+    std::reverse(pendingVisits.begin(), pendingVisits.end());
+    while (!pendingVisits.empty()) {
+        auto [currentLabelId, node] = pendingVisits.back();
+        pendingVisits.pop_back();
+        addEdgeToNextNode(currentLabelId);
+        auto numberOfPendingVisits = pendingVisits.size();
+        node->accept(*this);
+        std::reverse(pendingVisits.begin() + static_cast<std::ptrdiff_t>(numberOfPendingVisits), pendingVisits.end());
+    }
+    traversing = false;
+
     out << "digraph {\n";
     // Print the labels.
     for (unsigned i = 0; i < labels.size(); ++i) {
@@ -4,6 +4,7 @@
 #include "pljit/parse_tree/ParseTreeFwd.h"
 #include "pljit/parse_tree/ParseTreeVisitor.h"
 #include <memory>
+#include <memory_resource>
 #include <ostream>
 #include <string_view>
 #include <vector>
@@ -69,23 +70,31 @@ class ParseTreeDotVisitor : public ParseTreeVisitor {
     void visitDeclaratorListWrapper(unsigned currentLabelId, const DeclaratorListWrapper& node);
 
     /// General visit function for nodes which have variable length children.
-    void visitVariableLengthChildren(const std::vector<std::unique_ptr<ParseTreeNode>>& children,
+    void visitVariableLengthChildren(const std::pmr::vector<std::unique_ptr<ParseTreeNode>>& children,
                                      std::string_view label);
 
-    /// Handles the next visit, i.e. adding a new edge and visiting the next node.
+    /// Handles the next visit, i.e. schedules the visit of a child node, which
+    /// adds a new edge and visits the node.
     void handleNextVisit(unsigned currentLabelId, const ParseTreeNode& node);
 
-    /// This function prints the collected information about the tree
-    /// in the DOT format if currentDepth == 0. This implies that
-    /// the starting node is reached
+    /// If the starting node is reached again, this function visits the
+    /// scheduled nodes and prints the collected information about the tree
+    /// in the DOT format.
     void printDotGraphIfStartingNodeIsReachedAgain();
 
     std::ostream& out;
 
-    /// Indicates the current depth of the parse tree. This is needed
-    /// in order to know when we reached the starting node again. This
-    /// ensures that also subtrees of a parse tree can be printed.
-    unsigned currentDepth{};
+    /// Whether the scheduled nodes are being visited, i.e. whether the
+    /// current node is not the starting node. This ensures that also subtrees
+    /// can be printed.
+    bool traversing{false};
+
+    /// Scheduled visits of child nodes
+    struct PendingVisit {
+        unsigned parentLabelId;
+        const ParseTreeNode* node;
+    };
+    std::vector<PendingVisit> pendingVisits;
 
     /// Vector of labels
     std::vector<std::string_view> labels;
@@ -1,6 +1,12 @@
 #include "Parser.h"
+#include "pljit/common/MemoryResource.h"
+#include "pljit/common/ThreadPool.h"
 #include "pljit/parse_tree/ParseTree.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <iterator>
+#include <memory>
 
 namespace pljit::parser {
 
@@ -97,13 +103,68 @@ bool hasError(const std::unique_ptr<ParseTreeNodeT>& node)
 
 } // namespace
 
-Parser::Parser(const common::SourceCodeManager& sourceCodeManager)
-    : sourceCodeManager(sourceCodeManager),
-      lexer(sourceCodeManager),
+/// An expression whose parsing was started but which is not yet complete.
+struct Parser::PendingExpression {
+    enum class Type {
+        /// additive-expression, after its operator the left operand is set.
+        Additive,
+        /// multiplicative-expression, after its operator the left operand is set.
+        Multiplicative,
+        /// "(" additive-expression ")" with an optional sign in front.
+        Parenthesized
+    };
+
+    /// Constructor
+    explicit PendingExpression(Type type) : type(type) {}
+
+    Type type;
+    /// The operator or the left parenthesis.
+    std::unique_ptr<parse_tree::GenericToken> token{};
+    /// The sign in front of a parenthesized expression.
+    std::unique_ptr<parse_tree::GenericToken> sign{};
+    /// The left operand of an additive-expression.
+    std::unique_ptr<parse_tree::MultiplicativeExpression> multiplicativeExpression{};
+    /// The left operand of a multiplicative-expression.
+    std::unique_ptr<parse_tree::UnaryExpression> unaryExpression{};
+};
+
+Parser::Parser(const common::SourceCodeManager& sourceCodeManager,
+               ParserOptions options)
+    : options(options),
+      sourceCodeManager(sourceCodeManager),
+      lexer(sourceCodeManager, options.pipelinedLexing, options.lexerStatistics),
       refToLastChar(lexer.peek().getReference().first())
 // Constructor
 {}
 
+Parser::Parser(const common::SourceCodeManager& sourceCodeManager,
+               common::SourceCodeManager::SourceCodeIterator begin,
+               common::SourceCodeManager::SourceCodeIterator end,
+               lexer::Lexer::Statistics* lexerStatistics)
+    : options{.parallelParsingThreshold = 0, .lexerStatistics = lexerStatistics},
+      reportErrors(false),
+      sourceCodeManager(sourceCodeManager),
+      lexer(sourceCodeManager, begin, end, false, lexerStatistics),
+      refToLastChar(lexer.peek().getReference().first())
+// Constructor
+{}
+
+void Parser::printContext(common::SourceLocationReference location, std::string_view message) const
+// Prints the context with a message if errors are reported.
+{
+    if (reportErrors) {
+        sourceCodeManager.printContext(location, message);
+    }
+}
+
+void Parser::printContext(common::SourceRangeReference ref, std::string_view message) const
+// Prints the context with a message if errors are reported.
+{
+    if (reportErrors) {
+        sourceCodeManager.printContext(ref, message);
+    }
+}
+
 std::unique_ptr<parse_tree::FunctionDefinition> Parser::parseFunctionDefinition()
 // Parses the source code and returns a parse tree.
 {
@@ -118,8 +179,8 @@ std::unique_ptr<parse_tree::FunctionDefinition> Parser::parseFunctionDefinition(
         }
 
         if (!lexer.hasNext()) {
-            sourceCodeManager.printContext(parameterDeclarations->getReference().last(),
-                                           "error: expected afterwards either 'VAR', 'CONST', or 'BEGIN'");
+            printContext(parameterDeclarations->getReference().last(),
+                         "error: expected afterwards either 'VAR', 'CONST', or 'BEGIN'");
             return error<parse_tree::FunctionDefinition>();
         }
     }
@@ -134,8 +195,8 @@ std::unique_ptr<parse_tree::FunctionDefinition> Parser::parseFunctionDefinition(
         }
 
         if (!lexer.hasNext()) {
-            sourceCodeManager.printContext(variableDeclarations->getReference().last(),
-                                           "error: expected afterwards either 'CONST' or 'BEGIN'");
+            printContext(variableDeclarations->getReference().last(),
+                         "error: expected afterwards either 'CONST' or 'BEGIN'");
             return error<parse_tree::FunctionDefinition>();
         }
     }
@@ -150,8 +211,8 @@ std::unique_ptr<parse_tree::FunctionDefinition> Parser::parseFunctionDefinition(
         }
 
         if (!lexer.hasNext()) {
-            sourceCodeManager.printContext(constantDeclarations->getReference().last(),
-                                           "error: expected afterwards 'BEGIN'");
+            printContext(constantDeclarations->getReference().last(),
+                         "error: expected afterwards 'BEGIN'");
             return error<parse_tree::FunctionDefinition>();
         }
     }
@@ -171,8 +232,8 @@ std::unique_ptr<parse_tree::FunctionDefinition> Parser::parseFunctionDefinition(
     }
 
     if (lexer.hasNext()) {
-        sourceCodeManager.printContext(lexer.peek().getReference(),
-                                       "error: expected no tokens after the program terminator");
+        printContext(lexer.peek().getReference(),
+                     "error: expected no tokens after the program terminator");
         return error<parse_tree::FunctionDefinition>();
     }
 
@@ -195,9 +256,9 @@ std::unique_ptr<parse_tree::Identifier> Parser::parseIdentifier()
 {
     if (!lexer.hasNext()) {
         // No token left although expected!
-        sourceCodeManager.printContext(refToLastChar,
-                                       getErrorMessageForToken(lexer::Token::Type::Identifier,
-                                                               NO_TOKEN_LEFT));
+        printContext(refToLastChar,
+                     getErrorMessageForToken(lexer::Token::Type::Identifier,
+                                             NO_TOKEN_LEFT));
         return error<parse_tree::Identifier>();
     }
 
@@ -210,8 +271,8 @@ std::unique_ptr<parse_tree::Identifier> Parser::parseIdentifier()
 
     if (token.getTokenType() != lexer::Token::Type::Identifier) {
         // Received a different token than expected!
-        sourceCodeManager.printContext(token.getReference(),
-                                       getErrorMessageForToken(lexer::Token::Type::Identifier));
+        printContext(token.getReference(),
+                     getErrorMessageForToken(lexer::Token::Type::Identifier));
         return error<parse_tree::Identifier>();
     }
 
@@ -225,9 +286,9 @@ std::unique_ptr<parse_tree::Literal> Parser::parseLiteral()
 {
     if (!lexer.hasNext()) {
         // No token left although expected!
-        sourceCodeManager.printContext(refToLastChar,
-                                       getErrorMessageForToken(lexer::Token::Type::Literal,
-                                                               NO_TOKEN_LEFT));
+        printContext(refToLastChar,
+                     getErrorMessageForToken(lexer::Token::Type::Literal,
+                                             NO_TOKEN_LEFT));
         return error<parse_tree::Literal>();
     }
 
@@ -240,8 +301,8 @@ std::unique_ptr<parse_tree::Literal> Parser::parseLiteral()
 
     if (token.getTokenType() != lexer::Token::Type::Literal) {
         // Received a different token than expected!
-        sourceCodeManager.printContext(token.getReference(),
-                                       getErrorMessageForToken(lexer::Token::Type::Literal));
+        printContext(token.getReference(),
+                     getErrorMessageForToken(lexer::Token::Type::Literal));
         return error<parse_tree::Literal>();
     }
 
@@ -259,8 +320,8 @@ std::unique_ptr<parse_tree::GenericToken> Parser::parseGenericToken(
 {
     if (!lexer.hasNext()) {
         // No token left although expected!
-        sourceCodeManager.printContext(refToLastChar,
-                                       getErrorMessageForToken(expectedTokenType, NO_TOKEN_LEFT));
+        printContext(refToLastChar,
+                     getErrorMessageForToken(expectedTokenType, NO_TOKEN_LEFT));
         return error<parse_tree::GenericToken>();
     }
 
@@ -273,8 +334,8 @@ std::unique_ptr<parse_tree::GenericToken> Parser::parseGenericToken(
 
     if (token.getTokenType() != expectedTokenType) {
         // Received a different token than expected!
-        sourceCodeManager.printContext(token.getReference(),
-                                       getErrorMessageForToken(expectedTokenType));
+        printContext(token.getReference(),
+                     getErrorMessageForToken(expectedTokenType));
         return error<parse_tree::GenericToken>();
     }
 
@@ -363,7 +424,7 @@ std::unique_ptr<parse_tree::ConstantDeclarations> Parser::parseConstantDeclarati
 
 std::unique_ptr<parse_tree::DeclaratorList> Parser::parseDeclaratorList()
 {
-    std::vector<std::unique_ptr<parse_tree::ParseTreeNode>> children;
+    parse_tree::FlexibleChildrenBase::ChildrenType children(common::getNodeMemoryResource());
 
     auto firstIdentifier = parseIdentifier();
     if (hasError(firstIdentifier)) {
@@ -398,7 +459,7 @@ std::unique_ptr<parse_tree::DeclaratorList> Parser::parseDeclaratorList()
 
 std::unique_ptr<parse_tree::InitDeclaratorList> Parser::parseInitDeclaratorList()
 {
-    std::vector<std::unique_ptr<parse_tree::ParseTreeNode>> children;
+    parse_tree::FlexibleChildrenBase::ChildrenType children(common::getNodeMemoryResource());
 
     auto firstInitDeclarator = parseInitDeclarator();
     if (hasError(firstInitDeclarator)) {
@@ -471,8 +532,8 @@ std::unique_ptr<parse_tree::CompoundStatement> Parser::parseCompoundStatement()
 
     auto endKeyword = parseGenericToken(lexer::Token::Type::End);
     if (hasError(endKeyword)) {
-        sourceCodeManager.printContext(beginKeyword->getReference(),
-                                       "note: to match this 'BEGIN'");
+        printContext(beginKeyword->getReference(),
+                     "note: to match this 'BEGIN'");
         return error<parse_tree::CompoundStatement>();
     }
 
@@ -487,7 +548,13 @@ std::unique_ptr<parse_tree::CompoundStatement> Parser::parseCompoundStatement()
 
 std::unique_ptr<parse_tree::StatementList> Parser::parseStatementList()
 {
-    std::vector<std::unique_ptr<parse_tree::ParseTreeNode>> children;
+    parse_tree::FlexibleChildrenBase::ChildrenType children(common::getNodeMemoryResource());
+
+    if (options.parallelParsingThreshold > 0) {
+        // Large statement lists are partially parsed in parallel. The remaining
+        // statements (at least the last one) are parsed sequentially below.
+        parseStatementsInParallel(children);
+    }
 
     auto firstStatement = parseStatement();
     if (hasError(firstStatement)) {
@@ -518,11 +585,174 @@ std::unique_ptr<parse_tree::StatementList> Parser::parseStatementList()
     return std::make_unique<parse_tree::StatementList>(std::move(children), newRangeRef);
 }
 
+void Parser::parseStatementsInParallel(std::pmr::vector<std::unique_ptr<parse_tree::ParseTreeNode>>& children)
+// Parses the leading statements of a large statement list in parallel.
+{
+    if (!lexer.hasNext() || lexer.peek().hasError()) {
+        return;
+    }
+
+    auto begin = sourceCodeManager.getCodeIterator(lexer.peek().getReference().first());
+    auto end = sourceCodeManager.getCodeEnd();
+
+    // Cheap check before tokenizing: every statement except the last one is
+    // followed by a semi-colon.
+    if (static_cast<size_t>(std::count(begin, end, ';')) < options.parallelParsingThreshold) {
+        return;
+    }
+
+    if (options.threadPool == nullptr) {
+        return;
+    }
+
+    // Determine the positions right after the semi-colons of the statement list.
+    // Note: Semi-colons only separate statements after BEGIN, hence, all of them
+    //       until END belong to the statement list. If the statement list is
+    //       malformed, a chunk will fail and we fall back to sequential parsing.
+    std::vector<common::SourceCodeManager::SourceCodeIterator> statementEnds;
+    lexer::Lexer scanner(sourceCodeManager, begin, end, false);
+    while (scanner.hasNext()) {
+        auto token = scanner.next();
+        if (token.getTokenType() == lexer::Token::Type::SemiColon) {
+            statementEnds.push_back(sourceCodeManager.getCodeIterator(token.getReference().last()) + 1);
+        } else if (token.getTokenType() == lexer::Token::Type::End || token.hasError()) {
+            break;
+        }
+    }
+
+    if (statementEnds.size() < options.parallelParsingThreshold) {
+        return;
+    }
+
+    // Split the statements into chunks. Having more chunks than threads
+    // balances the load if the statements differ in size.
+    size_t numberOfThreads = options.threadPool->getNumberOfThreads() + 1;
+    size_t numberOfChunks = std::min(numberOfThreads * 4, statementEnds.size());
+    struct Chunk {
+        common::SourceCodeManager::SourceCodeIterator begin;
+        common::SourceCodeManager::SourceCodeIterator end;
+        /// Note: The vector might outlive the node memory resource of the
+        ///       calling thread, hence, it uses the new/delete resource.
+        parse_tree::FlexibleChildrenBase::ChildrenType children{std::pmr::new_delete_resource()};
+        /// Nodes which were allocated by a worker of the pool for the chunk
+        size_t numberOfAllocatedNodes{0};
+        size_t numberOfAllocatedNodeBytes{0};
+        /// Tokens of the chunk and the time of the calling thread lexing them
+        lexer::Lexer::Statistics lexerStatistics{};
+    };
+    /// Shared with the tasks on the pool, which might only start after the
+    /// chunks were parsed. The nodes of all chunks are allocated from the node
+    /// memory resource of the calling thread.
+    struct ParallelParse {
+        std::pmr::memory_resource* resource{common::getNodeMemoryResource()};
+        std::vector<Chunk> chunks;
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> numberOfParsedChunks{0};
+        std::atomic<bool> failed{false};
+    };
+    auto parallelParse = std::make_shared<ParallelParse>();
+    auto& chunks = parallelParse->chunks;
+    chunks.reserve(numberOfChunks);
+    auto chunkBegin = begin;
+    for (size_t i = 0; i < numberOfChunks; ++i) {
+        auto chunkEnd = statementEnds[(i + 1) * statementEnds.size() / numberOfChunks - 1];
+        chunks.push_back({chunkBegin, chunkEnd});
+        chunkBegin = chunkEnd;
+    }
+
+    // Every thread takes chunks until none are left. Chunks which are taken
+    // after a failure are only counted. The workers remember the nodes and the
+    // tokens of their chunks, such that they are added to the statistics of
+    // the calling thread.
+    auto parseChunks = [this](ParallelParse& parallelParse, bool onWorker) {
+        common::MemoryResourceScope scope(parallelParse.resource);
+        auto& chunks = parallelParse.chunks;
+        for (size_t i = parallelParse.nextChunk++; i < chunks.size(); i = parallelParse.nextChunk++) {
+            if (!parallelParse.failed) {
+                auto startNodes = common::getNumberOfAllocatedNodes();
+                auto startBytes = common::getNumberOfAllocatedNodeBytes();
+                auto* lexerStatistics = options.lexerStatistics != nullptr ? &chunks[i].lexerStatistics : nullptr;
+                Parser chunkParser(sourceCodeManager, chunks[i].begin, chunks[i].end, lexerStatistics);
+                if (!chunkParser.parseStatementChunk(chunks[i].children)) {
+                    parallelParse.failed = true;
+                }
+                if (onWorker) {
+                    chunks[i].numberOfAllocatedNodes = common::getNumberOfAllocatedNodes() - startNodes;
+                    chunks[i].numberOfAllocatedNodeBytes = common::getNumberOfAllocatedNodeBytes() - startBytes;
+                    // The lexing time of the workers overlaps with the calling thread.
+                    chunks[i].lexerStatistics.time = {};
+                }
+            }
+            if (++parallelParse.numberOfParsedChunks == chunks.size()) {
+                parallelParse.numberOfParsedChunks.notify_all();
+            }
+        }
+    };
+
+    // The calling thread parses chunks as well and only waits for the chunks
+    // which other threads are parsing, but never for a task which did not
+    // start yet. Hence, a worker of a busy pool can parse in parallel without
+    // blocking the pool, its tasks are only run by idle workers.
+    size_t numberOfTasks = std::min(numberOfThreads, numberOfChunks) - 1;
+    for (size_t i = 0; i < numberOfTasks; ++i) {
+        options.threadPool->submit([parseChunks, parallelParse]() { parseChunks(*parallelParse, true); });
+    }
+    parseChunks(*parallelParse, false);
+    for (size_t numberOfParsedChunks = parallelParse->numberOfParsedChunks; numberOfParsedChunks < chunks.size();
+         numberOfParsedChunks = parallelParse->numberOfParsedChunks) {
+        parallelParse->numberOfParsedChunks.wait(numberOfParsedChunks);
+    }
+    for (const auto& chunk : chunks) {
+        common::addAllocatedNodes(chunk.numberOfAllocatedNodes, chunk.numberOfAllocatedNodeBytes);
+    }
+
+    if (parallelParse->failed) {
+        // The sequential parse reports the earliest error. The nodes of the
+        // chunks are deleted here, as a task might hold the chunks longer.
+        for (auto& chunk : chunks) {
+            chunk.children.clear();
+        }
+        return;
+    }
+
+    // Merge the chunks in order and continue after the last semi-colon. The
+    // tokens of failed chunks are not counted, as the sequential parse lexes
+    // them again.
+    for (auto& chunk : chunks) {
+        std::move(chunk.children.begin(), chunk.children.end(), std::back_inserter(children));
+        if (options.lexerStatistics != nullptr) {
+            options.lexerStatistics->numberOfTokens += chunk.lexerStatistics.numberOfTokens;
+            options.lexerStatistics->time += chunk.lexerStatistics.time;
+        }
+    }
+    lexer.skipTo(chunks.back().end);
+    refToLastChar = children.back()->getReference().last();
+}
+
+bool Parser::parseStatementChunk(std::pmr::vector<std::unique_ptr<parse_tree::ParseTreeNode>>& children)
+// Parses statements which are each followed by a semi-colon.
+{
+    while (lexer.hasNext()) {
+        auto statement = parseStatement();
+        if (hasError(statement)) {
+            return false;
+        }
+        children.push_back(std::move(statement));
+
+        auto semiColon = parseGenericToken(lexer::Token::Type::SemiColon);
+        if (hasError(semiColon)) {
+            return false;
+        }
+        children.push_back(std::move(semiColon));
+    }
+    return true;
+}
+
 std::unique_ptr<parse_tree::Statement> Parser::parseStatement()
 {
     if (!lexer.hasNext()) {
-        sourceCodeManager.printContext(refToLastChar,
-                                       "error: expected statement afterwards");
+        printContext(refToLastChar,
+                     "error: expected statement afterwards");
         return error<parse_tree::Statement>();
     }
 
@@ -549,8 +779,8 @@ std::unique_ptr<parse_tree::Statement> Parser::parseStatement()
 
     // Can this be an assignment expression?
     if (lexer.peek().getTokenType() != lexer::Token::Type::Identifier) {
-        sourceCodeManager.printContext(lexer.peek().getReference(),
-                                       "error: expected statement");
+        printContext(lexer.peek().getReference(),
+                     "error: expected statement");
         return error<parse_tree::Statement>();
     }
 
@@ -594,99 +824,169 @@ std::unique_ptr<parse_tree::AssignmentExpression> Parser::parseAssignmentExpress
 }
 
 std::unique_ptr<parse_tree::AdditiveExpression> Parser::parseAdditiveExpression()
+// Parses an additive-expression.
 {
-    auto multiplicativeExpression = parseMultiplicativeExpression();
-    if (hasError(multiplicativeExpression)) {
-        return error<parse_tree::AdditiveExpression>();
-    }
-
-    // Check whether we have + or -, i.e. an additive expression.
-    if (lexer.hasNext() && (lexer.peek().getTokenType() == lexer::Token::Type::OpPlus ||
-                            lexer.peek().getTokenType() == lexer::Token::Type::OpMinus)) {
-        auto op = parseGenericToken(lexer.peek().getTokenType());
-        if (hasError(op)) {
-            return error<parse_tree::AdditiveExpression>();
-        }
-
-        auto additiveExpression = parseAdditiveExpression();
-        if (hasError(additiveExpression)) {
+    // Expressions can be nested arbitrarily deep (e.g. by parentheses or long
+    // chains of operators). Hence, instead of descending recursively, we keep the
+    // partially parsed expressions on an explicit stack. The innermost expression
+    // which is currently parsed is on top of the stack.
+    std::vector<PendingExpression> pendingExpressions;
+    pendingExpressions.emplace_back(PendingExpression::Type::Additive);
+    pendingExpressions.emplace_back(PendingExpression::Type::Multiplicative);
+
+    while (true) {
+        // First, we parse the next unary-expression until its primary-expression.
+        if (!lexer.hasNext()) {
+            printContext(refToLastChar,
+                         "error: expected unary-expression or primary-expression afterwards");
             return error<parse_tree::AdditiveExpression>();
         }
 
-        auto newRangeRef = multiplicativeExpression->getReference()
-                               .extendUntil(additiveExpression->getReference().last());
+        auto nextTokenType = lexer.peek().getTokenType();
+        bool hasSign = nextTokenType == lexer::Token::Type::OpPlus || nextTokenType == lexer::Token::Type::OpMinus;
 
-        return std::make_unique<parse_tree::AdditiveExpression>(std::move(multiplicativeExpression),
-                                                                std::move(op),
-                                                                std::move(additiveExpression),
-                                                                newRangeRef);
-    }
-
-    // We only have the multiplicative expression.
-    auto newRangeRef = multiplicativeExpression->getReference();
-
-    return std::make_unique<parse_tree::AdditiveExpression>(std::move(multiplicativeExpression),
-                                                            newRangeRef);
-}
-
-std::unique_ptr<parse_tree::MultiplicativeExpression> Parser::parseMultiplicativeExpression()
-{
-    auto unaryExpression = parseUnaryExpression();
-    if (hasError(unaryExpression)) {
-        return error<parse_tree::MultiplicativeExpression>();
-    }
-
-    // Check whether we have * or /, i.e. a multiplicative expression.
-    if (lexer.hasNext() && (lexer.peek().getTokenType() == lexer::Token::Type::OpMul
-                            || lexer.peek().getTokenType() == lexer::Token::Type::OpDiv)) {
-        auto op = parseGenericToken(lexer.peek().getTokenType());
-        if (hasError(op)) {
-            return error<parse_tree::MultiplicativeExpression>();
+        std::unique_ptr<parse_tree::GenericToken> sign{};
+        if (hasSign) {
+            sign = parseGenericToken(nextTokenType);
+            if (hasError(sign)) {
+                return error<parse_tree::AdditiveExpression>();
+            }
         }
 
-        auto multiplicativeExpression = parseMultiplicativeExpression();
-        if (hasError(multiplicativeExpression)) {
-            return error<parse_tree::MultiplicativeExpression>();
+        if (lexer.hasNext() && lexer.peek().getTokenType() == lexer::Token::Type::LeftParenthesis) {
+            // The primary expression is "( additive-expression )"! We remember the
+            // sign and the parenthesis and continue with the inner additive-expression.
+            auto leftParenthesis = parseGenericToken(lexer::Token::Type::LeftParenthesis);
+            if (hasError(leftParenthesis)) {
+                return error<parse_tree::AdditiveExpression>();
+            }
+
+            auto& parenthesized = pendingExpressions.emplace_back(PendingExpression::Type::Parenthesized);
+            parenthesized.sign = std::move(sign);
+            parenthesized.token = std::move(leftParenthesis);
+            pendingExpressions.emplace_back(PendingExpression::Type::Additive);
+            pendingExpressions.emplace_back(PendingExpression::Type::Multiplicative);
+            continue;
         }
 
-        auto newRangeRef = unaryExpression->getReference()
-                               .extendUntil(multiplicativeExpression->getReference().last());
+        auto primaryExpression = parseNonParenthesizedPrimaryExpression();
+        if (hasError(primaryExpression)) {
+            return error<parse_tree::AdditiveExpression>();
+        }
 
-        return std::make_unique<parse_tree::MultiplicativeExpression>(std::move(unaryExpression),
-                                                                      std::move(op),
-                                                                      std::move(multiplicativeExpression),
-                                                                      newRangeRef);
+        // Now, we go up the stack and complete all expressions which end with
+        // the parsed primary-expression.
+        while (true) {
+            auto unaryExpression = makeUnaryExpression(std::move(sign), std::move(primaryExpression));
+
+            // The unary-expression is the left operand of the multiplicative-expression on
+            // top of the stack. Check whether we have * or /, i.e. a multiplicative expression.
+            assert(pendingExpressions.back().type == PendingExpression::Type::Multiplicative);
+            if (lexer.hasNext() && (lexer.peek().getTokenType() == lexer::Token::Type::OpMul
+                                    || lexer.peek().getTokenType() == lexer::Token::Type::OpDiv)) {
+                auto op = parseGenericToken(lexer.peek().getTokenType());
+                if (hasError(op)) {
+                    return error<parse_tree::AdditiveExpression>();
+                }
+
+                pendingExpressions.back().unaryExpression = std::move(unaryExpression);
+                pendingExpressions.back().token = std::move(op);
+                pendingExpressions.emplace_back(PendingExpression::Type::Multiplicative);
+                break;
+            }
+
+            // We only have the unary expression. This completes all pending
+            // multiplicative-expressions.
+            auto newRangeRef = unaryExpression->getReference();
+            auto multiplicativeExpression =
+                std::make_unique<parse_tree::MultiplicativeExpression>(std::move(unaryExpression),
+                                                                       newRangeRef);
+            pendingExpressions.pop_back();
+            while (pendingExpressions.back().type == PendingExpression::Type::Multiplicative) {
+                auto& pending = pendingExpressions.back();
+                assert(pending.unaryExpression != nullptr && pending.token != nullptr);
+                newRangeRef = pending.unaryExpression->getReference()
+                                  .extendUntil(multiplicativeExpression->getReference().last());
+                multiplicativeExpression =
+                    std::make_unique<parse_tree::MultiplicativeExpression>(std::move(pending.unaryExpression),
+                                                                           std::move(pending.token),
+                                                                           std::move(multiplicativeExpression),
+                                                                           newRangeRef);
+                pendingExpressions.pop_back();
+            }
+
+            // The multiplicative-expression is the left operand of the additive-expression on
+            // top of the stack. Check whether we have + or -, i.e. an additive expression.
+            assert(pendingExpressions.back().type == PendingExpression::Type::Additive);
+            if (lexer.hasNext() && (lexer.peek().getTokenType() == lexer::Token::Type::OpPlus ||
+                                    lexer.peek().getTokenType() == lexer::Token::Type::OpMinus)) {
+                auto op = parseGenericToken(lexer.peek().getTokenType());
+                if (hasError(op)) {
+                    return error<parse_tree::AdditiveExpression>();
+                }
+
+                pendingExpressions.back().multiplicativeExpression = std::move(multiplicativeExpression);
+                pendingExpressions.back().token = std::move(op);
+                pendingExpressions.emplace_back(PendingExpression::Type::Additive);
+                pendingExpressions.emplace_back(PendingExpression::Type::Multiplicative);
+                break;
+            }
+
+            // We only have the multiplicative expression. This completes all pending
+            // additive-expressions.
+            newRangeRef = multiplicativeExpression->getReference();
+            auto additiveExpression =
+                std::make_unique<parse_tree::AdditiveExpression>(std::move(multiplicativeExpression),
+                                                                 newRangeRef);
+            pendingExpressions.pop_back();
+            while (!pendingExpressions.empty() &&
+                   pendingExpressions.back().type == PendingExpression::Type::Additive) {
+                auto& pending = pendingExpressions.back();
+                assert(pending.multiplicativeExpression != nullptr && pending.token != nullptr);
+                newRangeRef = pending.multiplicativeExpression->getReference()
+                                  .extendUntil(additiveExpression->getReference().last());
+                additiveExpression =
+                    std::make_unique<parse_tree::AdditiveExpression>(std::move(pending.multiplicativeExpression),
+                                                                     std::move(pending.token),
+                                                                     std::move(additiveExpression),
+                                                                     newRangeRef);
+                pendingExpressions.pop_back();
+            }
+
+            if (pendingExpressions.empty()) {
+                // We completed the outermost additive-expression.
+                return additiveExpression;
+            }
+
+            // The additive-expression is enclosed in parentheses.
+            auto& parenthesized = pendingExpressions.back();
+            assert(parenthesized.type == PendingExpression::Type::Parenthesized);
+
+            auto rightParenthesis = parseGenericToken(lexer::Token::Type::RightParenthesis);
+            if (hasError(rightParenthesis)) {
+                printContext(parenthesized.token->getReference(),
+                             "note: to match this '('");
+                return error<parse_tree::AdditiveExpression>();
+            }
+
+            newRangeRef = parenthesized.token->getReference()
+                              .extendUntil(rightParenthesis->getReference().last());
+            primaryExpression = std::make_unique<parse_tree::PrimaryExpression>(std::move(parenthesized.token),
+                                                                                std::move(additiveExpression),
+                                                                                std::move(rightParenthesis),
+                                                                                newRangeRef);
+            sign = std::move(parenthesized.sign);
+            pendingExpressions.pop_back();
+        }
     }
-
-    // We only have the unary expression.
-    auto newRangeRef = unaryExpression->getReference();
-
-    return std::make_unique<parse_tree::MultiplicativeExpression>(std::move(unaryExpression),
-                                                                  newRangeRef);
 }
 
-std::unique_ptr<parse_tree::UnaryExpression> Parser::parseUnaryExpression()
+std::unique_ptr<parse_tree::UnaryExpression> Parser::makeUnaryExpression( // NOLINT
+    std::unique_ptr<parse_tree::GenericToken> sign,
+    std::unique_ptr<parse_tree::PrimaryExpression> primaryExpression)
+// Constructs a unary-expression from an optional sign and a primary-expression.
 {
-    if (!lexer.hasNext()) {
-        sourceCodeManager.printContext(refToLastChar,
-                                       "error: expected unary-expression or primary-expression afterwards");
-        return error<parse_tree::UnaryExpression>();
-    }
-
-    auto nextTokenType = lexer.peek().getTokenType();
-    bool hasSign = nextTokenType == lexer::Token::Type::OpPlus || nextTokenType == lexer::Token::Type::OpMinus;
-
-    if (hasSign) {
-        auto sign = parseGenericToken(nextTokenType);
-        if (hasError(sign)) {
-            return error<parse_tree::UnaryExpression>();
-        }
-
-        auto primaryExpression = parsePrimaryExpression();
-        if (hasError(primaryExpression)) {
-            return error<parse_tree::UnaryExpression>();
-        }
-
+    if (sign != nullptr) {
         auto newRangeRef = sign->getReference()
                                .extendUntil(primaryExpression->getReference().last());
 
@@ -696,22 +996,18 @@ std::unique_ptr<parse_tree::UnaryExpression> Parser::parseUnaryExpression()
     }
 
     // We have an unsigned unary expression.
-    auto primaryExpression = parsePrimaryExpression();
-    if (hasError(primaryExpression)) {
-        return error<parse_tree::UnaryExpression>();
-    }
-
     auto newRangeRef = primaryExpression->getReference();
 
     return std::make_unique<parse_tree::UnaryExpression>(std::move(primaryExpression),
                                                          newRangeRef);
 }
 
-std::unique_ptr<parse_tree::PrimaryExpression> Parser::parsePrimaryExpression()
+std::unique_ptr<parse_tree::PrimaryExpression> Parser::parseNonParenthesizedPrimaryExpression()
+// Parses an identifier or a literal as primary-expression.
 {
     if (!lexer.hasNext()) {
-        sourceCodeManager.printContext(refToLastChar,
-                                       "error: expected primary-expression afterwards");
+        printContext(refToLastChar,
+                     "error: expected primary-expression afterwards");
         return error<parse_tree::PrimaryExpression>();
     }
 
@@ -745,40 +1041,11 @@ std::unique_ptr<parse_tree::PrimaryExpression> Parser::parsePrimaryExpression()
                                                                newRangeRef);
     }
 
-    // The primary expression must be "( additive-expression )"!
-
-    if (nextTokenType != lexer::Token::Type::LeftParenthesis) {
-        // If the next token type is not '(', then this token cannot be a valid
-        // primary-expression although expected!
-        sourceCodeManager.printContext(lexer.peek().getReference(),
-                                       "error: expected primary-expression");
-        return error<parse_tree::PrimaryExpression>();
-    }
-
-    auto leftParenthesis = parseGenericToken(lexer::Token::Type::LeftParenthesis);
-    if (hasError(leftParenthesis)) {
-        return error<parse_tree::PrimaryExpression>();
-    }
-
-    auto additiveExpression = parseAdditiveExpression();
-    if (hasError(additiveExpression)) {
-        return error<parse_tree::PrimaryExpression>();
-    }
-
-    auto rightParenthesis = parseGenericToken(lexer::Token::Type::RightParenthesis);
-    if (hasError(rightParenthesis)) {
-        sourceCodeManager.printContext(leftParenthesis->getReference(),
-                                       "note: to match this '('");
-        return error<parse_tree::PrimaryExpression>();
-    }
-
-    auto newRangeRef = leftParenthesis->getReference()
-                           .extendUntil(rightParenthesis->getReference().last());
-
-    return std::make_unique<parse_tree::PrimaryExpression>(std::move(leftParenthesis),
-                                                           std::move(additiveExpression),
-                                                           std::move(rightParenthesis),
-                                                           newRangeRef);
+    // Parenthesized primary-expressions are handled by parseAdditiveExpression(),
+    // hence, this token cannot be a valid primary-expression although expected!
+    printContext(lexer.peek().getReference(),
+                 "error: expected primary-expression");
+    return error<parse_tree::PrimaryExpression>();
 }
 
 } // namespace pljit::parser
@@ -2,24 +2,61 @@
 #define H_parser_Parser
 
 #include "pljit/lexer/Lexer.h"
+#include "pljit/common/ThreadPoolFwd.h"
 #include "pljit/parse_tree/ParseTreeFwd.h"
 #include <memory>
+#include <memory_resource>
+#include <vector>
 
 namespace pljit::parser {
 
+/// Options for configuring the parser.
+struct ParserOptions {
+    /// Minimum number of statements in a statement list from which on the
+    /// statements are parsed in parallel. Zero disables parallel parsing.
+    size_t parallelParsingThreshold{16384};
+    /// Thread pool on which the statements are parsed in parallel together
+    /// with the calling thread, which may be a worker of the pool itself.
+    /// Without a pool, the statements are parsed sequentially.
+    /// Note: All threads allocate the nodes from the node memory resource of
+    ///       the calling thread, which hence must be thread-safe (see
+    ///       common::SynchronizedMemoryResource).
+    common::ThreadPool* threadPool{nullptr};
+    /// If set, the lexer runs on its own thread and passes the tokens through
+    /// a ring buffer to the parser, such that lexing and parsing overlap.
+    bool pipelinedLexing{false};
+    /// If set, the lexer statistics are accumulated, including the tokens of
+    /// the chunks which are parsed in parallel. Only the time which the
+    /// calling thread spends tokenizing is measured.
+    lexer::Lexer::Statistics* lexerStatistics{nullptr};
+};
+
 /// Parses the tokens returned from the lexer and transforms them into
-/// a parse tree. It implements the recursive-descent algorithm internally.
+/// a parse tree. It implements the recursive-descent algorithm internally,
+/// except for expressions which are parsed with an explicit stack.
 class Parser {
     public:
     /// Constructor
     /// Note: The source code manager must not manage an empty string!
-    explicit Parser(const common::SourceCodeManager& sourceCodeManager);
+    explicit Parser(const common::SourceCodeManager& sourceCodeManager,
+                    ParserOptions options = {});
 
     /// Parses the source code and returns a parse tree.
     /// If an error occurs, a nullptr will be returned.
     std::unique_ptr<parse_tree::FunctionDefinition> parseFunctionDefinition();
 
     private:
+    /// Constructor for a parser which silently parses the statements within
+    /// [begin, end) of a statement list.
+    Parser(const common::SourceCodeManager& sourceCodeManager,
+           common::SourceCodeManager::SourceCodeIterator begin,
+           common::SourceCodeManager::SourceCodeIterator end,
+           lexer::Lexer::Statistics* lexerStatistics);
+
+    /// Prints the context with a message if errors are reported.
+    void printContext(common::SourceLocationReference location, std::string_view message) const;
+    void printContext(common::SourceRangeReference ref, std::string_view message) const;
+
     /// Parses an identifier.
     /// If an error occurs, a nullptr will be returned.
     std::unique_ptr<parse_tree::Identifier> parseIdentifier();
@@ -45,10 +82,44 @@ class Parser {
     std::unique_ptr<parse_tree::StatementList> parseStatementList();
     std::unique_ptr<parse_tree::Statement> parseStatement();
     std::unique_ptr<parse_tree::AssignmentExpression> parseAssignmentExpression();
+
+    /// Parses the leading statements of a large statement list in parallel.
+    /// The statements are split at the semi-colons into chunks which are parsed
+    /// by silent parsers on the thread pool. On success, the statements and
+    /// semi-colons of all chunks are appended to the children and the lexer is
+    /// advanced to the last statement. If any chunk fails, nothing is appended
+    /// and the lexer is left untouched, such that the sequential parse reports
+    /// the earliest error.
+    void parseStatementsInParallel(std::pmr::vector<std::unique_ptr<parse_tree::ParseTreeNode>>& children);
+
+    /// Parses statements which are each followed by a semi-colon until no
+    /// tokens are left and appends them to the children.
+    /// Returns false if an error occurs.
+    bool parseStatementChunk(std::pmr::vector<std::unique_ptr<parse_tree::ParseTreeNode>>& children);
+
+    /// Parses an additive-expression including all its nested expressions.
+    /// It does not recurse, thus, the depth of the expression is only limited
+    /// by the available memory.
+    /// If an error occurs, a nullptr will be returned.
     std::unique_ptr<parse_tree::AdditiveExpression> parseAdditiveExpression();
-    std::unique_ptr<parse_tree::MultiplicativeExpression> parseMultiplicativeExpression();
-    std::unique_ptr<parse_tree::UnaryExpression> parseUnaryExpression();
-    std::unique_ptr<parse_tree::PrimaryExpression> parsePrimaryExpression();
+
+    /// Parses an identifier or a literal as primary-expression. Parenthesized
+    /// primary-expressions are handled by parseAdditiveExpression().
+    /// If an error occurs, a nullptr will be returned.
+    std::unique_ptr<parse_tree::PrimaryExpression> parseNonParenthesizedPrimaryExpression();
+
+    /// Constructs a unary-expression from an optional sign and a primary-expression.
+    static std::unique_ptr<parse_tree::UnaryExpression> makeUnaryExpression(
+        std::unique_ptr<parse_tree::GenericToken> sign,
+        std::unique_ptr<parse_tree::PrimaryExpression> primaryExpression);
+
+    /// An expression on the explicit stack of parseAdditiveExpression().
+    struct PendingExpression;
+
+    /// Options
+    const ParserOptions options;
+    /// True if errors should be printed.
+    const bool reportErrors{true};
 
     /// Source code manager for error handling (i.e. printing the context)
     const common::SourceCodeManager& sourceCodeManager;
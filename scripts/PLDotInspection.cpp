@@ -1,6 +1,7 @@
 #include "pljit/analysis/SemanticAnalysis.h"
 #include "pljit/analysis/SymbolTable.h"
 #include "pljit/ast/ASTDotVisitor.h"
+#include "pljit/common/Diagnostics.h"
 #include "pljit/common/SourceCodeManager.h"
 #include "pljit/optim/ConstantPropagation.h"
 #include "pljit/optim/DeadCodeElimination.h"
@@ -78,6 +79,10 @@ int main(int argc, char* argv[]) {
     buffer << in.rdbuf();
     auto code = buffer.str();
 
+    // The errors in the program are printed.
+    pljit::common::StreamDiagnosticsSink diagnosticsSink(std::cout);
+    pljit::common::DiagnosticsSinkScope diagnosticsSinkScope(&diagnosticsSink);
+
     pljit::common::SourceCodeManager sourceCodeManager(code);
     pljit::parser::Parser parser(sourceCodeManager);
     auto parseTree = parser.parseFunctionDefinition();
@@ -0,0 +1,137 @@
+#include "scripts/WorkloadGenerator.h"
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+
+/// Parses an option value, returns false if the value is invalid.
+template <typename T>
+bool parseValue(std::string_view value, T& result)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        try {
+            size_t length = 0;
+            result = std::stod(std::string{value}, &length);
+            return length == value.size();
+        } catch (const std::exception&) {
+            return false;
+        }
+    } else {
+        auto [ptr, errorCode] = std::from_chars(value.data(), value.data() + value.size(), result);
+        return errorCode == std::errc{} && ptr == value.data() + value.size();
+    }
+}
+
+/// Applies an option of the form --name=value, returns false if the option is
+/// unknown or its value is invalid.
+bool parseOption(std::string_view argument, pljit::workload::WorkloadOptions& options, size_t& numberOfFunctions)
+{
+    auto separator = argument.find('=');
+    if (!argument.starts_with("--") || separator == std::string_view::npos) {
+        return false;
+    }
+    auto name = argument.substr(2, separator - 2);
+    auto value = argument.substr(separator + 1);
+
+    if (name == "functions") {
+        return parseValue(value, numberOfFunctions);
+    } else if (name == "params") {
+        return parseValue(value, options.numberOfParameters);
+    } else if (name == "vars") {
+        return parseValue(value, options.numberOfVariables);
+    } else if (name == "consts") {
+        return parseValue(value, options.numberOfConstants);
+    } else if (name == "statements") {
+        return parseValue(value, options.numberOfStatements);
+    } else if (name == "depth") {
+        return parseValue(value, options.maxExpressionDepth);
+    } else if (name == "fan-out") {
+        return parseValue(value, options.fanOut);
+    } else if (name == "nesting") {
+        return parseValue(value, options.nestingFrequency);
+    } else if (name == "add") {
+        return parseValue(value, options.addWeight);
+    } else if (name == "sub") {
+        return parseValue(value, options.subWeight);
+    } else if (name == "mul") {
+        return parseValue(value, options.mulWeight);
+    } else if (name == "div") {
+        return parseValue(value, options.divisionFrequency);
+    } else if (name == "neg") {
+        return parseValue(value, options.unaryMinusFrequency);
+    } else if (name == "literals") {
+        return parseValue(value, options.literalFrequency);
+    } else if (name == "max-literal") {
+        return parseValue(value, options.maxLiteral);
+    } else if (name == "max-param") {
+        return parseValue(value, options.maxParameterValue);
+    } else if (name == "seed") {
+        return parseValue(value, options.seed);
+    }
+    return false;
+}
+
+} // namespace
+
+/// This script generates valid PL/0 functions of a configurable shape, e.g. as
+/// inputs for scaling benchmarks (see WorkloadGenerator). The functions are
+/// written as a module to the output file, or to stdout if no output file is
+/// given.
+///
+///             ./<script-executable> [--<option>=<value>...] [<outfile>]
+///
+/// Options (defaults in parentheses):
+///     --functions     number of functions (1)
+///     --params        number of parameters (2)
+///     --vars          number of variables (4)
+///     --consts        number of constants (2)
+///     --statements    number of statements including the return (16)
+///     --depth         maximum number of nested parentheses (3)
+///     --fan-out       number of operands per expression (3)
+///     --nesting       probability of a nested expression (0.3)
+///     --add/sub/mul   relative weights of the operators (1/1/1)
+///     --div           probability of a division (0.1)
+///     --neg           probability of a negated operand (0.1)
+///     --literals      probability of a literal operand (0.2)
+///     --max-literal   maximum value of the literals and constants (100)
+///     --max-param     maximum absolute argument without overflows (1000)
+///     --seed          seed of the random number generator (0)
+///
+/// Example: 1000 functions with 100 statements of deep, multiplication-heavy
+/// expressions:
+///             ./<script-executable> --functions=1000 --statements=100 --depth=8 --mul=4 module.pl
+///
+int main(int argc, char* argv[]) {
+    pljit::workload::WorkloadOptions options;
+    size_t numberOfFunctions = 1;
+    const char* outputPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--", 2) != 0 && outputPath == nullptr) {
+            outputPath = argv[i];
+        } else if (!parseOption(argv[i], options, numberOfFunctions)) {
+            std::cerr << "Could not recognize option " << argv[i] << std::endl;
+            std::cerr << "USAGE: " << argv[0] << " [--<option>=<value>...] [<outfile>]" << std::endl;
+            return 1;
+        }
+    }
+
+    pljit::workload::WorkloadGenerator generator(options);
+    auto module = generator.generateModule(numberOfFunctions);
+    if (outputPath == nullptr) {
+        std::cout << module;
+        return 0;
+    }
+
+    std::ofstream out(outputPath);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open file " << outputPath << std::endl;
+        return 1;
+    }
+    out << module;
+    return 0;
+}
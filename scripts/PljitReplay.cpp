@@ -0,0 +1,186 @@
+#include "pljit/CallTrace.h"
+#include "pljit/Pljit.h"
+#include "pljit/common/Diagnostics.h"
+#include "pljit/common/Tracer.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <latch>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/// Options of the replay.
+struct ReplayOptions {
+    /// Number of threads, the calls are distributed round-robin
+    size_t numberOfThreads{1};
+    /// Number of times the trace is replayed
+    size_t numberOfRepetitions{1};
+    /// If set, the functions are compiled by their first replayed call
+    /// instead of before the replay.
+    bool cold{false};
+};
+
+/// Applies an option, returns false if the option is unknown or its value is
+/// invalid.
+bool parseOption(std::string_view argument, ReplayOptions& options)
+{
+    if (argument == "--cold") {
+        options.cold = true;
+        return true;
+    }
+    auto separator = argument.find('=');
+    if (!argument.starts_with("--") || separator == std::string_view::npos) {
+        return false;
+    }
+    auto name = argument.substr(2, separator - 2);
+    auto value = argument.substr(separator + 1);
+    size_t* result = nullptr;
+    if (name == "threads") {
+        result = &options.numberOfThreads;
+    } else if (name == "repeat") {
+        result = &options.numberOfRepetitions;
+    } else {
+        return false;
+    }
+    auto [ptr, errorCode] = std::from_chars(value.data(), value.data() + value.size(), *result);
+    return errorCode == std::errc{} && ptr == value.data() + value.size() && *result > 0;
+}
+
+/// Returns the percentile (between 0 and 1) of the sorted latencies.
+uint64_t getPercentile(const std::vector<uint64_t>& sortedLatencies, double percentile)
+{
+    auto index = static_cast<size_t>(percentile * static_cast<double>(sortedLatencies.size()));
+    return sortedLatencies[std::min(index, sortedLatencies.size() - 1)];
+}
+
+} // namespace
+
+/// This script replays a call trace which was recorded with
+/// PljitOptions::callRecorder, e.g. to reproduce a production load offline
+/// when evaluating changes of the engine or the optimizer. The recorded
+/// functions are registered in a fresh Pljit and the recorded calls are
+/// replayed single-threaded or across multiple threads. The script reports the
+/// throughput, the latency percentiles and the calls whose result differs from
+/// the recorded result.
+///
+///             ./<script-executable> [--threads=<n>] [--repeat=<n>] [--cold] <trace>
+///
+/// Options:
+///     --threads   number of threads, the calls are distributed round-robin (1)
+///     --repeat    number of times the trace is replayed (1)
+///     --cold      compile the functions on their first call instead of before
+///                 the replay, such that the compilation is measured as well
+///
+int main(int argc, char* argv[]) {
+    ReplayOptions options;
+    const char* tracePath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--", 2) != 0 && tracePath == nullptr) {
+            tracePath = argv[i];
+        } else if (!parseOption(argv[i], options)) {
+            std::cerr << "Could not recognize option " << argv[i] << std::endl;
+            tracePath = nullptr;
+            break;
+        }
+    }
+    if (tracePath == nullptr) {
+        std::cerr << "USAGE: " << argv[0] << " [--threads=<n>] [--repeat=<n>] [--cold] <trace>" << std::endl;
+        return 1;
+    }
+
+    auto trace = pljit::CallTrace::read(tracePath);
+    if (!trace) {
+        std::cerr << "Failed to read call trace " << tracePath << std::endl;
+        return 1;
+    }
+
+    // The runtime errors of the recorded calls are expected, hence, they are
+    // not printed.
+    pljit::Pljit pljit(pljit::PljitOptions{.diagnosticsSink = std::make_shared<pljit::common::NullDiagnosticsSink>()});
+    std::unordered_map<uint64_t, pljit::FunctionHandle> functions;
+    size_t numberOfCompileErrors = 0;
+    for (const auto& function : trace->getFunctions()) {
+        auto handle = pljit.registerFunction(function.sourceCode);
+        functions.emplace(function.sourceHash, handle);
+        if (!options.cold && !pljit.waitUntilCompiled(handle)) {
+            ++numberOfCompileErrors;
+        }
+    }
+
+    // The handles are resolved before the replay, such that the lookups are
+    // not measured.
+    const auto& calls = trace->getCalls();
+    std::vector<const pljit::FunctionHandle*> handles;
+    handles.reserve(calls.size());
+    size_t numberOfUnknownCalls = 0;
+    for (const auto& call : calls) {
+        auto it = functions.find(call.sourceHash);
+        handles.push_back(it != functions.end() ? &it->second : nullptr);
+        numberOfUnknownCalls += it == functions.end();
+    }
+
+    std::vector<std::vector<uint64_t>> latencies(options.numberOfThreads);
+    std::vector<size_t> mismatches(options.numberOfThreads, 0);
+    std::latch start(static_cast<std::ptrdiff_t>(options.numberOfThreads + 1));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < options.numberOfThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            latencies[t].reserve(calls.size() / options.numberOfThreads * options.numberOfRepetitions + 1);
+            start.arrive_and_wait();
+            for (size_t repetition = 0; repetition < options.numberOfRepetitions; ++repetition) {
+                for (size_t i = t; i < calls.size(); i += options.numberOfThreads) {
+                    if (handles[i] == nullptr) {
+                        continue;
+                    }
+                    auto callStart = pljit::common::Tracer::now();
+                    auto result = handles[i]->call(calls[i].arguments);
+                    latencies[t].push_back(pljit::common::Tracer::now() - callStart);
+                    const auto& recordedResult = calls[i].result;
+                    if (result.resultCode != recordedResult.resultCode ||
+                        (result.resultCode == pljit::ResultCode::Success && result.value != recordedResult.value)) {
+                        ++mismatches[t];
+                    }
+                }
+            }
+        });
+    }
+    start.arrive_and_wait();
+    auto replayStart = pljit::common::Tracer::now();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto replayTime = pljit::common::Tracer::now() - replayStart;
+
+    std::vector<uint64_t> sortedLatencies;
+    size_t numberOfMismatches = 0;
+    for (size_t t = 0; t < options.numberOfThreads; ++t) {
+        sortedLatencies.insert(sortedLatencies.end(), latencies[t].begin(), latencies[t].end());
+        numberOfMismatches += mismatches[t];
+    }
+    std::sort(sortedLatencies.begin(), sortedLatencies.end());
+
+    std::cout << "functions:  " << trace->getFunctions().size() << " (" << numberOfCompileErrors
+              << " with compile errors)" << std::endl;
+    std::cout << "calls:      " << sortedLatencies.size() << " on " << options.numberOfThreads << " thread(s) ("
+              << numberOfUnknownCalls * options.numberOfRepetitions << " of unknown functions skipped, "
+              << numberOfMismatches << " with other results)" << std::endl;
+    if (sortedLatencies.empty()) {
+        return numberOfMismatches == 0 ? 0 : 2;
+    }
+    std::cout << "throughput: "
+              << static_cast<uint64_t>(static_cast<double>(sortedLatencies.size()) * 1e9 /
+                                       static_cast<double>(std::max<uint64_t>(replayTime, 1)))
+              << " calls/s" << std::endl;
+    std::cout << "latency:    p50 " << getPercentile(sortedLatencies, 0.5) << " ns, p90 "
+              << getPercentile(sortedLatencies, 0.9) << " ns, p99 " << getPercentile(sortedLatencies, 0.99)
+              << " ns, p99.9 " << getPercentile(sortedLatencies, 0.999) << " ns, max " << sortedLatencies.back()
+              << " ns" << std::endl;
+    // Other results indicate a behavior change of the engine.
+    return numberOfMismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,341 @@
+#include "WorkloadGenerator.h"
+#include <algorithm>
+#include <optional>
+
+namespace pljit::workload {
+
+namespace {
+
+/// Returns the distribution of the operators '+', '-' and '*' (if multiplications
+/// are included).
+std::discrete_distribution<int> getOperatorDistribution(const WorkloadOptions& options, bool includeMultiplications)
+{
+    auto addWeight = std::max(options.addWeight, 0.0);
+    auto subWeight = std::max(options.subWeight, 0.0);
+    auto mulWeight = includeMultiplications ? std::max(options.mulWeight, 0.0) : 0.0;
+    if (addWeight + subWeight + mulWeight <= 0) {
+        return std::discrete_distribution<int>{1.0, 1.0};
+    }
+    return std::discrete_distribution<int>{addWeight, subWeight, mulWeight};
+}
+
+/// Appends the name of a symbol. Identifiers consist of letters only, hence,
+/// the index is encoded in bijective base 26, e.g. "pa", "pz", "paa".
+void appendSymbolName(std::string& code, char prefix, size_t index)
+{
+    code.push_back(prefix);
+    auto begin = code.size();
+    for (size_t value = index + 1; value > 0; value = (value - 1) / 26) {
+        code.push_back(static_cast<char>('a' + (value - 1) % 26));
+    }
+    std::reverse(code.begin() + static_cast<std::ptrdiff_t>(begin), code.end());
+}
+
+/// Appends a comma-separated list of symbols, e.g. "pa, pb".
+void appendSymbols(std::string& code, char prefix, size_t numberOfSymbols)
+{
+    for (size_t i = 0; i < numberOfSymbols; ++i) {
+        if (i != 0) {
+            code.append(", ");
+        }
+        appendSymbolName(code, prefix, i);
+    }
+}
+
+} // namespace
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadOptions& options)
+    : options(options),
+      random(options.seed),
+      operatorDistribution(getOperatorDistribution(options, true)),
+      additiveOperatorDistribution(getOperatorDistribution(options, false))
+// Constructor
+{
+    // The bounds of the leaves must not exceed the bound of the expressions.
+    auto maxLeafValue = static_cast<int64_t>(maxValue);
+    this->options.maxLiteral = std::clamp<int64_t>(options.maxLiteral, 1, maxLeafValue);
+    this->options.maxParameterValue = std::clamp<int64_t>(options.maxParameterValue, 0, maxLeafValue);
+    this->options.fanOut = std::max<size_t>(options.fanOut, 1);
+}
+
+std::string WorkloadGenerator::generateFunction()
+// Generates the next function.
+{
+    std::uniform_int_distribution<int64_t> constantDistribution(1, options.maxLiteral);
+    constantValues.resize(options.numberOfConstants);
+    for (auto& constantValue : constantValues) {
+        constantValue = constantDistribution(random);
+    }
+    variableBounds.assign(options.numberOfVariables, 0);
+    initializedVariables.clear();
+
+    std::string code;
+    if (options.numberOfParameters > 0) {
+        code.append("PARAM ");
+        appendSymbols(code, 'p', options.numberOfParameters);
+        code.append(";\n");
+    }
+    if (options.numberOfVariables > 0) {
+        code.append("VAR ");
+        appendSymbols(code, 'v', options.numberOfVariables);
+        code.append(";\n");
+    }
+    if (options.numberOfConstants > 0) {
+        code.append("CONST ");
+        for (size_t i = 0; i < options.numberOfConstants; ++i) {
+            if (i != 0) {
+                code.append(", ");
+            }
+            appendSymbolName(code, 'c', i);
+            code.append(" = " + std::to_string(constantValues[i]));
+        }
+        code.append(";\n");
+    }
+    code.append("\nBEGIN\n");
+
+    // The variables are initialized in order of their declaration, afterwards
+    // the targets of the assignments are chosen randomly.
+    size_t numberOfAssignments = options.numberOfVariables > 0 ? std::max<size_t>(options.numberOfStatements, 1) - 1 : 0;
+    for (size_t i = 0; i < numberOfAssignments; ++i) {
+        size_t target = i < options.numberOfVariables ?
+            i :
+            std::uniform_int_distribution<size_t>(0, options.numberOfVariables - 1)(random);
+        auto [root, bound] = generateExpression();
+        code.append("    ");
+        appendSymbolName(code, 'v', target);
+        code.append(" := ");
+        appendExpression(code, root);
+        code.append(";\n");
+
+        if (variableBounds[target] == 0) {
+            initializedVariables.push_back(target);
+        }
+        // A bound of zero marks uninitialized variables.
+        variableBounds[target] = std::max<uint64_t>(bound, 1);
+    }
+
+    auto [root, bound] = generateExpression();
+    code.append("    RETURN ");
+    appendExpression(code, root);
+    code.append("\nEND.\n");
+    return code;
+}
+
+std::string WorkloadGenerator::generateModule(size_t numberOfFunctions)
+// Generates a module.
+{
+    std::string module;
+    for (size_t i = 0; i < numberOfFunctions; ++i) {
+        if (i != 0) {
+            module.push_back('\n');
+        }
+        module.append(generateFunction());
+    }
+    return module;
+}
+
+std::pair<uint32_t, uint64_t> WorkloadGenerator::generateExpression()
+// Generates an expression into the node buffer.
+{
+    // The expressions are generated with an explicit stack. Every expression
+    // tracks the bounds of its completed additive part and of its current
+    // multiplicative part, such that the bound of an operand is known before
+    // its operator is chosen. Due to the right-associativity, every partial
+    // result is a sum of products of a subset of the operands, hence, the
+    // bounds of the operands are at least one.
+    struct Frame {
+        uint32_t node;
+        size_t depth;
+        size_t operandsLeft;
+        uint64_t sum;
+        uint64_t product;
+        /// Whether the multiplicative part ends with a division
+        bool endsWithDivision;
+    };
+    std::vector<Frame> frames;
+    nodes.clear();
+
+    auto pushExpression = [&](size_t depth) {
+        nodes.push_back({Node::Kind::Expression, false, 0, {}});
+        frames.push_back({static_cast<uint32_t>(nodes.size() - 1), depth, options.fanOut, 0, 0, false});
+    };
+    pushExpression(0);
+
+    std::optional<std::pair<uint32_t, uint64_t>> completedExpression;
+    while (true) {
+        std::pair<uint32_t, uint64_t> operand;
+        if (completedExpression) {
+            operand = *completedExpression;
+            completedExpression.reset();
+        } else if (frames.back().operandsLeft == 0) {
+            auto [node, depth, operandsLeft, sum, product, endsWithDivision] = frames.back();
+            frames.pop_back();
+            if (frames.empty()) {
+                return {node, sum + product};
+            }
+            completedExpression = {node, sum + product};
+            continue;
+        } else if (frames.back().depth < options.maxExpressionDepth && flip(options.nestingFrequency)) {
+            --frames.back().operandsLeft;
+            pushExpression(frames.back().depth + 1);
+            continue;
+        } else {
+            --frames.back().operandsLeft;
+            operand = generateLeaf();
+        }
+        if (flip(options.unaryMinusFrequency)) {
+            nodes[operand.first].negated = true;
+        }
+
+        // Choose the operator, operations which could exceed the bound are
+        // replaced by divisions. After a division, only an additive operator
+        // may follow, since the divisor would include the following operands.
+        auto& frame = frames.back();
+        auto bound = std::max<uint64_t>(operand.second, 1);
+        char op = ' ';
+        if (nodes[frame.node].operands.empty()) {
+            frame.product = bound;
+        } else {
+            static constexpr char operators[] = {'+', '-', '*'};
+            if (frame.endsWithDivision) {
+                op = operators[additiveOperatorDistribution(random)];
+            } else {
+                op = flip(options.divisionFrequency) ? '/' : operators[operatorDistribution(random)];
+            }
+            if (op == '+' || op == '-') {
+                if (frame.sum + frame.product + bound <= maxValue) {
+                    frame.sum += frame.product;
+                    frame.product = bound;
+                    frame.endsWithDivision = false;
+                } else if (frame.endsWithDivision) {
+                    // Neither an addition nor a division is possible, hence,
+                    // the expression ends early.
+                    frame.operandsLeft = 0;
+                    continue;
+                } else {
+                    op = '/';
+                }
+            } else if (op == '*') {
+                if (frame.product > (maxValue - frame.sum) / bound) {
+                    op = '/';
+                } else {
+                    frame.product *= bound;
+                }
+            }
+            if (op == '/') {
+                // A quotient is never larger than the dividend.
+                operand.first = generateDivisor();
+                frame.endsWithDivision = true;
+            }
+        }
+        nodes[frame.node].operands.emplace_back(op, operand.first);
+    }
+}
+
+std::pair<uint32_t, uint64_t> WorkloadGenerator::generateLeaf()
+// Generates an operand which is not an expression.
+{
+    size_t numberOfSymbols = options.numberOfParameters + initializedVariables.size() + options.numberOfConstants;
+    if (numberOfSymbols == 0 || flip(options.literalFrequency)) {
+        auto value = std::uniform_int_distribution<int64_t>(0, options.maxLiteral)(random);
+        nodes.push_back({Node::Kind::Literal, false, value, {}});
+        return {static_cast<uint32_t>(nodes.size() - 1), static_cast<uint64_t>(value)};
+    }
+
+    auto symbol = std::uniform_int_distribution<size_t>(0, numberOfSymbols - 1)(random);
+    uint64_t bound;
+    if (symbol < options.numberOfParameters) {
+        nodes.push_back({Node::Kind::Parameter, false, static_cast<int64_t>(symbol), {}});
+        bound = static_cast<uint64_t>(options.maxParameterValue);
+    } else if (symbol -= options.numberOfParameters; symbol < initializedVariables.size()) {
+        auto variable = initializedVariables[symbol];
+        nodes.push_back({Node::Kind::Variable, false, static_cast<int64_t>(variable), {}});
+        bound = variableBounds[variable];
+    } else {
+        symbol -= initializedVariables.size();
+        nodes.push_back({Node::Kind::Constant, false, static_cast<int64_t>(symbol), {}});
+        bound = static_cast<uint64_t>(constantValues[symbol]);
+    }
+    return {static_cast<uint32_t>(nodes.size() - 1), bound};
+}
+
+uint32_t WorkloadGenerator::generateDivisor()
+// Generates a divisor.
+{
+    if (options.numberOfConstants > 0 && !flip(options.literalFrequency)) {
+        auto constant = std::uniform_int_distribution<size_t>(0, options.numberOfConstants - 1)(random);
+        nodes.push_back({Node::Kind::Constant, false, static_cast<int64_t>(constant), {}});
+    } else {
+        auto value = std::uniform_int_distribution<int64_t>(1, options.maxLiteral)(random);
+        nodes.push_back({Node::Kind::Literal, false, value, {}});
+    }
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void WorkloadGenerator::appendExpression(std::string& code, uint32_t root) const
+// Appends the expression with the given root to the code.
+{
+    struct PendingExpression {
+        uint32_t node;
+        size_t nextOperand;
+    };
+    std::vector<PendingExpression> pendingExpressions{{root, 0}};
+    while (!pendingExpressions.empty()) {
+        auto& pending = pendingExpressions.back();
+        const auto& node = nodes[pending.node];
+        if (pending.nextOperand == node.operands.size()) {
+            // Only the nested expressions are parenthesized.
+            if (pendingExpressions.size() > 1) {
+                code.push_back(')');
+            }
+            pendingExpressions.pop_back();
+            continue;
+        }
+
+        auto [op, operandIndex] = node.operands[pending.nextOperand++];
+        if (pending.nextOperand > 1) {
+            code.push_back(' ');
+            code.push_back(op);
+            code.push_back(' ');
+        }
+        const auto& operand = nodes[operandIndex];
+        if (operand.negated) {
+            code.push_back('-');
+        }
+        if (operand.kind == Node::Kind::Expression) {
+            code.push_back('(');
+            pendingExpressions.push_back({operandIndex, 0});
+        } else {
+            appendLeaf(code, operand);
+        }
+    }
+}
+
+void WorkloadGenerator::appendLeaf(std::string& code, const Node& node) const
+// Appends a leaf to the code.
+{
+    switch (node.kind) {
+        case Node::Kind::Literal:
+            code.append(std::to_string(node.value));
+            break;
+        case Node::Kind::Parameter:
+            appendSymbolName(code, 'p', static_cast<size_t>(node.value));
+            break;
+        case Node::Kind::Variable:
+            appendSymbolName(code, 'v', static_cast<size_t>(node.value));
+            break;
+        case Node::Kind::Constant:
+            appendSymbolName(code, 'c', static_cast<size_t>(node.value));
+            break;
+        case Node::Kind::Expression:
+            __builtin_unreachable();
+    }
+}
+
+bool WorkloadGenerator::flip(double probability)
+// Returns true with the given probability.
+{
+    return std::uniform_real_distribution<double>(0.0, 1.0)(random) < probability;
+}
+
+} // namespace pljit::workload
@@ -0,0 +1,133 @@
+#ifndef H_scripts_WorkloadGenerator
+#define H_scripts_WorkloadGenerator
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace pljit::workload {
+
+/// The shape of the generated functions.
+struct WorkloadOptions {
+    /// Number of declared parameters, variables and constants
+    size_t numberOfParameters{2};
+    size_t numberOfVariables{4};
+    size_t numberOfConstants{2};
+    /// Number of statements including the return statement. Statements
+    /// other than the return statement need a variable to assign to.
+    size_t numberOfStatements{16};
+    /// Maximum number of nested parentheses in an expression
+    size_t maxExpressionDepth{3};
+    /// Number of operands of every (parenthesized) expression
+    size_t fanOut{3};
+    /// Probability that an operand is a parenthesized expression (as long as
+    /// the maximum depth is not reached)
+    double nestingFrequency{0.3};
+    /// Relative weights of the operators which are not divisions
+    double addWeight{1.0};
+    double subWeight{1.0};
+    double mulWeight{1.0};
+    /// Probability that an operator is a division
+    double divisionFrequency{0.1};
+    /// Probability that an operand is negated
+    double unaryMinusFrequency{0.1};
+    /// Probability that an operand is a literal instead of a symbol
+    double literalFrequency{0.2};
+    /// Maximum value of the literals and the constants
+    int64_t maxLiteral{100};
+    /// Maximum absolute value of the arguments with which the functions are
+    /// guaranteed to execute without overflows
+    int64_t maxParameterValue{1000};
+    /// Seed of the random number generator
+    uint64_t seed{0};
+};
+
+/// Generates valid PL/0 functions of a configurable shape, e.g. for scaling
+/// benchmarks. The generated functions always compile, and they execute
+/// without runtime errors and overflows as long as the absolute values of the
+/// arguments do not exceed maxParameterValue: The generator tracks an upper
+/// bound of the absolute value of every expression, and operations which
+/// could exceed 2^40 are replaced by divisions. Since the operators of PL/0 are
+/// right-associative, a division always ends a multiplicative expression,
+/// such that the divisor is a single non-zero literal or constant.
+/// The expressions are generated without recursion, such that the depth of
+/// the expressions is only limited by the available memory.
+class WorkloadGenerator {
+    public:
+    /// Upper bound of the absolute value of every expression
+    static constexpr uint64_t maxValue = uint64_t{1} << 40;
+
+    /// Constructor
+    explicit WorkloadGenerator(const WorkloadOptions& options);
+
+    /// Generates the next function.
+    std::string generateFunction();
+
+    /// Generates a module, i.e. consecutive function definitions.
+    std::string generateModule(size_t numberOfFunctions);
+
+    private:
+    /// A node of a generated expression. Operands are leaves, parenthesized
+    /// expressions are chains of operands which are joined by operators.
+    struct Node {
+        enum class Kind {
+            Literal,
+            Parameter,
+            Variable,
+            Constant,
+            Expression
+        };
+        Kind kind;
+        bool negated;
+        /// Value of a literal or index of a symbol
+        int64_t value;
+        /// Operators and operands of an expression (the first operator is unused)
+        std::vector<std::pair<char, uint32_t>> operands;
+    };
+
+    /// Generates an expression into the node buffer, returns the index of its
+    /// root and its bound.
+    std::pair<uint32_t, uint64_t> generateExpression();
+
+    /// Generates an operand which is not an expression, returns its index and bound.
+    std::pair<uint32_t, uint64_t> generateLeaf();
+
+    /// Generates a divisor, i.e. a non-zero literal or a constant.
+    uint32_t generateDivisor();
+
+    /// Appends the expression with the given root to the code.
+    void appendExpression(std::string& code, uint32_t root) const;
+
+    /// Appends a leaf to the code.
+    void appendLeaf(std::string& code, const Node& node) const;
+
+    /// Returns true with the given probability.
+    bool flip(double probability);
+
+    /// Options
+    WorkloadOptions options;
+
+    /// Random number generator
+    std::mt19937_64 random;
+
+    /// Operator distributions (without divisions, without multiplications)
+    std::discrete_distribution<int> operatorDistribution;
+    std::discrete_distribution<int> additiveOperatorDistribution;
+
+    /// Values of the constants of the current function
+    std::vector<int64_t> constantValues;
+
+    /// Bounds of the variables of the current function (zero for variables
+    /// which are not initialized yet)
+    std::vector<uint64_t> variableBounds;
+    /// Indexes of the initialized variables
+    std::vector<size_t> initializedVariables;
+
+    /// Buffer of the nodes of the current expression
+    std::vector<Node> nodes;
+};
+
+} // namespace pljit::workload
+
+#endif
@@ -134,4 +134,31 @@ TEST(TestASTDotVisitor, MoreComplexTest) { // NOLINT
     executeTest(code, expectedASTInDot);
 }
 
+TEST(TestASTDotVisitor, DeepExpression) { // NOLINT
+    // RETURN -(-(...(-a)...)), which would overflow the stack if the visitor
+    // recursed.
+    constexpr size_t depth = 100000;
+    std::string code{"PARAM a; BEGIN RETURN "};
+    for (size_t i = 0; i < depth; ++i) {
+        code.append("-(");
+    }
+    code.append("a");
+    code.append(depth, ')');
+    code.append(" END.");
+    test_utils::ASTEnvironment env(code, test_utils::Optimization::NoOptimization);
+
+    std::ostringstream buffer;
+    ASTDotVisitor visitor(buffer, env.symbolTable);
+    env.ast->accept(visitor);
+
+    auto dotGraph = buffer.str();
+    ASSERT_TRUE(dotGraph.starts_with("digraph {\n"
+                                     "\t0 [label=\"Function\"];\n"
+                                     "\t1 [label=\"RETURN\"];\n"
+                                     "\t2 [label=\"-\"];\n"));
+    auto lastLabelId = std::to_string(depth + 2);
+    ASSERT_NE(dotGraph.find("\t" + lastLabelId + " [label=\"a\"];\n"), std::string::npos);
+    ASSERT_TRUE(dotGraph.ends_with("\t" + std::to_string(depth + 1) + " -> " + lastLabelId + ";\n}\n"));
+}
+
 } // namespace pljit::ast
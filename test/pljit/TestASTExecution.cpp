@@ -164,7 +164,7 @@ TEST(TestASTExecution, SomeCalculations3) { // NOLINT
 }
 
 TEST(TestASTExecution, DivisionByZero) { // NOLINT
-    test_utils::CaptureCout cout;
+    test_utils::CaptureDiagnostics diagnostics;
 
     std::string_view code{"BEGIN\n"
                           "   RETURN 1 / 0\n"
@@ -180,8 +180,8 @@ TEST(TestASTExecution, DivisionByZero) { // NOLINT
 
     // The error message is expected twice since we execute the program
     // once optimized and then also unoptimized.
-    ASSERT_EQ(cout.stream.str(), "error: division by zero\n"
-                                 "error: division by zero\n");
+    ASSERT_EQ(diagnostics.stream.str(), "error: division by zero\n"
+                                        "error: division by zero\n");
 }
 
 } // namespace pljit::ast
@@ -0,0 +1,129 @@
+#include "pljit/CallMetrics.h"
+#include "pljit/Pljit.h"
+#include "test/utils/TestUtils.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace pljit {
+
+TEST(TestCallMetrics, LatencyHistogram) { // NOLINT
+    ASSERT_EQ(CallMetrics::getLatencyBucket(0), 0);
+    ASSERT_EQ(CallMetrics::getLatencyBucket(1), 0);
+    ASSERT_EQ(CallMetrics::getLatencyBucket(2), 1);
+    ASSERT_EQ(CallMetrics::getLatencyBucket(1023), 9);
+    ASSERT_EQ(CallMetrics::getLatencyBucket(1024), 10);
+    ASSERT_EQ(CallMetrics::getLatencyBucket(UINT64_MAX), CallMetrics::numberOfLatencyBuckets - 1);
+
+    CallCounters counters;
+    for (size_t i = 0; i < 90; ++i) {
+        counters.recordSampledCall(false, 100);
+    }
+    for (size_t i = 0; i < 10; ++i) {
+        counters.recordSampledCall(true, 5000);
+    }
+    counters.recordCall(false);
+
+    auto metrics = counters.getMetrics();
+    ASSERT_EQ(metrics.numberOfCalls, 101);
+    ASSERT_EQ(metrics.numberOfRuntimeErrors, 10);
+    ASSERT_EQ(metrics.numberOfSampledCalls, 100);
+    ASSERT_EQ(metrics.sampledTicks, 90 * 100 + 10 * 5000);
+    ASSERT_EQ(metrics.latencyHistogram[6], 90);
+    ASSERT_EQ(metrics.latencyHistogram[12], 10);
+    ASSERT_DOUBLE_EQ(metrics.getMeanLatency(), 590);
+    ASSERT_DOUBLE_EQ(metrics.getEstimatedTotalTicks(), 590 * 101);
+    ASSERT_EQ(metrics.getLatencyPercentile(0.5), 127);
+    ASSERT_EQ(metrics.getLatencyPercentile(0.95), 8191);
+    ASSERT_EQ(metrics.getLatencyPercentile(1), 8191);
+    ASSERT_EQ(CallMetrics().getLatencyPercentile(0.5), 0);
+}
+
+TEST(TestCallMetrics, Disabled) { // NOLINT
+    Pljit pljit;
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_EQ(cantFail(func()), 1);
+    ASSERT_FALSE(pljit.getCallMetrics(func));
+    ASSERT_TRUE(pljit.getFunctionMetrics().empty());
+}
+
+TEST(TestCallMetrics, CountCalls) { // NOLINT
+    test_utils::CaptureCout cout;
+    Pljit pljit(PljitOptions{.collectCallMetrics = true});
+    auto div = pljit.registerFunction("PARAM a, b; BEGIN RETURN a / b END.");
+    auto error = pljit.registerFunction("BEGIN RETURN x END.");
+    auto unused = pljit.registerFunction("BEGIN RETURN 1 END.");
+    auto unregistered = pljit.registerFunction("BEGIN RETURN 2 END.");
+    pljit.unregisterFunction(unregistered);
+
+    for (int64_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(div(i, i % 10).resultCode, i % 10 == 0 ? ResultCode::RuntimeError : ResultCode::Success);
+    }
+    // Calls which are not executed are not counted.
+    ASSERT_EQ(div(1).resultCode, ResultCode::InvalidFunctionCall);
+    ASSERT_EQ(error().resultCode, ResultCode::CompileError);
+
+    auto metrics = pljit.getCallMetrics(div);
+    ASSERT_TRUE(metrics);
+    ASSERT_EQ(metrics->numberOfCalls, 1000);
+    ASSERT_EQ(metrics->numberOfRuntimeErrors, 100);
+    // Every 64th call of the function is sampled.
+    ASSERT_GE(metrics->numberOfSampledCalls, 15);
+    ASSERT_LE(metrics->numberOfSampledCalls, 16);
+    uint64_t numberOfSampledCalls = 0;
+    for (auto count : metrics->latencyHistogram) {
+        numberOfSampledCalls += count;
+    }
+    ASSERT_EQ(numberOfSampledCalls, metrics->numberOfSampledCalls);
+
+    auto functionMetrics = pljit.getFunctionMetrics();
+    ASSERT_EQ(functionMetrics.size(), 3);
+    ASSERT_EQ(functionMetrics[0].sourceCode, "PARAM a, b; BEGIN RETURN a / b END.");
+    ASSERT_EQ(functionMetrics[0].callMetrics.numberOfCalls, 1000);
+    ASSERT_EQ(cantFail(functionMetrics[0].handle(6, 3)), 2);
+    ASSERT_EQ(functionMetrics[1].callMetrics.numberOfCalls, 0);
+    ASSERT_EQ(functionMetrics[2].callMetrics.numberOfCalls, 0);
+    ASSERT_EQ(cantFail(functionMetrics[2].handle()), 1);
+    ASSERT_EQ(pljit.getCallMetrics(unused)->numberOfCalls, 1);
+}
+
+TEST(TestCallMetrics, InterleavedFunctions) { // NOLINT
+    Pljit pljit(PljitOptions{.collectCallMetrics = true});
+    auto first = pljit.registerFunction("PARAM a; BEGIN RETURN a + 1 END.");
+    auto second = pljit.registerFunction("PARAM a; BEGIN RETURN a + 2 END.");
+
+    // The calls of the other function do not shift the sampled calls.
+    for (int64_t i = 0; i < 6400; ++i) {
+        ASSERT_EQ(cantFail(first(i)), i + 1);
+        ASSERT_EQ(cantFail(second(i)), i + 2);
+    }
+    ASSERT_EQ(pljit.getCallMetrics(first)->numberOfSampledCalls, 100);
+    ASSERT_EQ(pljit.getCallMetrics(second)->numberOfSampledCalls, 100);
+}
+
+TEST(TestCallMetrics, ConcurrentCalls) { // NOLINT
+    Pljit pljit(PljitOptions{.collectCallMetrics = true});
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.");
+
+    constexpr size_t numberOfThreads = 8;
+    constexpr int64_t numberOfCalls = 10000;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numberOfThreads; ++i) {
+        threads.emplace_back([&]() {
+            for (int64_t j = 0; j < numberOfCalls; ++j) {
+                ASSERT_EQ(cantFail(func(j)), 2 * j);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto metrics = pljit.getCallMetrics(func);
+    ASSERT_EQ(metrics->numberOfCalls, numberOfThreads * numberOfCalls);
+    ASSERT_EQ(metrics->numberOfRuntimeErrors, 0);
+    ASSERT_GE(metrics->numberOfSampledCalls, numberOfThreads * (numberOfCalls / 64 - 1));
+    ASSERT_GT(metrics->getEstimatedTotalTicks(), 0);
+}
+
+} // namespace pljit
@@ -0,0 +1,185 @@
+#include "pljit/CallTrace.h"
+#include "pljit/Pljit.h"
+#include "pljit/common/Hash.h"
+#include "test/utils/TestUtils.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+namespace pljit {
+
+namespace {
+
+/// A temporary call trace which is removed at the end of the test.
+class TestCallTrace : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+            ("pljit_trace_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::filesystem::path path;
+};
+
+} // namespace
+
+TEST_F(TestCallTrace, RecordAndRead) { // NOLINT
+    test_utils::CaptureCout cout;
+
+    std::string divide{"PARAM a, b; BEGIN RETURN a / b END."};
+    std::string constant{"BEGIN RETURN 42 END."};
+    {
+        std::shared_ptr<CallRecorder> recorder = CallRecorder::create(path.string());
+        Pljit pljit(PljitOptions{.callRecorder = recorder});
+        auto divideFunction = pljit.registerFunction(divide);
+        auto constantFunction = pljit.registerFunction(constant);
+        // Functions with the same source code are only recorded once.
+        pljit.registerFunction(constant);
+
+        ASSERT_EQ(cantFail(divideFunction(-1000000, 3)), -333333);
+        ASSERT_EQ(divideFunction(1, 0).resultCode, ResultCode::RuntimeError);
+        ASSERT_EQ(divideFunction(1).resultCode, ResultCode::InvalidFunctionCall);
+        ASSERT_EQ(cantFail(constantFunction.call({})), 42);
+        ASSERT_TRUE(recorder->flush());
+    }
+
+    auto trace = CallTrace::read(path.string());
+    ASSERT_TRUE(trace);
+    const auto& functions = trace->getFunctions();
+    ASSERT_EQ(functions.size(), 2);
+    ASSERT_EQ(functions[0].sourceHash, common::hashBytes(divide));
+    ASSERT_EQ(functions[0].sourceCode, divide);
+    ASSERT_EQ(functions[1].sourceHash, common::hashBytes(constant));
+    ASSERT_EQ(functions[1].sourceCode, constant);
+
+    const auto& calls = trace->getCalls();
+    ASSERT_EQ(calls.size(), 4);
+    ASSERT_EQ(calls[0].sourceHash, functions[0].sourceHash);
+    ASSERT_EQ(calls[0].arguments, (std::vector<int64_t>{-1000000, 3}));
+    ASSERT_EQ(calls[0].result.resultCode, ResultCode::Success);
+    ASSERT_EQ(calls[0].result.value, -333333);
+    ASSERT_EQ(calls[1].arguments, (std::vector<int64_t>{1, 0}));
+    ASSERT_EQ(calls[1].result.resultCode, ResultCode::RuntimeError);
+    ASSERT_EQ(calls[2].arguments, (std::vector<int64_t>{1}));
+    ASSERT_EQ(calls[2].result.resultCode, ResultCode::InvalidFunctionCall);
+    ASSERT_EQ(calls[3].sourceHash, functions[1].sourceHash);
+    ASSERT_TRUE(calls[3].arguments.empty());
+    ASSERT_EQ(calls[3].result.value, 42);
+}
+
+TEST_F(TestCallTrace, ReplacedFunctions) { // NOLINT
+    std::string oldVersion{"PARAM a; BEGIN RETURN a END."};
+    std::string newVersion{"PARAM a; BEGIN RETURN a * 2 END."};
+    {
+        Pljit pljit(PljitOptions{.callRecorder = CallRecorder::create(path.string())});
+        auto function = pljit.registerFunction(oldVersion);
+        ASSERT_EQ(cantFail(function(21)), 21);
+        ASSERT_TRUE(pljit.replaceFunction(function, newVersion));
+        ASSERT_EQ(cantFail(function(21)), 42);
+    }
+
+    auto trace = CallTrace::read(path.string());
+    ASSERT_TRUE(trace);
+    ASSERT_EQ(trace->getFunctions().size(), 2);
+    ASSERT_EQ(trace->getCalls().size(), 2);
+    ASSERT_EQ(trace->getCalls()[0].sourceHash, common::hashBytes(oldVersion));
+    ASSERT_EQ(trace->getCalls()[1].sourceHash, common::hashBytes(newVersion));
+}
+
+TEST_F(TestCallTrace, MultipleThreads) { // NOLINT
+    constexpr size_t numberOfThreads = 4;
+    constexpr int64_t numberOfCalls = 1000;
+    {
+        // The small buffers are written to the file while the threads record.
+        Pljit pljit(PljitOptions{.callRecorder = CallRecorder::create(path.string(), 64)});
+        auto function = pljit.registerFunction("PARAM a, b; BEGIN RETURN a * 1000 + b END.");
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < numberOfThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int64_t i = 0; i < numberOfCalls; ++i) {
+                    function(static_cast<int64_t>(t), i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    auto trace = CallTrace::read(path.string());
+    ASSERT_TRUE(trace);
+    const auto& calls = trace->getCalls();
+    ASSERT_EQ(calls.size(), numberOfThreads * numberOfCalls);
+    // The calls of every thread are in order.
+    std::vector<int64_t> nextCall(numberOfThreads, 0);
+    for (const auto& call : calls) {
+        ASSERT_EQ(call.arguments.size(), 2);
+        auto t = static_cast<size_t>(call.arguments[0]);
+        ASSERT_LT(t, numberOfThreads);
+        ASSERT_EQ(call.arguments[1], nextCall[t]++);
+        ASSERT_EQ(call.result.value, call.arguments[0] * 1000 + call.arguments[1]);
+    }
+}
+
+TEST_F(TestCallTrace, InvalidFiles) { // NOLINT
+    // Missing file
+    ASSERT_FALSE(CallTrace::read(path.string()));
+
+    {
+        Pljit pljit(PljitOptions{.callRecorder = CallRecorder::create(path.string())});
+        auto function = pljit.registerFunction("PARAM a; BEGIN RETURN a END.");
+        ASSERT_EQ(cantFail(function(1)), 1);
+        ASSERT_EQ(cantFail(function(2)), 2);
+    }
+
+    // A truncated last record is ignored.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    auto trace = CallTrace::read(path.string());
+    ASSERT_TRUE(trace);
+    ASSERT_EQ(trace->getFunctions().size(), 1);
+    ASSERT_EQ(trace->getCalls().size(), 1);
+
+    // Unknown record type after the header
+    std::filesystem::resize_file(path, 2 * sizeof(uint64_t));
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << '\x7f';
+    }
+    ASSERT_FALSE(CallTrace::read(path.string()));
+
+    // Garbage
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "no call trace";
+    }
+    ASSERT_FALSE(CallTrace::read(path.string()));
+
+    // The file cannot be written.
+    ASSERT_EQ(CallRecorder::create((path / "trace").string()), nullptr);
+}
+
+TEST_F(TestCallTrace, WriteErrors) { // NOLINT
+    if (!std::filesystem::exists("/dev/full")) {
+        GTEST_SKIP() << "/dev/full is not available";
+    }
+    // Every write to /dev/full fails because the device is full.
+    std::shared_ptr<CallRecorder> recorder = CallRecorder::create("/dev/full");
+    ASSERT_NE(recorder, nullptr);
+    {
+        Pljit pljit(PljitOptions{.callRecorder = recorder});
+        auto function = pljit.registerFunction("PARAM a; BEGIN RETURN a END.");
+        ASSERT_EQ(cantFail(function(1)), 1);
+    }
+    ASSERT_FALSE(recorder->flush());
+    // The failure is not reset by the next flush.
+    ASSERT_FALSE(recorder->flush());
+}
+
+} // namespace pljit
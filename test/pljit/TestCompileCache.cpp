@@ -0,0 +1,201 @@
+#include "pljit/Pljit.h"
+#include "pljit/ast/AST.h"
+#include "pljit/exec/CompileCache.h"
+#include "pljit/exec/ExecutionImage.h"
+#include "pljit/exec/FunctionFingerprint.h"
+#include "test/utils/TestUtils.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace pljit::exec {
+
+namespace {
+
+using test_utils::ASTEnvironment;
+using test_utils::Optimization;
+
+/// A temporary cache directory which is removed at the end of the test.
+class TestCompileCache : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() /
+            ("pljit_cache_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::filesystem::path directory;
+};
+
+std::unique_ptr<ExecutionImage> compileImage(std::string_view code)
+{
+    ASTEnvironment environment(code, Optimization::DeadCodeEliminationAndConstantPropagation);
+    return std::make_unique<ExecutionImage>(std::move(environment.ast), environment.symbolTable);
+}
+
+} // namespace
+
+TEST_F(TestCompileCache, StoreAndLoad) { // NOLINT
+    std::string code{"PARAM a; VAR b; CONST c = 3;\n"
+                     "BEGIN b := -a * c; a := b / 2; RETURN a + b END."};
+    CompileCache cache(directory);
+    ASSERT_EQ(cache.load(code), nullptr);
+
+    auto image = compileImage(code);
+    cache.store(code, *image);
+    ASSERT_TRUE(std::filesystem::exists(cache.getPath(code)));
+
+    auto loadedImage = cache.load(code);
+    ASSERT_NE(loadedImage, nullptr);
+    ASSERT_EQ(FunctionFingerprint(*loadedImage), FunctionFingerprint(*image));
+    ASSERT_EQ(loadedImage->getNumberOfParameters(), 1);
+    ASSERT_EQ(loadedImage->getNumberOfVariables(), 1);
+
+    // Other source code is not found, even if the function is equal.
+    ASSERT_EQ(cache.load(code + " "), nullptr);
+}
+
+TEST_F(TestCompileCache, DeepExpression) { // NOLINT
+    // -(-(...(-a)...))
+    std::string code{"PARAM a; BEGIN RETURN "};
+    for (size_t i = 0; i < 100000; ++i) {
+        code.append("-(");
+    }
+    code.append("a");
+    code.append(100000, ')');
+    code.append(" END.");
+
+    CompileCache cache(directory);
+    cache.store(code, *compileImage(code));
+    auto loadedImage = cache.load(code);
+    ASSERT_NE(loadedImage, nullptr);
+    ASSERT_EQ(FunctionFingerprint(*loadedImage).getEncoding().size(), 3 + 2 + 100000 + 1);
+}
+
+TEST_F(TestCompileCache, InvalidFiles) { // NOLINT
+    std::string code{"BEGIN RETURN 1 END."};
+    CompileCache cache(directory);
+    cache.store(code, *compileImage(code));
+    auto path = cache.getPath(code);
+    auto size = std::filesystem::file_size(path);
+
+    // Truncated file
+    std::filesystem::resize_file(path, size - 8);
+    ASSERT_EQ(cache.load(code), nullptr);
+
+    // Garbage
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "no cache file";
+    }
+    ASSERT_EQ(cache.load(code), nullptr);
+}
+
+TEST_F(TestCompileCache, OtherBuild) { // NOLINT
+    std::string code{"PARAM a; BEGIN RETURN a * 2 END."};
+    CompileCache cache(directory);
+    cache.store(code, *compileImage(code));
+    ASSERT_NE(cache.load(code), nullptr);
+
+    // Another build does not find the file.
+    CompileCache otherCache(directory, "other build");
+    ASSERT_NE(otherCache.getPath(code), cache.getPath(code));
+    ASSERT_EQ(otherCache.load(code), nullptr);
+
+    // It does not load the file under its own name either.
+    std::filesystem::copy_file(cache.getPath(code), otherCache.getPath(code));
+    ASSERT_EQ(otherCache.load(code), nullptr);
+    ASSERT_NE(cache.load(code), nullptr);
+}
+
+TEST(TestCompileCacheDecode, InvalidEncodings) { // NOLINT
+    using Opcode = FunctionFingerprint::Opcode;
+    auto op = [](Opcode opcode) { return static_cast<int64_t>(opcode); };
+
+    // Valid: PARAM a; BEGIN RETURN a END.
+    ASSERT_NE(CompileCache::decode(std::vector<int64_t>{1, 0, 0, op(Opcode::Parameter), 0, op(Opcode::Return)}), nullptr);
+
+    // Truncated header
+    ASSERT_EQ(CompileCache::decode(std::vector<int64_t>{1, 0}), nullptr);
+    // Missing constant values
+    ASSERT_EQ(CompileCache::decode(std::vector<int64_t>{0, 0, 2, 1}), nullptr);
+    // No statements
+    ASSERT_EQ(CompileCache::decode(std::vector<int64_t>{0, 0, 0}), nullptr);
+    // Symbol id out of range
+    ASSERT_EQ(CompileCache::decode(std::vector<int64_t>{1, 0, 0, op(Opcode::Parameter), 1, op(Opcode::Return)}), nullptr);
+    // Missing operand
+    ASSERT_EQ(CompileCache::decode(std::vector<int64_t>{0, 0, 0, op(Opcode::ConstantLiteral), 1, op(Opcode::Add),
+                                                        op(Opcode::Return)}),
+              nullptr);
+    // Operand left over
+    ASSERT_EQ(CompileCache::decode(std::vector<int64_t>{0, 0, 0, op(Opcode::ConstantLiteral), 1,
+                                                        op(Opcode::ConstantLiteral), 2, op(Opcode::Return)}),
+              nullptr);
+    // Assignment to a constant
+    ASSERT_EQ(CompileCache::decode(std::vector<int64_t>{0, 0, 1, 5, op(Opcode::ConstantLiteral), 1,
+                                                        op(Opcode::Assignment), op(Opcode::Constant), 0,
+                                                        op(Opcode::ConstantLiteral), 1, op(Opcode::Return)}),
+              nullptr);
+    // Unknown opcode
+    ASSERT_EQ(CompileCache::decode(std::vector<int64_t>{0, 0, 0, 42}), nullptr);
+}
+
+TEST_F(TestCompileCache, PljitLoadsFromCache) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    std::string code{"PARAM a;\n"
+                     "BEGIN\n"
+                     "RETURN a * 2\n"
+                     "END."};
+    {
+        Pljit pljit(PljitOptions{.compileCacheDirectory = directory.string()});
+        auto func = pljit.registerFunction(code);
+        ASSERT_EQ(cantFail(func(21)), 42);
+    }
+    CompileCache cache(directory);
+    ASSERT_NE(cache.load(code), nullptr);
+
+    // Replace the cached function, such that we can observe that the function
+    // is loaded instead of being compiled.
+    cache.store(code, *compileImage("PARAM a; BEGIN RETURN a * 3 END."));
+    {
+        Pljit pljit(PljitOptions{.lowMemoryMode = true, .compileCacheDirectory = directory.string()});
+        auto func = pljit.registerFunction(code);
+        ASSERT_EQ(cantFail(func(21)), 63);
+        ASSERT_EQ(func().resultCode, ResultCode::InvalidFunctionCall);
+    }
+
+    // Invalid files are ignored and replaced.
+    std::filesystem::resize_file(cache.getPath(code), 16);
+    {
+        Pljit pljit(PljitOptions{.compileCacheDirectory = directory.string()});
+        auto func = pljit.registerFunction(code);
+        ASSERT_EQ(cantFail(func(21)), 42);
+    }
+    ASSERT_NE(cache.load(code), nullptr);
+}
+
+TEST_F(TestCompileCache, CompileErrorsAreNotCached) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    std::string code{"BEGIN RETURN x END."};
+    for (size_t i = 0; i < 2; ++i) {
+        Pljit pljit(PljitOptions{.compileCacheDirectory = directory.string()});
+        auto func = pljit.registerFunction(code);
+        ASSERT_EQ(func().resultCode, ResultCode::CompileError);
+    }
+    // The error is reported by both compilations.
+    ASSERT_EQ(diagnostics.stream.str(), "1:14: error: use of undeclared identifier\n"
+                                        "BEGIN RETURN x END.\n"
+                                        "             ^\n"
+                                        "1:14: error: use of undeclared identifier\n"
+                                        "BEGIN RETURN x END.\n"
+                                        "             ^\n");
+    ASSERT_TRUE(std::filesystem::is_empty(directory));
+}
+
+} // namespace pljit::exec
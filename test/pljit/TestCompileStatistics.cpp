@@ -0,0 +1,129 @@
+#include "pljit/CompileStatistics.h"
+#include "pljit/Pljit.h"
+#include "test/utils/TestUtils.h"
+#include <filesystem>
+#include <gtest/gtest.h>
+
+namespace pljit {
+
+TEST(TestCompileStatistics, CollectStatistics) { // NOLINT
+    Pljit pljit(PljitOptions{.collectCompileStatistics = true});
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.");
+    ASSERT_FALSE(pljit.getCompileStatistics(func));
+    ASSERT_EQ(cantFail(func(21)), 42);
+
+    auto statistics = pljit.getCompileStatistics(func);
+    ASSERT_TRUE(statistics);
+    ASSERT_EQ(statistics->numberOfCompilations, 1);
+    ASSERT_EQ(statistics->numberOfCacheHits, 0);
+    ASSERT_EQ(statistics->numberOfDeduplications, 0);
+    // PARAM a ; BEGIN RETURN a * 2 END .
+    ASSERT_EQ(statistics->numberOfTokens, 10);
+    ASSERT_GT(statistics->numberOfParseTreeNodes, statistics->numberOfASTNodes);
+    ASSERT_GT(statistics->numberOfASTNodes, 0);
+    ASSERT_GT((*statistics)[CompilePhase::Parsing].allocatedBytes, 0);
+    ASSERT_GT((*statistics)[CompilePhase::SemanticAnalysis].allocatedBytes, 0);
+    ASSERT_EQ((*statistics)[CompilePhase::Lexing].allocatedBytes, 0);
+    for (size_t i = 0; i < CompileStatistics::numberOfPhases; ++i) {
+        ASSERT_GT(statistics->phases[i].time.count(), 0);
+    }
+    ASSERT_GE(statistics->getTotalTime(), (*statistics)[CompilePhase::Parsing].time);
+}
+
+TEST(TestCompileStatistics, TokensAreCountedOnce) { // NOLINT
+    std::string code{"PARAM a; VAR b; BEGIN\n"};
+    for (size_t i = 0; i < 100; ++i) {
+        code.append("b := a + " + std::to_string(i) + ";\n");
+    }
+    code.append("RETURN b END.");
+    // PARAM a ; VAR b ; BEGIN, 100 * (b := a + i ;), RETURN b END .
+    size_t numberOfTokens = 7 + 100 * 6 + 4;
+
+    for (auto [parallelParsingThreshold, pipelinedLexing] : {std::pair{size_t{0}, false},
+                                                             std::pair{size_t{10}, false},
+                                                             std::pair{size_t{0}, true}}) {
+        Pljit pljit(PljitOptions{.parallelParsingThreshold = parallelParsingThreshold,
+                                 .pipelinedLexing = pipelinedLexing,
+                                 .collectCompileStatistics = true});
+        auto func = pljit.registerFunction(code);
+        ASSERT_EQ(cantFail(func(1)), 100);
+        auto statistics = pljit.getCompileStatistics(func);
+        ASSERT_TRUE(statistics);
+        ASSERT_EQ(statistics->numberOfTokens, numberOfTokens);
+        ASSERT_GE((*statistics)[CompilePhase::Parsing].time.count(), 0);
+    }
+}
+
+TEST(TestCompileStatistics, ReplacedFunction) { // NOLINT
+    Pljit pljit(PljitOptions{.collectCompileStatistics = true});
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_EQ(cantFail(func()), 1);
+    ASSERT_EQ(pljit.getCompileStatistics(func)->numberOfTokens, 5);
+
+    // The statistics of the function are the ones of its new version.
+    ASSERT_TRUE(pljit.replaceFunction(func, "PARAM a; BEGIN RETURN a END."));
+    ASSERT_EQ(pljit.getCompileStatistics(func)->numberOfTokens, 8);
+    ASSERT_EQ(pljit.getCompileStatistics().numberOfCompilations, 2);
+}
+
+TEST(TestCompileStatistics, Disabled) { // NOLINT
+    Pljit pljit;
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_EQ(cantFail(func()), 1);
+    ASSERT_FALSE(pljit.getCompileStatistics(func));
+    ASSERT_EQ(pljit.getCompileStatistics().numberOfCompilations, 0);
+}
+
+TEST(TestCompileStatistics, CompileError) { // NOLINT
+    test_utils::CaptureCout cout;
+    Pljit pljit(PljitOptions{.collectCompileStatistics = true});
+    auto func = pljit.registerFunction("BEGIN RETURN x END.");
+    ASSERT_EQ(func().resultCode, ResultCode::CompileError);
+
+    auto statistics = pljit.getCompileStatistics(func);
+    ASSERT_TRUE(statistics);
+    ASSERT_EQ(statistics->numberOfCompilations, 1);
+    ASSERT_GT(statistics->numberOfParseTreeNodes, 0);
+    ASSERT_EQ((*statistics)[CompilePhase::CodeGeneration].time.count(), 0);
+}
+
+TEST(TestCompileStatistics, Aggregate) { // NOLINT
+    auto processStatistics = CompileStatistics::getProcessSnapshot();
+
+    Pljit pljit(PljitOptions{.deduplicateFunctions = true, .collectCompileStatistics = true});
+    auto func1 = pljit.registerFunction("PARAM a; BEGIN RETURN a + 1 END.");
+    auto func2 = pljit.registerFunction("PARAM b; BEGIN RETURN b + 1 END.");
+    ASSERT_EQ(cantFail(func1(1)), 2);
+    ASSERT_EQ(cantFail(func2(2)), 3);
+    ASSERT_EQ(pljit.getCompileStatistics(func1)->numberOfDeduplications, 0);
+    ASSERT_EQ(pljit.getCompileStatistics(func2)->numberOfDeduplications, 1);
+
+    auto statistics = pljit.getCompileStatistics();
+    ASSERT_EQ(statistics.numberOfCompilations, 2);
+    ASSERT_EQ(statistics.numberOfDeduplications, 1);
+    ASSERT_EQ(statistics.numberOfTokens, 2 * pljit.getCompileStatistics(func1)->numberOfTokens);
+
+    // Other tests might compile concurrently, hence, only a lower bound is known.
+    auto newProcessStatistics = CompileStatistics::getProcessSnapshot();
+    ASSERT_GE(newProcessStatistics.numberOfCompilations, processStatistics.numberOfCompilations + 2);
+    ASSERT_GE(newProcessStatistics.numberOfDeduplications, processStatistics.numberOfDeduplications + 1);
+}
+
+TEST(TestCompileStatistics, CacheHit) { // NOLINT
+    auto directory = std::filesystem::temp_directory_path() / "pljit_cache_TestCompileStatistics";
+    std::filesystem::remove_all(directory);
+
+    std::string code{"PARAM a; BEGIN RETURN a * 2 END."};
+    for (uint64_t numberOfCacheHits : {0, 1}) {
+        Pljit pljit(PljitOptions{.compileCacheDirectory = directory.string(), .collectCompileStatistics = true});
+        auto func = pljit.registerFunction(code);
+        ASSERT_EQ(cantFail(func(21)), 42);
+        auto statistics = pljit.getCompileStatistics(func);
+        ASSERT_EQ(statistics->numberOfCacheHits, numberOfCacheHits);
+        // Cached functions are neither lexed nor parsed.
+        ASSERT_EQ(statistics->numberOfTokens == 0, numberOfCacheHits == 1);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace pljit
@@ -0,0 +1,178 @@
+#include "pljit/Pljit.h"
+#include "test/utils/TestUtils.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace pljit {
+
+namespace {
+
+/// Returns a function which multiplies its parameter with the factor.
+std::string getMultiplication(int64_t factor)
+{
+    return "PARAM a; CONST k = " + std::to_string(factor) + "; BEGIN RETURN a * k END.";
+}
+
+/// Returns the compiled code size of a single multiplication.
+size_t getMultiplicationSize()
+{
+    Pljit pljit;
+    auto func = pljit.registerFunction(getMultiplication(1));
+    pljit.waitUntilCompiled(func);
+    return pljit.getCompiledCodeSize();
+}
+
+} // namespace
+
+TEST(TestCompiledCodeBudget, CompiledCodeSize) { // NOLINT
+    Pljit pljit;
+    ASSERT_EQ(pljit.getCompiledCodeSize(), 0);
+    auto func = pljit.registerFunction(getMultiplication(2));
+    ASSERT_EQ(pljit.getCompiledCodeSize(), 0);
+    ASSERT_EQ(cantFail(func(21)), 42);
+    auto size = pljit.getCompiledCodeSize();
+    ASSERT_GT(size, 0);
+
+    // Larger functions occupy more memory.
+    auto largeFunc = pljit.registerFunction("PARAM a, b; VAR c; BEGIN c := a * b + a / b - (a + b); RETURN c * c END.");
+    ASSERT_EQ(cantFail(largeFunc(4, 2)), 16);
+    ASSERT_GT(pljit.getCompiledCodeSize() - size, size);
+
+    pljit.unregisterFunction(largeFunc);
+    ASSERT_EQ(pljit.getCompiledCodeSize(), size);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 0);
+}
+
+TEST(TestCompiledCodeBudget, EvictLeastRecentlyExecuted) { // NOLINT
+    // Two functions fit into the budget, even below its low-water mark.
+    auto size = getMultiplicationSize();
+    Pljit pljit(PljitOptions{.compiledCodeBudget = 2 * size + size / 2});
+
+    auto func2 = pljit.registerFunction(getMultiplication(2));
+    auto func3 = pljit.registerFunction(getMultiplication(3));
+    auto func4 = pljit.registerFunction(getMultiplication(4));
+    ASSERT_EQ(cantFail(func2(1)), 2);
+    ASSERT_EQ(cantFail(func3(1)), 3);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 0);
+
+    // The function which was executed least recently is evicted.
+    ASSERT_EQ(cantFail(func4(1)), 4);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 1);
+    ASSERT_EQ(pljit.getNumberOfRecompilations(), 0);
+    ASSERT_LE(pljit.getCompiledCodeSize(), 2 * size);
+
+    // func2 was evicted and is recompiled, which evicts func3.
+    ASSERT_EQ(cantFail(func4(2)), 8);
+    ASSERT_EQ(cantFail(func2(2)), 4);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 2);
+    ASSERT_EQ(pljit.getNumberOfRecompilations(), 1);
+    ASSERT_EQ(cantFail(func4(3)), 12);
+    ASSERT_EQ(pljit.getNumberOfRecompilations(), 1);
+    ASSERT_EQ(cantFail(func3(3)), 9);
+    ASSERT_EQ(pljit.getNumberOfRecompilations(), 2);
+    ASSERT_LE(pljit.getCompiledCodeSize(), 2 * size);
+}
+
+TEST(TestCompiledCodeBudget, EvictionByCallFreesImages) { // NOLINT
+    auto size = getMultiplicationSize();
+    Pljit pljit(PljitOptions{.compiledCodeBudget = size + size / 2});
+    auto func2 = pljit.registerFunction(getMultiplication(2));
+    auto func3 = pljit.registerFunction(getMultiplication(3));
+    ASSERT_EQ(cantFail(func2(1)), 2);
+
+    // The call which compiles func3 evicts func2. The calling thread does not
+    // pin the epoch while compiling, hence, the image of func2 is freed right
+    // away.
+    ASSERT_EQ(cantFail(func3(1)), 3);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 1);
+    ASSERT_EQ(pljit.getNumberOfRetiredObjects(), 0);
+}
+
+TEST(TestCompiledCodeBudget, EvictDownToLowWaterMark) { // NOLINT
+    // Ten functions fit into the budget, nine below its low-water mark.
+    auto size = getMultiplicationSize();
+    Pljit pljit(PljitOptions{.compiledCodeBudget = 10 * size});
+    std::vector<FunctionHandle> functions;
+    for (int64_t i = 0; i < 12; ++i) {
+        functions.push_back(pljit.registerFunction(getMultiplication(i + 2)));
+    }
+    for (int64_t i = 0; i < 10; ++i) {
+        ASSERT_EQ(cantFail(functions[i](1)), i + 2);
+    }
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 0);
+
+    // Exceeding the budget evicts the two least recently executed functions.
+    ASSERT_EQ(cantFail(functions[10](1)), 12);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 2);
+    ASSERT_EQ(pljit.getCompiledCodeSize(), 9 * size);
+
+    // The next function fits into the headroom.
+    ASSERT_EQ(cantFail(functions[11](1)), 13);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 2);
+    ASSERT_EQ(pljit.getCompiledCodeSize(), 10 * size);
+
+    // The evicted functions are the ones which were executed first.
+    ASSERT_EQ(cantFail(functions[2](1)), 4);
+    ASSERT_EQ(pljit.getNumberOfRecompilations(), 0);
+    ASSERT_EQ(cantFail(functions[0](1)), 2);
+    ASSERT_EQ(pljit.getNumberOfRecompilations(), 1);
+}
+
+TEST(TestCompiledCodeBudget, FunctionLargerThanBudget) { // NOLINT
+    Pljit pljit(PljitOptions{.compiledCodeBudget = 1});
+    auto func2 = pljit.registerFunction(getMultiplication(2));
+    auto func3 = pljit.registerFunction(getMultiplication(3));
+
+    // The function which was just compiled is never evicted by itself.
+    ASSERT_EQ(cantFail(func2(1)), 2);
+    ASSERT_EQ(cantFail(func3(1)), 3);
+    ASSERT_EQ(cantFail(func2(2)), 4);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 2);
+    ASSERT_EQ(pljit.getNumberOfRecompilations(), 1);
+}
+
+TEST(TestCompiledCodeBudget, LowMemoryModeDoesNotEvict) { // NOLINT
+    Pljit pljit(PljitOptions{.lowMemoryMode = true, .compiledCodeBudget = 1});
+    auto func2 = pljit.registerFunction(getMultiplication(2));
+    auto func3 = pljit.registerFunction(getMultiplication(3));
+    ASSERT_EQ(cantFail(func2(1)), 2);
+    ASSERT_EQ(cantFail(func3(1)), 3);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 0);
+    ASSERT_EQ(cantFail(func2(2)), 4);
+}
+
+TEST(TestCompiledCodeBudget, CompileErrorsAreNotCharged) { // NOLINT
+    test_utils::CaptureCout cout;
+    Pljit pljit(PljitOptions{.compiledCodeBudget = 1});
+    auto func = pljit.registerFunction("BEGIN RETURN x END.");
+    ASSERT_EQ(func().resultCode, ResultCode::CompileError);
+    ASSERT_EQ(pljit.getCompiledCodeSize(), 0);
+}
+
+TEST(TestCompiledCodeBudgetMultiThreaded, ConcurrentEvictions) { // NOLINT
+    // Only a few of the functions fit into the budget.
+    auto size = getMultiplicationSize();
+    Pljit pljit(PljitOptions{.compiledCodeBudget = 3 * size});
+    std::vector<FunctionHandle> functions;
+    for (int64_t i = 0; i < 16; ++i) {
+        functions.push_back(pljit.registerFunction(getMultiplication(i)));
+    }
+
+    std::vector<std::thread> threads;
+    for (int64_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&functions, t]() {
+            for (int64_t j = 0; j < 200; ++j) {
+                auto i = (j * (t + 1)) % 16;
+                ASSERT_EQ(cantFail(functions[i](j)), i * j);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_GT(pljit.getNumberOfEvictions(), 0);
+    ASSERT_GT(pljit.getNumberOfRecompilations(), 0);
+}
+
+} // namespace pljit
@@ -0,0 +1,74 @@
+#include "pljit/common/ConcurrentArena.h"
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace pljit::common {
+
+namespace {
+
+/// Counts the number of alive instances.
+struct Counted {
+    explicit Counted(size_t value, std::atomic<size_t>& alive) : value(value), alive(alive) { ++alive; }
+    ~Counted() { --alive; }
+
+    Counted(const Counted& other) = delete;
+    Counted& operator=(const Counted& other) = delete;
+
+    size_t value;
+    std::atomic<size_t>& alive;
+};
+
+} // namespace
+
+TEST(TestConcurrentArena, StableAddresses) { // NOLINT
+    ConcurrentArena<size_t> arena;
+    std::vector<size_t*> elements;
+    for (size_t i = 0; i < 10000; ++i) {
+        elements.push_back(arena.emplace(i));
+    }
+    for (size_t i = 0; i < elements.size(); ++i) {
+        ASSERT_EQ(*elements[i], i);
+    }
+
+    size_t expected = 0;
+    arena.forEach([&](size_t element) {
+        ASSERT_EQ(element, expected);
+        ++expected;
+    });
+    ASSERT_EQ(expected, elements.size());
+}
+
+TEST(TestConcurrentArena, ConcurrentEmplace) { // NOLINT
+    std::atomic<size_t> alive{0};
+    {
+        ConcurrentArena<Counted> arena;
+        const size_t numberOfThreads = 8;
+        const size_t numberOfElementsPerThread = 5000;
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < numberOfThreads; ++i) {
+            threads.emplace_back([&arena, &alive, i, numberOfElementsPerThread]() {
+                for (size_t j = 0; j < numberOfElementsPerThread; ++j) {
+                    auto* element = arena.emplace(i * numberOfElementsPerThread + j, alive);
+                    ASSERT_EQ(element->value, i * numberOfElementsPerThread + j);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::vector<bool> seen(numberOfThreads * numberOfElementsPerThread, false);
+        arena.forEach([&](const Counted& element) {
+            ASSERT_FALSE(seen[element.value]);
+            seen[element.value] = true;
+        });
+        ASSERT_EQ(std::count(seen.begin(), seen.end(), true), seen.size());
+        ASSERT_EQ(alive, seen.size());
+    }
+    // The arena destroys its elements.
+    ASSERT_EQ(alive, 0);
+}
+
+} // namespace pljit::common
@@ -0,0 +1,152 @@
+#include "pljit/Pljit.h"
+#include "test/utils/TestUtils.h"
+#include <gtest/gtest.h>
+
+namespace pljit {
+
+namespace {
+
+/// Number of nesting levels which would overflow the stack if expressions
+/// were handled recursively.
+constexpr size_t deepNesting = 100000;
+
+/// Number of terms of the long expression chains. Each term results in
+/// about five parse tree nodes, i.e., the parse trees have about a million nodes.
+constexpr size_t longChain = 200000;
+
+/// Wraps the expression into the given number of parentheses.
+std::string nestParentheses(std::string_view expression, size_t depth)
+{
+    std::string result;
+    result.reserve(expression.size() + 2 * depth);
+    result.append(depth, '(');
+    result.append(expression);
+    result.append(depth, ')');
+    return result;
+}
+
+/// Builds a chain of the given number of terms which are separated by the operator.
+std::string chain(std::string_view term, std::string_view op, size_t length)
+{
+    std::string result{term};
+    result.reserve(length * (term.size() + op.size()));
+    for (size_t i = 1; i < length; ++i) {
+        result.append(op);
+        result.append(term);
+    }
+    return result;
+}
+
+std::string makeFunction(std::string_view expression)
+{
+    std::string code{"PARAM a;\nBEGIN\nRETURN "};
+    code.append(expression);
+    code.append("\nEND.");
+    return code;
+}
+
+} // namespace
+
+TEST(TestDeepExpressions, DeepParentheses) { // NOLINT
+    Pljit pljit;
+    auto func = pljit.registerFunction(makeFunction(nestParentheses("a", deepNesting)));
+    auto result = func(42);
+    ASSERT_EQ(result.resultCode, ResultCode::Success);
+    ASSERT_EQ(result.value, 42);
+}
+
+TEST(TestDeepExpressions, ProfileDotGraph) { // NOLINT
+    // The DOT graph of a profiled function is generated without recursion.
+    // -(-(...(-a)...))
+    std::string expression;
+    for (size_t i = 0; i < deepNesting; ++i) {
+        expression.append("-(");
+    }
+    expression.append("a");
+    expression.append(deepNesting, ')');
+
+    Pljit pljit(PljitOptions{.profileExecution = true});
+    auto func = pljit.registerFunction(makeFunction(expression));
+    ASSERT_EQ(cantFail(func(42)), 42);
+    auto dotGraph = pljit.getProfileDotGraph(func);
+    ASSERT_TRUE(dotGraph.starts_with("digraph {\n"));
+    ASSERT_TRUE(dotGraph.ends_with("}\n"));
+}
+
+TEST(TestDeepExpressions, DeepNegations) { // NOLINT
+    // -(-(...(-a)...))
+    std::string expression;
+    for (size_t i = 0; i < deepNesting + 1; ++i) {
+        expression.append("-(");
+    }
+    expression.append("a");
+    expression.append(deepNesting + 1, ')');
+
+    Pljit pljit;
+    auto func = pljit.registerFunction(makeFunction(expression));
+    auto result = func(3);
+    ASSERT_EQ(result.resultCode, ResultCode::Success);
+    ASSERT_EQ(result.value, -3);
+}
+
+TEST(TestDeepExpressions, LongAdditiveChain) { // NOLINT
+    Pljit pljit;
+    auto func = pljit.registerFunction(makeFunction(chain("a", "+", longChain)));
+    auto result = func(2);
+    ASSERT_EQ(result.resultCode, ResultCode::Success);
+    ASSERT_EQ(result.value, 2 * static_cast<int64_t>(longChain));
+}
+
+TEST(TestDeepExpressions, LongMultiplicativeChain) { // NOLINT
+    Pljit pljit;
+    auto func = pljit.registerFunction(makeFunction(chain("a", "*", longChain)));
+    auto result = func(1);
+    ASSERT_EQ(result.resultCode, ResultCode::Success);
+    ASSERT_EQ(result.value, 1);
+}
+
+TEST(TestDeepExpressions, LongConstantChain) { // NOLINT
+    // The whole chain is folded into a single constant.
+    Pljit pljit;
+    auto func = pljit.registerFunction(makeFunction(chain("1", "+", longChain)));
+    auto result = func(0);
+    ASSERT_EQ(result.resultCode, ResultCode::Success);
+    ASSERT_EQ(result.value, static_cast<int64_t>(longChain));
+}
+
+TEST(TestDeepExpressions, DivisionByZeroInDeepExpression) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit;
+    auto func = pljit.registerFunction(makeFunction(nestParentheses("1 / a", deepNesting)));
+    auto result = func(0);
+    ASSERT_EQ(result.resultCode, ResultCode::RuntimeError);
+    ASSERT_EQ(diagnostics.stream.str(), "error: division by zero\n");
+}
+
+TEST(TestDeepExpressions, MissingClosingParenthesis) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    auto expression = nestParentheses("a", deepNesting);
+    expression.pop_back();
+
+    Pljit pljit;
+    auto func = pljit.registerFunction(makeFunction(expression));
+    auto result = func(1);
+    ASSERT_EQ(result.resultCode, ResultCode::CompileError);
+    auto output = diagnostics.stream.str();
+    ASSERT_NE(output.find("error: expected ')'"), std::string::npos);
+    ASSERT_NE(output.find("note: to match this '('"), std::string::npos);
+}
+
+TEST(TestDeepExpressions, MissingOperandInDeepExpression) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit;
+    auto func = pljit.registerFunction(makeFunction(nestParentheses("a +", deepNesting)));
+    auto result = func(1);
+    ASSERT_EQ(result.resultCode, ResultCode::CompileError);
+    ASSERT_NE(diagnostics.stream.str().find("error: expected primary-expression"), std::string::npos);
+}
+
+} // namespace pljit
@@ -0,0 +1,193 @@
+#include "pljit/Pljit.h"
+#include "pljit/common/AsyncDiagnosticsSink.h"
+#include "pljit/common/Diagnostics.h"
+#include "test/utils/TestUtils.h"
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace pljit::common {
+
+namespace {
+
+/// A sink which blocks until it is released.
+class BlockingDiagnosticsSink : public RecordingDiagnosticsSink {
+    public:
+    void report(const Diagnostic& diagnostic) override {
+        std::unique_lock lck(mutex);
+        releasedCondition.wait(lck, [this]() { return released; });
+        lck.unlock();
+        RecordingDiagnosticsSink::report(diagnostic);
+    }
+
+    void release() {
+        {
+            std::unique_lock lck(mutex);
+            released = true;
+        }
+        releasedCondition.notify_all();
+    }
+
+    private:
+    std::mutex mutex;
+    std::condition_variable releasedCondition;
+    bool released{false};
+};
+
+} // namespace
+
+TEST(TestDiagnostics, Format) { // NOLINT
+    Diagnostic error{Diagnostic::Kind::CompileError, "use of undeclared identifier", 1, 14, 1, "BEGIN RETURN x END."};
+    ASSERT_EQ(error.format(), "1:14: error: use of undeclared identifier\n"
+                              "BEGIN RETURN x END.\n"
+                              "             ^\n");
+
+    Diagnostic note{Diagnostic::Kind::Note, "declared here", 2, 3, 4, "  abcd"};
+    ASSERT_EQ(note.format(), "2:3: note: declared here\n"
+                             "  abcd\n"
+                             "  ^~~~\n");
+
+    Diagnostic runtimeError{Diagnostic::Kind::RuntimeError, "division by zero"};
+    ASSERT_EQ(runtimeError.format(), "error: division by zero\n");
+}
+
+TEST(TestDiagnostics, StructuredCompileErrors) { // NOLINT
+    auto sink = std::make_shared<RecordingDiagnosticsSink>();
+    Pljit pljit(PljitOptions{.diagnosticsSink = sink});
+    auto func = pljit.registerFunction("PARAM a;\n"
+                                       "BEGIN RETURN b END.");
+    ASSERT_EQ(func(1).resultCode, ResultCode::CompileError);
+
+    auto diagnostics = sink->getDiagnostics();
+    ASSERT_EQ(diagnostics.size(), 1);
+    ASSERT_EQ(diagnostics[0].kind, Diagnostic::Kind::CompileError);
+    ASSERT_EQ(diagnostics[0].message, "use of undeclared identifier");
+    ASSERT_EQ(diagnostics[0].line, 2);
+    ASSERT_EQ(diagnostics[0].column, 14);
+    ASSERT_EQ(diagnostics[0].length, 1);
+    ASSERT_EQ(diagnostics[0].sourceLine, "BEGIN RETURN b END.");
+}
+
+TEST(TestDiagnostics, StructuredRuntimeErrors) { // NOLINT
+    test_utils::CaptureCout cout;
+
+    auto sink = std::make_shared<RecordingDiagnosticsSink>();
+    Pljit pljit(PljitOptions{.diagnosticsSink = sink});
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN 1 / a END.");
+    ASSERT_EQ(func(0).resultCode, ResultCode::RuntimeError);
+    ASSERT_EQ(func().resultCode, ResultCode::InvalidFunctionCall);
+    pljit.unregisterFunction(func);
+    ASSERT_EQ(func(1).resultCode, ResultCode::InvalidFunctionCall);
+
+    auto diagnostics = sink->getDiagnostics();
+    ASSERT_EQ(diagnostics.size(), 3);
+    ASSERT_EQ(diagnostics[0].kind, Diagnostic::Kind::RuntimeError);
+    ASSERT_EQ(diagnostics[0].message, "division by zero");
+    ASSERT_EQ(diagnostics[0].line, 0);
+    ASSERT_EQ(diagnostics[1].kind, Diagnostic::Kind::InvalidCall);
+    ASSERT_EQ(diagnostics[1].message, "invalid number of parameters provided, expected 1 but 0 were provided");
+    ASSERT_EQ(diagnostics[2].kind, Diagnostic::Kind::InvalidCall);
+    ASSERT_EQ(diagnostics[2].message, "the function was unregistered");
+
+    // Nothing is printed.
+    ASSERT_TRUE(cout.stream.str().empty());
+}
+
+TEST(TestDiagnostics, NullSinkIsSilent) { // NOLINT
+    test_utils::CaptureCout cout;
+
+    Pljit pljit(PljitOptions{.diagnosticsSink = std::make_shared<NullDiagnosticsSink>()});
+    ASSERT_EQ(pljit.registerFunction("BEGIN RETURN x END.")().resultCode, ResultCode::CompileError);
+    ASSERT_EQ(pljit.registerFunction("BEGIN RETURN 1 / 0 END.")().resultCode, ResultCode::RuntimeError);
+    ASSERT_TRUE(pljit.registerModuleFile("/nonexistent/module.pl0").empty());
+    ASSERT_TRUE(cout.stream.str().empty());
+}
+
+TEST(TestDiagnostics, DiagnosticsAreDroppedByDefault) { // NOLINT
+    test_utils::CaptureCout cout;
+
+    Pljit pljit;
+    ASSERT_EQ(pljit.registerFunction("BEGIN RETURN x END.")().resultCode, ResultCode::CompileError);
+    ASSERT_EQ(pljit.registerFunction("BEGIN RETURN 1 / 0 END.")().resultCode, ResultCode::RuntimeError);
+    ASSERT_TRUE(cout.stream.str().empty());
+
+    // A sink scope on the calling thread receives them.
+    RecordingDiagnosticsSink sink;
+    DiagnosticsSinkScope scope(&sink);
+    ASSERT_EQ(pljit.registerFunction("BEGIN RETURN 1 / 0 END.")().resultCode, ResultCode::RuntimeError);
+    ASSERT_EQ(sink.getDiagnostics().size(), 1);
+    ASSERT_TRUE(cout.stream.str().empty());
+}
+
+TEST(TestDiagnostics, SinkScope) { // NOLINT
+    RecordingDiagnosticsSink outerSink;
+    RecordingDiagnosticsSink innerSink;
+    {
+        DiagnosticsSinkScope outerScope(&outerSink);
+        {
+            DiagnosticsSinkScope innerScope(&innerSink);
+            getDiagnosticsSink().report({Diagnostic::Kind::RuntimeError, "inner"});
+            // A nullptr keeps the current sink.
+            DiagnosticsSinkScope emptyScope(nullptr);
+            getDiagnosticsSink().report({Diagnostic::Kind::RuntimeError, "inner"});
+        }
+        getDiagnosticsSink().report({Diagnostic::Kind::RuntimeError, "outer"});
+    }
+    ASSERT_EQ(innerSink.getDiagnostics().size(), 2);
+    ASSERT_EQ(outerSink.getDiagnostics().size(), 1);
+    ASSERT_EQ(outerSink.getDiagnostics()[0].message, "outer");
+}
+
+TEST(TestAsyncDiagnosticsSink, Forward) { // NOLINT
+    auto target = std::make_shared<RecordingDiagnosticsSink>();
+    AsyncDiagnosticsSink sink(target);
+    for (size_t i = 0; i < 100; ++i) {
+        sink.report({Diagnostic::Kind::RuntimeError, std::to_string(i)});
+    }
+    sink.flush();
+
+    auto diagnostics = target->getDiagnostics();
+    ASSERT_EQ(diagnostics.size(), 100);
+    for (size_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(diagnostics[i].message, std::to_string(i));
+    }
+    ASSERT_EQ(sink.getNumberOfDroppedDiagnostics(), 0);
+}
+
+TEST(TestAsyncDiagnosticsSink, DropWhenFull) { // NOLINT
+    auto target = std::make_shared<BlockingDiagnosticsSink>();
+    {
+        AsyncDiagnosticsSink sink(target, 4);
+        // The background thread takes at most one diagnostic before blocking.
+        for (size_t i = 0; i < 10; ++i) {
+            sink.report({Diagnostic::Kind::RuntimeError, std::to_string(i)});
+        }
+        ASSERT_GE(sink.getNumberOfDroppedDiagnostics(), 5);
+        target->release();
+        sink.flush();
+        ASSERT_EQ(target->getDiagnostics().size() + sink.getNumberOfDroppedDiagnostics(), 10);
+    }
+}
+
+TEST(TestAsyncDiagnosticsSink, ConcurrentRuntimeErrors) { // NOLINT
+    auto target = std::make_shared<RecordingDiagnosticsSink>();
+    auto sink = std::make_shared<AsyncDiagnosticsSink>(target, 100000);
+    Pljit pljit(PljitOptions{.diagnosticsSink = sink});
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN 1 / a END.");
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([func]() {
+            for (size_t i = 0; i < 100; ++i) {
+                ASSERT_EQ(func(0).resultCode, ResultCode::RuntimeError);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    sink->flush();
+    ASSERT_EQ(target->getDiagnostics().size(), 400);
+}
+
+} // namespace pljit::common
@@ -0,0 +1,134 @@
+#include "pljit/common/EpochManager.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace pljit::common {
+
+namespace {
+
+/// Counts the number of alive instances.
+struct Counted {
+    explicit Counted(std::atomic<size_t>& alive) : alive(alive) { ++alive; }
+    ~Counted() { --alive; }
+
+    Counted(const Counted& other) = delete;
+    Counted& operator=(const Counted& other) = delete;
+
+    std::atomic<size_t>& alive;
+};
+
+} // namespace
+
+TEST(TestEpochManager, ReclaimWithoutReaders) { // NOLINT
+    std::atomic<size_t> alive{0};
+    EpochManager epochManager;
+
+    epochManager.retire(std::make_unique<Counted>(alive));
+    epochManager.retire(std::make_unique<Counted>(alive));
+    ASSERT_EQ(alive, 2);
+    ASSERT_EQ(epochManager.getNumberOfRetiredObjects(), 2);
+
+    epochManager.reclaim();
+    ASSERT_EQ(alive, 0);
+    ASSERT_EQ(epochManager.getNumberOfRetiredObjects(), 0);
+}
+
+TEST(TestEpochManager, PinnedReaderDelaysReclamation) { // NOLINT
+    std::atomic<size_t> alive{0};
+    EpochManager epochManager;
+
+    {
+        auto guard = epochManager.pin();
+        epochManager.retire(std::make_unique<Counted>(alive));
+
+        // The reader might still reference the object.
+        epochManager.reclaim();
+        epochManager.reclaim();
+        ASSERT_EQ(alive, 1);
+    }
+
+    epochManager.reclaim();
+    ASSERT_EQ(alive, 0);
+}
+
+TEST(TestEpochManager, ReaderOnOtherThread) { // NOLINT
+    std::atomic<size_t> alive{0};
+    EpochManager epochManager;
+
+    std::atomic<bool> pinned{false};
+    std::atomic<bool> release{false};
+    std::thread reader([&]() {
+        auto guard = epochManager.pin();
+        pinned = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned) {
+        std::this_thread::yield();
+    }
+
+    epochManager.retire(std::make_unique<Counted>(alive));
+    epochManager.reclaim();
+    ASSERT_EQ(alive, 1);
+
+    release = true;
+    reader.join();
+    epochManager.reclaim();
+    ASSERT_EQ(alive, 0);
+}
+
+TEST(TestEpochManager, DestructorFreesRetiredObjects) { // NOLINT
+    std::atomic<size_t> alive{0};
+    {
+        EpochManager epochManager;
+        {
+            auto guard = epochManager.pin();
+            epochManager.retire(std::make_unique<Counted>(alive));
+            epochManager.reclaim();
+            ASSERT_EQ(alive, 1);
+        }
+    }
+    ASSERT_EQ(alive, 0);
+}
+
+TEST(TestEpochManager, ConcurrentReadersAndWriter) { // NOLINT
+    EpochManager epochManager;
+
+    // The readers dereference the current object, while the writer replaces it
+    // and retires the old one. ASan reports any use after free.
+    std::atomic<const size_t*> current{new size_t{0}};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            size_t lastValue = 0;
+            while (!stop) {
+                auto guard = epochManager.pin();
+                auto value = *current.load(std::memory_order_acquire);
+                ASSERT_GE(value, lastValue);
+                lastValue = value;
+            }
+        });
+    }
+
+    for (size_t i = 1; i <= 2000; ++i) {
+        std::unique_ptr<const size_t> old(current.exchange(new size_t{i}));
+        epochManager.retire(std::move(old));
+        epochManager.reclaim();
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    epochManager.reclaim();
+    ASSERT_EQ(epochManager.getNumberOfRetiredObjects(), 0);
+    delete current.load();
+}
+
+} // namespace pljit::common
@@ -0,0 +1,199 @@
+#include "pljit/Pljit.h"
+#include "pljit/exec/ExecutionProfile.h"
+#include "test/utils/TestUtils.h"
+#include <gtest/gtest.h>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+namespace pljit {
+
+namespace {
+
+/// Returns the profile of the node with the given type and source range.
+std::optional<exec::ExecutionProfile::NodeProfile> findNode(const exec::ExecutionProfile& profile,
+                                                            std::string_view sourceCode,
+                                                            ast::ASTNode::Type type,
+                                                            std::string_view range)
+{
+    for (const auto& nodeProfile : profile.getNodeProfiles()) {
+        if (nodeProfile.type == type && sourceCode.substr(nodeProfile.offset, nodeProfile.length) == range) {
+            return nodeProfile;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+TEST(TestExecutionProfile, Disabled) { // NOLINT
+    Pljit pljit;
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_EQ(cantFail(func()), 1);
+    ASSERT_EQ(pljit.getExecutionProfile(func), nullptr);
+    ASSERT_EQ(pljit.getAnnotatedSource(func), "");
+    ASSERT_EQ(pljit.getProfileDotGraph(func), "");
+}
+
+TEST(TestExecutionProfile, CountExecutions) { // NOLINT
+    std::string code{"PARAM a, b;\n"
+                     "VAR c;\n"
+                     "BEGIN\n"
+                     "c := a * b + 1;\n"
+                     "RETURN -c / 2\n"
+                     "END."};
+    Pljit pljit(PljitOptions{.profileExecution = true});
+    auto func = pljit.registerFunction(code);
+    ASSERT_EQ(pljit.getExecutionProfile(func), nullptr);
+    for (int64_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(cantFail(func(i, 2)), -(i * 2 + 1) / 2);
+    }
+
+    auto profile = pljit.getExecutionProfile(func);
+    ASSERT_NE(profile, nullptr);
+    using Type = ast::ASTNode::Type;
+    for (auto [type, range] : {std::pair{Type::AssignmentStatement, "c := a * b + 1"},
+                               std::pair{Type::ReturnStatement, "RETURN -c / 2"},
+                               std::pair{Type::BinaryOp, "a * b + 1"},
+                               std::pair{Type::BinaryOp, "a * b"},
+                               std::pair{Type::BinaryOp, "-c / 2"},
+                               std::pair{Type::UnaryOp, "-c"},
+                               std::pair{Type::Identifier, "a"},
+                               std::pair{Type::ConstantLiteral, "2"}}) {
+        auto nodeProfile = findNode(*profile, code, type, range);
+        ASSERT_TRUE(nodeProfile) << range;
+        ASSERT_EQ(nodeProfile->executions, 100) << range;
+    }
+
+    // The ticks of the statements include the ticks of their expressions.
+    auto assignment = *findNode(*profile, code, Type::AssignmentStatement, "c := a * b + 1");
+    auto returnStatement = *findNode(*profile, code, Type::ReturnStatement, "RETURN -c / 2");
+    auto division = *findNode(*profile, code, Type::BinaryOp, "-c / 2");
+    auto negation = *findNode(*profile, code, Type::UnaryOp, "-c");
+    ASSERT_EQ(profile->getTotalTicks(), assignment.ticks + returnStatement.ticks);
+    ASSERT_GE(returnStatement.ticks, division.ticks);
+    ASSERT_GE(division.ticks, negation.ticks);
+}
+
+TEST(TestExecutionProfile, ConstantsKeepTheirSourceRange) { // NOLINT
+    std::string code{"PARAM a; BEGIN RETURN a * (2 + 3) END."};
+    Pljit pljit(PljitOptions{.profileExecution = true});
+    auto func = pljit.registerFunction(code);
+    for (int64_t i = 0; i < 10; ++i) {
+        ASSERT_EQ(cantFail(func(i)), i * 5);
+    }
+    auto profile = pljit.getExecutionProfile(func);
+    ASSERT_NE(profile, nullptr);
+    // The folded operation is executed as a constant literal.
+    auto folded = findNode(*profile, code, ast::ASTNode::Type::BinaryOp, "2 + 3");
+    ASSERT_TRUE(folded);
+    ASSERT_EQ(folded->executions, 10);
+    ASSERT_EQ(findNode(*profile, code, ast::ASTNode::Type::ConstantLiteral, "2")->executions, 0);
+}
+
+TEST(TestExecutionProfile, RuntimeError) { // NOLINT
+    test_utils::CaptureCout cout;
+    std::string code{"PARAM a; VAR b; BEGIN b := 1 / a; RETURN b END."};
+    Pljit pljit(PljitOptions{.profileExecution = true});
+    auto func = pljit.registerFunction(code);
+    ASSERT_EQ(func(0).resultCode, ResultCode::RuntimeError);
+    ASSERT_EQ(cantFail(func(1)), 1);
+
+    auto profile = pljit.getExecutionProfile(func);
+    ASSERT_EQ(findNode(*profile, code, ast::ASTNode::Type::AssignmentStatement, "b := 1 / a")->executions, 2);
+    ASSERT_EQ(findNode(*profile, code, ast::ASTNode::Type::BinaryOp, "1 / a")->executions, 1);
+    ASSERT_EQ(findNode(*profile, code, ast::ASTNode::Type::ReturnStatement, "RETURN b")->executions, 1);
+}
+
+TEST(TestExecutionProfile, AnnotatedSource) { // NOLINT
+    std::string code{"PARAM a;\n"
+                     "BEGIN\n"
+                     "RETURN a * (a + 1)\n"
+                     "END."};
+    Pljit pljit(PljitOptions{.profileExecution = true});
+    auto func = pljit.registerFunction(code);
+    for (int64_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(cantFail(func(i)), i * (i + 1));
+    }
+
+    // The percentages depend on the measured ticks, hence, they are removed.
+    auto annotatedSource = pljit.getAnnotatedSource(func);
+    std::string lines[7];
+    std::istringstream in(annotatedSource);
+    for (auto& line : lines) {
+        ASSERT_TRUE(std::getline(in, line));
+    }
+    ASSERT_FALSE(in >> lines[0]);
+    ASSERT_EQ(lines[0], "  executions   ticks |");
+    ASSERT_EQ(lines[1], "                     | PARAM a;");
+    ASSERT_EQ(lines[2], "                     | BEGIN");
+    ASSERT_EQ(lines[3].substr(0, 13), "         100 ");
+    ASSERT_EQ(lines[3].substr(19), "% | RETURN a * (a + 1)");
+    ASSERT_EQ(lines[4].substr(0, 42), "                     |        ^~~~~~~~~~~ ");
+    ASSERT_TRUE(lines[4].ends_with("% (100x)"));
+    ASSERT_EQ(lines[5].substr(0, 41), "                     |             ^~~~~ ");
+    ASSERT_TRUE(lines[5].ends_with("% (100x)"));
+    ASSERT_EQ(lines[6], "                     | END.");
+}
+
+TEST(TestExecutionProfile, DotGraph) { // NOLINT
+    Pljit pljit(PljitOptions{.profileExecution = true});
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN -a END.");
+    ASSERT_EQ(cantFail(func(1)), -1);
+    auto dotGraph = pljit.getProfileDotGraph(func);
+    ASSERT_TRUE(dotGraph.starts_with("digraph {\n\t0 [label=\"Function\"];\n")) << dotGraph;
+    ASSERT_NE(dotGraph.find("[label=\"-\\n1x "), std::string::npos) << dotGraph;
+    ASSERT_NE(dotGraph.find("style=filled, fillcolor=\"0.000 "), std::string::npos) << dotGraph;
+
+    // The source code and the symbol table are released in low-memory mode.
+    Pljit lowMemoryPljit(PljitOptions{.lowMemoryMode = true, .profileExecution = true});
+    auto lowMemoryFunc = lowMemoryPljit.registerFunction("PARAM a; BEGIN RETURN -a END.");
+    ASSERT_EQ(cantFail(lowMemoryFunc(1)), -1);
+    ASSERT_NE(lowMemoryPljit.getExecutionProfile(lowMemoryFunc), nullptr);
+    ASSERT_EQ(lowMemoryPljit.getAnnotatedSource(lowMemoryFunc), "");
+    ASSERT_EQ(lowMemoryPljit.getProfileDotGraph(lowMemoryFunc), "");
+}
+
+TEST(TestExecutionProfile, ProfiledFunctionsAreNotDeduplicated) { // NOLINT
+    std::string code{"PARAM a; BEGIN RETURN a + 1 END."};
+    Pljit pljit(PljitOptions{.deduplicateFunctions = true, .profileExecution = true});
+    auto first = pljit.registerFunction(code);
+    auto second = pljit.registerFunction(code);
+    ASSERT_EQ(cantFail(first(1)), 2);
+    ASSERT_EQ(cantFail(second(1)), 2);
+    ASSERT_EQ(cantFail(second(2)), 3);
+    ASSERT_NE(pljit.getExecutionProfile(first), pljit.getExecutionProfile(second));
+    ASSERT_EQ(findNode(*pljit.getExecutionProfile(second), code, ast::ASTNode::Type::BinaryOp, "a + 1")->executions, 2);
+}
+
+TEST(TestExecutionProfile, Replace) { // NOLINT
+    Pljit pljit(PljitOptions{.profileExecution = true});
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_EQ(cantFail(func()), 1);
+    std::string code{"BEGIN RETURN 2 * 3 END."};
+    ASSERT_TRUE(pljit.replaceFunction(func, code));
+    ASSERT_EQ(cantFail(func()), 6);
+    auto profile = pljit.getExecutionProfile(func);
+    ASSERT_EQ(findNode(*profile, code, ast::ASTNode::Type::ReturnStatement, "RETURN 2 * 3")->executions, 1);
+}
+
+TEST(TestExecutionProfile, ConcurrentExecutions) { // NOLINT
+    std::string code{"PARAM a; BEGIN RETURN a * a END."};
+    Pljit pljit(PljitOptions{.profileExecution = true});
+    auto func = pljit.registerFunction(code);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int64_t j = 0; j < 1000; ++j) {
+                ASSERT_EQ(cantFail(func(j)), j * j);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto profile = pljit.getExecutionProfile(func);
+    ASSERT_EQ(findNode(*profile, code, ast::ASTNode::Type::BinaryOp, "a * a")->executions, 4000);
+}
+
+} // namespace pljit
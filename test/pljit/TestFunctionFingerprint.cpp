@@ -0,0 +1,110 @@
+#include "pljit/ast/AST.h"
+#include "pljit/exec/ExecutionImage.h"
+#include "pljit/exec/ExecutionImageCache.h"
+#include "pljit/exec/FunctionFingerprint.h"
+#include "test/utils/TestUtils.h"
+#include <gtest/gtest.h>
+
+namespace pljit::exec {
+
+namespace {
+
+using test_utils::ASTEnvironment;
+using test_utils::Optimization;
+
+FunctionFingerprint computeFingerprint(std::string_view code)
+{
+    ASTEnvironment environment(code, Optimization::NoOptimization);
+    return FunctionFingerprint(*environment.ast, environment.symbolTable);
+}
+
+std::shared_ptr<const ExecutionImage> compileImage(std::string_view code)
+{
+    ASTEnvironment environment(code, Optimization::NoOptimization);
+    return std::make_shared<ExecutionImage>(std::move(environment.ast), environment.symbolTable);
+}
+
+} // namespace
+
+TEST(TestFunctionFingerprint, Encoding) { // NOLINT
+    auto fingerprint = computeFingerprint("PARAM a; VAR b; CONST c = 7;\n"
+                                          "BEGIN b := -a * c; RETURN b END.");
+    using Opcode = FunctionFingerprint::Opcode;
+    std::vector<int64_t> expectedEncoding{
+        1, 1, 1, 7, // 1 parameter, 1 variable, 1 constant with value 7
+        static_cast<int64_t>(Opcode::Parameter), 0,
+        static_cast<int64_t>(Opcode::MinusSign),
+        static_cast<int64_t>(Opcode::Constant), 0,
+        static_cast<int64_t>(Opcode::Mul),
+        static_cast<int64_t>(Opcode::Assignment), static_cast<int64_t>(Opcode::Variable), 0,
+        static_cast<int64_t>(Opcode::Variable), 0,
+        static_cast<int64_t>(Opcode::Return)};
+    ASSERT_EQ(fingerprint.getEncoding(), expectedEncoding);
+}
+
+TEST(TestFunctionFingerprint, IgnoresWhitespaceAndNames) { // NOLINT
+    auto fingerprint = computeFingerprint("PARAM width, height;\n"
+                                          "BEGIN\n"
+                                          "    RETURN width * height\n"
+                                          "END.");
+    auto renamed = computeFingerprint("PARAM a,b; BEGIN RETURN a*b END.");
+    ASSERT_EQ(fingerprint, renamed);
+    ASSERT_EQ(fingerprint.getHash(), renamed.getHash());
+}
+
+TEST(TestFunctionFingerprint, DistinguishesSemantics) { // NOLINT
+    auto fingerprint = computeFingerprint("PARAM a, b; BEGIN RETURN a - b END.");
+    // Swapped operands
+    ASSERT_FALSE(fingerprint == computeFingerprint("PARAM a, b; BEGIN RETURN b - a END."));
+    // Different operation
+    ASSERT_FALSE(fingerprint == computeFingerprint("PARAM a, b; BEGIN RETURN a + b END."));
+    // Different number of parameters
+    ASSERT_FALSE(fingerprint == computeFingerprint("PARAM a, b, c; BEGIN RETURN a - b END."));
+    // Different constant values
+    ASSERT_FALSE(computeFingerprint("CONST k = 1; BEGIN RETURN k END.") ==
+                 computeFingerprint("CONST k = 2; BEGIN RETURN k END."));
+    // Assignment to a parameter instead of a variable
+    ASSERT_FALSE(computeFingerprint("PARAM a; VAR b; BEGIN a := 1; RETURN 1 END.") ==
+                 computeFingerprint("PARAM a; VAR b; BEGIN b := 1; RETURN 1 END."));
+    // Literal instead of a constant
+    ASSERT_FALSE(computeFingerprint("CONST k = 1; BEGIN RETURN k END.") ==
+                 computeFingerprint("CONST k = 1; BEGIN RETURN 1 END."));
+}
+
+TEST(TestFunctionFingerprint, DeepExpression) { // NOLINT
+    // -(-(...(-1)...))
+    std::string code{"BEGIN RETURN "};
+    for (size_t i = 0; i < 100000; ++i) {
+        code.append("-(");
+    }
+    code.append("1");
+    code.append(100000, ')');
+    code.append(" END.");
+    auto fingerprint = computeFingerprint(code);
+    ASSERT_EQ(fingerprint.getEncoding().size(), 3 + 2 + 100000 + 1);
+}
+
+TEST(TestExecutionImageCache, SharesImages) { // NOLINT
+    ExecutionImageCache cache;
+    auto fingerprint = computeFingerprint("PARAM a; BEGIN RETURN a END.");
+    ASSERT_EQ(cache.lookup(fingerprint), nullptr);
+
+    auto image = cache.insert(fingerprint, compileImage("PARAM a; BEGIN RETURN a END."));
+    ASSERT_EQ(cache.lookup(computeFingerprint("PARAM x; BEGIN RETURN x END.")), image);
+    ASSERT_EQ(cache.size(), 1);
+
+    // A concurrently compiled image for an equal fingerprint is dropped.
+    auto otherImage = cache.insert(fingerprint, compileImage("PARAM a; BEGIN RETURN a END."));
+    ASSERT_EQ(otherImage, image);
+
+    // Images of other functions are not shared.
+    ASSERT_EQ(cache.lookup(computeFingerprint("PARAM a; BEGIN RETURN -a END.")), nullptr);
+
+    // The cache does not keep the images alive.
+    image.reset();
+    otherImage.reset();
+    ASSERT_EQ(cache.lookup(fingerprint), nullptr);
+    ASSERT_EQ(cache.size(), 0);
+}
+
+} // namespace pljit::exec
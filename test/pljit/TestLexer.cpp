@@ -14,32 +14,39 @@ namespace {
 
 using ExpectedTokens = std::vector<Token>;
 
+/// Both, the synchronous and the pipelined mode of the lexer are tested.
+constexpr bool lexerModes[] = {false, true};
+
 void executeLexerTest(const common::SourceCodeManager& sourceCodeManager,
                       const ExpectedTokens& expectedTokens) {
-    Lexer lexer(sourceCodeManager);
+    for (bool pipelined : lexerModes) {
+        Lexer lexer(sourceCodeManager, pipelined);
 
-    size_t expectedIdx = 0;
-    for (; lexer.hasNext() && expectedIdx < expectedTokens.size(); ++expectedIdx) {
-        auto nextToken = lexer.next();
-        ASSERT_EQ(nextToken, expectedTokens[expectedIdx]);
-    }
+        size_t expectedIdx = 0;
+        for (; lexer.hasNext() && expectedIdx < expectedTokens.size(); ++expectedIdx) {
+            auto nextToken = lexer.next();
+            ASSERT_EQ(nextToken, expectedTokens[expectedIdx]);
+        }
 
-    ASSERT_EQ(expectedIdx, expectedTokens.size());
-    ASSERT_FALSE(lexer.hasNext());
+        ASSERT_EQ(expectedIdx, expectedTokens.size());
+        ASSERT_FALSE(lexer.hasNext());
+    }
 }
 
 void executeLexerErrorTest(const common::SourceCodeManager& sourceCodeManager,
                            std::string_view expectedErrorMessage) {
-    test_utils::CaptureCout cout;
-    Lexer lexer(sourceCodeManager);
+    for (bool pipelined : lexerModes) {
+        test_utils::CaptureDiagnostics diagnostics;
+        Lexer lexer(sourceCodeManager, pipelined);
 
-    ASSERT_EQ(lexer.peek().getTokenType(), Token::Type::LexerError);
+        ASSERT_EQ(lexer.peek().getTokenType(), Token::Type::LexerError);
 
-    auto errorToken = lexer.next();
+        auto errorToken = lexer.next();
 
-    ASSERT_EQ(errorToken.getTokenType(), Token::Type::LexerError);
-    ASSERT_TRUE(lexer.hasNext());
-    ASSERT_EQ(cout.stream.str(), expectedErrorMessage);
+        ASSERT_EQ(errorToken.getTokenType(), Token::Type::LexerError);
+        ASSERT_TRUE(lexer.hasNext());
+        ASSERT_EQ(diagnostics.stream.str(), expectedErrorMessage);
+    }
 }
 
 } // namespace
@@ -736,6 +743,68 @@ TEST(TestLexer, Peek) { // NOLINT
     ASSERT_FALSE(lexer.hasNext());
 }
 
+TEST(TestLexer, PipelinedManyTokens) { // NOLINT
+    // More tokens than the ring buffer of the pipelined lexer can hold.
+    std::string code;
+    for (size_t i = 0; i < 100000; ++i) {
+        code.append("abc := 12 * (x - 3);\n");
+    }
+    common::SourceCodeManager sourceCodeManager(std::move(code));
+
+    Lexer synchronousLexer(sourceCodeManager);
+    Lexer pipelinedLexer(sourceCodeManager, true);
+    size_t numberOfTokens = 0;
+    while (synchronousLexer.hasNext()) {
+        ASSERT_TRUE(pipelinedLexer.hasNext());
+        ASSERT_EQ(pipelinedLexer.peek(), synchronousLexer.peek());
+        ASSERT_EQ(pipelinedLexer.next(), synchronousLexer.next());
+        ++numberOfTokens;
+    }
+    ASSERT_FALSE(pipelinedLexer.hasNext());
+    ASSERT_EQ(numberOfTokens, 1000000);
+}
+
+TEST(TestLexer, PipelinedDestroyedEarly) { // NOLINT
+    // The producer must stop even if the ring buffer is full.
+    std::string code;
+    for (size_t i = 0; i < 100000; ++i) {
+        code.append("a ");
+    }
+    common::SourceCodeManager sourceCodeManager(std::move(code));
+
+    Lexer lexer(sourceCodeManager, true);
+    ASSERT_EQ(lexer.next().getTokenType(), Token::Type::Identifier);
+}
+
+TEST(TestLexer, PipelinedSkipTo) { // NOLINT
+    std::string code{"a b c d"};
+    common::SourceCodeManager sourceCodeManager(std::move(code));
+
+    Lexer lexer(sourceCodeManager, true);
+    ASSERT_EQ(static_cast<std::string_view>(lexer.peek().getReference()), "a");
+    lexer.skipTo(sourceCodeManager.getCodeBegin() + 4);
+    ASSERT_EQ(static_cast<std::string_view>(lexer.next().getReference()), "c");
+    ASSERT_EQ(static_cast<std::string_view>(lexer.next().getReference()), "d");
+    ASSERT_FALSE(lexer.hasNext());
+}
+
+TEST(TestLexerErrors, PipelinedErrorAfterTokens) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    std::string code{"a b ? c"};
+    common::SourceCodeManager sourceCodeManager(std::move(code));
+
+    Lexer lexer(sourceCodeManager, true);
+    lexer.next();
+    lexer.next();
+    // The error is only reported when the erroneous token is consumed.
+    ASSERT_TRUE(diagnostics.stream.str().empty());
+    ASSERT_EQ(lexer.next().getTokenType(), Token::Type::LexerError);
+    ASSERT_EQ(diagnostics.stream.str(), "1:5: error: illegal character\n"
+                                        "a b ? c\n"
+                                        "    ^\n");
+}
+
 TEST(TestLexerErrors, IllegalMulticharacterOperator) { // NOLINT
     std::string code{":+="};
     common::SourceCodeManager sourceCodeManager(std::move(code));
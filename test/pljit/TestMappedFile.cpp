@@ -0,0 +1,143 @@
+#include "pljit/Pljit.h"
+#include "pljit/common/MappedFile.h"
+#include "test/utils/TestUtils.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace pljit::common {
+
+namespace {
+
+/// A temporary file which is removed at the end of the test.
+class TestMappedFile : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+            ("pljit_mapped_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    void writeFile(std::string_view contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    std::filesystem::path path;
+};
+
+} // namespace
+
+TEST_F(TestMappedFile, Open) { // NOLINT
+    writeFile("BEGIN RETURN 1 END.");
+    auto file = MappedFile::open(path.string());
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(file->getContents(), "BEGIN RETURN 1 END.");
+
+    // Empty files are not mapped, but can be opened.
+    writeFile("");
+    file = MappedFile::open(path.string());
+    ASSERT_NE(file, nullptr);
+    ASSERT_TRUE(file->getContents().empty());
+}
+
+TEST_F(TestMappedFile, OpenInvalidFiles) { // NOLINT
+    ASSERT_EQ(MappedFile::open(path.string()), nullptr);
+    ASSERT_EQ(MappedFile::open(std::filesystem::temp_directory_path().string()), nullptr);
+}
+
+TEST_F(TestMappedFile, RegisterModuleFile) { // NOLINT
+    test_utils::CaptureCout cout;
+
+    writeFile("PARAM a; BEGIN RETURN a * 2 END.\n"
+              "BEGIN RETURN x END.\n"
+              "PARAM a, b; BEGIN RETURN a + b END.\n");
+    Pljit pljit;
+    auto moduleFunctions = pljit.registerModuleFile(path.string());
+    ASSERT_EQ(moduleFunctions.size(), 3);
+    ASSERT_EQ(cantFail(moduleFunctions[0].handle(21)), 42);
+    ASSERT_FALSE(moduleFunctions[1].compiled);
+    ASSERT_EQ(moduleFunctions[1].diagnostics, "1:14: error: use of undeclared identifier\n"
+                                              "BEGIN RETURN x END.\n"
+                                              "             ^\n");
+    ASSERT_EQ(cantFail(moduleFunctions[2].handle(40, 2)), 42);
+}
+
+TEST_F(TestMappedFile, IsModified) { // NOLINT
+    writeFile("BEGIN RETURN 1 END.");
+    auto file = MappedFile::open(path.string());
+    ASSERT_NE(file, nullptr);
+    ASSERT_FALSE(file->isModified());
+
+    // Replacing the file by renaming keeps the mapped file intact.
+    auto newPath = path;
+    newPath += ".new";
+    std::ofstream(newPath) << "BEGIN RETURN 2 END.";
+    std::filesystem::rename(newPath, path);
+    ASSERT_FALSE(file->isModified());
+    ASSERT_EQ(file->getContents(), "BEGIN RETURN 1 END.");
+
+    file = MappedFile::open(path.string());
+    writeFile("BEGIN RETURN 3 END.\n");
+    ASSERT_TRUE(file->isModified());
+}
+
+TEST_F(TestMappedFile, RewrittenFileIsNotRecompiled) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    writeFile("PARAM a; BEGIN RETURN a * 2 END.\n"
+              "PARAM a; BEGIN RETURN a * 3 END.\n");
+    // Every compilation evicts the other functions.
+    Pljit pljit(PljitOptions{.compiledCodeBudget = 1, .diagnosticsSink = diagnostics.sink});
+    auto moduleFunctions = pljit.registerModuleFile(path.string());
+    ASSERT_EQ(moduleFunctions.size(), 2);
+    ASSERT_EQ(cantFail(moduleFunctions[0].handle(21)), 42);
+    ASSERT_EQ(cantFail(moduleFunctions[1].handle(14)), 42);
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_EQ(cantFail(func()), 1);
+
+    // The evicted functions would be recompiled from the rewritten source code.
+    writeFile("PARAM a; BEGIN RETURN a * 5 END.\n"
+              "PARAM a; BEGIN RETURN a * 7 END.\n");
+    auto result = moduleFunctions[0].handle(21);
+    ASSERT_EQ(result.resultCode, ResultCode::CompileError);
+    // Note: Background compilations of the module might report the error as well.
+    ASSERT_TRUE(diagnostics.stream.str().starts_with(
+        "error: source file was modified after the function was registered\n"));
+}
+
+TEST(TestSharedSourceCode, OwnerIsReleased) { // NOLINT
+    auto code = std::make_shared<const std::string>("PARAM a; BEGIN RETURN a * 2 END.");
+    std::weak_ptr<const std::string> weakCode = code;
+
+    // The function references the source code of the owner without copying it.
+    Pljit pljit;
+    auto func = pljit.registerFunction(*code, code);
+    code.reset();
+    ASSERT_FALSE(weakCode.expired());
+    ASSERT_EQ(cantFail(func(21)), 42);
+
+    pljit.unregisterFunction(func);
+    ASSERT_TRUE(weakCode.expired());
+}
+
+TEST(TestSharedSourceCode, LowMemoryModeReleasesOwner) { // NOLINT
+    auto module = std::make_shared<const std::string>("PARAM a; BEGIN RETURN a * 2 END.\n"
+                                                      "PARAM a; BEGIN RETURN a * 3 END.\n");
+    std::weak_ptr<const std::string> weakModule = module;
+
+    Pljit pljit(PljitOptions{.lowMemoryMode = true});
+    auto moduleFunctions = pljit.registerModule(*module, module);
+    module.reset();
+
+    // The module is released once all of its functions were compiled.
+    ASSERT_EQ(moduleFunctions.size(), 2);
+    ASSERT_TRUE(weakModule.expired());
+    ASSERT_EQ(cantFail(moduleFunctions[0].handle(1)), 2);
+    ASSERT_EQ(cantFail(moduleFunctions[1].handle(1)), 3);
+}
+
+} // namespace pljit::common
@@ -0,0 +1,165 @@
+#include "pljit/Pljit.h"
+#include "pljit/ast/AST.h"
+#include "pljit/common/MemoryResource.h"
+#include "pljit/parse_tree/ParseTree.h"
+#include <atomic>
+#include <thread>
+#include <gtest/gtest.h>
+
+namespace pljit {
+
+namespace {
+
+/// A thread-safe memory resource which counts the allocations.
+class CountingMemoryResource : public std::pmr::memory_resource {
+    public:
+    std::atomic<size_t> numberOfAllocations{0};
+    std::atomic<size_t> allocatedBytes{0};
+
+    private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++numberOfAllocations;
+        allocatedBytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        allocatedBytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+TEST(TestMemoryResource, NodesUseScopedResource) { // NOLINT
+    CountingMemoryResource resource;
+    std::unique_ptr<ast::Function> function;
+    {
+        common::MemoryResourceScope scope(&resource);
+        ASSERT_EQ(common::getNodeMemoryResource(), &resource);
+        std::vector<std::unique_ptr<ast::Statement>> statements;
+        statements.push_back(std::make_unique<ast::ReturnStatement>(
+            std::make_unique<ast::UnaryOp>(ast::UnaryOp::Type::MinusSign, std::make_unique<ast::ConstantLiteral>(1))));
+        function = std::make_unique<ast::Function>(std::move(statements));
+    }
+    ASSERT_EQ(common::getNodeMemoryResource(), std::pmr::new_delete_resource());
+    ASSERT_EQ(resource.numberOfAllocations, 4);
+    ASSERT_GT(resource.allocatedBytes, 0);
+
+    // The function remembers the resource of its tree, hence, the nodes are
+    // returned to it even after the scope has ended.
+    function.reset();
+    ASSERT_EQ(resource.allocatedBytes, 0);
+}
+
+TEST(TestMemoryResource, NodesHaveNoHeader) { // NOLINT
+    CountingMemoryResource resource;
+    common::MemoryResourceScope scope(&resource);
+    auto literal = std::make_unique<ast::ConstantLiteral>(1);
+    ASSERT_EQ(resource.allocatedBytes, sizeof(ast::ConstantLiteral));
+    literal.reset();
+    ASSERT_EQ(resource.allocatedBytes, 0);
+}
+
+TEST(TestMemoryResource, ScopesAreThreadLocal) { // NOLINT
+    CountingMemoryResource resource;
+    common::MemoryResourceScope scope(&resource);
+
+    std::thread thread([]() {
+        ASSERT_EQ(common::getNodeMemoryResource(), std::pmr::new_delete_resource());
+    });
+    thread.join();
+    ASSERT_EQ(common::getNodeMemoryResource(), &resource);
+}
+
+TEST(TestMemoryResource, CompileAllocatesFromResource) { // NOLINT
+    std::string code{"PARAM a;\n"
+                     "VAR b;\n"
+                     "CONST c = 3;\n"
+                     "BEGIN\n"
+                     "b := a * c;\n"
+                     "RETURN b + (1 + 2)\n"
+                     "END."};
+
+    CountingMemoryResource resource;
+    {
+        Pljit pljit(PljitOptions{.memoryResource = &resource});
+        auto func = pljit.registerFunction(code);
+        ASSERT_EQ(resource.numberOfAllocations, 0);
+
+        auto result = func(2);
+        ASSERT_EQ(result.resultCode, ResultCode::Success);
+        ASSERT_EQ(result.value, 9);
+
+        // The compile arena was released, only the compiled function remains.
+        ASSERT_GT(resource.numberOfAllocations, 0);
+        ASSERT_GT(resource.allocatedBytes, 0);
+    }
+    ASSERT_EQ(resource.allocatedBytes, 0);
+}
+
+TEST(TestMemoryResource, ConcurrentCompiles) { // NOLINT
+    std::string code{"PARAM a;\n"
+                     "BEGIN\n"
+                     "RETURN a * (a + 1)\n"
+                     "END."};
+
+    CountingMemoryResource resource;
+    {
+        Pljit pljit(PljitOptions{.memoryResource = &resource});
+        std::vector<FunctionHandle> functions;
+        for (size_t i = 0; i < 8; ++i) {
+            functions.push_back(pljit.registerFunction(code));
+        }
+
+        std::vector<std::thread> threads;
+        for (auto& func : functions) {
+            threads.emplace_back([func]() {
+                auto result = func(3);
+                ASSERT_EQ(result.resultCode, ResultCode::Success);
+                ASSERT_EQ(result.value, 12);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    ASSERT_EQ(resource.allocatedBytes, 0);
+}
+
+TEST(TestMemoryResource, DeduplicatedFunctionsShareImage) { // NOLINT
+    std::string code{"PARAM width, height;\n"
+                     "BEGIN\n"
+                     "RETURN width * height\n"
+                     "END."};
+    std::string renamedCode{"PARAM a, b; BEGIN RETURN a * b END."};
+
+    for (bool deduplicateFunctions : {false, true}) {
+        CountingMemoryResource resource;
+        Pljit pljit(PljitOptions{.lowMemoryMode = true,
+                                 .memoryResource = &resource,
+                                 .deduplicateFunctions = deduplicateFunctions});
+        auto func = pljit.registerFunction(code);
+        ASSERT_EQ(cantFail(func(2, 3)), 6);
+        size_t bytesOfOneFunction = resource.allocatedBytes;
+
+        auto renamedFunc = pljit.registerFunction(renamedCode);
+        ASSERT_EQ(cantFail(renamedFunc(4, 5)), 20);
+        if (deduplicateFunctions) {
+            // The AST of the second function was dropped in favor of the shared image.
+            ASSERT_EQ(resource.allocatedBytes, bytesOfOneFunction);
+        } else {
+            ASSERT_EQ(resource.allocatedBytes, 2 * bytesOfOneFunction);
+        }
+
+        // The shared image stays alive while one of the functions uses it.
+        pljit.unregisterFunction(func);
+        ASSERT_EQ(cantFail(renamedFunc(6, 7)), 42);
+    }
+}
+
+} // namespace pljit
@@ -0,0 +1,189 @@
+#include "pljit/common/MemoryResource.h"
+#include "pljit/common/SourceCodeManager.h"
+#include "pljit/common/ThreadPool.h"
+#include "pljit/parse_tree/ParseTree.h"
+#include "pljit/parse_tree/ParseTreeDotVisitor.h"
+#include "pljit/parser/Parser.h"
+#include "test/utils/TestUtils.h"
+#include <future>
+#include <gtest/gtest.h>
+
+namespace pljit::parser {
+
+namespace {
+
+constexpr size_t numberOfStatements = 2000;
+
+/// Returns options which enforce parallel parsing of the generated functions.
+/// The pool is only started by the first test which parses in parallel.
+ParserOptions getParallelOptions()
+{
+    static common::ThreadPool threadPool(3);
+    return ParserOptions{.parallelParsingThreshold = 100, .threadPool = &threadPool};
+}
+
+const ParserOptions sequentialOptions{.parallelParsingThreshold = 0};
+
+/// Generates a function with the given number of statements. The statement
+/// with the index brokenStatement (if any) is replaced by the given one.
+std::string generateFunction(size_t statements,
+                             size_t brokenStatement = std::numeric_limits<size_t>::max(),
+                             std::string_view replacement = "")
+{
+    std::string code{"PARAM a;\nVAR b;\nBEGIN\n"};
+    for (size_t i = 0; i + 1 < statements; ++i) {
+        if (i == brokenStatement) {
+            code.append(replacement);
+        } else {
+            code.append("b := (a + " + std::to_string(i) + ") * -b / 2");
+        }
+        code.append(";\n");
+    }
+    code.append("RETURN b\nEND.");
+    return code;
+}
+
+/// Parses the code and returns the parse tree in the DOT format as well as
+/// the output of the parser.
+std::pair<std::string, std::string> parse(const std::string& code, ParserOptions options)
+{
+    test_utils::CaptureDiagnostics diagnostics;
+
+    common::SourceCodeManager sourceCodeManager(code);
+    Parser parser(sourceCodeManager, options);
+    auto parseTree = parser.parseFunctionDefinition();
+
+    std::ostringstream buffer;
+    if (parseTree != nullptr) {
+        parse_tree::ParseTreeDotVisitor visitor(buffer);
+        parseTree->accept(visitor);
+    }
+    return {buffer.str(), diagnostics.stream.str()};
+}
+
+void expectSameResult(const std::string& code)
+{
+    auto [sequentialTree, sequentialOutput] = parse(code, sequentialOptions);
+    auto [parallelTree, parallelOutput] = parse(code, getParallelOptions());
+    ASSERT_EQ(parallelTree, sequentialTree);
+    ASSERT_EQ(parallelOutput, sequentialOutput);
+}
+
+} // namespace
+
+TEST(TestParallelParsing, SameParseTree) { // NOLINT
+    auto code = generateFunction(numberOfStatements);
+    auto [tree, output] = parse(code, getParallelOptions());
+    ASSERT_FALSE(tree.empty());
+    ASSERT_TRUE(output.empty());
+    expectSameResult(code);
+}
+
+TEST(TestParallelParsing, OnPoolWorker) { // NOLINT
+    auto code = generateFunction(numberOfStatements);
+    auto [sequentialTree, sequentialOutput] = parse(code, sequentialOptions);
+
+    // The parser runs on the only worker of the pool, hence, it parses all
+    // chunks itself instead of waiting for its tasks.
+    common::ThreadPool singleThread(1);
+    std::promise<std::pair<std::string, std::string>> result;
+    singleThread.submit([&]() {
+        result.set_value(parse(code, ParserOptions{.parallelParsingThreshold = 100, .threadPool = &singleThread}));
+    });
+    auto [parallelTree, parallelOutput] = result.get_future().get();
+    ASSERT_EQ(parallelTree, sequentialTree);
+    ASSERT_EQ(parallelOutput, sequentialOutput);
+}
+
+TEST(TestParallelParsing, AllocatedNodes) { // NOLINT
+    // The nodes which the workers allocate are counted for the calling thread.
+    auto code = generateFunction(numberOfStatements);
+    auto countNodes = [&](ParserOptions options) {
+        common::SourceCodeManager sourceCodeManager(code);
+        Parser parser(sourceCodeManager, options);
+        auto startNodes = common::getNumberOfAllocatedNodes();
+        auto startBytes = common::getNumberOfAllocatedNodeBytes();
+        auto parseTree = parser.parseFunctionDefinition();
+        EXPECT_NE(parseTree, nullptr);
+        return std::pair{common::getNumberOfAllocatedNodes() - startNodes,
+                         common::getNumberOfAllocatedNodeBytes() - startBytes};
+    };
+    auto sequentialNodes = countNodes(sequentialOptions);
+    ASSERT_GT(sequentialNodes.first, numberOfStatements);
+    ASSERT_EQ(countNodes(getParallelOptions()), sequentialNodes);
+}
+
+TEST(TestParallelParsing, BelowThreshold) { // NOLINT
+    expectSameResult(generateFunction(50));
+}
+
+TEST(TestParallelParsing, ParseErrorInChunk) { // NOLINT
+    expectSameResult(generateFunction(numberOfStatements, 1000, "b := a +"));
+}
+
+TEST(TestParallelParsing, EarliestErrorIsReported) { // NOLINT
+    auto code = generateFunction(numberOfStatements, 1500, "b := (a");
+    code.replace(code.find("b := (a + 300)"), 4, "b = ");
+    auto [tree, output] = parse(code, getParallelOptions());
+    ASSERT_TRUE(tree.empty());
+    ASSERT_NE(output.find("error: expected ':='"), std::string::npos);
+    ASSERT_EQ(output.find("error: expected ')'"), std::string::npos);
+    expectSameResult(code);
+}
+
+TEST(TestParallelParsing, LexerErrorInChunk) { // NOLINT
+    expectSameResult(generateFunction(numberOfStatements, 700, "b := a % 2"));
+}
+
+TEST(TestParallelParsing, MissingSemiColon) { // NOLINT
+    expectSameResult(generateFunction(numberOfStatements, 10, "b := a b := a"));
+}
+
+TEST(TestParallelParsing, ErrorInLastStatement) { // NOLINT
+    auto code = generateFunction(numberOfStatements);
+    code.replace(code.find("RETURN b"), 8, "RETURN");
+    expectSameResult(code);
+}
+
+TEST(TestParallelParsing, MissingEnd) { // NOLINT
+    auto code = generateFunction(numberOfStatements);
+    code.erase(code.find("END."));
+    expectSameResult(code);
+}
+
+TEST(TestParallelParsing, SemiColonAfterEnd) { // NOLINT
+    auto code = generateFunction(numberOfStatements);
+    code.append(";;;");
+    expectSameResult(code);
+}
+
+TEST(TestParallelParsing, PipelinedLexing) { // NOLINT
+    auto code = generateFunction(numberOfStatements);
+    auto [sequentialTree, sequentialOutput] = parse(code, sequentialOptions);
+
+    auto options = getParallelOptions();
+    options.pipelinedLexing = true;
+    auto [parallelTree, parallelOutput] = parse(code, options);
+    ASSERT_EQ(parallelTree, sequentialTree);
+    ASSERT_EQ(parallelOutput, sequentialOutput);
+
+    options = sequentialOptions;
+    options.pipelinedLexing = true;
+    auto [pipelinedTree, pipelinedOutput] = parse(code, options);
+    ASSERT_EQ(pipelinedTree, sequentialTree);
+    ASSERT_EQ(pipelinedOutput, sequentialOutput);
+}
+
+TEST(TestParallelParsing, PipelinedLexingWithErrors) { // NOLINT
+    auto code = generateFunction(numberOfStatements, 1200, "b := a ? 2");
+    code.replace(code.find("b := (a + 300)"), 4, "b = ");
+    auto [sequentialTree, sequentialOutput] = parse(code, sequentialOptions);
+
+    auto options = sequentialOptions;
+    options.pipelinedLexing = true;
+    auto [pipelinedTree, pipelinedOutput] = parse(code, options);
+    ASSERT_TRUE(pipelinedTree.empty());
+    ASSERT_EQ(pipelinedOutput, sequentialOutput);
+}
+
+} // namespace pljit::parser
@@ -2,6 +2,7 @@
 #include "pljit/parse_tree/ParseTree.h"
 #include "pljit/parse_tree/ParseTreeDotVisitor.h"
 #include "pljit/parser/Parser.h"
+#include <algorithm>
 #include <gtest/gtest.h>
 
 namespace pljit::parse_tree {
@@ -328,4 +329,29 @@ TEST(TestParseTreeDotVisitor, ComplexStatement) { // NOLINT
     executeTest(code, expectedParseTreeInDot);
 }
 
+TEST(TestParseTreeDotVisitor, DeepExpression) { // NOLINT
+    // RETURN ((...(1)...)), which would overflow the stack if the visitor
+    // recursed.
+    constexpr size_t depth = 100000;
+    std::string code{"BEGIN RETURN "};
+    code.append(depth, '(');
+    code.append("1");
+    code.append(depth, ')');
+    code.append(" END.");
+    common::SourceCodeManager sourceCodeManager(code);
+    parser::Parser parser(sourceCodeManager);
+    auto parseTree = parser.parseFunctionDefinition();
+    ASSERT_NE(parseTree, nullptr);
+
+    std::ostringstream buffer;
+    ParseTreeDotVisitor visitor(buffer);
+    parseTree->accept(visitor);
+
+    auto dotGraph = buffer.str();
+    ASSERT_TRUE(dotGraph.starts_with("digraph {\n\t0 [label=\"function-definition\"];\n"));
+    ASSERT_TRUE(dotGraph.ends_with("}\n"));
+    // Every nesting level has an opening and a closing parenthesis.
+    ASSERT_GE(std::count(dotGraph.begin(), dotGraph.end(), '('), depth);
+}
+
 } // namespace pljit::parse_tree
@@ -9,14 +9,14 @@ namespace pljit::parser {
 namespace {
 
 void executeErrorTest(std::string_view code, std::string_view expectedCout) {
-    test_utils::CaptureCout cout;
+    test_utils::CaptureDiagnostics diagnostics;
 
     common::SourceCodeManager sourceCodeManager(std::string{code});
     Parser parser(sourceCodeManager);
     auto parseResult = parser.parseFunctionDefinition();
 
     ASSERT_TRUE(parseResult == nullptr);
-    ASSERT_EQ(cout.stream.str(), expectedCout);
+    ASSERT_EQ(diagnostics.stream.str(), expectedCout);
 }
 
 } // namespace
@@ -1,5 +1,7 @@
 #include "pljit/Pljit.h"
+#include "pljit/common/Diagnostics.h"
 #include "test/utils/TestUtils.h"
+#include <atomic>
 #include <thread>
 #include <type_traits>
 #include <gtest/gtest.h>
@@ -49,7 +51,7 @@ TEST(TestPljitSingleThreaded, ParameterTest2) { // NOLINT
 }
 
 TEST(TestPljitSingleThreaded, WrongParameterCount) { // NOLINT
-    test_utils::CaptureCout cout;
+    test_utils::CaptureDiagnostics diagnostics;
 
     std::string code{"PARAM a, b, c;\n"
                      "BEGIN\n"
@@ -61,12 +63,12 @@ TEST(TestPljitSingleThreaded, WrongParameterCount) { // NOLINT
     auto result = func(1, 2);
 
     ASSERT_EQ(result.resultCode, ResultCode::InvalidFunctionCall);
-    ASSERT_EQ(cout.stream.str(), "error: invalid number of parameters "
-                                 "provided, expected 3 but 2 were provided\n");
+    ASSERT_EQ(diagnostics.stream.str(), "error: invalid number of parameters "
+                                        "provided, expected 3 but 2 were provided\n");
 }
 
 TEST(TestPljitSingleThreaded, RuntimeError) { // NOLINT
-    test_utils::CaptureCout cout;
+    test_utils::CaptureDiagnostics diagnostics;
 
     std::string code{"PARAM a, b;\n"
                      "BEGIN\n"
@@ -78,11 +80,11 @@ TEST(TestPljitSingleThreaded, RuntimeError) { // NOLINT
     auto result = func(1, 0);
 
     ASSERT_EQ(result.resultCode, ResultCode::RuntimeError);
-    ASSERT_EQ(cout.stream.str(), "error: division by zero\n");
+    ASSERT_EQ(diagnostics.stream.str(), "error: division by zero\n");
 }
 
 TEST(TestPljitSingleThreaded, CompileError) { // NOLINT
-    test_utils::CaptureCout cout;
+    test_utils::CaptureDiagnostics diagnostics;
 
     std::string code{"PARAM a, b;\n"
                      "VAR c;\n"
@@ -95,9 +97,9 @@ TEST(TestPljitSingleThreaded, CompileError) { // NOLINT
     auto result = func(1, 2);
 
     ASSERT_EQ(result.resultCode, ResultCode::CompileError);
-    ASSERT_EQ(cout.stream.str(), "4:11: error: use of uninitialized identifier\n"
-                                 "   RETURN c * (a + b)\n"
-                                 "          ^\n");
+    ASSERT_EQ(diagnostics.stream.str(), "4:11: error: use of uninitialized identifier\n"
+                                        "   RETURN c * (a + b)\n"
+                                        "          ^\n");
 }
 
 TEST(TestPljitSingleThreaded, CantFailTest) { // NOLINT
@@ -111,7 +113,7 @@ TEST(TestPljitSingleThreaded, CantFailTest) { // NOLINT
 }
 
 TEST(TestPljitSingleThreaded, EmptyCodeString) { // NOLINT
-    test_utils::CaptureCout cout;
+    test_utils::CaptureDiagnostics diagnostics;
 
     std::string code;
 
@@ -120,7 +122,315 @@ TEST(TestPljitSingleThreaded, EmptyCodeString) { // NOLINT
     auto result = func();
 
     ASSERT_EQ(result.resultCode, ResultCode::CompileError);
-    ASSERT_EQ(cout.stream.str(), "error: received code string of length 0\n");
+    ASSERT_EQ(diagnostics.stream.str(), "error: received code string of length 0\n");
+}
+
+TEST(TestPljitSingleThreaded, LowMemoryMode) { // NOLINT
+    std::string code{"PARAM width, height, depth;\n"
+                     "VAR volume;\n"
+                     "CONST density = 2400;\n"
+                     "BEGIN\n"
+                     "    volume := width * height * depth;\n"
+                     "    RETURN density * volume\n"
+                     "END."};
+
+    Pljit pljit(PljitOptions{.lowMemoryMode = true});
+    auto func = pljit.registerFunction(code);
+
+    // The compile artifacts are released after the first call, the following
+    // calls only use the execution image.
+    for (int64_t i = 1; i <= 3; ++i) {
+        auto result = func(i, 2, 3);
+        ASSERT_EQ(result.resultCode, ResultCode::Success);
+        ASSERT_EQ(result.value, 2400 * i * 6);
+    }
+}
+
+TEST(TestPljitSingleThreaded, LowMemoryModeCompileError) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    std::string code{"VAR c;\n"
+                     "BEGIN\n"
+                     "   RETURN c\n"
+                     "END.\n"};
+
+    Pljit pljit(PljitOptions{.lowMemoryMode = true});
+    auto func = pljit.registerFunction(code);
+
+    ASSERT_EQ(func().resultCode, ResultCode::CompileError);
+    ASSERT_EQ(func().resultCode, ResultCode::CompileError);
+    ASSERT_EQ(diagnostics.stream.str(), "3:11: error: use of uninitialized identifier\n"
+                                        "   RETURN c\n"
+                                        "          ^\n");
+}
+
+TEST(TestPljitSingleThreaded, Unregister) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    std::string code{"PARAM a;\n"
+                     "BEGIN\n"
+                     "RETURN a + 1\n"
+                     "END."};
+
+    Pljit pljit;
+    auto func = pljit.registerFunction(code);
+    auto otherFunc = pljit.registerFunction(code);
+    ASSERT_EQ(cantFail(func(1)), 2);
+
+    pljit.unregisterFunction(func);
+    ASSERT_EQ(func(1).resultCode, ResultCode::InvalidFunctionCall);
+    ASSERT_EQ(diagnostics.stream.str(), "error: the function was unregistered\n");
+
+    // Unregistering twice has no effect, other functions are not affected.
+    pljit.unregisterFunction(func);
+    ASSERT_EQ(cantFail(otherFunc(2)), 3);
+}
+
+TEST(TestPljitSingleThreaded, UnregisterReleasesStatisticsAndProfile) { // NOLINT
+    Pljit pljit(PljitOptions{.collectCompileStatistics = true, .collectCallMetrics = true, .profileExecution = true});
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a + 1 END.");
+    ASSERT_EQ(cantFail(func(1)), 2);
+    ASSERT_TRUE(pljit.getCompileStatistics(func));
+    ASSERT_TRUE(pljit.getCallMetrics(func));
+    ASSERT_NE(pljit.getExecutionProfile(func), nullptr);
+
+    pljit.unregisterFunction(func);
+    ASSERT_FALSE(pljit.getCompileStatistics(func));
+    ASSERT_FALSE(pljit.getCallMetrics(func));
+    ASSERT_EQ(pljit.getExecutionProfile(func), nullptr);
+    ASSERT_TRUE(pljit.getFunctionMetrics().empty());
+}
+
+TEST(TestPljitSingleThreaded, UnregisterBeforeCompilation) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit(PljitOptions{.lowMemoryMode = true});
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    auto invalidFunc = pljit.registerFunction("BEGIN RETURN 1 END");
+    pljit.unregisterFunction(func);
+    pljit.unregisterFunction(invalidFunc);
+
+    // The functions are never compiled, hence, no compile error is reported.
+    ASSERT_EQ(func().resultCode, ResultCode::InvalidFunctionCall);
+    ASSERT_EQ(invalidFunc().resultCode, ResultCode::InvalidFunctionCall);
+    ASSERT_EQ(diagnostics.stream.str(), "error: the function was unregistered\n"
+                                        "error: the function was unregistered\n");
+}
+
+TEST(TestPljitSingleThreaded, ReplaceFunction) { // NOLINT
+    Pljit pljit;
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.");
+    ASSERT_EQ(cantFail(func(21)), 42);
+
+    // The new version may have another signature.
+    ASSERT_TRUE(pljit.replaceFunction(func, "PARAM a, b; BEGIN RETURN a * b END."));
+    ASSERT_EQ(cantFail(func(6, 7)), 42);
+    ASSERT_EQ(func(21).resultCode, ResultCode::InvalidFunctionCall);
+
+    // Functions which were not yet compiled can be replaced as well.
+    auto notCompiledFunc = pljit.registerFunction("BEGIN RETURN 1 END.");
+    ASSERT_TRUE(pljit.replaceFunction(notCompiledFunc, "BEGIN RETURN 2 END."));
+    ASSERT_EQ(cantFail(notCompiledFunc()), 2);
+}
+
+TEST(TestPljitSingleThreaded, ReplaceFunctionWithCompileError) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit;
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.");
+    ASSERT_FALSE(pljit.replaceFunction(func, "PARAM a; BEGIN RETURN x END."));
+    ASSERT_EQ(diagnostics.stream.str(), "1:23: error: use of undeclared identifier\n"
+                                        "PARAM a; BEGIN RETURN x END.\n"
+                                        "                      ^\n");
+
+    // The function keeps its old version.
+    ASSERT_EQ(cantFail(func(21)), 42);
+
+    // A function with a compile error can be fixed.
+    auto invalidFunc = pljit.registerFunction("BEGIN RETURN x END.");
+    ASSERT_EQ(invalidFunc().resultCode, ResultCode::CompileError);
+    ASSERT_TRUE(pljit.replaceFunction(invalidFunc, "BEGIN RETURN 1 END."));
+    ASSERT_EQ(cantFail(invalidFunc()), 1);
+}
+
+TEST(TestPljitSingleThreaded, ReplaceUnregisteredFunction) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit;
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    pljit.unregisterFunction(func);
+    ASSERT_FALSE(pljit.replaceFunction(func, "BEGIN RETURN 2 END."));
+    ASSERT_EQ(func().resultCode, ResultCode::InvalidFunctionCall);
+    ASSERT_EQ(pljit.getCompiledCodeSize(), 0);
+}
+
+TEST(TestPljitSingleThreaded, WaitUntilCompiled) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit;
+    auto func = pljit.registerFunction("BEGIN RETURN 1 END.");
+    auto invalidFunc = pljit.registerFunction("BEGIN RETURN 1 END");
+
+    // Without background compilation, the functions are compiled right away.
+    ASSERT_TRUE(pljit.waitUntilCompiled(func));
+    ASSERT_FALSE(pljit.waitUntilCompiled(invalidFunc));
+    ASSERT_EQ(diagnostics.stream.str(), "1:18: error: expected '.' afterwards\n"
+                                        "BEGIN RETURN 1 END\n"
+                                        "                 ^\n");
+    ASSERT_EQ(cantFail(func()), 1);
+    ASSERT_EQ(invalidFunc().resultCode, ResultCode::CompileError);
+}
+
+TEST(TestPljitMultiThreaded, EagerCompilation) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    // The functions are compiled by the background threads, hence, the
+    // diagnostics must be passed to them.
+    Pljit pljit(PljitOptions{.eagerCompilation = true,
+                             .numberOfCompileThreads = 2,
+                             .diagnosticsSink = diagnostics.sink});
+    std::vector<FunctionHandle> functions;
+    for (int64_t i = 0; i < 100; ++i) {
+        functions.push_back(pljit.registerFunction("PARAM a; BEGIN RETURN a + " + std::to_string(i) + " END."));
+    }
+    auto invalidFunc = pljit.registerFunction("BEGIN RETURN 1 END");
+
+    for (auto& function : functions) {
+        ASSERT_TRUE(pljit.waitUntilCompiled(function));
+    }
+    ASSERT_FALSE(pljit.waitUntilCompiled(invalidFunc));
+    ASSERT_EQ(diagnostics.stream.str(), "1:18: error: expected '.' afterwards\n"
+                                        "BEGIN RETURN 1 END\n"
+                                        "                 ^\n");
+
+    for (int64_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(cantFail(functions[i](1)), i + 1);
+    }
+}
+
+TEST(TestPljitMultiThreaded, CompileAsync) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit(PljitOptions{.numberOfCompileThreads = 2});
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a * a END.");
+    auto invalidFunc = pljit.registerFunction("BEGIN RETURN b END.");
+
+    auto compiled = pljit.compileAsync(func);
+    auto failed = pljit.compileAsync(invalidFunc);
+    ASSERT_TRUE(compiled.get());
+    ASSERT_FALSE(failed.get());
+    ASSERT_EQ(cantFail(func(7)), 49);
+
+    // Compiling an unregistered function fails.
+    pljit.unregisterFunction(func);
+    ASSERT_FALSE(pljit.compileAsync(func).get());
+}
+
+TEST(TestPljitMultiThreaded, RegisterModule) { // NOLINT
+    std::string module{"PARAM a;\n"
+                       "BEGIN\n"
+                       "RETURN a + 1\n"
+                       "END.\n"
+                       "\n"
+                       "VAR ENDING;\n"
+                       "BEGIN\n"
+                       "RETURN ENDING\n"
+                       "END .\n"
+                       "BEGIN RETURN 3 END."};
+
+    Pljit pljit(PljitOptions{.numberOfCompileThreads = 2});
+    auto functions = pljit.registerModule(module);
+    ASSERT_EQ(functions.size(), 3);
+
+    ASSERT_TRUE(functions[0].compiled);
+    ASSERT_EQ(functions[0].diagnostics, "");
+    ASSERT_EQ(cantFail(functions[0].handle(41)), 42);
+
+    // The positions are relative to the start of the function definition.
+    ASSERT_FALSE(functions[1].compiled);
+    ASSERT_EQ(functions[1].diagnostics, "3:8: error: use of uninitialized identifier\n"
+                                        "RETURN ENDING\n"
+                                        "       ^~~~~~\n");
+    ASSERT_EQ(functions[1].handle().resultCode, ResultCode::CompileError);
+
+    ASSERT_TRUE(functions[2].compiled);
+    ASSERT_EQ(cantFail(functions[2].handle()), 3);
+}
+
+TEST(TestPljitMultiThreaded, RegisterModuleWithMissingTerminator) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit;
+    auto functions = pljit.registerModule("BEGIN RETURN 1 END.\n  BEGIN RETURN 2 END");
+    ASSERT_EQ(functions.size(), 2);
+    ASSERT_TRUE(functions[0].compiled);
+    ASSERT_FALSE(functions[1].compiled);
+    ASSERT_EQ(functions[1].diagnostics, "1:18: error: expected '.' afterwards\n"
+                                        "BEGIN RETURN 2 END\n"
+                                        "                 ^\n");
+
+    // Nothing is reported to the sink of the calling thread.
+    ASSERT_EQ(diagnostics.stream.str(), "");
+    ASSERT_TRUE(pljit.registerModule(" \n ").empty());
+}
+
+TEST(TestPljitMultiThreaded, RegisterLargeModule) { // NOLINT
+    std::string module;
+    for (int64_t i = 0; i < 1000; ++i) {
+        if (i % 10 == 0) {
+            module.append("BEGIN RETURN x END.\n");
+        } else {
+            module.append("PARAM a; BEGIN RETURN a * " + std::to_string(i) + " END.\n");
+        }
+    }
+
+    Pljit pljit(PljitOptions{.numberOfCompileThreads = 4});
+    auto functions = pljit.registerModule(module);
+    ASSERT_EQ(functions.size(), 1000);
+    for (int64_t i = 0; i < 1000; ++i) {
+        if (i % 10 == 0) {
+            ASSERT_FALSE(functions[i].compiled);
+            ASSERT_EQ(functions[i].diagnostics, "1:14: error: use of undeclared identifier\n"
+                                                "BEGIN RETURN x END.\n"
+                                                "             ^\n");
+        } else {
+            ASSERT_TRUE(functions[i].compiled);
+            ASSERT_EQ(functions[i].diagnostics, "");
+            ASSERT_EQ(cantFail(functions[i].handle(2)), 2 * i);
+        }
+    }
+}
+
+TEST(TestPljitSingleThreaded, RegisterModuleFileNotFound) { // NOLINT
+    test_utils::CaptureDiagnostics diagnostics;
+
+    Pljit pljit;
+    ASSERT_TRUE(pljit.registerModuleFile("/nonexistent/module.pl0").empty());
+    ASSERT_EQ(diagnostics.stream.str(), "error: cannot read module file '/nonexistent/module.pl0'\n");
+}
+
+TEST(TestPljitMultiThreaded, DeduplicatedFunctions) { // NOLINT
+    Pljit pljit(PljitOptions{.deduplicateFunctions = true});
+
+    // Functions which only differ in whitespace, identifier names or constant
+    // values are compiled concurrently.
+    std::vector<std::thread> threadPool;
+    for (int64_t i = 0; i < 8; i++) {
+        threadPool.emplace_back([&pljit, i]() {
+            std::string name = i % 2 == 0 ? "x" : "y";
+            std::string code{"PARAM " + name + ";\n"
+                             "CONST k = " + std::to_string(i % 4) + ";\n"
+                             "BEGIN RETURN " + name + " * k END."};
+            auto func = pljit.registerFunction(code);
+            for (int64_t j = 0; j < 10; j++) {
+                ASSERT_EQ(cantFail(func(j)), j * (i % 4));
+            }
+            pljit.unregisterFunction(func);
+        });
+    }
+    for (auto& thread : threadPool) {
+        thread.join();
+    }
 }
 
 TEST(TestPljitMultiThreaded, MultipleThreadsSameFunction) { // NOLINT
@@ -276,6 +586,118 @@ TEST(TestPljitMultiThreaded, MultipleRegistrationsWithOnlyInvalidFunctionCalls)
     }
 }
 
+TEST(TestPljitMultiThreaded, ConcurrentRegistrationAndExecution) { // NOLINT
+    Pljit pljit;
+
+    std::string sharedCode{"PARAM a;\n"
+                           "BEGIN\n"
+                           "RETURN a * 2\n"
+                           "END."};
+    auto sharedFunction = pljit.registerFunction(sharedCode);
+
+    const unsigned numberOfRegistrationsPerThread = 200;
+
+    std::vector<std::thread> threadPool;
+    for (int64_t i = 0; i < 8; i++) {
+        threadPool.emplace_back([&pljit, sharedFunction, i, numberOfRegistrationsPerThread]() {
+            std::vector<std::pair<FunctionHandle, int64_t>> functions;
+            for (int64_t j = 0; j < numberOfRegistrationsPerThread; j++) {
+                int64_t value = i * numberOfRegistrationsPerThread + j;
+                std::string function{"BEGIN\n"
+                                     "RETURN " + std::to_string(value) + "\n"
+                                     "END."};
+                functions.emplace_back(pljit.registerFunction(function), value);
+
+                auto result = sharedFunction(value);
+                ASSERT_EQ(result.resultCode, ResultCode::Success);
+                ASSERT_EQ(result.value, 2 * value);
+            }
+
+            // The handles stay valid while other threads register functions.
+            for (auto [function, value] : functions) {
+                auto result = function();
+                ASSERT_EQ(result.resultCode, ResultCode::Success);
+                ASSERT_EQ(result.value, value);
+            }
+        });
+    }
+
+    for (auto& thread : threadPool) {
+        thread.join();
+    }
+}
+
+TEST(TestPljitMultiThreaded, UnregisterDuringExecution) { // NOLINT
+    // We ignore the errors of calls after the unregistration. They are
+    // reported concurrently, hence, they must not be written to cout.
+    Pljit pljit(PljitOptions{.diagnosticsSink = std::make_shared<common::NullDiagnosticsSink>()});
+    for (int64_t round = 0; round < 50; ++round) {
+        std::string code{"PARAM a;\n"
+                         "VAR b;\n"
+                         "BEGIN\n"
+                         "b := a * 3;\n"
+                         "RETURN b + " + std::to_string(round) + "\n"
+                         "END."};
+        auto func = pljit.registerFunction(code);
+
+        std::vector<std::thread> threadPool;
+        for (int64_t i = 0; i < 4; i++) {
+            threadPool.emplace_back([func, round, i]() {
+                // Every call either sees the complete function or fails cleanly.
+                for (int64_t j = 0; j < 100; j++) {
+                    auto result = func(i + j);
+                    if (result.resultCode == ResultCode::InvalidFunctionCall) {
+                        return;
+                    }
+                    ASSERT_EQ(result.resultCode, ResultCode::Success);
+                    ASSERT_EQ(result.value, (i + j) * 3 + round);
+                }
+            });
+        }
+        pljit.unregisterFunction(func);
+
+        for (auto& thread : threadPool) {
+            thread.join();
+        }
+        ASSERT_EQ(func(1).resultCode, ResultCode::InvalidFunctionCall);
+    }
+}
+
+TEST(TestPljitMultiThreaded, ReplaceDuringExecution) { // NOLINT
+    auto getCode = [](int64_t version) {
+        return "PARAM a; BEGIN RETURN a * 1000 + " + std::to_string(version) + " END.";
+    };
+
+    Pljit pljit;
+    auto func = pljit.registerFunction(getCode(0));
+    std::atomic<int64_t> publishedVersion{0};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> threadPool;
+    for (int64_t i = 0; i < 4; i++) {
+        threadPool.emplace_back([&, i]() {
+            // Every call sees a complete version which is at least as new as
+            // the version published before the call.
+            while (!done) {
+                auto minVersion = publishedVersion.load();
+                auto result = cantFail(func(i));
+                ASSERT_EQ(result / 1000, i);
+                ASSERT_GE(result % 1000, minVersion);
+            }
+        });
+    }
+    for (int64_t version = 1; version <= 100; ++version) {
+        ASSERT_TRUE(pljit.replaceFunction(func, getCode(version)));
+        publishedVersion = version;
+    }
+    done = true;
+
+    for (auto& thread : threadPool) {
+        thread.join();
+    }
+    ASSERT_EQ(cantFail(func(1)), 1100);
+}
+
 TEST(TestPljitMultiThreaded, FuzzyTest) { // NOLINT
     // We ignore everything printed to std::cout to not spam the console.
     std::cout.setstate(std::ios_base::failbit);
@@ -0,0 +1,79 @@
+#include "pljit/Pljit.h"
+#include "pljit/common/Diagnostics.h"
+#include "pljit/common/Probes.h"
+#include <algorithm>
+#include <cstring>
+#include <elf.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace pljit::common {
+
+#if !defined(PLJIT_DISABLE_PROBES) && defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+
+namespace {
+
+/// Returns the names of the probes in the .note.stapsdt section of the executable.
+std::set<std::string> readProbeNames()
+{
+    std::ifstream file("/proc/self/exe", std::ios::binary | std::ios::ate);
+    std::vector<char> elf(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(elf.data(), static_cast<std::streamsize>(elf.size())) || elf.size() < sizeof(Elf64_Ehdr)) {
+        return {};
+    }
+    Elf64_Ehdr header;
+    std::memcpy(&header, elf.data(), sizeof(header));
+    auto readSectionHeader = [&](size_t index) {
+        Elf64_Shdr sectionHeader;
+        std::memcpy(&sectionHeader, elf.data() + header.e_shoff + index * header.e_shentsize, sizeof(sectionHeader));
+        return sectionHeader;
+    };
+    auto sectionNames = readSectionHeader(header.e_shstrndx);
+
+    std::set<std::string> names;
+    for (size_t i = 0; i < header.e_shnum; ++i) {
+        auto section = readSectionHeader(i);
+        if (std::strcmp(elf.data() + sectionNames.sh_offset + section.sh_name, ".note.stapsdt") != 0) {
+            continue;
+        }
+        // Every note: name size, description size, type, "stapsdt", then the
+        // description: location, base, semaphore, provider, name, arguments.
+        for (size_t pos = section.sh_offset; pos + sizeof(Elf64_Nhdr) <= section.sh_offset + section.sh_size;) {
+            Elf64_Nhdr note;
+            std::memcpy(&note, elf.data() + pos, sizeof(note));
+            const char* description = elf.data() + pos + sizeof(note) + ((note.n_namesz + 3) & ~3u);
+            const char* provider = description + 3 * sizeof(uint64_t);
+            if (std::strcmp(provider, "pljit") == 0) {
+                names.insert(provider + std::strlen(provider) + 1);
+            }
+            pos += sizeof(note) + ((note.n_namesz + 3) & ~3u) + ((note.n_descsz + 3) & ~3u);
+        }
+    }
+    return names;
+}
+
+} // namespace
+
+TEST(TestProbes, ProbesAreEmitted) { // NOLINT
+    auto names = readProbeNames();
+    for (const char* name : {"compile__lock__wait", "compile__lock__acquired", "compile__phase__start",
+                             "compile__phase__end", "execute__start", "execute__end", "runtime__error"}) {
+        ASSERT_TRUE(names.contains(name)) << name;
+    }
+}
+
+#endif
+
+TEST(TestProbes, ExecuteWithProbes) { // NOLINT
+    // The probes do not change the behavior of the calls.
+    Pljit pljit(PljitOptions{.diagnosticsSink = std::make_shared<NullDiagnosticsSink>()});
+    auto func = pljit.registerFunction("PARAM a; BEGIN RETURN 6 / a END.");
+    ASSERT_EQ(cantFail(func(3)), 2);
+    ASSERT_EQ(func(0).resultCode, ResultCode::RuntimeError);
+}
+
+} // namespace pljit::common
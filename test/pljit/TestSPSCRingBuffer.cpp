@@ -0,0 +1,68 @@
+#include "pljit/common/SPSCRingBuffer.h"
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+
+namespace pljit::common {
+
+TEST(TestSPSCRingBuffer, TryPushAndTryPop) { // NOLINT
+    SPSCRingBuffer<int> ringBuffer(4);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ringBuffer.tryPush(int{i}));
+    }
+    ASSERT_FALSE(ringBuffer.tryPush(4));
+
+    int element;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ringBuffer.tryPop(element));
+        ASSERT_EQ(element, i);
+    }
+    ASSERT_FALSE(ringBuffer.tryPop(element));
+}
+
+TEST(TestSPSCRingBuffer, BlockingPushAndPop) { // NOLINT
+    // The small capacity lets both threads block on each other.
+    constexpr int numberOfElements = 100000;
+    SPSCRingBuffer<int> ringBuffer(2);
+    std::thread producer([&]() {
+        for (int i = 0; i < numberOfElements; ++i) {
+            ASSERT_TRUE(ringBuffer.push(int{i}));
+        }
+        ringBuffer.finish();
+    });
+
+    int element;
+    for (int i = 0; i < numberOfElements; ++i) {
+        ASSERT_TRUE(ringBuffer.pop(element));
+        ASSERT_EQ(element, i);
+    }
+    ASSERT_FALSE(ringBuffer.pop(element));
+    producer.join();
+}
+
+TEST(TestSPSCRingBuffer, PopAfterFinish) { // NOLINT
+    SPSCRingBuffer<int> ringBuffer(4);
+    ASSERT_TRUE(ringBuffer.push(1));
+    ringBuffer.finish();
+
+    // The element which was pushed before finishing is still popped.
+    int element;
+    ASSERT_TRUE(ringBuffer.pop(element));
+    ASSERT_EQ(element, 1);
+    ASSERT_FALSE(ringBuffer.pop(element));
+}
+
+TEST(TestSPSCRingBuffer, StopWakesUpProducer) { // NOLINT
+    SPSCRingBuffer<int> ringBuffer(2);
+    std::thread producer([&]() {
+        // Blocks on the third element until the consumer stops.
+        ASSERT_TRUE(ringBuffer.push(1));
+        ASSERT_TRUE(ringBuffer.push(2));
+        ASSERT_FALSE(ringBuffer.push(3));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ringBuffer.stop();
+    producer.join();
+}
+
+} // namespace pljit::common
@@ -8,10 +8,10 @@ namespace pljit::analysis {
 namespace {
 
 void executeErrorTest(std::string_view code, std::string_view expectedErrorMsg) {
-    test_utils::CaptureCout cout;
+    test_utils::CaptureDiagnostics diagnostics;
     test_utils::ASTEnvironment env(code, test_utils::Optimization::NoOptimization);
     ASSERT_TRUE(env.ast == nullptr);
-    ASSERT_EQ(cout.stream.str(), expectedErrorMsg);
+    ASSERT_EQ(diagnostics.stream.str(), expectedErrorMsg);
 }
 
 } // namespace
@@ -0,0 +1,78 @@
+#include "pljit/common/ThreadPool.h"
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <gtest/gtest.h>
+
+namespace pljit::common {
+
+TEST(TestThreadPool, ExecutesAllTasks) { // NOLINT
+    std::atomic<size_t> sum{0};
+    std::promise<void> done;
+    {
+        ThreadPool threadPool(4);
+        ASSERT_EQ(threadPool.getNumberOfThreads(), 4);
+
+        std::atomic<size_t> remaining{1000};
+        for (size_t i = 1; i <= 1000; ++i) {
+            threadPool.submit([&, i]() {
+                sum += i;
+                if (--remaining == 0) {
+                    done.set_value();
+                }
+            });
+        }
+        done.get_future().wait();
+    }
+    ASSERT_EQ(sum, 1000 * 1001 / 2);
+}
+
+TEST(TestThreadPool, DefaultNumberOfThreads) { // NOLINT
+    ThreadPool threadPool(0);
+    ASSERT_GE(threadPool.getNumberOfThreads(), 1);
+}
+
+TEST(TestThreadPool, TasksSubmittedByWorkersAreStolen) { // NOLINT
+    ThreadPool threadPool(4);
+    std::mutex mutex;
+    std::set<std::thread::id> threadIds;
+    std::atomic<size_t> remaining{64};
+    std::promise<void> done;
+
+    // All tasks are submitted to the queue of a single worker, the other
+    // workers have to steal them.
+    threadPool.submit([&]() {
+        for (size_t i = 0; i < 64; ++i) {
+            threadPool.submit([&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                {
+                    std::unique_lock lck(mutex);
+                    threadIds.insert(std::this_thread::get_id());
+                }
+                if (--remaining == 0) {
+                    done.set_value();
+                }
+            });
+        }
+    });
+    done.get_future().wait();
+    ASSERT_GT(threadIds.size(), 1);
+}
+
+TEST(TestThreadPool, DiscardsPendingTasks) { // NOLINT
+    auto task = std::make_shared<std::packaged_task<void()>>([]() {});
+    auto pendingResult = task->get_future().share();
+    {
+        ThreadPool threadPool(1);
+        // The only worker is blocked until the pending task is discarded by
+        // the destructor, which makes its future ready.
+        threadPool.submit([pendingResult]() { pendingResult.wait(); });
+        threadPool.submit([task = std::move(task)]() { (*task)(); });
+    }
+    ASSERT_THROW(pendingResult.get(), std::future_error);
+}
+
+} // namespace pljit::common
@@ -0,0 +1,135 @@
+#include "pljit/Pljit.h"
+#include "pljit/common/Tracer.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+namespace pljit::common {
+
+namespace {
+
+/// Returns the number of events with the given name.
+size_t countEvents(const std::vector<TraceEvent>& events, std::string_view name)
+{
+    return static_cast<size_t>(std::count_if(events.begin(), events.end(), [&](const TraceEvent& event) {
+        return event.name == name;
+    }));
+}
+
+} // namespace
+
+TEST(TestTracer, RingBuffer) { // NOLINT
+    Tracer tracer(4);
+    for (uint64_t i = 0; i < 6; ++i) {
+        tracer.recordComplete("event", "test", 100 + i, 200 + i, i);
+    }
+    auto events = tracer.getEvents();
+    ASSERT_EQ(events.size(), 4);
+    ASSERT_EQ(tracer.getNumberOfOverwrittenEvents(), 2);
+    // The oldest events were overwritten.
+    for (uint64_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(events[i].functionHash, i + 2);
+        ASSERT_EQ(events[i].start, 102 + i);
+        ASSERT_EQ(events[i].threadIndex, 1);
+    }
+}
+
+TEST(TestTracer, PerThreadBuffers) { // NOLINT
+    Tracer tracer(16);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            for (size_t j = 0; j < 16; ++j) {
+                tracer.recordInstant("event", "test", 0);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // Every thread has its own buffer, hence, no event is overwritten.
+    auto events = tracer.getEvents();
+    ASSERT_EQ(events.size(), 64);
+    ASSERT_EQ(tracer.getNumberOfOverwrittenEvents(), 0);
+    ASSERT_TRUE(std::is_sorted(events.begin(), events.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.start < rhs.start;
+    }));
+    for (uint32_t threadIndex = 1; threadIndex <= 4; ++threadIndex) {
+        ASSERT_EQ(std::count_if(events.begin(), events.end(), [&](const auto& event) {
+                      return event.threadIndex == threadIndex;
+                  }),
+                  16);
+    }
+}
+
+TEST(TestTracer, WriteJson) { // NOLINT
+    Tracer tracer;
+    auto start = Tracer::now();
+    tracer.recordComplete("parsing", "compile", start + 1500, start + 4000, 0xabc);
+    tracer.recordInstant("publish", "compile", 0xabc);
+
+    std::ostringstream stream;
+    tracer.writeJson(stream);
+    auto json = stream.str();
+    ASSERT_TRUE(json.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n{\""));
+    ASSERT_NE(json.find("{\"name\":\"parsing\",\"cat\":\"compile\",\"ph\":\"X\",\"ts\":"), std::string::npos);
+    ASSERT_NE(json.find(",\"dur\":2.500,\"pid\":1,\"tid\":1,\"args\":{\"function\":\"0x0000000000000abc\"}}"),
+              std::string::npos);
+    ASSERT_NE(json.find("{\"name\":\"publish\",\"cat\":\"compile\",\"ph\":\"i\",\"s\":\"t\",\"ts\":"),
+              std::string::npos);
+    ASSERT_EQ(json.substr(json.size() - 4), "\n]}\n");
+
+    std::ostringstream emptyStream;
+    Tracer().writeJson(emptyStream);
+    ASSERT_EQ(emptyStream.str(), "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n");
+}
+
+TEST(TestTracer, TraceCompilation) { // NOLINT
+    auto tracer = std::make_shared<Tracer>();
+    Pljit pljit(PljitOptions{.deduplicateFunctions = true, .tracer = tracer});
+    auto func1 = pljit.registerFunction("PARAM a; BEGIN RETURN a * 2 END.");
+    auto func2 = pljit.registerFunction("PARAM b; BEGIN RETURN b * 2 END.");
+    ASSERT_EQ(cantFail(func1(1)), 2);
+    ASSERT_EQ(cantFail(func2(2)), 4);
+
+    auto events = tracer->getEvents();
+    ASSERT_EQ(countEvents(events, "compile lock"), 2);
+    ASSERT_EQ(countEvents(events, "compile"), 2);
+    ASSERT_EQ(countEvents(events, "parsing"), 2);
+    ASSERT_EQ(countEvents(events, "semantic analysis"), 2);
+    // Both functions are optimized, then the second one shares the image of
+    // the first one.
+    ASSERT_EQ(countEvents(events, "dead code elimination"), 2);
+    ASSERT_EQ(countEvents(events, "deduplication"), 1);
+    ASSERT_EQ(countEvents(events, "publish"), 2);
+    // Lexing is traced as part of the parsing.
+    ASSERT_EQ(countEvents(events, "lexing"), 0);
+    ASSERT_EQ(countEvents(events, "execute"), 0);
+
+    // The phases are nested into the compilation of their function.
+    auto compile = std::find_if(events.begin(), events.end(), [](const auto& event) { return event.name == "compile"; });
+    auto parsing = std::find_if(events.begin(), events.end(), [](const auto& event) { return event.name == "parsing"; });
+    ASSERT_EQ(parsing->functionHash, compile->functionHash);
+    ASSERT_LE(compile->start, parsing->start);
+    ASSERT_GE(compile->end, parsing->end);
+}
+
+TEST(TestTracer, TraceQueueAndExecutions) { // NOLINT
+    auto tracer = std::make_shared<Tracer>();
+    {
+        Pljit pljit(PljitOptions{.tracer = tracer, .traceSampledExecutions = true});
+        auto func = pljit.registerFunction("PARAM a; BEGIN RETURN a + 1 END.");
+        ASSERT_TRUE(pljit.compileAsync(func).get());
+        for (int64_t i = 0; i < 128; ++i) {
+            ASSERT_EQ(cantFail(func(i)), i + 1);
+        }
+    }
+    auto events = tracer->getEvents();
+    ASSERT_EQ(countEvents(events, "compile queue"), 1);
+    ASSERT_EQ(countEvents(events, "compile"), 1);
+    // Every 64th call of the function is sampled.
+    ASSERT_EQ(countEvents(events, "execute"), 2);
+}
+
+} // namespace pljit::common
@@ -0,0 +1,169 @@
+#include "pljit/Pljit.h"
+#include "pljit/common/Hash.h"
+#include "pljit/exec/WarmUpProfile.h"
+#include "test/utils/TestUtils.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace pljit::exec {
+
+namespace {
+
+/// A temporary profile which is removed at the end of the test.
+class TestWarmUpProfile : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+            ("pljit_profile_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::filesystem::path path;
+};
+
+} // namespace
+
+TEST_F(TestWarmUpProfile, WriteAndRead) { // NOLINT
+    WarmUpProfile profile;
+    profile.add(0x1234, {10, WarmUpProfile::Tier::Compiled});
+    profile.add(0xabcdef, {500, WarmUpProfile::Tier::Compiled});
+    profile.add(0x1234, {5, WarmUpProfile::Tier::Compiled});
+    ASSERT_EQ(profile.size(), 2);
+    ASSERT_TRUE(profile.write(path.string()));
+
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    ASSERT_EQ(content.str(), "pljit-profile 1\n"
+                             "abcdef 500 compiled\n"
+                             "1234 15 compiled\n");
+
+    auto readProfile = WarmUpProfile::read(path.string());
+    ASSERT_TRUE(readProfile);
+    ASSERT_EQ(readProfile->size(), 2);
+    ASSERT_EQ(readProfile->lookup(0x1234)->numberOfCalls, 15);
+    ASSERT_EQ(readProfile->lookup(0xabcdef)->numberOfCalls, 500);
+    ASSERT_FALSE(readProfile->lookup(0x42));
+
+    // The profile is replaced as a whole, no temporary file is left behind.
+    ASSERT_TRUE(WarmUpProfile().write(path.string()));
+    ASSERT_EQ(WarmUpProfile::read(path.string())->size(), 0);
+    for (const auto& entry : std::filesystem::directory_iterator(path.parent_path())) {
+        ASSERT_FALSE(entry.path().filename().string().starts_with(path.filename().string() + ".tmp"));
+    }
+
+    // The file cannot be written.
+    ASSERT_FALSE(profile.write((path / "profile").string()));
+}
+
+TEST_F(TestWarmUpProfile, InvalidFiles) { // NOLINT
+    // Missing file
+    ASSERT_FALSE(WarmUpProfile::read(path.string()));
+
+    auto readContent = [&](std::string_view content) {
+        {
+            std::ofstream file(path, std::ios::trunc);
+            file << content;
+        }
+        return WarmUpProfile::read(path.string());
+    };
+    ASSERT_TRUE(readContent("pljit-profile 1\n"));
+    ASSERT_FALSE(readContent(""));
+    ASSERT_FALSE(readContent("pljit-profile 2\n1234 1 compiled\n"));
+    ASSERT_FALSE(readContent("pljit-profile 1\n1234 1\n"));
+    ASSERT_FALSE(readContent("pljit-profile 1\n1234 1 interpreted\n"));
+    ASSERT_FALSE(readContent("pljit-profile 1\nxyz 1 compiled\n"));
+}
+
+TEST_F(TestWarmUpProfile, PljitWarmUp) { // NOLINT
+    test_utils::CaptureCout cout;
+
+    std::string hotCode{"PARAM a; BEGIN RETURN a * 2 END."};
+    std::string coldCode{"PARAM a; BEGIN RETURN a * 3 END."};
+    std::string unusedCode{"PARAM a; BEGIN RETURN a * 4 END."};
+    std::string invalidCode{"BEGIN RETURN x END."};
+
+    // The first run records the compiled functions.
+    {
+        Pljit pljit(PljitOptions{.profilePath = path.string()});
+        ASSERT_EQ(pljit.warmUp(), 0);
+        auto hotFunc = pljit.registerFunction(hotCode);
+        auto coldFunc = pljit.registerFunction(coldCode);
+        pljit.registerFunction(unusedCode);
+        auto invalidFunc = pljit.registerFunction(invalidCode);
+        for (int64_t i = 0; i < 1000; ++i) {
+            ASSERT_EQ(cantFail(hotFunc(i)), i * 2);
+            if (i % 100 == 0) {
+                ASSERT_EQ(cantFail(coldFunc(i)), i * 3);
+            }
+        }
+        ASSERT_EQ(invalidFunc().resultCode, ResultCode::CompileError);
+    }
+    auto profile = WarmUpProfile::read(path.string());
+    ASSERT_TRUE(profile);
+    ASSERT_EQ(profile->size(), 2);
+    // The calls are counted per function, i.e. the interleaved calls of the
+    // functions do not distort each other.
+    ASSERT_EQ(profile->lookup(common::hashBytes(hotCode))->numberOfCalls, 1000);
+    ASSERT_EQ(profile->lookup(common::hashBytes(coldCode))->numberOfCalls, 10);
+
+    // The second run compiles the recorded functions before they are called.
+    {
+        Pljit pljit(PljitOptions{.lowMemoryMode = true, .profilePath = path.string()});
+        auto hotFunc = pljit.registerFunction(hotCode);
+        pljit.registerFunction(coldCode);
+        pljit.registerFunction(unusedCode);
+        ASSERT_EQ(pljit.warmUp(), 2);
+        // Functions are only compiled once.
+        ASSERT_EQ(pljit.warmUp(), 0);
+        ASSERT_EQ(cantFail(hotFunc(21)), 42);
+    }
+    profile = WarmUpProfile::read(path.string());
+    ASSERT_TRUE(profile);
+    ASSERT_EQ(profile->size(), 2);
+    ASSERT_FALSE(profile->lookup(common::hashBytes(unusedCode)));
+}
+
+TEST_F(TestWarmUpProfile, EvictedFunctionsAreWritten) { // NOLINT
+    std::string hotCode{"PARAM a; BEGIN RETURN a * 2 END."};
+    std::string otherCode{"PARAM a; BEGIN RETURN a * 3 END."};
+
+    // Every compilation evicts the other function.
+    Pljit pljit(PljitOptions{.profilePath = path.string(), .compiledCodeBudget = 1});
+    auto hotFunc = pljit.registerFunction(hotCode);
+    auto otherFunc = pljit.registerFunction(otherCode);
+    for (int64_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(cantFail(hotFunc(i)), i * 2);
+    }
+    ASSERT_EQ(cantFail(otherFunc(1)), 3);
+    ASSERT_EQ(pljit.getNumberOfEvictions(), 1);
+
+    ASSERT_TRUE(pljit.writeProfile(path.string()));
+    auto profile = WarmUpProfile::read(path.string());
+    ASSERT_TRUE(profile);
+    ASSERT_EQ(profile->size(), 2);
+    ASSERT_EQ(profile->lookup(common::hashBytes(hotCode))->numberOfCalls, 100);
+    ASSERT_EQ(profile->lookup(common::hashBytes(otherCode))->numberOfCalls, 1);
+}
+
+TEST_F(TestWarmUpProfile, CallsAreOnlyCountedIfNeeded) { // NOLINT
+    // Without a profile path, call metrics or traced samples, the calls are
+    // not counted.
+    std::string code{"PARAM a; BEGIN RETURN a * 2 END."};
+    Pljit pljit;
+    auto func = pljit.registerFunction(code);
+    for (int64_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(cantFail(func(i)), i * 2);
+    }
+    ASSERT_TRUE(pljit.writeProfile(path.string()));
+    auto profile = WarmUpProfile::read(path.string());
+    ASSERT_TRUE(profile);
+    ASSERT_EQ(profile->lookup(common::hashBytes(code))->numberOfCalls, 0);
+}
+
+} // namespace pljit::exec
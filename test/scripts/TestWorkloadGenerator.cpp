@@ -0,0 +1,98 @@
+#include "pljit/Pljit.h"
+#include "scripts/WorkloadGenerator.h"
+#include "test/utils/TestUtils.h"
+#include <gtest/gtest.h>
+
+namespace pljit::workload {
+
+namespace {
+
+/// Compiles the function and calls it with the extreme arguments, the calls
+/// must neither fail nor overflow (which is detected by the sanitizers).
+void checkFunction(const std::string& code, const WorkloadOptions& options)
+{
+    ASSERT_EQ(options.numberOfParameters, 2);
+    Pljit pljit;
+    auto function = pljit.registerFunction(code);
+    auto maxParameterValue = options.maxParameterValue;
+    for (auto [a, b] : {std::pair<int64_t, int64_t>{0, 0},
+                        {maxParameterValue, maxParameterValue},
+                        {-maxParameterValue, maxParameterValue},
+                        {maxParameterValue, -maxParameterValue},
+                        {-maxParameterValue, -maxParameterValue}}) {
+        auto result = function(a, b);
+        ASSERT_EQ(result.resultCode, ResultCode::Success) << code;
+        ASSERT_LE(static_cast<uint64_t>(std::abs(result.value)), WorkloadGenerator::maxValue) << code;
+    }
+}
+
+} // namespace
+
+TEST(TestWorkloadGenerator, Deterministic) { // NOLINT
+    WorkloadOptions options{.seed = 42};
+    auto code = WorkloadGenerator(options).generateFunction();
+    ASSERT_EQ(WorkloadGenerator(options).generateFunction(), code);
+    options.seed = 43;
+    ASSERT_NE(WorkloadGenerator(options).generateFunction(), code);
+}
+
+TEST(TestWorkloadGenerator, Declarations) { // NOLINT
+    WorkloadOptions options{.numberOfParameters = 2, .numberOfVariables = 3, .numberOfConstants = 1,
+                            .numberOfStatements = 5, .maxLiteral = 7};
+    auto code = WorkloadGenerator(options).generateFunction();
+    ASSERT_TRUE(code.starts_with("PARAM pa, pb;\nVAR va, vb, vc;\nCONST ca = ")) << code;
+    ASSERT_NE(code.find("\nBEGIN\n    va := "), std::string::npos) << code;
+    ASSERT_NE(code.find(";\n    vb := "), std::string::npos) << code;
+    ASSERT_NE(code.find(";\n    vc := "), std::string::npos) << code;
+    ASSERT_NE(code.find(";\n    RETURN "), std::string::npos) << code;
+    ASSERT_TRUE(code.ends_with("\nEND.\n")) << code;
+    // Four assignments and the return statement
+    ASSERT_EQ(std::count(code.begin(), code.end(), ':'), 4) << code;
+
+    // Without variables, only the return statement is generated.
+    Pljit pljit;
+    auto function = pljit.registerFunction(WorkloadGenerator(WorkloadOptions{.numberOfParameters = 0,
+                                                                             .numberOfVariables = 0,
+                                                                             .numberOfConstants = 0})
+                                               .generateFunction());
+    ASSERT_EQ(function().resultCode, ResultCode::Success);
+}
+
+TEST(TestWorkloadGenerator, Shapes) { // NOLINT
+    std::vector<WorkloadOptions> shapes{
+        {},
+        {.numberOfStatements = 64, .maxExpressionDepth = 6, .fanOut = 4, .nestingFrequency = 0.5},
+        // Multiplications only, hence, most of them have to be replaced by divisions.
+        {.numberOfStatements = 64, .addWeight = 0, .subWeight = 0, .mulWeight = 1, .divisionFrequency = 0,
+         .literalFrequency = 0, .maxLiteral = 1000000, .maxParameterValue = 1000000},
+        {.numberOfConstants = 0, .numberOfStatements = 32, .divisionFrequency = 0.9},
+        {.numberOfVariables = 1, .fanOut = 1, .unaryMinusFrequency = 1}};
+    for (auto& options : shapes) {
+        for (uint64_t seed = 0; seed < 16; ++seed) {
+            options.seed = seed;
+            checkFunction(WorkloadGenerator(options).generateFunction(), options);
+        }
+    }
+}
+
+TEST(TestWorkloadGenerator, DeepExpression) { // NOLINT
+    WorkloadOptions options{.numberOfStatements = 1, .maxExpressionDepth = 10000, .fanOut = 1,
+                            .nestingFrequency = 1, .unaryMinusFrequency = 0};
+    auto code = WorkloadGenerator(options).generateFunction();
+    ASSERT_NE(code.find(std::string(10000, '(')), std::string::npos);
+    checkFunction(code, options);
+}
+
+TEST(TestWorkloadGenerator, Module) { // NOLINT
+    test_utils::CaptureCout cout;
+    WorkloadGenerator generator(WorkloadOptions{.numberOfStatements = 8});
+    Pljit pljit;
+    auto functions = pljit.registerModule(generator.generateModule(8));
+    ASSERT_EQ(functions.size(), 8);
+    for (const auto& function : functions) {
+        ASSERT_TRUE(function.compiled) << function.diagnostics;
+    }
+    ASSERT_EQ(cout.stream.str(), "");
+}
+
+} // namespace pljit::workload
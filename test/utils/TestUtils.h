@@ -3,9 +3,11 @@
 
 #include "pljit/analysis/SymbolTable.h"
 #include "pljit/ast/ASTFwd.h"
+#include "pljit/common/Diagnostics.h"
 #include "pljit/common/SourceCodeManager.h"
 #include "pljit/exec/ExecutionContext.h"
 #include <iostream>
+#include <memory>
 #include <sstream>
 
 namespace pljit::test_utils {
@@ -34,6 +36,18 @@ class CaptureCout {
     CaptureCout& operator=(CaptureCout&& other) noexcept = delete;
 };
 
+/// Class for capturing the formatted diagnostics which are reported on the
+/// current thread. Diagnostics of other threads are only captured if the sink
+/// is passed to them, e.g. with PljitOptions::diagnosticsSink.
+class CaptureDiagnostics {
+    public:
+    std::stringstream stream;
+    std::shared_ptr<common::DiagnosticsSink> sink{std::make_shared<common::StreamDiagnosticsSink>(stream)};
+
+    private:
+    common::DiagnosticsSinkScope scope{sink.get()};
+};
+
 void checkASTParameter(const analysis::SymbolTable& symbolTable, size_t id,
                        std::string_view name);
 